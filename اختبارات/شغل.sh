@@ -0,0 +1,197 @@
+#!/bin/sh
+#
+# SEEKEP - مشغل الاختبارات
+# ينفذ كل اختبار بكل طرق التنفيذ: المكدسي، ومستويا التحسين، والجهاز
+# السجلي، وصورة البايتكود، وذاكرة الترجمة؛ ويقارن المخرج في كل منها
+# بملف .متوقع بجانب الاختبار. سطور في رأس الاختبار تضبط تشغيله:
+#   # خيارات: <خيارات>     تُمرر للمفسر في كل الطرق
+#   # حد_الذاكرة: <KB>     أقصى ذاكرة افتراضية للعملية (ulimit -v)
+#   # الجهاز_السجلي: كامل   يترجم كله للجهاز السجلي، فلا ملاحظة رجوع للمكدسي
+#   # الجهاز_السجلي: رجوع   فيه ما لا يدعمه السجلي، فيُنفذ بالمكدسي بعد ملاحظة
+#   # خطأ: <رسالة>          ينتهي الاختبار بخطأ زمني هذه رسالته، بعد مخرجه المتوقع
+#
+# الاستخدام: اختبارات/شغل.sh <المفسر> [اختبار.سكيب...]
+#
+
+SEEKEP=${1:?"الاستخدام: $0 <المفسر> [اختبار.سكيب...]"}
+shift
+DIR=$(dirname "$0")
+if [ $# -eq 0 ]; then
+    set -- "$DIR"/*.سكيب
+    [ -f "$1" ] || set --    # لا اختبارات بعد
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+total=0
+failed=0
+
+directive() {
+    sed -n "s/^# $1: *//p" "$2" | head -n 1
+}
+
+# عدد u32 صغير الطرف من ملف عند إزاحة
+u32() {
+    od -An -tu1 -j "$2" -N4 "$1" | awk '{ print $1 + 256 * ($2 + 256 * ($3 + 256 * $4)) }'
+}
+
+# تشغيل بحد الذاكرة إن عُين؛ المخرج في $WORK/out
+run() {
+    ( if [ -n "$limit" ]; then ulimit -v "$limit"; fi; "$@" ) > "$WORK/out" 2> "$WORK/err"
+}
+
+# مقارنة آخر تشغيل (status) بالمتوقع: نجاح، أو الخطأ المعلن برمز خروج لا بإشارة
+check() {
+    total=$((total + 1))
+    if [ -z "$error" ]; then
+        ok=$([ "$status" -eq 0 ] && echo 1)
+    else
+        ok=$([ "$status" -gt 0 ] && [ "$status" -lt 128 ] && grep -qF "$error" "$WORK/err" && echo 1)
+    fi
+    if [ -z "$ok" ] || ! cmp -s "$WORK/out" "$expected"; then
+        failed=$((failed + 1))
+        echo "فشل: $test ($1)، رمز الخروج $status"
+        diff "$expected" "$WORK/out" | head -n 10
+        head -n 5 "$WORK/err"
+    fi
+}
+
+for test in "$@"; do
+    expected="${test%.سكيب}.متوقع"
+    if [ ! -f "$expected" ]; then
+        echo "فشل: $test بلا ملف متوقع"
+        failed=$((failed + 1))
+        continue
+    fi
+    options=$(directive خيارات "$test")
+    limit=$(directive حد_الذاكرة "$test")
+    registers=$(directive الجهاز_السجلي "$test")
+    error=$(directive خطأ "$test")
+    echo "اختبار: $test"
+
+    run "$SEEKEP" --no-cache $options "$test"; status=$?; check "المكدسي"
+    run "$SEEKEP" --no-cache -O1 $options "$test"; status=$?; check "-O1"
+    run "$SEEKEP" --no-cache -O2 $options "$test"; status=$?; check "-O2"
+    run "$SEEKEP" --reg $options "$test"; status=$?; check "السجلي"
+    if [ "$registers" = "كامل" ] && [ -s "$WORK/err" ]; then
+        failed=$((failed + 1))
+        echo "فشل: $test (السجلي) رجع إلى المكدسي"
+        head -n 5 "$WORK/err"
+    elif [ "$registers" = "رجوع" ] && ! grep -q "فيُنفذ البرنامج بالجهاز المكدسي" "$WORK/err"; then
+        failed=$((failed + 1))
+        echo "فشل: $test (السجلي) بلا ملاحظة الرجوع إلى المكدسي"
+    fi
+
+    for level in 0 2; do
+        rm -f "$WORK/image.skpbc"
+        "$SEEKEP" -c -O$level "$test" -o "$WORK/image.skpbc" > /dev/null 2>&1
+        run "$SEEKEP" $options "$WORK/image.skpbc"; status=$?; check "صورة البايتكود -O$level"
+    done
+
+    # التشغيل الأول يكتب النسخة والثاني يحملها
+    rm -rf "$WORK/cache"
+    for pass in "كتابة" "تحميل"; do
+        run env SEEKEP_CACHE_DIR="$WORK/cache" "$SEEKEP" $options "$test"; status=$?
+        check "ذاكرة الترجمة، $pass"
+    done
+done
+
+# ذاكرة الترجمة تُبطل بأي تعديل في المصدر، ولو بقي طوله وزمن تعديله
+limit=
+error=
+test="إبطال ذاكرة الترجمة"
+script="$WORK/نسخة.سكيب"
+printf 'اطبع(1 + 1)\n' > "$script"
+printf '2\n' > "$WORK/expected"
+expected="$WORK/expected"
+run env SEEKEP_CACHE_DIR="$WORK/cache" "$SEEKEP" "$script"; status=$?; check "الكتابة"
+run env SEEKEP_CACHE_DIR="$WORK/cache" "$SEEKEP" "$script"; status=$?; check "التحميل"
+touch -r "$script" "$WORK/stamp"
+printf 'اطبع(1 + 2)\n' > "$script"
+touch -r "$WORK/stamp" "$script"
+printf '3\n' > "$WORK/expected"
+run env SEEKEP_CACHE_DIR="$WORK/cache" "$SEEKEP" "$script"; status=$?; check "بعد التعديل"
+run env SEEKEP_CACHE_DIR="$WORK/cache" "$SEEKEP" -O2 "$script"; status=$?; check "بعد التعديل -O2"
+
+# النسخة التي لا تجتاز التحقق عند تحميلها تُترك بصمت ويُترجم المصدر، ثم
+# تُكتب فوقها نسخة سليمة
+for cached in "$WORK"/cache/*.skpbc; do
+    code=$(u32 "$cached" $(($(u32 "$cached" 20) + 12)))
+    printf '\377' | dd of="$cached" bs=1 seek="$code" conv=notrunc 2> /dev/null
+done
+for pass in "التالفة" "المكتوبة بدلها"; do
+    run env SEEKEP_CACHE_DIR="$WORK/cache" "$SEEKEP" "$script"; status=$?
+    check "النسخة $pass"
+    if [ -s "$WORK/err" ]; then
+        failed=$((failed + 1))
+        echo "فشل: $test (النسخة $pass) برسالة على stderr"
+        head -n 5 "$WORK/err"
+    fi
+done
+
+# الصورة المبتورة أو التالفة تُرفض برسالة لا بانهيار
+test="صور البايتكود التالفة"
+"$SEEKEP" -c "$script" -o "$WORK/image.skpbc" > /dev/null 2>&1
+size=$(wc -c < "$WORK/image.skpbc")
+for cut in 8 40 $((size / 2)) $((size - 1)); do
+    head -c "$cut" "$WORK/image.skpbc" > "$WORK/cut.skpbc"
+    run "$SEEKEP" "$WORK/cut.skpbc"; status=$?
+    total=$((total + 1))
+    if [ "$status" -eq 0 ] || [ "$status" -ge 128 ]; then
+        failed=$((failed + 1))
+        echo "فشل: $test (مبتورة عند $cut بايت)، رمز الخروج $status"
+    fi
+done
+
+# بايت واحد 0xFF في أي موضع من تعليمات الصورة: كود عملية غير معروف، أو
+# ثابت أو فتحة أو ذاكرة مخبئية خارج جدولها، أو قفزة خارج الكتلة. كلها
+# يرفضها التحميل قبل تنفيذ أي تعليمة
+cat > "$script" <<'EOF'
+صنف نقطة {
+    دالة init(س) { هذا.س = س }
+    دالة ضعف() { أرجع هذا.س * 2 }
+}
+دالة عداد(بداية) {
+    متغير ع = بداية
+    دالة زد(خطوة) {
+        ع = ع + خطوة
+        أرجع ع
+    }
+    أرجع زد
+}
+متغير ز = عداد(1)
+متغير مجموع = 0
+لكل (ن في [1، 2، 3]) { مجموع = مجموع + ز(ن) }
+متغير ق = {"أ": جديد نقطة(مجموع)}
+إذا (مجموع > 3 و مجموع < 100) { اطبع(ق["أ"].ضعف()) }
+EOF
+for level in 0 2; do
+    "$SEEKEP" -c -O$level "$script" -o "$WORK/image.skpbc" > /dev/null 2>&1
+    functions=$(u32 "$WORK/image.skpbc" 12)
+    table=$(u32 "$WORK/image.skpbc" 20)
+    accepted=
+    i=0
+    while [ "$i" -lt "$functions" ]; do
+        code=$(u32 "$WORK/image.skpbc" $((table + 36 * i + 12)))
+        count=$(u32 "$WORK/image.skpbc" $((table + 36 * i + 16)))
+        offset=0
+        while [ "$offset" -lt "$count" ]; do
+            cp "$WORK/image.skpbc" "$WORK/bad.skpbc"
+            printf '\377' | dd of="$WORK/bad.skpbc" bs=1 seek=$((code + offset)) conv=notrunc 2> /dev/null
+            run "$SEEKEP" "$WORK/bad.skpbc"; status=$?
+            if [ "$status" -eq 0 ] || [ "$status" -ge 128 ] || ! grep -q "تالف" "$WORK/err"; then
+                accepted="$accepted $i:$offset"
+            fi
+            offset=$((offset + 1))
+        done
+        i=$((i + 1))
+    done
+    total=$((total + 1))
+    if [ -n "$accepted" ]; then
+        failed=$((failed + 1))
+        echo "فشل: $test (-O$level) قُبلت تعليمات تالفة في (الدالة:الموضع)$accepted"
+    fi
+done
+
+echo "نجح $((total - failed)) من $total"
+[ "$failed" -eq 0 ]
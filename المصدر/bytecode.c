@@ -0,0 +1,1012 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * ملفات البايتكود (.skpbc) - Bytecode Files Implementation
+ *
+ * حفظ الكتلة المترجمة وتحميلها لتشغيلها دون المرور بالمعجم والمحلل والمترجم
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bytecode.h"
+#include "vm.h"
+
+/* أنواع الثوابت في الملف؛ مستقلة عن ترقيم skp_type_t */
+#define CONSTANT_INT    1
+#define CONSTANT_FLOAT  2
+#define CONSTANT_STRING 3
+#define CONSTANT_FUNC   4
+
+#define NO_NAME 0xFFFFFFFFu
+
+#define HEADER_SIZE    40
+#define FUNCTION_SIZE  36
+#define CONSTANT_SIZE  16
+
+/* حقول سجل الدالة بترتيبها، كل حقل u32 */
+enum {
+    FUNCTION_NAME,
+    FUNCTION_ARITY,
+    FUNCTION_UPVALUES,
+    FUNCTION_CODE,
+    FUNCTION_CODE_COUNT,
+    FUNCTION_LINES,
+    FUNCTION_CACHES,
+    FUNCTION_CONSTANTS,
+    FUNCTION_CONSTANT_COUNT,
+    FUNCTION_FIELDS
+};
+
+/* ========== الكتابة ========== */
+
+typedef struct {
+    uint8_t* data;
+    size_t count;
+    size_t capacity;
+} bc_writer_t;
+
+/* دالة في الصورة: البرنامج (الرقم 0) أو دالة متداخلة */
+typedef struct {
+    const char* name;
+    int arity;
+    int upvalue_count;
+    chunk_t* chunk;
+} bc_function_t;
+
+static void write_bytes(bc_writer_t* writer, const void* bytes, size_t length) {
+    if (writer->count + length > writer->capacity) {
+        size_t capacity = writer->capacity == 0 ? 4096 : writer->capacity;
+        while (capacity < writer->count + length) capacity *= 2;
+        writer->data = (uint8_t*)realloc(writer->data, capacity);
+        writer->capacity = capacity;
+    }
+    
+    if (bytes) {
+        memcpy(writer->data + writer->count, bytes, length);
+    } else {
+        memset(writer->data + writer->count, 0, length);
+    }
+    writer->count += length;
+}
+
+static void write_u32(bc_writer_t* writer, uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+    write_bytes(writer, bytes, 4);
+}
+
+/* كتابة في مكان محجوز سابقاً؛ المخزن قد ينتقل فلا تُحفظ مؤشرات إليه */
+static void patch_u32(bc_writer_t* writer, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) writer->data[offset + i] = (uint8_t)(value >> (8 * i));
+}
+
+static void patch_u64(bc_writer_t* writer, size_t offset, uint64_t value) {
+    for (int i = 0; i < 8; i++) writer->data[offset + i] = (uint8_t)(value >> (8 * i));
+}
+
+/* أصفار حتى يصير الموضع مضاعفاً لـ alignment؛ يعيد الموضع */
+static size_t align(bc_writer_t* writer, size_t alignment) {
+    write_bytes(writer, NULL, (alignment - writer->count % alignment) % alignment);
+    return writer->count;
+}
+
+/* حجز length بايت أصفاراً؛ يعيد موضعها */
+static size_t reserve(bc_writer_t* writer, size_t length) {
+    size_t offset = writer->count;
+    write_bytes(writer, NULL, length);
+    return offset;
+}
+
+/* نص: الطول ثم البايتات ثم صفر، فيصلح نصاً C في الصورة المخططة */
+static uint32_t write_string(bc_writer_t* writer, const char* chars, size_t length) {
+    uint32_t offset = (uint32_t)writer->count;
+    write_u32(writer, (uint32_t)length);
+    write_bytes(writer, chars, length);
+    write_bytes(writer, "", 1);
+    return offset;
+}
+
+static void add_function(bc_function_t** functions, size_t* count, size_t* capacity,
+                         const char* name, int arity, int upvalue_count, chunk_t* chunk) {
+    if (*count >= *capacity) {
+        *capacity = *capacity == 0 ? 16 : *capacity * 2;
+        *functions = (bc_function_t*)realloc(*functions, *capacity * sizeof(bc_function_t));
+    }
+    
+    bc_function_t* function = &(*functions)[(*count)++];
+    function->name = name;
+    function->arity = arity;
+    function->upvalue_count = upvalue_count;
+    function->chunk = chunk;
+}
+
+/* بناء الصورة كاملة في الذاكرة */
+static void build_image(bc_writer_t* out, chunk_t* chunk, skp_object_t* globals, uint64_t source_key) {
+    bc_writer_t writer = { NULL, 0, 0 };
+    
+    /* الدوال بترتيب الاتساع، فرقم كل دالة أكبر من رقم مالكها */
+    bc_function_t* functions = NULL;
+    size_t function_count = 0;
+    size_t function_capacity = 0;
+    add_function(&functions, &function_count, &function_capacity, NULL, 0, 0, chunk);
+    for (size_t i = 0; i < function_count; i++) {
+        chunk_t* owner = functions[i].chunk;
+        for (size_t k = 0; k < owner->constant_count; k++) {
+            if (owner->constants[k].type != SKP_TYPE_FUNC) continue;
+            skp_object_t* function = owner->constants[k].value.func_val;
+            add_function(&functions, &function_count, &function_capacity,
+                         function->data.v_func.name, function->data.v_func.arity,
+                         function->data.v_func.upvalue_count, function->data.v_func.chunk);
+        }
+    }
+    
+    /* أسماء العامة بترتيب فتحاتها */
+    size_t global_count = skp_dict_len(globals);
+    const skp_object_t** names = (const skp_object_t**)calloc(global_count + 1, sizeof(skp_object_t*));
+    size_t position = 0;
+    skp_dict_entry_t* entry;
+    while (skp_dict_next(globals, &position, &entry)) {
+        skp_int slot = SKP_AS_INT(entry->value);
+        if (slot >= 0 && (size_t)slot < global_count) names[slot] = entry->key;
+    }
+    
+    /* الجداول أولاً، وإزاحات ما تشير إليه تُملأ بعد كتابته */
+    size_t header = reserve(&writer, HEADER_SIZE);
+    size_t global_table = reserve(&writer, global_count * 4);
+    size_t function_table = reserve(&writer, function_count * FUNCTION_SIZE);
+    
+    size_t* constant_tables = (size_t*)malloc((function_count + 1) * sizeof(size_t));
+    align(&writer, 8);
+    for (size_t i = 0; i < function_count; i++) {
+        constant_tables[i] = reserve(&writer, functions[i].chunk->constant_count * CONSTANT_SIZE);
+    }
+    
+    for (size_t i = 0; i < function_count; i++) {
+        chunk_t* c = functions[i].chunk;
+        size_t record = function_table + i * FUNCTION_SIZE;
+        
+        size_t lines = align(&writer, 4);
+        for (size_t b = 0; b < c->count; b++) {
+            write_u32(&writer, (uint32_t)c->lines[b]);
+        }
+        size_t code = writer.count;
+        write_bytes(&writer, c->code, c->count);
+        
+        uint32_t name = functions[i].name
+            ? write_string(&writer, functions[i].name, strlen(functions[i].name)) : NO_NAME;
+        
+        patch_u32(&writer, record + 4 * FUNCTION_NAME, name);
+        patch_u32(&writer, record + 4 * FUNCTION_ARITY, (uint32_t)functions[i].arity);
+        patch_u32(&writer, record + 4 * FUNCTION_UPVALUES, (uint32_t)functions[i].upvalue_count);
+        patch_u32(&writer, record + 4 * FUNCTION_CODE, (uint32_t)code);
+        patch_u32(&writer, record + 4 * FUNCTION_CODE_COUNT, (uint32_t)c->count);
+        patch_u32(&writer, record + 4 * FUNCTION_LINES, (uint32_t)lines);
+        patch_u32(&writer, record + 4 * FUNCTION_CACHES, (uint32_t)c->cache_count);
+        patch_u32(&writer, record + 4 * FUNCTION_CONSTANTS, (uint32_t)constant_tables[i]);
+        patch_u32(&writer, record + 4 * FUNCTION_CONSTANT_COUNT, (uint32_t)c->constant_count);
+    }
+    
+    /* الثوابت. الدوال تُرقم بترتيب ظهورها كما جُمعت أعلاه */
+    size_t next_function = 1;
+    for (size_t i = 0; i < function_count; i++) {
+        chunk_t* c = functions[i].chunk;
+        
+        for (size_t k = 0; k < c->constant_count; k++) {
+            constant_t* constant = &c->constants[k];
+            size_t slot = constant_tables[i] + k * CONSTANT_SIZE;
+            uint32_t type = 0;
+            uint64_t value = 0;
+            
+            switch (constant->type) {
+                case SKP_TYPE_INT:
+                    type = CONSTANT_INT;
+                    value = (uint64_t)constant->value.int_val;
+                    break;
+                case SKP_TYPE_FLOAT:
+                    type = CONSTANT_FLOAT;
+                    memcpy(&value, &constant->value.float_val, sizeof(value));
+                    break;
+                case SKP_TYPE_STRING:
+                    type = CONSTANT_STRING;
+                    value = write_string(&writer, constant->value.string_val->data.v_string.chars,
+                                         constant->value.string_val->data.v_string.length);
+                    break;
+                case SKP_TYPE_FUNC:
+                    type = CONSTANT_FUNC;
+                    value = next_function++;
+                    break;
+                default:
+                    break;
+            }
+            
+            patch_u32(&writer, slot, type);
+            patch_u64(&writer, slot + 8, value);
+        }
+    }
+    
+    for (size_t i = 0; i < global_count; i++) {
+        uint32_t name = names[i]
+            ? write_string(&writer, names[i]->data.v_string.chars, names[i]->data.v_string.length)
+            : write_string(&writer, "", 0);
+        patch_u32(&writer, global_table + 4 * i, name);
+    }
+    
+    memcpy(writer.data + header, SKP_BYTECODE_MAGIC, 4);
+    patch_u32(&writer, header + 4, SKP_BYTECODE_VERSION | ((uint32_t)(OP_HALT + 1) << 16));
+    patch_u32(&writer, header + 8, (uint32_t)global_count);
+    patch_u32(&writer, header + 12, (uint32_t)function_count);
+    patch_u32(&writer, header + 16, (uint32_t)global_table);
+    patch_u32(&writer, header + 20, (uint32_t)function_table);
+    patch_u32(&writer, header + 24, (uint32_t)writer.count);
+    patch_u64(&writer, header + 32, source_key);
+    
+    free(constant_tables);
+    free(names);
+    free(functions);
+    *out = writer;
+}
+
+/* الكتابة في ملف مؤقت بجانب الهدف ثم إعادة تسميته فوقه: من يقرأ الملف
+ * يرى القديم أو الجديد كاملاً، ولا يُقطع ملف مخطط في ذاكرة عملية أخرى */
+static int write_atomically(const char* path, const uint8_t* data, size_t size) {
+    size_t length = strlen(path);
+    char* temp = (char*)malloc(length + 32);
+    snprintf(temp, length + 32, "%s.%ld.tmp", path, (long)getpid());
+    
+    FILE* file = fopen(temp, "wb");
+    if (!file) {
+        free(temp);
+        return 0;
+    }
+    
+    int ok = fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+    ok = ok && rename(temp, path) == 0;
+    if (!ok) remove(temp);
+    
+    free(temp);
+    return ok;
+}
+
+int bytecode_write(chunk_t* chunk, skp_object_t* globals, const char* path) {
+    bc_writer_t writer;
+    build_image(&writer, chunk, globals, 0);
+    
+    int ok = write_atomically(path, writer.data, writer.count);
+    free(writer.data);
+    
+    if (!ok) {
+        fprintf(stderr, "خطأ: فشل في كتابة الملف '%s'\n", path);
+    }
+    return ok;
+}
+
+/* ========== القراءة ========== */
+
+typedef struct {
+    uint8_t* base;               /* الصورة المخططة */
+    size_t size;
+    uint16_t* remap;             /* فتحة الملف ← فتحة الجهاز، أو NULL إن تطابقتا */
+    size_t global_count;
+    int failed;
+} bc_image_t;
+
+static uint32_t get_u32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t* bytes) {
+    return (uint64_t)get_u32(bytes) | ((uint64_t)get_u32(bytes + 4) << 32);
+}
+
+/* هل [offset, offset + length) داخل الصورة؟ */
+static int in_image(bc_image_t* image, size_t offset, size_t length) {
+    if (offset > image->size || length > image->size - offset) {
+        image->failed = 1;
+        return 0;
+    }
+    return 1;
+}
+
+/* النص عند الإزاحة، في مكانه من الصورة ومنتهياً بصفر */
+static const char* image_string(bc_image_t* image, uint32_t offset, size_t* length) {
+    if (!in_image(image, offset, 4)) return NULL;
+    
+    *length = get_u32(image->base + offset);
+    if (!in_image(image, (size_t)offset + 4, *length + 1) ||
+        image->base[(size_t)offset + 4 + *length] != '\0') {
+        image->failed = 1;
+        return NULL;
+    }
+    return (const char*)image->base + offset + 4;
+}
+
+static int host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+/* ========== التحقق من التعليمات ========== */
+
+/* أقصى ارتفاع لمكدس الإطار الواحد. إطار المستدعى يبدأ داخل إطار مستدعيه،
+ * فلا تتجاوز الإطارات كلها مكدس الجهاز */
+#define MAX_FRAME_STACK (SKP_STACK_MAX / SKP_FRAMES_MAX)
+
+static int constant_is(chunk_t* chunk, uint8_t index, skp_type_t type) {
+    return index < chunk->constant_count && chunk->constants[index].type == type;
+}
+
+static size_t code_short(chunk_t* chunk, size_t offset) {
+    return (size_t)(chunk->code[offset] << 8) | chunk->code[offset + 1];
+}
+
+/* المرور الأول على التعليمات بالترتيب: كل كود عملية معروف ومنفذ، وكل
+ * تعليمة داخل الكتلة، وكل معامل داخل جدوله (الثوابت بنوعها المنتظر،
+ * والذاكرة المخبئية، والعامة، والـ upvalues). يعلّم بدايات التعليمات
+ * في starts ويحوّل معاملات تعليمات العامة إلى فتحات الجهاز */
+static int decode_code(bc_image_t* image, chunk_t* chunk, int upvalue_count, uint8_t* starts) {
+    for (size_t offset = 0; offset < chunk->count;) {
+        uint8_t op = chunk->code[offset];
+        if (op > OP_HALT) return 0;
+        
+        /* الطول يُحسب بثابت CLOSURE فيُفحص قبله */
+        if (op == OP_CLOSURE &&
+            (offset + 1 >= chunk->count || !constant_is(chunk, chunk->code[offset + 1], SKP_TYPE_FUNC))) {
+            return 0;
+        }
+        
+        size_t length = (size_t)instruction_length(chunk, (int)offset);
+        if (offset + length > chunk->count) return 0;
+        starts[offset] = 1;
+        
+        const uint8_t* operand = chunk->code + offset + 1;
+        int ok = 1;
+        switch (op) {
+            case OP_CONST_INT:
+                ok = constant_is(chunk, operand[0], SKP_TYPE_INT);
+                break;
+            case OP_CONST_FLOAT:
+                ok = constant_is(chunk, operand[0], SKP_TYPE_FLOAT);
+                break;
+            case OP_CONST_STRING:
+            case OP_CLASS:
+            case OP_METHOD:
+                ok = constant_is(chunk, operand[0], SKP_TYPE_STRING);
+                break;
+            case OP_GET_FIELD:
+            case OP_SET_FIELD:
+                ok = constant_is(chunk, operand[0], SKP_TYPE_STRING) &&
+                     code_short(chunk, offset + 2) < chunk->cache_count;
+                break;
+            case OP_INVOKE:
+                ok = constant_is(chunk, operand[0], SKP_TYPE_STRING) &&
+                     code_short(chunk, offset + 3) < chunk->cache_count;
+                break;
+            case OP_GET_LOCAL_CONST_ADD:
+                ok = constant_is(chunk, operand[1], SKP_TYPE_INT) ||
+                     constant_is(chunk, operand[1], SKP_TYPE_FLOAT);
+                break;
+            case OP_GET_UPVALUE:
+            case OP_SET_UPVALUE:
+                ok = operand[0] < upvalue_count;
+                break;
+            case OP_CLOSURE:
+                /* أزواج (محلي؟، فهرس)؛ الفهارس المحلية تُفحص مع ارتفاع المكدس */
+                for (size_t i = 1; i + 1 < length; i += 2) {
+                    if (operand[i] > 1 || (!operand[i] && operand[i + 1] >= upvalue_count)) ok = 0;
+                }
+                break;
+            case OP_GET_GLOBAL:
+            case OP_SET_GLOBAL:
+            case OP_SET_GLOBAL_POP:
+            case OP_DEFINE_GLOBAL:
+            case OP_CALL_GLOBAL: {
+                size_t slot = code_short(chunk, offset + 1);
+                if (slot >= image->global_count) return 0;
+                if (image->remap) {
+                    chunk->code[offset + 1] = (uint8_t)(image->remap[slot] >> 8);
+                    chunk->code[offset + 2] = (uint8_t)(image->remap[slot] & 0xFF);
+                }
+                break;
+            }
+            case OP_GET_SUPER:
+            case OP_SUPER_INVOKE:
+            case OP_THROW:
+            case OP_TRY_START:
+            case OP_TRY_END:
+            case OP_CATCH:
+            case OP_FINALLY:
+                /* لا ينفذها الجهاز بعد */
+                ok = 0;
+                break;
+            default:
+                break;
+        }
+        if (!ok) return 0;
+        
+        offset += length;
+    }
+    return 1;
+}
+
+/* ارتفاع المكدس عند الهدف: يُسجل أول مرة، ويجب أن يطابق في كل مرة بعدها */
+static int reach(const uint8_t* starts, int* heights, size_t* pending, size_t* pending_count,
+                 size_t count, size_t target, int height) {
+    if (target >= count || !starts[target]) return 0;
+    if (heights[target] < 0) {
+        heights[target] = height;
+        pending[(*pending_count)++] = target;
+        return 1;
+    }
+    return heights[target] == height;
+}
+
+/* المرور الثاني على كل طريق من البداية: ارتفاع المكدس واحد عند كل تعليمة
+ * أياً كان الطريق إليها، ولا يقل عما تأخذه منه ولا يتجاوز حد الإطار، وكل
+ * فتحة محلية تحته، وكل قفزة إلى بداية تعليمة، ولا يخرج التنفيذ من آخر
+ * الكتلة. entry_height ما على المكدس عند الدخول: المعاملات والدالة نفسها */
+static int check_stack(chunk_t* chunk, const uint8_t* starts, int entry_height) {
+    size_t count = chunk->count;
+    int* heights = (int*)malloc(count * sizeof(int));
+    size_t* pending = (size_t*)malloc(count * sizeof(size_t));
+    size_t pending_count = 0;
+    for (size_t i = 0; i < count; i++) heights[i] = -1;
+    
+    int ok = reach(starts, heights, pending, &pending_count, count, 0, entry_height);
+    while (ok && pending_count > 0) {
+        size_t offset = pending[--pending_count];
+        const uint8_t* code = chunk->code + offset;
+        size_t length = (size_t)instruction_length(chunk, (int)offset);
+        int height = heights[offset];
+        
+        int pops = 0;
+        int pushes = 0;
+        int peak = 0;            /* ما يزيد مؤقتاً فوق الارتفاع قبلها */
+        int falls = 1;
+        int jumps = 0;
+        size_t target = 0;
+        int local = -1;          /* أعلى فتحة محلية تقرؤها التعليمة */
+        
+        switch (code[0]) {
+            case OP_CONST_INT:
+            case OP_CONST_FLOAT:
+            case OP_CONST_STRING:
+            case OP_CONST_TRUE:
+            case OP_CONST_FALSE:
+            case OP_CONST_NULL:
+            case OP_GET_GLOBAL:
+            case OP_GET_UPVALUE:
+            case OP_CLASS:
+                pushes = 1;
+                break;
+            case OP_CONST_LIST:
+                pops = code[1];
+                pushes = 1;
+                break;
+            case OP_CONST_DICT:
+                pops = code[1] * 2;
+                pushes = 1;
+                break;
+            case OP_GET_LOCAL:
+            case OP_GET_LOCAL_CONST_ADD:
+                local = code[1];
+                pushes = 1;
+                break;
+            case OP_GET_LOCAL_GET_LOCAL:
+                local = code[1] > code[2] ? code[1] : code[2];
+                pushes = 2;
+                break;
+            case OP_INC_LOCAL:
+                local = code[1];
+                break;
+            case OP_SET_LOCAL:
+                local = code[1];
+                pops = pushes = 1;
+                break;
+            case OP_SET_LOCAL_POP:
+                /* الفتحة تحت القيمة المزالة */
+                local = code[1] + 1;
+                pops = 1;
+                break;
+            case OP_SET_GLOBAL:
+            case OP_SET_UPVALUE:
+            case OP_GET_FIELD:
+            case OP_NEG:
+            case OP_NOT:
+            case OP_BIT_NOT:
+            case OP_IS_NULL:
+                pops = pushes = 1;
+                break;
+            case OP_SET_GLOBAL_POP:
+            case OP_DEFINE_GLOBAL:
+            case OP_CLOSE_UPVALUE:
+            case OP_POP:
+            case OP_PRINT:
+                pops = 1;
+                break;
+            case OP_SET_FIELD:
+            case OP_GET_INDEX:
+            case OP_METHOD:
+            case OP_INHERIT:
+            case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD: case OP_POW:
+            case OP_AND: case OP_OR:
+            case OP_EQ: case OP_NE: case OP_LT: case OP_GT: case OP_LE: case OP_GE:
+            case OP_BIT_AND: case OP_BIT_OR: case OP_BIT_XOR: case OP_SHL: case OP_SHR:
+            case OP_ADD_INT: case OP_ADD_FLOAT: case OP_SUB_INT: case OP_SUB_FLOAT:
+            case OP_MUL_INT: case OP_MUL_FLOAT: case OP_LT_INT: case OP_LT_FLOAT:
+            case OP_GT_INT: case OP_GT_FLOAT: case OP_LE_INT: case OP_LE_FLOAT:
+            case OP_GE_INT: case OP_GE_FLOAT:
+                pops = 2;
+                pushes = 1;
+                break;
+            case OP_SET_INDEX:
+                pops = 3;
+                pushes = 1;
+                break;
+            case OP_SWAP:
+                pops = pushes = 2;
+                break;
+            case OP_DUP:
+                pops = 1;
+                pushes = 2;
+                break;
+            case OP_JUMP:
+                falls = 0;
+                jumps = 1;
+                target = offset + 3 + code_short(chunk, offset + 1);
+                break;
+            case OP_JUMP_IF_FALSE:
+            case OP_JUMP_IF_TRUE:
+                pops = pushes = 1;
+                jumps = 1;
+                target = offset + 3 + code_short(chunk, offset + 1);
+                break;
+            case OP_LT_JUMP_IF_FALSE:
+                pops = 2;
+                jumps = 1;
+                target = offset + 3 + code_short(chunk, offset + 1);
+                break;
+            case OP_LOOP:
+                /* القفز قبل بداية الكتلة يلتف إلى موضع بعد نهايتها فيُرفض */
+                falls = 0;
+                jumps = 1;
+                target = offset + 3 - code_short(chunk, offset + 1);
+                break;
+            case OP_ITER_NEXT:
+                /* المجموعة وموضعها في فتحتين؛ القفز عند النهاية دون عنصر */
+                local = code[1] + 1;
+                pushes = 1;
+                jumps = 1;
+                target = offset + 4 + code_short(chunk, offset + 2);
+                break;
+            case OP_CALL:
+                pops = code[1] + 1;
+                pushes = 1;
+                break;
+            case OP_INVOKE:
+                pops = code[2] + 1;
+                pushes = 1;
+                break;
+            case OP_CALL_GLOBAL:
+                /* الدالة تُدرج تحت معاملاتها قبل الاستدعاء */
+                pops = code[3];
+                pushes = 1;
+                peak = 1;
+                break;
+            case OP_CLOSURE:
+                for (size_t i = 3; i < length; i += 2) {
+                    if (code[i - 1] && code[i] > local) local = code[i];
+                }
+                pushes = 1;
+                break;
+            case OP_RETURN:
+                pops = 1;
+                falls = 0;
+                break;
+            case OP_RETURN_VOID:
+            case OP_HALT:
+                falls = 0;
+                break;
+            default:
+                /* IMPORT و EXPORT لا يمسان المكدس */
+                break;
+        }
+        
+        int next = height - pops + pushes;
+        if (pops > height || local >= height || next > MAX_FRAME_STACK ||
+            height + peak > MAX_FRAME_STACK) {
+            ok = 0;
+        }
+        
+        /* عند نهاية لكل يقفز دون أن يدفع عنصراً */
+        int target_height = code[0] == OP_ITER_NEXT ? height : next;
+        if (ok && jumps) {
+            ok = reach(starts, heights, pending, &pending_count, count, target, target_height);
+        }
+        if (ok && falls) {
+            ok = reach(starts, heights, pending, &pending_count, count, offset + length, next);
+        }
+    }
+    
+    free(heights);
+    free(pending);
+    return ok;
+}
+
+/* بناء الدالة index من سجلها. الدوال المتداخلة أرقامها أكبر فهي مبنية قبلها */
+static skp_object_t* load_function(bc_image_t* image, size_t index,
+                                   skp_object_t** functions, size_t function_count) {
+    const uint8_t* record = image->base + get_u32(image->base + 20) + index * FUNCTION_SIZE;
+    uint32_t field[FUNCTION_FIELDS];
+    for (int i = 0; i < FUNCTION_FIELDS; i++) field[i] = get_u32(record + 4 * i);
+    
+    uint32_t count = field[FUNCTION_CODE_COUNT];
+    uint32_t constant_count = field[FUNCTION_CONSTANT_COUNT];
+    if (!in_image(image, field[FUNCTION_CODE], count) ||
+        !in_image(image, field[FUNCTION_LINES], (size_t)count * 4) ||
+        !in_image(image, field[FUNCTION_CONSTANTS], (size_t)constant_count * CONSTANT_SIZE) ||
+        field[FUNCTION_LINES] % 4 != 0 || field[FUNCTION_CONSTANTS] % 8 != 0 ||
+        constant_count > 256 || field[FUNCTION_CACHES] > UINT16_MAX + 1u ||
+        field[FUNCTION_UPVALUES] > 256 || field[FUNCTION_ARITY] > 255 ||
+        (index == 0 && (field[FUNCTION_ARITY] != 0 || field[FUNCTION_UPVALUES] != 0))) {
+        image->failed = 1;
+        return NULL;
+    }
+    
+    const char* name = NULL;
+    size_t name_length;
+    if (field[FUNCTION_NAME] != NO_NAME) {
+        name = image_string(image, field[FUNCTION_NAME], &name_length);
+        if (!name) return NULL;
+    }
+    
+    chunk_t* chunk = (chunk_t*)malloc(sizeof(chunk_t));
+    chunk_init(chunk);
+    skp_object_t* function = skp_new_function(name, (int)field[FUNCTION_ARITY], chunk);
+    function->data.v_func.upvalue_count = (int)field[FUNCTION_UPVALUES];
+    
+    /* البايتكود والأسطر من الصورة مباشرة، إلا على جهاز big-endian
+     * فالأسطر تحتاج قلب بايتاتها */
+    chunk->count = chunk->capacity = count;
+    if (host_is_little_endian()) {
+        chunk->code = image->base + field[FUNCTION_CODE];
+        chunk->lines = (int*)(void*)(image->base + field[FUNCTION_LINES]);
+        chunk->borrowed = 1;
+    } else {
+        chunk->code = (uint8_t*)malloc(count ? count : 1);
+        chunk->lines = (int*)malloc(count ? count * sizeof(int) : sizeof(int));
+        memcpy(chunk->code, image->base + field[FUNCTION_CODE], count);
+        for (uint32_t i = 0; i < count; i++) {
+            chunk->lines[i] = (int)get_u32(image->base + field[FUNCTION_LINES] + 4 * i);
+        }
+    }
+    
+    if (field[FUNCTION_CACHES] > 0) {
+        chunk->caches = (inline_cache_t*)calloc(field[FUNCTION_CACHES], sizeof(inline_cache_t));
+        chunk->cache_count = chunk->cache_capacity = field[FUNCTION_CACHES];
+    }
+    
+    if (constant_count > 0) {
+        chunk->constants = (constant_t*)malloc(constant_count * sizeof(constant_t));
+        chunk->constant_capacity = constant_count;
+    }
+    
+    const uint8_t* slot = image->base + field[FUNCTION_CONSTANTS];
+    for (uint32_t i = 0; i < constant_count && !image->failed; i++, slot += CONSTANT_SIZE) {
+        uint64_t value = get_u64(slot + 8);
+        constant_t constant;
+        
+        switch (get_u32(slot)) {
+            case CONSTANT_INT:
+                constant.type = SKP_TYPE_INT;
+                constant.value.int_val = (skp_int)value;
+                break;
+            case CONSTANT_FLOAT:
+                constant.type = SKP_TYPE_FLOAT;
+                memcpy(&constant.value.float_val, &value, sizeof(value));
+                break;
+            case CONSTANT_STRING: {
+                size_t length;
+                const char* chars = value <= UINT32_MAX
+                    ? image_string(image, (uint32_t)value, &length) : NULL;
+                if (!chars) {
+                    image->failed = 1;
+                    continue;
+                }
+                constant.type = SKP_TYPE_STRING;
+                constant.value.string_val = skp_intern_borrowed(chars, length);
+                break;
+            }
+            case CONSTANT_FUNC:
+                if (value <= index || value >= function_count || !functions[value]) {
+                    image->failed = 1;
+                    continue;
+                }
+                constant.type = SKP_TYPE_FUNC;
+                constant.value.func_val = functions[value];
+                skp_incref(functions[value]);
+                break;
+            default:
+                image->failed = 1;
+                continue;
+        }
+        
+        chunk->constants[chunk->constant_count++] = constant;
+    }
+    
+    /* الطول يعتمد على ثوابت CLOSURE، فيُمر على التعليمات بعد اكتمالها.
+     * البرنامج يبدأ بمكدس فارغ، والدالة فوق معاملاتها */
+    if (!image->failed) {
+        int upvalue_count = (int)field[FUNCTION_UPVALUES];
+        int entry_height = index == 0 ? 0 : (int)field[FUNCTION_ARITY] + 1;
+        uint8_t* starts = (uint8_t*)calloc(count ? count : 1, 1);
+        if (!decode_code(image, chunk, upvalue_count, starts) ||
+            !check_stack(chunk, starts, entry_height)) {
+            image->failed = 1;
+        }
+        free(starts);
+    }
+    
+    if (image->failed) {
+        skp_decref(function);
+        return NULL;
+    }
+    return function;
+}
+
+/* قراءة الملف كله إلى الذاكرة، إن تعذر تخطيطه */
+static uint8_t* read_whole_file(int fd, size_t size) {
+    uint8_t* data = (uint8_t*)malloc(size);
+    size_t done = 0;
+    while (data && done < size) {
+        ssize_t n = read(fd, data + done, size - done);
+        if (n <= 0) {
+            free(data);
+            return NULL;
+        }
+        done += (size_t)n;
+    }
+    return data;
+}
+
+/* تخطيط الملف خاصاً وقابلاً للكتابة: الصفحات مشتركة مع ذاكرة الملفات
+ * المؤقتة ومع كل عملية تشغل الملف نفسه، وما يكتبه الجهاز في البايتكود
+ * (تخصيص التعليمات وتحويل فتحات العامة) ينسخ الصفحة التي يمسها وحدها */
+static uint8_t* map_file(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "خطأ: لا يمكن فتح الملف '%s'\n", path);
+        return NULL;
+    }
+    
+    struct stat info;
+    uint8_t* data = NULL;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        *size = (size_t)info.st_size;
+        void* mapped = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        data = mapped != MAP_FAILED ? (uint8_t*)mapped : read_whole_file(fd, *size);
+    }
+    close(fd);
+    
+    if (!data) {
+        fprintf(stderr, "خطأ: فشل في قراءة الملف '%s'\n", path);
+    }
+    return data;
+}
+
+/* قراءة الرأس وحده دون تخطيط الملف ولا رسائل خطأ */
+static int read_header(const char* path, uint8_t header[HEADER_SIZE]) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    
+    int ok = fread(header, 1, HEADER_SIZE, file) == HEADER_SIZE &&
+             memcmp(header, SKP_BYTECODE_MAGIC, 4) == 0;
+    fclose(file);
+    return ok;
+}
+
+int bytecode_is_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    
+    char magic[4];
+    int is_bytecode = fread(magic, 1, 4, file) == 4 && memcmp(magic, SKP_BYTECODE_MAGIC, 4) == 0;
+    fclose(file);
+    return is_bytecode;
+}
+
+/* source_key غير الصفر لنسخة ذاكرة الترجمة: يُطلب في الرأس، والنسخة التي
+ * لا تطابقه أو لا تجتاز التحقق تُرفض بصمت فيُترجم المصدر بدلها */
+static chunk_t* load_image(const char* path, skp_object_t* globals, uint64_t source_key) {
+    bc_image_t image = { NULL, 0, NULL, 0, 0 };
+    image.base = map_file(path, &image.size);
+    if (!image.base) return NULL;
+    
+    /* الصورة لا تُلغى ولو فشل التحميل، فقد تكون بعض نصوصها قد دخلت
+     * جدول الاحتجاز */
+    const uint8_t* header = image.base;
+    if (image.size < HEADER_SIZE || memcmp(header, SKP_BYTECODE_MAGIC, 4) != 0) {
+        fprintf(stderr, "خطأ: '%s' ليس ملف بايتكود\n", path);
+        return NULL;
+    }
+    
+    uint32_t version = get_u32(header + 4);
+    if ((version & 0xFFFF) != SKP_BYTECODE_VERSION || (version >> 16) != OP_HALT + 1) {
+        fprintf(stderr, "خطأ: إصدار البايتكود في '%s' لا يطابق هذا المفسر، أعد ترجمته\n", path);
+        return NULL;
+    }
+    
+    /* نسخة في ذاكرة الترجمة استُبدلت بين فحص رأسها وتخطيطها */
+    if (source_key != 0 && get_u64(header + 32) != source_key) {
+        return NULL;
+    }
+    
+    image.global_count = get_u32(header + 8);
+    size_t function_count = get_u32(header + 12);
+    uint32_t global_table = get_u32(header + 16);
+    if (get_u32(header + 24) != image.size || image.global_count > UINT16_MAX + 1u ||
+        function_count == 0 ||
+        !in_image(&image, global_table, image.global_count * 4) ||
+        !in_image(&image, get_u32(header + 20), function_count * FUNCTION_SIZE)) {
+        image.failed = 1;
+    }
+    
+    /* حل أسماء العامة في جدول الجهاز؛ التحويل يُترك إن طابقت الفتحات */
+    uint16_t* remap = image.failed ? NULL :
+                      (uint16_t*)malloc((image.global_count + 1) * sizeof(uint16_t));
+    int identity = 1;
+    for (size_t i = 0; i < image.global_count && !image.failed; i++) {
+        size_t length;
+        const char* name = image_string(&image, get_u32(image.base + global_table + 4 * i), &length);
+        if (!name) break;
+        
+        int slot = resolve_global(globals, name);
+        if (slot < 0) {
+            image.failed = 1;
+            break;
+        }
+        remap[i] = (uint16_t)slot;
+        identity = identity && (size_t)slot == i;
+    }
+    image.remap = identity ? NULL : remap;
+    
+    /* من آخر دالة إلى البرنامج، فكل دالة تجد دوالها المتداخلة مبنية.
+     * ثوابت المالك تأخذ مرجعاً لكل منها، فيُترك مرجع البناء بعد ذلك */
+    skp_object_t** functions = image.failed ? NULL :
+                               (skp_object_t**)calloc(function_count, sizeof(skp_object_t*));
+    for (size_t i = function_count; functions && i-- > 0 && !image.failed;) {
+        functions[i] = load_function(&image, i, functions, function_count);
+    }
+    
+    skp_object_t* script = NULL;
+    if (functions) {
+        script = image.failed ? NULL : functions[0];
+        for (size_t i = script ? 1 : 0; i < function_count; i++) {
+            if (functions[i]) skp_decref(functions[i]);
+        }
+        free(functions);
+    }
+    free(remap);
+    
+    if (!script) {
+        if (source_key == 0) fprintf(stderr, "خطأ: ملف البايتكود '%s' تالف أو مقطوع\n", path);
+        return NULL;
+    }
+    
+    /* الكتلة الرئيسية تُعاد وحدها كما يعيدها compiler_compile */
+    chunk_t* chunk = script->data.v_func.chunk;
+    script->data.v_func.chunk = NULL;
+    skp_decref(script);
+    return chunk;
+}
+
+chunk_t* bytecode_load(const char* path, skp_object_t* globals) {
+    return load_image(path, globals, 0);
+}
+
+/* ========== ذاكرة الترجمة ========== */
+
+#define CACHE_DIRECTORY "__skpcache__"
+
+/* تجزئة تمر على ثماني بايتات في كل خطوة، فثمنها صغير بجانب تحميل
+ * الصورة نفسها. ليست تشفيرية؛ تكفي لتمييز نسخ الملف الواحد */
+static uint64_t hash_words(uint64_t hash, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    
+    uint64_t tail = 0;
+    memcpy(&tail, bytes + i, length - i);
+    hash = (hash ^ tail ^ length) * multiplier;
+    return hash ^ (hash >> 32);
+}
+
+uint64_t bytecode_source_key(const char* source, size_t length, int optimize) {
+    const char* version = SEEKEP_VERSION_STRING;
+    uint32_t format[2] = { SKP_BYTECODE_VERSION | ((uint32_t)(OP_HALT + 1) << 16), (uint32_t)optimize };
+    
+    uint64_t hash = hash_words(0xCBF29CE484222325ull, version, strlen(version));
+    hash = hash_words(hash, format, sizeof(format));
+    hash = hash_words(hash, source, length);
+    return hash != 0 ? hash : 1;   /* الصفر للصور التي لا مصدر لها (-c) */
+}
+
+/* مسار نسخة الملف: __skpcache__/<الاسم>.skpbc بجانبه، أو في SEEKEP_CACHE_DIR
+ * إن عُين باسم تميزه تجزئة مساره المطلق. لكل مستوى تحسين نسخته
+ * (<الاسم>.opt-1.skpbc...) فلا يتناوب مستويان على ملف واحد. create ينشئ
+ * المجلد إن لم يوجد */
+static char* cache_path(const char* script, int optimize, int create) {
+    const char* slash = strrchr(script, '/');
+    const char* name = slash ? slash + 1 : script;
+    int directory_length = slash ? (int)(slash - script) + 1 : 0;
+    const char* root = getenv("SEEKEP_CACHE_DIR");
+    
+    size_t size = strlen(script) + sizeof(CACHE_DIRECTORY) + 48 + (root ? strlen(root) : 0);
+    char* path = (char*)malloc(size);
+    
+    char suffix[24] = ".skpbc";
+    if (optimize > 0) snprintf(suffix, sizeof(suffix), ".opt-%d.skpbc", optimize);
+    
+    if (root && *root) {
+        /* المسار المطلق، فلا يشترك ملفان بالاسم نفسه في مجلدين */
+        uint64_t hash = 0;
+        char directory[4096];
+        if (script[0] != '/' && getcwd(directory, sizeof(directory))) {
+            hash = hash_words(hash, directory, strlen(directory));
+        }
+        hash = hash_words(hash, script, strlen(script));
+        
+        if (create) mkdir(root, 0777);
+        snprintf(path, size, "%s/%s-%016llx%s", root, name, (unsigned long long)hash, suffix);
+    } else {
+        if (create) {
+            snprintf(path, size, "%.*s" CACHE_DIRECTORY, directory_length, script);
+            mkdir(path, 0777);
+        }
+        snprintf(path, size, "%.*s" CACHE_DIRECTORY "/%s%s", directory_length, script, name, suffix);
+    }
+    return path;
+}
+
+chunk_t* bytecode_cache_load(const char* script, int optimize, uint64_t source_key,
+                             skp_object_t* globals) {
+    char* path = cache_path(script, optimize, 0);
+    
+    /* الرأس يُفحص أولاً فلا يُخطط ملف قديم ولا تُطبع رسالة عن غيابه */
+    uint8_t header[HEADER_SIZE];
+    chunk_t* chunk = NULL;
+    if (read_header(path, header) &&
+        get_u32(header + 4) == (SKP_BYTECODE_VERSION | ((uint32_t)(OP_HALT + 1) << 16)) &&
+        get_u64(header + 32) == source_key) {
+        chunk = load_image(path, globals, source_key);
+    }
+    
+    free(path);
+    return chunk;
+}
+
+void bytecode_cache_store(const char* script, int optimize, uint64_t source_key,
+                          chunk_t* chunk, skp_object_t* globals) {
+    char* path = cache_path(script, optimize, 1);
+    
+    bc_writer_t writer;
+    build_image(&writer, chunk, globals, source_key);
+    
+    /* الفشل (مجلد للقراءة فقط مثلاً) لا يعني إلا التشغيل دون ذاكرة */
+    write_atomically(path, writer.data, writer.count);
+    
+    free(writer.data);
+    free(path);
+}
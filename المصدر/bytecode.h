@@ -0,0 +1,56 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * ملفات البايتكود (.skpbc) - Bytecode Files
+ *
+ * حفظ الكتلة المترجمة وتحميلها لتشغيلها دون المرور بالمعجم والمحلل والمترجم
+ */
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "compiler.h"
+
+/* الصيغة صورة تُخطط في الذاكرة وتُنفذ في مكانها. لا مؤشرات فيها، بل
+ * إزاحات من بداية الملف، والأعداد كلها little-endian:
+ *
+ *   الرأس (40 بايتاً): "SKPB"، u16 الإصدار، u16 عدد أكواد العمليات،
+ *       u32 عدد العامة، u32 عدد الدوال، u32 إزاحة جدول العامة،
+ *       u32 إزاحة جدول الدوال، u32 حجم الملف، u32 محجوز، u64 مفتاح المصدر
+ *       (صفر إلا في ذاكرة الترجمة)
+ *   جدول العامة:  إزاحة نص اسم كل فتحة بترتيبها عند الترجمة
+ *   جدول الدوال:  لكل دالة 9 × u32: الاسم (0xFFFFFFFF بلا اسم)، المعاملات،
+ *       الـ upvalues، إزاحة البايتكود وطوله، إزاحة الأسطر، عدد الذواكر
+ *       المخبئية، إزاحة الثوابت وعددها. الدالة 0 هي البرنامج
+ *   الثوابت (محاذاة 8):  16 بايتاً لكل ثابت: u32 النوع، u32 صفر، u64 القيمة
+ *       (العدد، أو بتات العشري، أو إزاحة النص، أو رقم دالة أكبر من رقم مالكها)
+ *   الأسطر (محاذاة 4):   i32 لكل بايت من البايتكود
+ *   النصوص:  u32 الطول ثم البايتات ثم صفر
+ *
+ * البايتكود والأسطر والنصوص تُستعمل من الصورة مباشرة دون نسخ. فتحات العامة
+ * تُحل من جديد بالأسماء عند التحميل، فيصح تشغيل الملف في جهاز عُرفت فيه
+ * أسماء أخرى قبله. */
+#define SKP_BYTECODE_MAGIC "SKPB"
+
+/* يُزاد عند أي تغيير في الصيغة أو في معاني أكواد العمليات ومعاملاتها */
+#define SKP_BYTECODE_VERSION 6
+
+/* هل يبدأ الملف بتوقيع البايتكود؟ */
+int bytecode_is_file(const char* path);
+
+/* الحفظ والتحميل. globals جدول أسماء العامة الذي تُرجمت الكتلة به،
+ * أو الذي ستعمل فيه عند التحميل. الصورة المحملة تبقى مخططة حتى نهاية
+ * العملية، إذ قد تبقى نصوصها المحتجزة حية بعد تحرير الكتلة */
+int bytecode_write(chunk_t* chunk, skp_object_t* globals, const char* path);
+chunk_t* bytecode_load(const char* path, skp_object_t* globals);
+
+/* ذاكرة الترجمة: نسخة مترجمة من كل ملف مصدر في __skpcache__ بجانبه، أو في
+ * المجلد SEEKEP_CACHE_DIR إن عُين. المفتاح تجزئة المصدر مع إصدار المفسر
+ * وصيغة البايتكود ومستوى التحسين، فأي تغيير في أحدها يعيد الترجمة. الكتابة بملف مؤقت ثم
+ * إعادة تسمية، فيصح أن يكتب أكثر من مفسر في الوقت نفسه */
+uint64_t bytecode_source_key(const char* source, size_t length, int optimize);
+chunk_t* bytecode_cache_load(const char* script, int optimize, uint64_t source_key,
+                             skp_object_t* globals);
+void bytecode_cache_store(const char* script, int optimize, uint64_t source_key,
+                          chunk_t* chunk, skp_object_t* globals);
+
+#endif /* BYTECODE_H */
@@ -20,19 +20,27 @@ void chunk_init(chunk_t* chunk) {
     chunk->constants = NULL;
     chunk->constant_count = 0;
     chunk->constant_capacity = 0;
+    chunk->caches = NULL;
+    chunk->cache_count = 0;
+    chunk->cache_capacity = 0;
+    chunk->borrowed = 0;
 }
 
 void chunk_free(chunk_t* chunk) {
-    free(chunk->code);
-    free(chunk->lines);
+    if (!chunk->borrowed) {
+        free(chunk->code);
+        free(chunk->lines);
+    }
     
     for (size_t i = 0; i < chunk->constant_count; i++) {
-        if (chunk->constants[i].type == SKP_TYPE_STRING && 
-            chunk->constants[i].value.string_val) {
-            free(chunk->constants[i].value.string_val);
+        if (chunk->constants[i].type == SKP_TYPE_STRING) {
+            skp_decref(chunk->constants[i].value.string_val);
+        } else if (chunk->constants[i].type == SKP_TYPE_FUNC) {
+            skp_decref(chunk->constants[i].value.func_val);
         }
     }
     free(chunk->constants);
+    free(chunk->caches);
     
     chunk_init(chunk);
 }
@@ -52,7 +60,7 @@ void chunk_write(chunk_t* chunk, uint8_t byte, int line) {
 int chunk_add_constant(chunk_t* chunk, constant_t constant) {
     if (chunk->constant_count >= chunk->constant_capacity) {
         chunk->constant_capacity = chunk->constant_capacity == 0 ? 8 : chunk->constant_capacity * 2;
-        chunk->constants = (constant_t*)realloc(chunk->constants, 
+        chunk->constants = (constant_t*)realloc(chunk->constants,
                                                   chunk->constant_capacity * sizeof(constant_t));
     }
     
@@ -60,6 +68,18 @@ int chunk_add_constant(chunk_t* chunk, constant_t constant) {
     return chunk->constant_count++;
 }
 
+/* ذاكرة مخبئية فارغة لتعليمة وصول إلى خاصية */
+int chunk_add_cache(chunk_t* chunk) {
+    if (chunk->cache_count >= chunk->cache_capacity) {
+        chunk->cache_capacity = chunk->cache_capacity == 0 ? 8 : chunk->cache_capacity * 2;
+        chunk->caches = (inline_cache_t*)realloc(chunk->caches,
+                                                 chunk->cache_capacity * sizeof(inline_cache_t));
+    }
+    
+    memset(&chunk->caches[chunk->cache_count], 0, sizeof(inline_cache_t));
+    return chunk->cache_count++;
+}
+
 /* ========== إنشاء وإتلاف المترجم ========== */
 
 static compiler_t* create_compiler(compiler_t* enclosing, function_type_t type, const char* name) {
@@ -73,12 +93,15 @@ static compiler_t* create_compiler(compiler_t* enclosing, function_type_t type,
     compiler->scope_depth = 0;
     compiler->upvalue_count = 0;
     compiler->function_arity = 0;
+    compiler->loop = NULL;
+    compiler->last_get_local = -1;
     
     chunk_init(&compiler->chunk);
     
-    /* المتغير المحلي الأول هو دائماً 'هذا' في الأساليب */
+    /* الفتحة الأولى محجوزة للدالة نفسها، وتسمى 'هذا' في الأساليب */
     if (type != TYPE_SCRIPT) {
-        compiler->locals[0].name = strdup("هذا");
+        int is_method = type == TYPE_METHOD || type == TYPE_INITIALIZER;
+        compiler->locals[0].name = strdup(is_method ? "هذا" : "");
         compiler->locals[0].depth = 0;
         compiler->locals[0].is_captured = 0;
         compiler->local_count = 1;
@@ -99,22 +122,43 @@ static void destroy_compiler(compiler_t* compiler) {
     free(compiler);
 }
 
-skp_compiler_t* compiler_create(parser_t* parser) {
+skp_compiler_t* compiler_create(parser_t* parser, skp_object_t* globals) {
     skp_compiler_t* compiler = (skp_compiler_t*)malloc(sizeof(skp_compiler_t));
     if (!compiler) return NULL;
     
     compiler->parser = parser;
     compiler->ast = NULL;
+    
+    /* جدول الأسماء مشترك مع الجهاز حتى تطابق الفتحات قيمه */
+    if (globals) {
+        skp_incref(globals);
+        compiler->globals = globals;
+    } else {
+        compiler->globals = skp_new_dict();
+    }
+    compiler->declared = skp_new_dict();
+    compiler->bound = NULL;
+    compiler->bound_count = 0;
+    compiler->line = 0;
     compiler->had_error = 0;
     compiler->current = create_compiler(NULL, TYPE_SCRIPT, NULL);
     
     return compiler;
 }
 
+/* العامة المعرفة قبل الترجمة (الدوال المدمجة، وما عرّفه سطر سابق في
+ * التفاعلي) لا تعود غير معرفة، فيصح دمج استدعائها */
+void compiler_bind_globals(skp_compiler_t* compiler, const skp_value_t* values, size_t count) {
+    compiler->bound = values;
+    compiler->bound_count = count;
+}
+
 void compiler_destroy(skp_compiler_t* compiler) {
     if (!compiler) return;
     
     destroy_compiler(compiler->current);
+    skp_decref(compiler->globals);
+    skp_decref(compiler->declared);
     free(compiler);
 }
 
@@ -122,6 +166,7 @@ chunk_t* compiler_compile(skp_compiler_t* compiler, ast_node_t* ast) {
     if (!compiler || !ast) return NULL;
     
     compiler->ast = ast;
+    compiler->line = ast->line;
     compile_node(compiler, ast);
     
     /* إضافة إيقاف في النهاية */
@@ -136,9 +181,7 @@ chunk_t* compiler_compile(skp_compiler_t* compiler, ast_node_t* ast) {
     if (result) {
         *result = compiler->current->chunk;
         /* إعادة تعيين الكتلة الأصلية حتى لا يتم تحريرها */
-        compiler->current->chunk.code = NULL;
-        compiler->current->chunk.lines = NULL;
-        compiler->current->chunk.constants = NULL;
+        chunk_init(&compiler->current->chunk);
     }
     
     return result;
@@ -147,8 +190,7 @@ chunk_t* compiler_compile(skp_compiler_t* compiler, ast_node_t* ast) {
 /* ========== كتابة أكواد العمليات ========== */
 
 void emit_byte(skp_compiler_t* compiler, uint8_t byte) {
-    chunk_write(&compiler->current->chunk, byte, 
-                compiler->ast ? compiler->ast->line : 0);
+    chunk_write(&compiler->current->chunk, byte, compiler->line);
 }
 
 void emit_bytes(skp_compiler_t* compiler, uint8_t byte1, uint8_t byte2) {
@@ -160,23 +202,49 @@ void emit_opcode(skp_compiler_t* compiler, opcode_t op) {
     emit_byte(compiler, (uint8_t)op);
 }
 
-void emit_constant(skp_compiler_t* compiler, constant_t constant) {
-    int index = chunk_add_constant(&compiler->current->chunk, constant);
+static uint8_t make_constant(skp_compiler_t* compiler, constant_t constant) {
+    chunk_t* chunk = &compiler->current->chunk;
+    
+    /* النصوص محتجزة، فالنص المكرر يعيد استعمال ثابته */
+    if (constant.type == SKP_TYPE_STRING) {
+        for (size_t i = 0; i < chunk->constant_count; i++) {
+            if (chunk->constants[i].type == SKP_TYPE_STRING &&
+                chunk->constants[i].value.string_val == constant.value.string_val) {
+                skp_decref(constant.value.string_val);
+                return (uint8_t)i;
+            }
+        }
+    }
+    
+    int index = chunk_add_constant(chunk, constant);
     
     if (index > 255) {
         fprintf(stderr, "خطأ: عدد كبير جداً من الثوابت\n");
         compiler->had_error = 1;
-        return;
+        return 0;
     }
     
-    emit_bytes(compiler, OP_CONST_INT, (uint8_t)index);
+    return (uint8_t)index;
 }
 
-void emit_jump(skp_compiler_t* compiler, opcode_t op, int offset) {
+void emit_constant(skp_compiler_t* compiler, constant_t constant) {
+    opcode_t op;
+    switch (constant.type) {
+        case SKP_TYPE_FLOAT:  op = OP_CONST_FLOAT; break;
+        case SKP_TYPE_STRING: op = OP_CONST_STRING; break;
+        default:              op = OP_CONST_INT; break;
+    }
+    
+    emit_bytes(compiler, op, make_constant(compiler, constant));
+}
+
+/* يُرجع موضع الإزاحة لترقيعها لاحقاً */
+int emit_jump(skp_compiler_t* compiler, opcode_t op) {
     emit_opcode(compiler, op);
     /* نترك مكاناً للإزاحة (2 بايت) */
     emit_byte(compiler, 0xFF);
     emit_byte(compiler, 0xFF);
+    return (int)compiler->current->chunk.count - 2;
 }
 
 void patch_jump(skp_compiler_t* compiler, int offset) {
@@ -190,6 +258,15 @@ void patch_jump(skp_compiler_t* compiler, int offset) {
     
     compiler->current->chunk.code[offset] = (jump >> 8) & 0xFF;
     compiler->current->chunk.code[offset + 1] = jump & 0xFF;
+    
+    /* الموضع الحالي صار هدف قفزة */
+    compiler->current->last_get_local = -1;
+}
+
+/* موضع يُقفز إليه لاحقاً: لا تُدمج التعليمة قبله مع التي بعده */
+static int mark_label(skp_compiler_t* compiler) {
+    compiler->current->last_get_local = -1;
+    return (int)compiler->current->chunk.count;
 }
 
 void emit_loop(skp_compiler_t* compiler, int loop_start) {
@@ -217,7 +294,7 @@ void end_scope(skp_compiler_t* compiler) {
     
     /* إزالة المتغيرات المحلية التي خرجت من النطاق */
     while (compiler->current->local_count > 0 &&
-           compiler->current->locals[compiler->current->local_count - 1].depth > 
+           compiler->current->locals[compiler->current->local_count - 1].depth >
            compiler->current->scope_depth) {
         
         if (compiler->current->locals[compiler->current->local_count - 1].is_captured) {
@@ -226,28 +303,29 @@ void end_scope(skp_compiler_t* compiler) {
             emit_opcode(compiler, OP_POP);
         }
         
+        free(compiler->current->locals[compiler->current->local_count - 1].name);
         compiler->current->local_count--;
     }
 }
 
 /* ========== المتغيرات ========== */
 
-int resolve_local(skp_compiler_t* compiler, const char* name) {
-    for (int i = compiler->current->local_count - 1; i >= 0; i--) {
-        if (strcmp(compiler->current->locals[i].name, name) == 0) {
+int resolve_local(compiler_t* compiler, const char* name) {
+    for (int i = compiler->local_count - 1; i >= 0; i--) {
+        if (strcmp(compiler->locals[i].name, name) == 0) {
             return i;
         }
     }
     return -1;
 }
 
-int add_upvalue(skp_compiler_t* compiler, uint8_t index, int is_local) {
-    int upvalue_count = compiler->current->upvalue_count;
+int add_upvalue(compiler_t* compiler, uint8_t index, int is_local) {
+    int upvalue_count = compiler->upvalue_count;
     
     /* التحقق من وجود upvalue مسبقاً */
     for (int i = 0; i < upvalue_count; i++) {
-        if (compiler->current->upvalues[i].index == index &&
-            compiler->current->upvalues[i].is_local == is_local) {
+        if (compiler->upvalues[i].index == index &&
+            compiler->upvalues[i].is_local == is_local) {
             return i;
         }
     }
@@ -257,21 +335,21 @@ int add_upvalue(skp_compiler_t* compiler, uint8_t index, int is_local) {
         return 0;
     }
     
-    compiler->current->upvalues[upvalue_count].index = index;
-    compiler->current->upvalues[upvalue_count].is_local = is_local;
-    return compiler->current->upvalue_count++;
+    compiler->upvalues[upvalue_count].index = index;
+    compiler->upvalues[upvalue_count].is_local = is_local;
+    return compiler->upvalue_count++;
 }
 
-int resolve_upvalue(skp_compiler_t* compiler, const char* name) {
-    if (compiler->current->enclosing == NULL) return -1;
+int resolve_upvalue(compiler_t* compiler, const char* name) {
+    if (compiler->enclosing == NULL) return -1;
     
-    int local = resolve_local(compiler->current->enclosing, name);
+    int local = resolve_local(compiler->enclosing, name);
     if (local != -1) {
-        compiler->current->enclosing->locals[local].is_captured = 1;
+        compiler->enclosing->locals[local].is_captured = 1;
         return add_upvalue(compiler, (uint8_t)local, 1);
     }
     
-    int upvalue = resolve_upvalue(compiler->current->enclosing, name);
+    int upvalue = resolve_upvalue(compiler->enclosing, name);
     if (upvalue != -1) {
         return add_upvalue(compiler, (uint8_t)upvalue, 0);
     }
@@ -303,7 +381,8 @@ void declare_variable(skp_compiler_t* compiler, const char* name) {
         }
         
         if (strcmp(compiler->current->locals[i].name, name) == 0) {
-            fprintf(stderr, "خطأ: متغير '%s' معرف مسبقاً في هذا النطاق\n", name);
+            fprintf(stderr, "خطأ في السطر %d: متغير '%s' معرف مسبقاً في هذا النطاق\n",
+                    compiler->line, name);
             compiler->had_error = 1;
             return;
         }
@@ -315,19 +394,82 @@ void declare_variable(skp_compiler_t* compiler, const char* name) {
 uint8_t identifier_constant(skp_compiler_t* compiler, const char* name) {
     constant_t constant;
     constant.type = SKP_TYPE_STRING;
-    constant.value.string_val = strdup(name);
-    return (uint8_t)chunk_add_constant(&compiler->current->chunk, constant);
+    constant.value.string_val = skp_intern(name, strlen(name));
+    return make_constant(compiler, constant);
+}
+
+/* فتحة المتغير العام بالاسم، تُضاف إلى الجدول عند أول ظهور */
+int resolve_global(skp_object_t* globals, const char* name) {
+    skp_value_t slot;
+    if (skp_dict_get(globals, name, &slot)) {
+        return (int)SKP_AS_INT(slot);
+    }
+    
+    size_t count = skp_dict_len(globals);
+    if (count > UINT16_MAX) return -1;
+    
+    skp_dict_set(globals, name, SKP_INT_VAL(count));
+    return (int)count;
+}
+
+static uint16_t global_slot(skp_compiler_t* compiler, const char* name) {
+    int slot = resolve_global(compiler->globals, name);
+    if (slot < 0) {
+        fprintf(stderr, "خطأ: عدد كبير جداً من المتغيرات العامة\n");
+        compiler->had_error = 1;
+        return 0;
+    }
+    return (uint16_t)slot;
+}
+
+static void emit_global(skp_compiler_t* compiler, opcode_t op, uint16_t slot) {
+    emit_opcode(compiler, op);
+    emit_byte(compiler, (slot >> 8) & 0xFF);
+    emit_byte(compiler, slot & 0xFF);
+}
+
+/* رقم ذاكرة مخبئية جديدة (16 بت) */
+static void emit_cache(skp_compiler_t* compiler) {
+    int cache = chunk_add_cache(&compiler->current->chunk);
+    if (cache > UINT16_MAX) {
+        fprintf(stderr, "خطأ: عدد كبير جداً من الوصول إلى الخصائص في دالة واحدة\n");
+        compiler->had_error = 1;
+        cache = 0;
+    }
+    emit_byte(compiler, (cache >> 8) & 0xFF);
+    emit_byte(compiler, cache & 0xFF);
+}
+
+static void emit_field(skp_compiler_t* compiler, opcode_t op, const char* name) {
+    emit_bytes(compiler, op, identifier_constant(compiler, name));
+    emit_cache(compiler);
 }
 
-void define_variable(skp_compiler_t* compiler, uint8_t global) {
+void define_variable(skp_compiler_t* compiler, uint16_t global) {
     if (compiler->current->scope_depth > 0) {
         /* متغير محلي */
-        compiler->current->locals[compiler->current->local_count - 1].depth = 
+        compiler->current->locals[compiler->current->local_count - 1].depth =
             compiler->current->scope_depth;
         return;
     }
     
-    emit_bytes(compiler, OP_DEFINE_GLOBAL, global);
+    emit_global(compiler, OP_DEFINE_GLOBAL, global);
+}
+
+/* قراءة متغير محلي؛ تُدمج مع قراءة محلي قبلها مباشرة في تعليمة واحدة */
+static void emit_get_local(skp_compiler_t* compiler, uint8_t slot) {
+    chunk_t* chunk = &compiler->current->chunk;
+    int last = compiler->current->last_get_local;
+    
+    if (last >= 0 && (size_t)last + 2 == chunk->count && chunk->code[last] == OP_GET_LOCAL) {
+        chunk->code[last] = OP_GET_LOCAL_GET_LOCAL;
+        emit_byte(compiler, slot);
+        compiler->current->last_get_local = -1;
+        return;
+    }
+    
+    emit_bytes(compiler, OP_GET_LOCAL, slot);
+    compiler->current->last_get_local = (int)chunk->count - 2;
 }
 
 void named_variable(skp_compiler_t* compiler, const char* name, int can_assign) {
@@ -337,17 +479,19 @@ void named_variable(skp_compiler_t* compiler, const char* name, int can_assign)
     if (arg != -1) {
         get_op = OP_GET_LOCAL;
         set_op = OP_SET_LOCAL;
-    } else if ((arg = resolve_upvalue(compiler, name)) != -1) {
+    } else if ((arg = resolve_upvalue(compiler->current, name)) != -1) {
         get_op = OP_GET_UPVALUE;
         set_op = OP_SET_UPVALUE;
     } else {
-        arg = identifier_constant(compiler, name);
-        get_op = OP_GET_GLOBAL;
-        set_op = OP_SET_GLOBAL;
+        uint16_t slot = global_slot(compiler, name);
+        emit_global(compiler, can_assign ? OP_SET_GLOBAL : OP_GET_GLOBAL, slot);
+        return;
     }
     
     if (can_assign) {
         emit_bytes(compiler, set_op, (uint8_t)arg);
+    } else if (get_op == OP_GET_LOCAL) {
+        emit_get_local(compiler, (uint8_t)arg);
     } else {
         emit_bytes(compiler, get_op, (uint8_t)arg);
     }
@@ -358,6 +502,8 @@ void named_variable(skp_compiler_t* compiler, const char* name, int can_assign)
 void compile_node(skp_compiler_t* compiler, ast_node_t* node) {
     if (!node) return;
     
+    compiler->line = node->line;
+    
     switch (node->type) {
         /* التعبيرات */
         case AST_NUMBER:
@@ -377,7 +523,7 @@ void compile_node(skp_compiler_t* compiler, ast_node_t* node) {
         case AST_TERNARY:
             compile_expression(compiler, node);
             break;
-            
+        
         /* التصريحات */
         case AST_VAR_DECL:
         case AST_CONST_DECL:
@@ -387,7 +533,7 @@ void compile_node(skp_compiler_t* compiler, ast_node_t* node) {
         case AST_EXPORT:
             compile_declaration(compiler, node);
             break;
-            
+        
         /* عبارات التحكم */
         case AST_IF:
         case AST_WHILE:
@@ -400,11 +546,11 @@ void compile_node(skp_compiler_t* compiler, ast_node_t* node) {
         case AST_EXPRESSION_STMT:
             compile_statement(compiler, node);
             break;
-            
+        
         case AST_PROGRAM:
             compile_program(compiler, node);
             break;
-            
+        
         default:
             fprintf(stderr, "خطأ: نوع عقدة غير معروف\n");
             compiler->had_error = 1;
@@ -414,87 +560,92 @@ void compile_node(skp_compiler_t* compiler, ast_node_t* node) {
 
 /* ========== ترجمة التعبيرات ========== */
 
+/* ثابت العدد الحرفي: عشري إذا كتب بفاصلة أو أس، وإلا صحيح */
+constant_t number_constant(ast_node_t* node) {
+    constant_t constant;
+    if (strchr(node->data.number.value, '.') ||
+        strchr(node->data.number.value, 'e') ||
+        strchr(node->data.number.value, 'E')) {
+        constant.type = SKP_TYPE_FLOAT;
+        constant.value.float_val = strtod(node->data.number.value, NULL);
+    } else {
+        constant.type = SKP_TYPE_INT;
+        constant.value.int_val = strtoll(node->data.number.value, NULL, 10);
+    }
+    return constant;
+}
+
 void compile_expression(skp_compiler_t* compiler, ast_node_t* node) {
     if (!node) return;
     
+    compiler->line = node->line;
+    
     switch (node->type) {
-        case AST_NUMBER: {
-            constant_t constant;
-            /* التحقق إذا كان عدد صحيح أو عشري */
-            if (strchr(node->data.number.value, '.') || 
-                strchr(node->data.number.value, 'e') ||
-                strchr(node->data.number.value, 'E')) {
-                constant.type = SKP_TYPE_FLOAT;
-                constant.value.float_val = strtod(node->data.number.value, NULL);
-                emit_constant(compiler, constant);
-            } else {
-                constant.type = SKP_TYPE_INT;
-                constant.value.int_val = strtoll(node->data.number.value, NULL, 10);
-                emit_constant(compiler, constant);
-            }
+        case AST_NUMBER:
+            emit_constant(compiler, number_constant(node));
             break;
-        }
-            
+        
         case AST_STRING: {
             constant_t constant;
             constant.type = SKP_TYPE_STRING;
-            constant.value.string_val = strdup(node->data.string.value);
+            constant.value.string_val = skp_intern(node->data.string.value,
+                                                   strlen(node->data.string.value));
             emit_constant(compiler, constant);
             break;
         }
-            
+        
         case AST_BOOLEAN:
             emit_opcode(compiler, node->data.boolean.value ? OP_CONST_TRUE : OP_CONST_FALSE);
             break;
-            
+        
         case AST_NULL:
             emit_opcode(compiler, OP_CONST_NULL);
             break;
-            
+        
         case AST_IDENTIFIER:
-            named_variable(compiler, node->data.identifier.name, 1);
+            named_variable(compiler, node->data.identifier.name, 0);
             break;
-            
+        
         case AST_BINARY_OP:
             compile_binary(compiler, node);
             break;
-            
+        
         case AST_UNARY_OP:
             compile_unary(compiler, node);
             break;
-            
+        
         case AST_ASSIGNMENT:
             compile_assignment(compiler, node);
             break;
-            
+        
         case AST_CALL:
             compile_call(compiler, node);
             break;
-            
+        
         case AST_MEMBER_ACCESS:
             compile_member_access(compiler, node);
             break;
-            
+        
         case AST_INDEX_ACCESS:
             compile_index_access(compiler, node);
             break;
-            
+        
         case AST_LIST_LITERAL:
             compile_list_literal(compiler, node);
             break;
-            
+        
         case AST_DICT_LITERAL:
             compile_dict_literal(compiler, node);
             break;
-            
+        
         case AST_LAMBDA:
             compile_lambda(compiler, node);
             break;
-            
+        
         case AST_TERNARY:
             compile_ternary(compiler, node);
             break;
-            
+        
         default:
             fprintf(stderr, "خطأ: تعبير غير معروف\n");
             compiler->had_error = 1;
@@ -503,6 +654,21 @@ void compile_expression(skp_compiler_t* compiler, ast_node_t* node) {
 }
 
 void compile_binary(skp_compiler_t* compiler, ast_node_t* node) {
+    ast_node_t* left = node->data.binary_op.left;
+    ast_node_t* right = node->data.binary_op.right;
+    
+    /* متغير محلي + عدد ثابت، كعداد الحلقة */
+    if (node->data.binary_op.op == BINOP_ADD && left->type == AST_IDENTIFIER &&
+        right->type == AST_NUMBER) {
+        int slot = resolve_local(compiler->current, left->data.identifier.name);
+        if (slot != -1) {
+            uint8_t constant = make_constant(compiler, number_constant(right));
+            emit_bytes(compiler, OP_GET_LOCAL_CONST_ADD, (uint8_t)slot);
+            emit_byte(compiler, constant);
+            return;
+        }
+    }
+    
     compile_expression(compiler, node->data.binary_op.left);
     compile_expression(compiler, node->data.binary_op.right);
     
@@ -534,22 +700,28 @@ void compile_binary(skp_compiler_t* compiler, ast_node_t* node) {
 }
 
 void compile_unary(skp_compiler_t* compiler, ast_node_t* node) {
+    unop_type_t op = node->data.unary_op.op;
+    
+    if (op == UNOP_INC || op == UNOP_DEC) {
+        /* ++x => x = x + 1 ، --x => x = x - 1 */
+        ast_arena_t* arena = &compiler->parser->arena;
+        ast_node_t* target = node->data.unary_op.operand;
+        ast_node_t* one = ast_create_number(arena, "1", node->line, node->column);
+        ast_node_t* step = ast_create_binary_op(arena, op == UNOP_INC ? BINOP_ADD : BINOP_SUB,
+                                                target, one, node->line, node->column);
+        ast_node_t* assign = ast_create_assignment(arena, target, step, node->line, node->column);
+        
+        /* العقد المؤقتة في ساحة المحلل وتُحرر معها */
+        compile_assignment(compiler, assign);
+        return;
+    }
+    
     compile_expression(compiler, node->data.unary_op.operand);
     
-    switch (node->data.unary_op.op) {
+    switch (op) {
         case UNOP_NEG: emit_opcode(compiler, OP_NEG); break;
         case UNOP_NOT: emit_opcode(compiler, OP_NOT); break;
         case UNOP_BIT_NOT: emit_opcode(compiler, OP_BIT_NOT); break;
-        case UNOP_INC:
-            /* ++x => x = x + 1 */
-            emit_byte(compiler, 1);
-            emit_opcode(compiler, OP_ADD);
-            break;
-        case UNOP_DEC:
-            /* --x => x = x - 1 */
-            emit_byte(compiler, 1);
-            emit_opcode(compiler, OP_SUB);
-            break;
         default:
             fprintf(stderr, "خطأ: عملية أحادية غير معروفة\n");
             compiler->had_error = 1;
@@ -558,45 +730,152 @@ void compile_unary(skp_compiler_t* compiler, ast_node_t* node) {
 }
 
 void compile_assignment(skp_compiler_t* compiler, ast_node_t* node) {
-    /* تجميع القيمة أولاً */
-    compile_expression(compiler, node->data.assignment.value);
-    
-    /* ثم تعيينها للهدف */
     ast_node_t* target = node->data.assignment.target;
     
     if (target->type == AST_IDENTIFIER) {
+        compile_expression(compiler, node->data.assignment.value);
         named_variable(compiler, target->data.identifier.name, 1);
     } else if (target->type == AST_MEMBER_ACCESS) {
+        /* المكدس: [كائن، قيمة] */
         compile_expression(compiler, target->data.member_access.object);
-        uint8_t name = identifier_constant(compiler, target->data.member_access.member);
-        emit_bytes(compiler, OP_SET_FIELD, name);
+        compile_expression(compiler, node->data.assignment.value);
+        emit_field(compiler, OP_SET_FIELD, target->data.member_access.member);
     } else if (target->type == AST_INDEX_ACCESS) {
+        /* المكدس: [كائن، فهرس، قيمة] */
         compile_expression(compiler, target->data.index_access.object);
         compile_expression(compiler, target->data.index_access.index);
+        compile_expression(compiler, node->data.assignment.value);
         emit_opcode(compiler, OP_SET_INDEX);
     } else {
-        fprintf(stderr, "خطأ: هدف تعيين غير صالح\n");
+        fprintf(stderr, "خطأ في السطر %d: هدف تعيين غير صالح\n", node->line);
         compiler->had_error = 1;
     }
 }
 
+/* هل يُحل الاسم إلى متغير عام لا محلي ولا upvalue؟ */
+static int is_global_name(skp_compiler_t* compiler, const char* name) {
+    return resolve_local(compiler->current, name) == -1 &&
+           resolve_upvalue(compiler->current, name) == -1;
+}
+
+/* تعبير لا يستدعي دالة ولا يكتب متغيراً */
+static int is_pure(ast_node_t* node) {
+    switch (node->type) {
+        case AST_NUMBER:
+        case AST_STRING:
+        case AST_BOOLEAN:
+        case AST_NULL:
+        case AST_IDENTIFIER:
+            return 1;
+        case AST_BINARY_OP:
+            return is_pure(node->data.binary_op.left) && is_pure(node->data.binary_op.right);
+        case AST_UNARY_OP:
+            return node->data.unary_op.op != UNOP_INC && node->data.unary_op.op != UNOP_DEC &&
+                   is_pure(node->data.unary_op.operand);
+        default:
+            return 0;
+    }
+}
+
+static int pure_arguments(ast_node_t* node) {
+    for (size_t i = 0; i < node->data.call.arg_count; i++) {
+        if (!is_pure(node->data.call.args[i])) return 0;
+    }
+    return 1;
+}
+
+/* معاملات لا تفشل: ثوابت ومتغيرات محلية، فلا خطأ يسبق قراءة الدالة */
+static int safe_arguments(skp_compiler_t* compiler, ast_node_t* node) {
+    for (size_t i = 0; i < node->data.call.arg_count; i++) {
+        ast_node_t* arg = node->data.call.args[i];
+        switch (arg->type) {
+            case AST_NUMBER:
+            case AST_STRING:
+            case AST_BOOLEAN:
+            case AST_NULL:
+                break;
+            case AST_IDENTIFIER:
+                if (is_global_name(compiler, arg->data.identifier.name)) return 0;
+                break;
+            default:
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/* العامة معرفة حتماً متى نُفذ موضع الترجمة: معرفة قبل الترجمة، أو أعلنها
+ * البرنامج في مستواه الأعلى قبل هذا الموضع. الدالة المعلنة قبله لا تُستدعى
+ * إلا بعد تنفيذ إعلانها، وإعلانات المستوى الأعلى تُنفذ بترتيبها */
+static int is_bound_global(skp_compiler_t* compiler, const char* name) {
+    skp_value_t slot;
+    if (skp_dict_get(compiler->declared, name, &slot)) return 1;
+    if (!skp_dict_get(compiler->globals, name, &slot)) return 0;
+    
+    size_t index = (size_t)SKP_AS_INT(slot);
+    return index < compiler->bound_count && compiler->bound[index].type != SKP_TYPE_UNDEFINED;
+}
+
+static void declare_global(skp_compiler_t* compiler, const char* name) {
+    if (compiler->current->type == TYPE_SCRIPT && compiler->current->scope_depth == 0) {
+        skp_dict_set(compiler->declared, name, SKP_BOOL_VAL(SKP_TRUE));
+    }
+}
+
 void compile_call(skp_compiler_t* compiler, ast_node_t* node) {
-    /* تجميع المعاملات أولاً */
+    if (node->data.call.arg_count > 255) {
+        fprintf(stderr, "خطأ في السطر %d: عدد كبير جداً من المعاملات\n", node->line);
+        compiler->had_error = 1;
+        return;
+    }
+    
+    /* كائن.طريقة(...) يُستدعى مباشرة دون إنشاء طريقة مربوطة */
+    ast_node_t* callee = node->data.call.callee;
+    if (callee->type == AST_MEMBER_ACCESS) {
+        compile_expression(compiler, callee->data.member_access.object);
+        
+        for (size_t i = 0; i < node->data.call.arg_count; i++) {
+            compile_expression(compiler, node->data.call.args[i]);
+        }
+        
+        uint8_t name = identifier_constant(compiler, callee->data.member_access.member);
+        emit_bytes(compiler, OP_INVOKE, name);
+        emit_byte(compiler, (uint8_t)node->data.call.arg_count);
+        emit_cache(compiler);
+        return;
+    }
+    
+    /* دالة عامة: المعاملات أولاً ثم تعليمة واحدة تقرأ الدالة وتضعها تحتها.
+     * يصح ما دامت المعاملات لا تغير المتغيرات، فقراءة الدالة بعدها كقراءتها
+     * قبلها، وما دام خطأ الدالة غير المعرفة لا يسبقه خطأ في معاملاتها */
+    if (callee->type == AST_IDENTIFIER && is_global_name(compiler, callee->data.identifier.name) &&
+        pure_arguments(node) &&
+        (is_bound_global(compiler, callee->data.identifier.name) ||
+         safe_arguments(compiler, node))) {
+        for (size_t i = 0; i < node->data.call.arg_count; i++) {
+            compile_expression(compiler, node->data.call.args[i]);
+        }
+        
+        compiler->line = node->line;
+        emit_global(compiler, OP_CALL_GLOBAL, global_slot(compiler, callee->data.identifier.name));
+        emit_byte(compiler, (uint8_t)node->data.call.arg_count);
+        return;
+    }
+    
+    /* الدالة أولاً ثم المعاملات فوقها */
+    compile_expression(compiler, callee);
+    
     for (size_t i = 0; i < node->data.call.arg_count; i++) {
         compile_expression(compiler, node->data.call.args[i]);
     }
     
-    /* ثم تجميع الدالة */
-    compile_expression(compiler, node->data.call.callee);
-    
     /* استدعاء الدالة */
     emit_bytes(compiler, OP_CALL, (uint8_t)node->data.call.arg_count);
 }
 
 void compile_member_access(skp_compiler_t* compiler, ast_node_t* node) {
     compile_expression(compiler, node->data.member_access.object);
-    uint8_t name = identifier_constant(compiler, node->data.member_access.member);
-    emit_bytes(compiler, OP_GET_FIELD, name);
+    emit_field(compiler, OP_GET_FIELD, node->data.member_access.member);
 }
 
 void compile_index_access(skp_compiler_t* compiler, ast_node_t* node) {
@@ -626,41 +905,77 @@ void compile_dict_literal(skp_compiler_t* compiler, ast_node_t* node) {
     emit_bytes(compiler, OP_CONST_DICT, (uint8_t)node->data.dict_literal.entry_count);
 }
 
-void compile_lambda(skp_compiler_t* compiler, ast_node_t* node) {
-    /* إنشاء مترجم فرعي للدالة */
+/* تجميع جسم دالة في مترجم فرعي ثم إصدار OP_CLOSURE في السياق الحالي */
+static void compile_function(skp_compiler_t* compiler, function_type_t type, const char* name,
+                             char** params, size_t param_count, ast_node_t** defaults,
+                             ast_node_t* body) {
     compiler_t* enclosing = compiler->current;
-    compiler->current = create_compiler(enclosing, TYPE_FUNCTION, "<lambda>");
-    compiler->current->function_arity = (int)node->data.lambda.param_count;
+    compiler->current = create_compiler(enclosing, type, name);
+    compiler->current->function_arity = (int)param_count;
+    
+    begin_scope(compiler);
     
     /* إضافة المعاملات كمتغيرات محلية */
-    for (size_t i = 0; i < node->data.lambda.param_count; i++) {
-        declare_variable(compiler, node->data.lambda.params[i]);
+    for (size_t i = 0; i < param_count; i++) {
+        declare_variable(compiler, params[i]);
         define_variable(compiler, 0);
     }
     
-    /* تجميع جسم الدالة */
-    compile_node(compiler, node->data.lambda.body);
+    /* القيم الافتراضية: المعامل الناقص يصل فارغاً */
+    for (size_t i = 0; defaults && i < param_count; i++) {
+        if (!defaults[i]) continue;
+        
+        uint8_t slot = (uint8_t)(i + 1);
+        emit_bytes(compiler, OP_GET_LOCAL, slot);
+        emit_opcode(compiler, OP_CONST_NULL);
+        emit_opcode(compiler, OP_EQ);
+        int skip = emit_jump(compiler, OP_JUMP_IF_FALSE);
+        emit_opcode(compiler, OP_POP);
+        compile_expression(compiler, defaults[i]);
+        emit_bytes(compiler, OP_SET_LOCAL, slot);
+        emit_opcode(compiler, OP_POP);
+        int done = emit_jump(compiler, OP_JUMP);
+        patch_jump(compiler, skip);
+        emit_opcode(compiler, OP_POP);
+        patch_jump(compiler, done);
+    }
     
-    /* إرجاع تلقائي */
-    emit_opcode(compiler, OP_RETURN_VOID);
+    /* تجميع الجسم مع إرجاع تلقائي */
+    if (body && body->type == AST_BLOCK) {
+        compile_node(compiler, body);
+        if (type == TYPE_INITIALIZER) {
+            emit_bytes(compiler, OP_GET_LOCAL, 0);
+            emit_opcode(compiler, OP_RETURN);
+        } else {
+            emit_opcode(compiler, OP_RETURN_VOID);
+        }
+    } else {
+        /* دالة تعبيرية: (س) => س * 3 */
+        compile_expression(compiler, body);
+        emit_opcode(compiler, OP_RETURN);
+    }
     
-    /* استعادة المترجم السابق */
+    /* نقل الكتلة إلى كائن الدالة */
+    compiler_t* function_compiler = compiler->current;
     chunk_t* function_chunk = (chunk_t*)malloc(sizeof(chunk_t));
-    *function_chunk = compiler->current->chunk;
-    compiler->current->chunk.code = NULL;
-    compiler->current->chunk.lines = NULL;
-    compiler->current->chunk.constants = NULL;
+    *function_chunk = function_compiler->chunk;
+    chunk_init(&function_compiler->chunk);
     
-    int upvalue_count = compiler->current->upvalue_count;
+    skp_object_t* function = skp_new_function(name, (int)param_count, function_chunk);
+    function->data.v_func.upvalue_count = function_compiler->upvalue_count;
+    
+    int upvalue_count = function_compiler->upvalue_count;
     upvalue_t upvalues[256];
-    memcpy(upvalues, compiler->current->upvalues, sizeof(upvalue_t) * upvalue_count);
+    memcpy(upvalues, function_compiler->upvalues, sizeof(upvalue_t) * upvalue_count);
     
-    destroy_compiler(compiler->current);
+    destroy_compiler(function_compiler);
     compiler->current = enclosing;
     
     /* إنشاء closure */
-    emit_opcode(compiler, OP_CLOSURE);
-    emit_byte(compiler, (uint8_t)upvalue_count);
+    constant_t constant;
+    constant.type = SKP_TYPE_FUNC;
+    constant.value.func_val = function;
+    emit_bytes(compiler, OP_CLOSURE, make_constant(compiler, constant));
     
     for (int i = 0; i < upvalue_count; i++) {
         emit_byte(compiler, upvalues[i].is_local ? 1 : 0);
@@ -668,18 +983,24 @@ void compile_lambda(skp_compiler_t* compiler, ast_node_t* node) {
     }
 }
 
+void compile_lambda(skp_compiler_t* compiler, ast_node_t* node) {
+    compile_function(compiler, TYPE_FUNCTION, "<lambda>",
+                     node->data.lambda.params, node->data.lambda.param_count,
+                     NULL, node->data.lambda.body);
+}
+
 void compile_ternary(skp_compiler_t* compiler, ast_node_t* node) {
     compile_expression(compiler, node->data.ternary.condition);
     
-    int else_jump = compiler->current->chunk.count;
-    emit_jump(compiler, OP_JUMP_IF_FALSE, 0);
+    int else_jump = emit_jump(compiler, OP_JUMP_IF_FALSE);
+    emit_opcode(compiler, OP_POP);
     
     compile_expression(compiler, node->data.ternary.true_expr);
     
-    int end_jump = compiler->current->chunk.count;
-    emit_jump(compiler, OP_JUMP, 0);
+    int end_jump = emit_jump(compiler, OP_JUMP);
     
     patch_jump(compiler, else_jump);
+    emit_opcode(compiler, OP_POP);
     
     compile_expression(compiler, node->data.ternary.false_expr);
     
@@ -724,51 +1045,27 @@ void compile_var_decl(skp_compiler_t* compiler, ast_node_t* node) {
     }
     
     /* تعريف المتغير */
-    define_variable(compiler, identifier_constant(compiler, node->data.var_decl.name));
+    uint16_t global = compiler->current->scope_depth > 0
+        ? 0 : global_slot(compiler, node->data.var_decl.name);
+    define_variable(compiler, global);
+    declare_global(compiler, node->data.var_decl.name);
 }
 
 void compile_func_decl(skp_compiler_t* compiler, ast_node_t* node) {
-    /* إنشاء مترجم فرعي */
-    compiler_t* enclosing = compiler->current;
-    compiler->current = create_compiler(enclosing, TYPE_FUNCTION, node->data.func_decl.name);
-    compiler->current->function_arity = (int)node->data.func_decl.param_count;
-    
-    begin_scope(compiler);
-    
-    /* إضافة المعاملات */
-    for (size_t i = 0; i < node->data.func_decl.param_count; i++) {
-        declare_variable(compiler, node->data.func_decl.params[i]);
+    /* الدالة المحلية مُعرَّفة قبل جسمها حتى تستدعي نفسها */
+    declare_variable(compiler, node->data.func_decl.name);
+    if (compiler->current->scope_depth > 0) {
         define_variable(compiler, 0);
     }
+    declare_global(compiler, node->data.func_decl.name);
     
-    /* تجميع الجسم */
-    compile_node(compiler, node->data.func_decl.body);
-    
-    /* إرجاع تلقائي */
-    emit_opcode(compiler, OP_RETURN_VOID);
+    compile_function(compiler, TYPE_FUNCTION, node->data.func_decl.name,
+                     node->data.func_decl.params, node->data.func_decl.param_count,
+                     node->data.func_decl.defaults, node->data.func_decl.body);
     
-    end_scope(compiler);
-    
-    /* استعادة المترجم السابق */
-    int upvalue_count = compiler->current->upvalue_count;
-    upvalue_t upvalues[256];
-    memcpy(upvalues, compiler->current->upvalues, sizeof(upvalue_t) * upvalue_count);
-    
-    destroy_compiler(compiler->current);
-    compiler->current = enclosing;
-    
-    /* تعريف الدالة */
-    uint8_t global = identifier_constant(compiler, node->data.func_decl.name);
-    
-    emit_opcode(compiler, OP_CLOSURE);
-    emit_byte(compiler, (uint8_t)upvalue_count);
-    
-    for (int i = 0; i < upvalue_count; i++) {
-        emit_byte(compiler, upvalues[i].is_local ? 1 : 0);
-        emit_byte(compiler, upvalues[i].index);
+    if (compiler->current->scope_depth == 0) {
+        define_variable(compiler, global_slot(compiler, node->data.func_decl.name));
     }
-    
-    define_variable(compiler, global);
 }
 
 void compile_class_decl(skp_compiler_t* compiler, ast_node_t* node) {
@@ -776,46 +1073,36 @@ void compile_class_decl(skp_compiler_t* compiler, ast_node_t* node) {
     declare_variable(compiler, node->data.class_decl.name);
     
     emit_bytes(compiler, OP_CLASS, name_constant);
-    define_variable(compiler, name_constant);
+    define_variable(compiler, compiler->current->scope_depth > 0
+                    ? 0 : global_slot(compiler, node->data.class_decl.name));
+    declare_global(compiler, node->data.class_decl.name);
     
     named_variable(compiler, node->data.class_decl.name, 0);
     
-    /* وراثة */
+    /* وراثة: المكدس [صنف، أب] ويزيل OP_INHERIT الأب */
     if (node->data.class_decl.parent) {
+        if (strcmp(node->data.class_decl.parent, node->data.class_decl.name) == 0) {
+            fprintf(stderr, "خطأ في السطر %d: لا يمكن للصنف أن يرث من نفسه\n", node->line);
+            compiler->had_error = 1;
+        }
         named_variable(compiler, node->data.class_decl.parent, 0);
         emit_opcode(compiler, OP_INHERIT);
     }
     
     /* تجميع الأعضاء */
     for (size_t i = 0; i < node->data.class_decl.member_count; i++) {
-        if (node->data.class_decl.members[i]->type == AST_FUNC_DECL) {
-            ast_node_t* method = node->data.class_decl.members[i];
-            uint8_t method_name = identifier_constant(compiler, method->data.func_decl.name);
-            
-            /* تجميع الدالة */
-            compiler_t* enclosing = compiler->current;
-            compiler->current = create_compiler(enclosing, TYPE_METHOD, method->data.func_decl.name);
-            compiler->current->function_arity = (int)method->data.func_decl.param_count;
-            
-            begin_scope(compiler);
-            
-            /* إضافة 'هذا' ومعاملات */
-            for (size_t j = 0; j < method->data.func_decl.param_count; j++) {
-                declare_variable(compiler, method->data.func_decl.params[j]);
-                define_variable(compiler, 0);
-            }
-            
-            compile_node(compiler, method->data.func_decl.body);
-            emit_opcode(compiler, OP_RETURN_VOID);
-            
-            end_scope(compiler);
-            
-            int upvalue_count = compiler->current->upvalue_count;
-            destroy_compiler(compiler->current);
-            compiler->current = enclosing;
-            
-            emit_bytes(compiler, OP_METHOD, method_name);
-        }
+        ast_node_t* method = node->data.class_decl.members[i];
+        if (!method || method->type != AST_FUNC_DECL) continue;
+        
+        compiler->line = method->line;
+        uint8_t method_name = identifier_constant(compiler, method->data.func_decl.name);
+        function_type_t type = strcmp(method->data.func_decl.name, "init") == 0
+            ? TYPE_INITIALIZER : TYPE_METHOD;
+        
+        compile_function(compiler, type, method->data.func_decl.name,
+                         method->data.func_decl.params, method->data.func_decl.param_count,
+                         method->data.func_decl.defaults, method->data.func_decl.body);
+        emit_bytes(compiler, OP_METHOD, method_name);
     }
     
     emit_opcode(compiler, OP_POP);
@@ -823,6 +1110,121 @@ void compile_class_decl(skp_compiler_t* compiler, ast_node_t* node) {
 
 /* ========== ترجمة العبارات ========== */
 
+/* إزالة المتغيرات المحلية الأعمق من الحلقة دون إغلاق النطاق (لتوقف واستمر) */
+static void discard_loop_locals(skp_compiler_t* compiler) {
+    compiler_t* current = compiler->current;
+    for (int i = current->local_count - 1;
+         i >= 0 && current->locals[i].depth > current->loop->scope_depth; i--) {
+        emit_opcode(compiler, current->locals[i].is_captured ? OP_CLOSE_UPVALUE : OP_POP);
+    }
+}
+
+static void begin_loop(skp_compiler_t* compiler, loop_t* loop, int start) {
+    loop->enclosing = compiler->current->loop;
+    loop->start = start;
+    loop->scope_depth = compiler->current->scope_depth;
+    loop->break_count = 0;
+    compiler->current->loop = loop;
+}
+
+static void end_loop(skp_compiler_t* compiler) {
+    loop_t* loop = compiler->current->loop;
+    for (int i = 0; i < loop->break_count; i++) {
+        patch_jump(compiler, loop->break_jumps[i]);
+    }
+    compiler->current->loop = loop->enclosing;
+}
+
+static void compile_break(skp_compiler_t* compiler, ast_node_t* node) {
+    loop_t* loop = compiler->current->loop;
+    if (!loop) {
+        fprintf(stderr, "خطأ في السطر %d: 'توقف' خارج حلقة\n", node->line);
+        compiler->had_error = 1;
+        return;
+    }
+    if (loop->break_count >= 256) {
+        fprintf(stderr, "خطأ في السطر %d: عدد كبير جداً من 'توقف' في الحلقة\n", node->line);
+        compiler->had_error = 1;
+        return;
+    }
+    
+    discard_loop_locals(compiler);
+    loop->break_jumps[loop->break_count++] = emit_jump(compiler, OP_JUMP);
+}
+
+static void compile_continue(skp_compiler_t* compiler, ast_node_t* node) {
+    if (!compiler->current->loop) {
+        fprintf(stderr, "خطأ في السطر %d: 'استمر' خارج حلقة\n", node->line);
+        compiler->had_error = 1;
+        return;
+    }
+    
+    discard_loop_locals(compiler);
+    emit_loop(compiler, compiler->current->loop->start);
+}
+
+/* المتغير المحلي في س = س + 1 أو ++س، وإلا -1 */
+static int incremented_local(skp_compiler_t* compiler, ast_node_t* node) {
+    ast_node_t* target;
+    
+    if (node->type == AST_UNARY_OP && node->data.unary_op.op == UNOP_INC) {
+        target = node->data.unary_op.operand;
+    } else if (node->type == AST_ASSIGNMENT) {
+        target = node->data.assignment.target;
+        ast_node_t* value = node->data.assignment.value;
+        if (target->type != AST_IDENTIFIER || value->type != AST_BINARY_OP ||
+            value->data.binary_op.op != BINOP_ADD) {
+            return -1;
+        }
+        
+        ast_node_t* left = value->data.binary_op.left;
+        ast_node_t* right = value->data.binary_op.right;
+        if (left->type != AST_IDENTIFIER ||
+            strcmp(left->data.identifier.name, target->data.identifier.name) != 0 ||
+            right->type != AST_NUMBER) {
+            return -1;
+        }
+        
+        constant_t step = number_constant(right);
+        if (step.type != SKP_TYPE_INT || step.value.int_val != 1) return -1;
+    } else {
+        return -1;
+    }
+    
+    if (target->type != AST_IDENTIFIER) return -1;
+    return resolve_local(compiler->current, target->data.identifier.name);
+}
+
+/* تعبير تُهمل قيمته: زيادة متغير محلي بواحد تعليمة واحدة، وغيره يُزال ناتجه */
+static void compile_effect(skp_compiler_t* compiler, ast_node_t* node) {
+    int slot = incremented_local(compiler, node);
+    if (slot != -1) {
+        compiler->line = node->line;
+        emit_bytes(compiler, OP_INC_LOCAL, (uint8_t)slot);
+        return;
+    }
+    
+    compile_expression(compiler, node);
+    emit_opcode(compiler, OP_POP);
+}
+
+/* شرط إذا أو حلقة مع قفزته عند الخطأ. يُرجع موضع الإزاحة لترقيعها. مقارنة
+ * أصغر من تقفز دون أن تترك ناتجها، وغيرها يبقى على المكدس (*keeps = 1)
+ * فيُزال بعد القفزة في الطريقين */
+static int emit_condition(skp_compiler_t* compiler, ast_node_t* condition, int* keeps) {
+    if (condition->type == AST_BINARY_OP && condition->data.binary_op.op == BINOP_LT) {
+        compile_expression(compiler, condition->data.binary_op.left);
+        compile_expression(compiler, condition->data.binary_op.right);
+        compiler->line = condition->line;
+        *keeps = 0;
+        return emit_jump(compiler, OP_LT_JUMP_IF_FALSE);
+    }
+    
+    compile_expression(compiler, condition);
+    *keeps = 1;
+    return emit_jump(compiler, OP_JUMP_IF_FALSE);
+}
+
 void compile_statement(skp_compiler_t* compiler, ast_node_t* node) {
     switch (node->type) {
         case AST_IF:
@@ -841,37 +1243,40 @@ void compile_statement(skp_compiler_t* compiler, ast_node_t* node) {
             compile_return(compiler, node);
             break;
         case AST_BREAK:
-            /* TODO: تنفيذ التوقف */
+            compile_break(compiler, node);
             break;
         case AST_CONTINUE:
-            /* TODO: تنفيذ الاستمرار */
+            compile_continue(compiler, node);
             break;
         case AST_BLOCK:
             compile_block(compiler, node);
             break;
         case AST_EXPRESSION_STMT:
-            compile_expression(compiler, node->data.expression_stmt.expression);
-            emit_opcode(compiler, OP_POP);
+            compile_effect(compiler, node->data.expression_stmt.expression);
             break;
         default:
-            compile_expression(compiler, node);
-            emit_opcode(compiler, OP_POP);
+            compile_effect(compiler, node);
             break;
     }
 }
 
 void compile_if(skp_compiler_t* compiler, ast_node_t* node) {
-    compile_expression(compiler, node->data.if_stmt.condition);
-    
-    int then_jump = compiler->current->chunk.count;
-    emit_jump(compiler, OP_JUMP_IF_FALSE, 0);
+    int keeps;
+    int then_jump = emit_condition(compiler, node->data.if_stmt.condition, &keeps);
+    if (keeps) emit_opcode(compiler, OP_POP);
     
     compile_node(compiler, node->data.if_stmt.then_branch);
     
-    int else_jump = compiler->current->chunk.count;
-    emit_jump(compiler, OP_JUMP, 0);
+    /* لا شيء يُتخطى إذا لم يبق للشرط قيمة ولم يكن وإلا */
+    if (!keeps && !node->data.if_stmt.else_branch) {
+        patch_jump(compiler, then_jump);
+        return;
+    }
+    
+    int else_jump = emit_jump(compiler, OP_JUMP);
     
     patch_jump(compiler, then_jump);
+    if (keeps) emit_opcode(compiler, OP_POP);
     
     if (node->data.if_stmt.else_branch) {
         compile_node(compiler, node->data.if_stmt.else_branch);
@@ -881,18 +1286,22 @@ void compile_if(skp_compiler_t* compiler, ast_node_t* node) {
 }
 
 void compile_while(skp_compiler_t* compiler, ast_node_t* node) {
-    int loop_start = compiler->current->chunk.count;
-    
-    compile_expression(compiler, node->data.while_stmt.condition);
+    loop_t loop;
+    int loop_start = mark_label(compiler);
+    begin_loop(compiler, &loop, loop_start);
     
-    int exit_jump = compiler->current->chunk.count;
-    emit_jump(compiler, OP_JUMP_IF_FALSE, 0);
+    int keeps;
+    int exit_jump = emit_condition(compiler, node->data.while_stmt.condition, &keeps);
+    if (keeps) emit_opcode(compiler, OP_POP);
     
     compile_node(compiler, node->data.while_stmt.body);
     
     emit_loop(compiler, loop_start);
     
     patch_jump(compiler, exit_jump);
+    if (keeps) emit_opcode(compiler, OP_POP);
+    
+    end_loop(compiler);
 }
 
 void compile_for(skp_compiler_t* compiler, ast_node_t* node) {
@@ -908,34 +1317,40 @@ void compile_for(skp_compiler_t* compiler, ast_node_t* node) {
         }
         define_variable(compiler, 0);
     } else if (node->data.for_stmt.init_expr) {
-        compile_expression(compiler, node->data.for_stmt.init_expr);
-        emit_opcode(compiler, OP_POP);
+        compile_effect(compiler, node->data.for_stmt.init_expr);
     }
     
-    int loop_start = compiler->current->chunk.count;
+    loop_t loop;
+    int loop_start = mark_label(compiler);
     int exit_jump = -1;
+    int keeps = 0;
     
     /* الشرط */
     if (node->data.for_stmt.condition) {
-        compile_expression(compiler, node->data.for_stmt.condition);
-        exit_jump = compiler->current->chunk.count;
-        emit_jump(compiler, OP_JUMP_IF_FALSE, 0);
+        exit_jump = emit_condition(compiler, node->data.for_stmt.condition, &keeps);
+        if (keeps) emit_opcode(compiler, OP_POP);
     }
     
-    /* الجسم */
-    compile_node(compiler, node->data.for_stmt.body);
-    
-    /* الزيادة */
+    /* الزيادة تسبق الجسم في البايتكود ليكون هدفها ثابتاً لـ 'استمر' */
     if (node->data.for_stmt.increment) {
-        compile_expression(compiler, node->data.for_stmt.increment);
-        emit_opcode(compiler, OP_POP);
+        int body_jump = emit_jump(compiler, OP_JUMP);
+        int increment_start = mark_label(compiler);
+        compile_effect(compiler, node->data.for_stmt.increment);
+        emit_loop(compiler, loop_start);
+        loop_start = increment_start;
+        patch_jump(compiler, body_jump);
     }
     
+    /* الجسم */
+    begin_loop(compiler, &loop, loop_start);
+    compile_node(compiler, node->data.for_stmt.body);
     emit_loop(compiler, loop_start);
     
     if (exit_jump != -1) {
         patch_jump(compiler, exit_jump);
+        if (keeps) emit_opcode(compiler, OP_POP);
     }
+    end_loop(compiler);
     
     end_scope(compiler);
 }
@@ -943,43 +1358,57 @@ void compile_for(skp_compiler_t* compiler, ast_node_t* node) {
 void compile_foreach(skp_compiler_t* compiler, ast_node_t* node) {
     begin_scope(compiler);
     
-    /* المتغير المؤقت للمجموعة */
-    const char* iter_name = "@iter";
-    declare_variable(compiler, iter_name);
+    /* متغيرات مخفية: المجموعة والفهرس الحالي */
     compile_expression(compiler, node->data.foreach_stmt.iterable);
+    add_local(compiler, "(مجموعة)");
     define_variable(compiler, 0);
+    uint8_t slot = (uint8_t)(compiler->current->local_count - 1);
     
-    /* متغير الحلقة */
-    declare_variable(compiler, node->data.foreach_stmt.var);
-    
-    int loop_start = compiler->current->chunk.count;
-    
-    /* الحصول على العنصر التالي */
-    named_variable(compiler, iter_name, 0);
-    emit_opcode(compiler, OP_CONST_NULL); /* TODO: استدعاء التالي */
+    constant_t zero;
+    zero.type = SKP_TYPE_INT;
+    zero.value.int_val = 0;
+    emit_constant(compiler, zero);
+    add_local(compiler, "(فهرس)");
+    define_variable(compiler, 0);
     
-    /* التحقق من النهاية */
-    emit_opcode(compiler, OP_CONST_NULL);
-    emit_opcode(compiler, OP_EQ);
+    loop_t loop;
+    int loop_start = mark_label(compiler);
+    begin_loop(compiler, &loop, loop_start);
     
-    int exit_jump = compiler->current->chunk.count;
-    emit_jump(compiler, OP_JUMP_IF_TRUE, 0);
+    /* يدفع العنصر التالي أو يقفز للخروج عند النهاية */
+    emit_bytes(compiler, OP_ITER_NEXT, slot);
+    emit_byte(compiler, 0xFF);
+    emit_byte(compiler, 0xFF);
+    int exit_jump = (int)compiler->current->chunk.count - 2;
     
-    /* تعيين العنصر للمتغير */
-    named_variable(compiler, node->data.foreach_stmt.var, 1);
+    /* متغير الحلقة جديد في كل دورة */
+    begin_scope(compiler);
+    add_local(compiler, node->data.foreach_stmt.var);
+    define_variable(compiler, 0);
     
-    /* الجسم */
     compile_node(compiler, node->data.foreach_stmt.body);
     
+    end_scope(compiler);
     emit_loop(compiler, loop_start);
     
     patch_jump(compiler, exit_jump);
+    end_loop(compiler);
     
     end_scope(compiler);
 }
 
 void compile_return(skp_compiler_t* compiler, ast_node_t* node) {
-    if (node->data.return_stmt.value) {
+    if (compiler->current->type == TYPE_SCRIPT) {
+        fprintf(stderr, "خطأ في السطر %d: 'أرجع' خارج دالة\n", node->line);
+        compiler->had_error = 1;
+        return;
+    }
+    
+    if (compiler->current->type == TYPE_INITIALIZER) {
+        /* المُهيِّئ يُرجع الكائن دائماً */
+        emit_bytes(compiler, OP_GET_LOCAL, 0);
+        emit_opcode(compiler, OP_RETURN);
+    } else if (node->data.return_stmt.value) {
         compile_expression(compiler, node->data.return_stmt.value);
         emit_opcode(compiler, OP_RETURN);
     } else {
@@ -1070,7 +1499,9 @@ const char* opcode_name(opcode_t op) {
         case OP_JUMP_IF_FALSE: return "JUMP_IF_FALSE";
         case OP_JUMP_IF_TRUE: return "JUMP_IF_TRUE";
         case OP_LOOP: return "LOOP";
+        case OP_ITER_NEXT: return "ITER_NEXT";
         case OP_CALL: return "CALL";
+        case OP_INVOKE: return "INVOKE";
         case OP_RETURN: return "RETURN";
         case OP_RETURN_VOID: return "RETURN_VOID";
         case OP_CLOSURE: return "CLOSURE";
@@ -1085,6 +1516,28 @@ const char* opcode_name(opcode_t op) {
         case OP_TRY_END: return "TRY_END";
         case OP_CATCH: return "CATCH";
         case OP_FINALLY: return "FINALLY";
+        case OP_ADD_INT: return "ADD_INT";
+        case OP_ADD_FLOAT: return "ADD_FLOAT";
+        case OP_SUB_INT: return "SUB_INT";
+        case OP_SUB_FLOAT: return "SUB_FLOAT";
+        case OP_MUL_INT: return "MUL_INT";
+        case OP_MUL_FLOAT: return "MUL_FLOAT";
+        case OP_LT_INT: return "LT_INT";
+        case OP_LT_FLOAT: return "LT_FLOAT";
+        case OP_GT_INT: return "GT_INT";
+        case OP_GT_FLOAT: return "GT_FLOAT";
+        case OP_LE_INT: return "LE_INT";
+        case OP_LE_FLOAT: return "LE_FLOAT";
+        case OP_GE_INT: return "GE_INT";
+        case OP_GE_FLOAT: return "GE_FLOAT";
+        case OP_SET_LOCAL_POP: return "SET_LOCAL_POP";
+        case OP_SET_GLOBAL_POP: return "SET_GLOBAL_POP";
+        case OP_IS_NULL: return "IS_NULL";
+        case OP_GET_LOCAL_GET_LOCAL: return "GET_LOCAL_GET_LOCAL";
+        case OP_GET_LOCAL_CONST_ADD: return "GET_LOCAL_CONST_ADD";
+        case OP_LT_JUMP_IF_FALSE: return "LT_JUMP_IF_FALSE";
+        case OP_INC_LOCAL: return "INC_LOCAL";
+        case OP_CALL_GLOBAL: return "CALL_GLOBAL";
         case OP_POP: return "POP";
         case OP_DUP: return "DUP";
         case OP_SWAP: return "SWAP";
@@ -1096,6 +1549,59 @@ const char* opcode_name(opcode_t op) {
     }
 }
 
+/* طول التعليمة عند offset بالبايتات مع معاملاتها */
+int instruction_length(chunk_t* chunk, int offset) {
+    switch (chunk->code[offset]) {
+        case OP_CONST_INT:
+        case OP_CONST_FLOAT:
+        case OP_CONST_STRING:
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_GET_UPVALUE:
+        case OP_SET_UPVALUE:
+        case OP_CALL:
+        case OP_CONST_LIST:
+        case OP_CONST_DICT:
+        case OP_CLASS:
+        case OP_METHOD:
+        case OP_IMPORT:
+        case OP_EXPORT:
+        case OP_SET_LOCAL_POP:
+        case OP_INC_LOCAL:
+            return 2;
+        
+        case OP_GET_GLOBAL:
+        case OP_SET_GLOBAL:
+        case OP_SET_GLOBAL_POP:
+        case OP_DEFINE_GLOBAL:
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_JUMP_IF_TRUE:
+        case OP_LOOP:
+        case OP_GET_LOCAL_GET_LOCAL:
+        case OP_GET_LOCAL_CONST_ADD:
+        case OP_LT_JUMP_IF_FALSE:
+            return 3;
+        
+        case OP_GET_FIELD:
+        case OP_SET_FIELD:
+        case OP_ITER_NEXT:
+        case OP_CALL_GLOBAL:
+            return 4;
+        
+        case OP_INVOKE:
+            return 5;
+        
+        case OP_CLOSURE: {
+            skp_object_t* function = chunk->constants[chunk->code[offset + 1]].value.func_val;
+            return 2 + 2 * function->data.v_func.upvalue_count;
+        }
+        
+        default:
+            return 1;
+    }
+}
+
 void chunk_disassemble(chunk_t* chunk, const char* name) {
     printf("== %s ==\n", name);
     
@@ -1104,26 +1610,32 @@ void chunk_disassemble(chunk_t* chunk, const char* name) {
     }
 }
 
-static int constant_instruction(const char* name, chunk_t* chunk, int offset) {
-    uint8_t constant = chunk->code[offset + 1];
-    printf("%-16s %4d '", name, constant);
+/* قيمة الثابت بين علامتي اقتباس */
+static void print_constant(chunk_t* chunk, uint8_t constant) {
+    printf("'");
     
     constant_t c = chunk->constants[constant];
     switch (c.type) {
         case SKP_TYPE_INT:
-            printf("%lld", c.value.int_val);
+            printf("%lld", (long long)c.value.int_val);
             break;
         case SKP_TYPE_FLOAT:
             printf("%f", c.value.float_val);
             break;
         case SKP_TYPE_STRING:
-            printf("%s", c.value.string_val);
+            printf("%s", c.value.string_val->data.v_string.chars);
             break;
         default:
             printf("?");
     }
-    printf("'\n");
-    
+    printf("'");
+}
+
+static int constant_instruction(const char* name, chunk_t* chunk, int offset) {
+    uint8_t constant = chunk->code[offset + 1];
+    printf("%-16s %4d ", name, constant);
+    print_constant(chunk, constant);
+    printf("\n");
     return offset + 2;
 }
 
@@ -1133,6 +1645,30 @@ static int byte_instruction(const char* name, chunk_t* chunk, int offset) {
     return offset + 2;
 }
 
+static int short_instruction(const char* name, chunk_t* chunk, int offset) {
+    uint16_t slot = (uint16_t)(chunk->code[offset + 1] << 8);
+    slot |= chunk->code[offset + 2];
+    printf("%-16s %4d\n", name, slot);
+    return offset + 3;
+}
+
+/* اسم الخاصية، وعدد المعاملات لـ INVOKE، ثم رقم الذاكرة المخبئية */
+static int field_instruction(const char* name, chunk_t* chunk, int offset, int has_args) {
+    uint8_t constant = chunk->code[offset + 1];
+    int next = offset + 2;
+    
+    printf("%-16s %4d '%s'", name, constant, chunk->constants[constant].value.string_val->data.v_string.chars);
+    if (has_args) {
+        printf(" (%d)", chunk->code[next]);
+        next++;
+    }
+    
+    uint16_t cache = (uint16_t)(chunk->code[next] << 8);
+    cache |= chunk->code[next + 1];
+    printf(" ic %d\n", cache);
+    return next + 2;
+}
+
 static int jump_instruction(const char* name, int sign, chunk_t* chunk, int offset) {
     uint16_t jump = (uint16_t)(chunk->code[offset + 1] << 8);
     jump |= chunk->code[offset + 2];
@@ -1155,32 +1691,70 @@ int disassemble_instruction(chunk_t* chunk, int offset) {
         case OP_CONST_INT:
         case OP_CONST_FLOAT:
         case OP_CONST_STRING:
+        case OP_IMPORT:
+        case OP_EXPORT:
             return constant_instruction(opcode_name((opcode_t)instruction), chunk, offset);
-            
-        case OP_GET_LOCAL:
-        case OP_SET_LOCAL:
+        
         case OP_GET_GLOBAL:
         case OP_SET_GLOBAL:
-        case OP_GET_UPVALUE:
-        case OP_SET_UPVALUE:
+        case OP_SET_GLOBAL_POP:
         case OP_DEFINE_GLOBAL:
+            return short_instruction(opcode_name((opcode_t)instruction), chunk, offset);
+        
         case OP_GET_FIELD:
         case OP_SET_FIELD:
+            return field_instruction(opcode_name((opcode_t)instruction), chunk, offset, 0);
+        
+        case OP_INVOKE:
+            return field_instruction(opcode_name((opcode_t)instruction), chunk, offset, 1);
+        
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_GET_UPVALUE:
+        case OP_SET_UPVALUE:
         case OP_CALL:
         case OP_CONST_LIST:
         case OP_CONST_DICT:
         case OP_CLASS:
         case OP_METHOD:
+        case OP_SET_LOCAL_POP:
+        case OP_INC_LOCAL:
             return byte_instruction(opcode_name((opcode_t)instruction), chunk, offset);
-            
+        
         case OP_JUMP:
         case OP_JUMP_IF_FALSE:
         case OP_JUMP_IF_TRUE:
+        case OP_LT_JUMP_IF_FALSE:
             return jump_instruction(opcode_name((opcode_t)instruction), 1, chunk, offset);
-            
+        
         case OP_LOOP:
             return jump_instruction(opcode_name((opcode_t)instruction), -1, chunk, offset);
-            
+        
+        case OP_GET_LOCAL_GET_LOCAL:
+            printf("%-16s %4d %d\n", "GET_LOCAL_GET_LOCAL", chunk->code[offset + 1], chunk->code[offset + 2]);
+            return offset + 3;
+        
+        case OP_GET_LOCAL_CONST_ADD:
+            printf("%-16s %4d + ", "GET_LOCAL_CONST_ADD", chunk->code[offset + 1]);
+            print_constant(chunk, chunk->code[offset + 2]);
+            printf("\n");
+            return offset + 3;
+        
+        case OP_CALL_GLOBAL: {
+            uint16_t slot = (uint16_t)(chunk->code[offset + 1] << 8);
+            slot |= chunk->code[offset + 2];
+            printf("%-16s %4d (%d)\n", "CALL_GLOBAL", slot, chunk->code[offset + 3]);
+            return offset + 4;
+        }
+        
+        case OP_ITER_NEXT: {
+            uint8_t slot = chunk->code[offset + 1];
+            uint16_t jump = (uint16_t)(chunk->code[offset + 2] << 8);
+            jump |= chunk->code[offset + 3];
+            printf("%-16s %4d -> %d\n", "ITER_NEXT", slot, offset + 4 + jump);
+            return offset + 4;
+        }
+        
         case OP_CONST_TRUE:
         case OP_CONST_FALSE:
         case OP_CONST_NULL:
@@ -1219,20 +1793,36 @@ int disassemble_instruction(chunk_t* chunk, int offset) {
         case OP_TRY_END:
         case OP_CATCH:
         case OP_FINALLY:
+        case OP_ADD_INT:
+        case OP_ADD_FLOAT:
+        case OP_SUB_INT:
+        case OP_SUB_FLOAT:
+        case OP_MUL_INT:
+        case OP_MUL_FLOAT:
+        case OP_LT_INT:
+        case OP_LT_FLOAT:
+        case OP_GT_INT:
+        case OP_GT_FLOAT:
+        case OP_LE_INT:
+        case OP_LE_FLOAT:
+        case OP_GE_INT:
+        case OP_GE_FLOAT:
+        case OP_IS_NULL:
         case OP_POP:
         case OP_DUP:
         case OP_SWAP:
         case OP_PRINT:
-        case OP_IMPORT:
-        case OP_EXPORT:
         case OP_HALT:
             printf("%s\n", opcode_name((opcode_t)instruction));
             return offset + 1;
-            
+        
         case OP_CLOSURE: {
             offset++;
-            uint8_t upvalue_count = chunk->code[offset++];
-            printf("%-16s %4d\n", "CLOSURE", upvalue_count);
+            uint8_t constant = chunk->code[offset++];
+            skp_object_t* function = chunk->constants[constant].value.func_val;
+            int upvalue_count = function->data.v_func.upvalue_count;
+            printf("%-16s %4d <دالة %s>\n", "CLOSURE", constant,
+                   function->data.v_func.name ? function->data.v_func.name : "");
             for (int i = 0; i < upvalue_count; i++) {
                 int is_local = chunk->code[offset++];
                 int index = chunk->code[offset++];
@@ -1241,7 +1831,7 @@ int disassemble_instruction(chunk_t* chunk, int offset) {
             }
             return offset;
         }
-            
+        
         default:
             printf("Unknown opcode %d\n", instruction);
             return offset + 1;
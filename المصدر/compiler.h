@@ -26,15 +26,15 @@ typedef enum {
     /* المتغيرات */
     OP_GET_LOCAL,       /* قراءة متغير محلي */
     OP_SET_LOCAL,       /* كتابة متغير محلي */
-    OP_GET_GLOBAL,      /* قراءة متغير عام */
-    OP_SET_GLOBAL,      /* كتابة متغير عام */
+    OP_GET_GLOBAL,      /* قراءة متغير عام (فتحة 16 بت) */
+    OP_SET_GLOBAL,      /* كتابة متغير عام (فتحة 16 بت) */
     OP_GET_UPVALUE,     /* قراءة upvalue */
     OP_SET_UPVALUE,     /* كتابة upvalue */
-    OP_GET_FIELD,       /* قراءة حقل */
-    OP_SET_FIELD,       /* كتابة حقل */
+    OP_GET_FIELD,       /* قراءة حقل (ثابت الاسم + ذاكرة مخبئية 16 بت) */
+    OP_SET_FIELD,       /* كتابة حقل (ثابت الاسم + ذاكرة مخبئية 16 بت) */
     OP_GET_INDEX,       /* قراءة بالفهرس */
     OP_SET_INDEX,       /* كتابة بالفهرس */
-    OP_DEFINE_GLOBAL,   /* تعريف متغير عام */
+    OP_DEFINE_GLOBAL,   /* تعريف متغير عام (فتحة 16 بت) */
     
     /* العمليات الحسابية */
     OP_ADD,             /* جمع */
@@ -71,7 +71,9 @@ typedef enum {
     OP_JUMP_IF_FALSE,   /* قفز إذا خطأ */
     OP_JUMP_IF_TRUE,    /* قفز إذا صحيح */
     OP_LOOP,            /* تكرار حلقة */
+    OP_ITER_NEXT,       /* العنصر التالي في حلقة لكل */
     OP_CALL,            /* استدعاء دالة */
+    OP_INVOKE,          /* استدعاء طريقة دون ربطها (اسم، معاملات، ذاكرة مخبئية) */
     OP_RETURN,          /* إرجاع */
     OP_RETURN_VOID,     /* إرجاع بدون قيمة */
     
@@ -91,6 +93,34 @@ typedef enum {
     OP_CATCH,           /* catch */
     OP_FINALLY,         /* finally */
     
+    /* عمليات مخصصة بالنوع: يكتبها الجهاز مكان العامة أثناء التشغيل */
+    OP_ADD_INT,         /* جمع صحيحين */
+    OP_ADD_FLOAT,       /* جمع عشريين */
+    OP_SUB_INT,         /* طرح صحيحين */
+    OP_SUB_FLOAT,       /* طرح عشريين */
+    OP_MUL_INT,         /* ضرب صحيحين */
+    OP_MUL_FLOAT,       /* ضرب عشريين */
+    OP_LT_INT,          /* أصغر من (صحيحان) */
+    OP_LT_FLOAT,        /* أصغر من (عشريان) */
+    OP_GT_INT,          /* أكبر من (صحيحان) */
+    OP_GT_FLOAT,        /* أكبر من (عشريان) */
+    OP_LE_INT,          /* أصغر أو يساوي (صحيحان) */
+    OP_LE_FLOAT,        /* أصغر أو يساوي (عشريان) */
+    OP_GE_INT,          /* أكبر أو يساوي (صحيحان) */
+    OP_GE_FLOAT,        /* أكبر أو يساوي (عشريان) */
+    
+    /* تعليمات مدمجة يكتبها محسّن البايتكود مكان تسلسلات المترجم */
+    OP_SET_LOCAL_POP,   /* كتابة متغير محلي وإزالة القيمة (SET_LOCAL ثم POP) */
+    OP_SET_GLOBAL_POP,  /* كتابة متغير عام وإزالة القيمة (فتحة 16 بت) */
+    OP_IS_NULL,         /* هل القيمة فارغة؟ (CONST_NULL ثم EQ) */
+    
+    /* تعليمات مركبة يصدرها المترجم لأكثر أزواج التعليمات تكراراً */
+    OP_GET_LOCAL_GET_LOCAL, /* قراءة متغيرين محليين (فتحتان) */
+    OP_GET_LOCAL_CONST_ADD, /* متغير محلي + عدد ثابت (فتحة، ثابت) */
+    OP_LT_JUMP_IF_FALSE,    /* مقارنة أصغر من ثم قفز إذا خطأ، دون إبقاء الناتج */
+    OP_INC_LOCAL,           /* زيادة متغير محلي بواحد في عبارة */
+    OP_CALL_GLOBAL,         /* استدعاء دالة عامة فوقها معاملاتها (فتحة 16 بت، عدد) */
+    
     /* أخرى */
     OP_POP,             /* إزالة من المكدس */
     OP_DUP,             /* تكرار قمة المكدس */
@@ -107,13 +137,31 @@ typedef struct {
     union {
         skp_int int_val;
         skp_float float_val;
-        char* string_val;
+        skp_object_t* string_val; /* نص محتجز */
+        skp_object_t* func_val;   /* دالة مُجمَّعة */
         size_t count;
     } value;
 } constant_t;
 
-/* كتلة بايتكود */
+/* عدد الأشكال التي تتذكرها الذاكرة المخبئية المضمنة الواحدة */
+#define SKP_IC_WAYS 4
+
+/* ما عُرف عن خاصية لشكل كائن واحد */
+typedef struct {
+    uint32_t shape_id;              /* معرف الشكل (0 = مدخل فارغ) */
+    int32_t slot;                   /* فتحة الحقل، أو -1 إذا لم يكن في الشكل */
+    struct skp_shape* transition;   /* لكتابة حقل جديد: الشكل بعد إضافته */
+    skp_object_t* method;           /* طريقة الصنف بهذا الاسم، أو NULL */
+} inline_cache_entry_t;
+
+/* ذاكرة مخبئية مضمنة لتعليمة وصول إلى خاصية */
 typedef struct {
+    uint32_t next;              /* المدخل الذي يُستبدل عند امتلاء الذاكرة */
+    inline_cache_entry_t entries[SKP_IC_WAYS];
+} inline_cache_t;
+
+/* كتلة بايتكود */
+typedef struct chunk {
     uint8_t* code;          /* البايتكود */
     size_t count;           /* عدد البايتات */
     size_t capacity;        /* السعة */
@@ -123,6 +171,12 @@ typedef struct {
     constant_t* constants;  /* تجمع الثوابت */
     size_t constant_count;
     size_t constant_capacity;
+    
+    inline_cache_t* caches; /* الذواكر المخبئية المضمنة للتعليمات */
+    size_t cache_count;
+    size_t cache_capacity;
+    
+    int borrowed;           /* code و lines داخل صورة بايتكود مخططة: لا تُحرر ولا تنمو */
 } chunk_t;
 
 /* متغير محلي */
@@ -138,6 +192,15 @@ typedef struct {
     int is_local;
 } upvalue_t;
 
+/* حلقة قيد الترجمة (لتنفيذ توقف واستمر) */
+typedef struct loop {
+    struct loop* enclosing;      /* الحلقة الخارجية */
+    int start;                   /* هدف استمر */
+    int scope_depth;             /* عمق النطاق عند بداية الحلقة */
+    int break_jumps[256];        /* قفزات توقف بانتظار الترقيع */
+    int break_count;
+} loop_t;
+
 /* نوع الدالة المُجمَّعة */
 typedef enum {
     TYPE_FUNCTION,
@@ -162,6 +225,10 @@ typedef struct compiler {
     
     chunk_t chunk;               /* كتلة البايتكود */
     int function_arity;          /* عدد المعاملات */
+    
+    loop_t* loop;                /* الحلقة الحالية (NULL خارج الحلقات) */
+    
+    int last_get_local;          /* موضع GET_LOCAL في آخر الكتلة يصح دمجه بما بعده، أو -1 */
 } compiler_t;
 
 /* المترجم */
@@ -169,12 +236,18 @@ typedef struct {
     compiler_t* current;         /* المترجم الحالي */
     parser_t* parser;            /* المحلل اللغوي */
     ast_node_t* ast;             /* شجرة البنية المجردة */
+    skp_object_t* globals;       /* أسماء المتغيرات العامة: اسم ← فتحة */
+    skp_object_t* declared;      /* عامة تُعرّف في البرنامج قبل موضع الترجمة */
+    const skp_value_t* bound;    /* قيم العامة عند الترجمة، وعددها */
+    size_t bound_count;
+    int line;                    /* سطر العقدة الجاري ترجمتها */
     int had_error;               /* هل حدث خطأ؟ */
 } skp_compiler_t;
 
 /* إنشاء وإتلاف */
-skp_compiler_t* compiler_create(parser_t* parser);
+skp_compiler_t* compiler_create(parser_t* parser, skp_object_t* globals);
 void compiler_destroy(skp_compiler_t* compiler);
+void compiler_bind_globals(skp_compiler_t* compiler, const skp_value_t* values, size_t count);
 chunk_t* compiler_compile(skp_compiler_t* compiler, ast_node_t* ast);
 
 /* إدارة الكتلة */
@@ -182,13 +255,14 @@ void chunk_init(chunk_t* chunk);
 void chunk_free(chunk_t* chunk);
 void chunk_write(chunk_t* chunk, uint8_t byte, int line);
 int chunk_add_constant(chunk_t* chunk, constant_t constant);
+int chunk_add_cache(chunk_t* chunk);
 
 /* كتابة أكواد العمليات */
 void emit_byte(skp_compiler_t* compiler, uint8_t byte);
 void emit_bytes(skp_compiler_t* compiler, uint8_t byte1, uint8_t byte2);
 void emit_opcode(skp_compiler_t* compiler, opcode_t op);
 void emit_constant(skp_compiler_t* compiler, constant_t constant);
-void emit_jump(skp_compiler_t* compiler, opcode_t op, int offset);
+int emit_jump(skp_compiler_t* compiler, opcode_t op);
 void patch_jump(skp_compiler_t* compiler, int offset);
 void emit_loop(skp_compiler_t* compiler, int loop_start);
 
@@ -197,13 +271,14 @@ void begin_scope(skp_compiler_t* compiler);
 void end_scope(skp_compiler_t* compiler);
 
 /* المتغيرات */
-int resolve_local(skp_compiler_t* compiler, const char* name);
-int resolve_upvalue(skp_compiler_t* compiler, const char* name);
-int add_upvalue(skp_compiler_t* compiler, uint8_t index, int is_local);
+int resolve_local(compiler_t* compiler, const char* name);
+int resolve_upvalue(compiler_t* compiler, const char* name);
+int add_upvalue(compiler_t* compiler, uint8_t index, int is_local);
+int resolve_global(skp_object_t* globals, const char* name);
 void add_local(skp_compiler_t* compiler, const char* name);
 void declare_variable(skp_compiler_t* compiler, const char* name);
 uint8_t identifier_constant(skp_compiler_t* compiler, const char* name);
-void define_variable(skp_compiler_t* compiler, uint8_t global);
+void define_variable(skp_compiler_t* compiler, uint16_t global);
 void named_variable(skp_compiler_t* compiler, const char* name, int can_assign);
 
 /* الترجمة */
@@ -242,7 +317,9 @@ void compile_program(skp_compiler_t* compiler, ast_node_t* node);
 
 /* دوال مساعدة */
 int get_line(ast_node_t* node);
+constant_t number_constant(ast_node_t* node);
 const char* opcode_name(opcode_t op);
+int instruction_length(chunk_t* chunk, int offset);
 void chunk_disassemble(chunk_t* chunk, const char* name);
 int disassemble_instruction(chunk_t* chunk, int offset);
 
@@ -3,10 +3,240 @@
  * ============================================ */
 
 #include "lexer.h"
-#include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
 
+/* المسار السريع بـ SSE2 (أساسي في كل معالجات x86-64) لتخطي سلاسل
+ * بايتات المعرفات والمسافات 16 بايتاً في كل مرة. يُعطَّل بتعريف
+ * SKP_NO_SIMD ويُستعمل المسار العددي وحده */
+#if defined(__SSE2__) && defined(__GNUC__) && !defined(SKP_NO_SIMD)
+#define SKP_LEXER_SSE2
+#include <emmintrin.h>
+#endif
+
+/* أصناف البايتات. ما كان CC_WORD يتمم المعرف دائماً؛ وبدايات CC_SPECIAL
+ * وحدها قد تبدأ فاصلة عربية أو مسافة فتُفك لتُحسم */
+#define CC_SPACE    0x01   /* مسافة ASCII */
+#define CC_DIGIT    0x02   /* رقم ASCII */
+#define CC_ALPHA    0x04   /* حرف ASCII أو _ */
+#define CC_CONT     0x08   /* بايت تتمة UTF-8 (10xxxxxx) */
+#define CC_LEAD     0x10   /* بداية تسلسل UTF-8 صالحة (C2..F4) */
+#define CC_SPECIAL  0x20   /* C2 و D8 و E2 و EF */
+#define CC_WORD     0x40
+
+#define SP CC_SPACE
+#define DG (CC_DIGIT | CC_WORD)
+#define AL (CC_ALPHA | CC_WORD)
+#define CT (CC_CONT | CC_WORD)
+#define LD (CC_LEAD | CC_WORD)
+#define SC (CC_LEAD | CC_SPECIAL)
+#define XX CC_WORD               /* بايت لا يصح في UTF-8: يُعامل حرفاً كما كان */
+
+static const unsigned char char_class[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0, SP, SP, SP, SP, SP,  0,  0,   /* 0_ */
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   /* 1_ */
+    SP,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,   /* 2_ */
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG,  0,  0,  0,  0,  0,  0,   /* 3_ */
+     0, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,   /* 4_ */
+    AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,  0,  0,  0,  0, AL,   /* 5_ */
+     0, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,   /* 6_ */
+    AL, AL, AL, AL, AL, AL, AL, AL, AL, AL, AL,  0,  0,  0,  0,  0,   /* 7_ */
+    CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT,   /* 8_ */
+    CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT,   /* 9_ */
+    CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT,   /* A_ */
+    CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT, CT,   /* B_ */
+    XX, XX, SC, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD,   /* C_ */
+    LD, LD, LD, LD, LD, LD, LD, LD, SC, LD, LD, LD, LD, LD, LD, LD,   /* D_ */
+    LD, LD, SC, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD, LD, SC,   /* E_ */
+    LD, LD, LD, LD, LD, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,   /* F_ */
+};
+
+#undef SP
+#undef DG
+#undef AL
+#undef CT
+#undef LD
+#undef SC
+#undef XX
+
+/* أصناف المحارف متعددة البايتات */
+typedef enum {
+    UTF8_LETTER,         /* جزء من معرف: الحروف العربية وكل ما سوى ما يلي */
+    UTF8_SPACE,          /* مسافة غير منقسمة وعلامات الاتجاه وعلامة BOM */
+    UTF8_COMMA,          /* الفاصلة العربية ، */
+    UTF8_SEMICOLON       /* الفاصلة المنقوطة العربية ؛ */
+} utf8_kind_t;
+
+/* فك تسلسل UTF-8؛ يعيد طوله أو 0 إن كان غير صالح أو مقطوعاً */
+static size_t utf8_decode(const unsigned char* s, size_t avail, unsigned int* cp) {
+    unsigned char c = s[0];
+    size_t length;
+    unsigned int min;
+    
+    if (c < 0x80) { *cp = c; return 1; }
+    if (!(char_class[c] & CC_LEAD)) return 0;
+    if (c < 0xE0) { length = 2; *cp = c & 0x1F; min = 0x80; }
+    else if (c < 0xF0) { length = 3; *cp = c & 0x0F; min = 0x800; }
+    else { length = 4; *cp = c & 0x07; min = 0x10000; }
+    
+    if (avail < length) return 0;
+    for (size_t i = 1; i < length; i++) {
+        if (!(char_class[s[i]] & CC_CONT)) return 0;
+        *cp = (*cp << 6) | (s[i] & 0x3F);
+    }
+    
+    /* الترميز الأطول من اللازم وأنصاف الأزواج البديلة وما بعد U+10FFFF */
+    if (*cp < min || (*cp >= 0xD800 && *cp <= 0xDFFF) || *cp > 0x10FFFF) return 0;
+    return length;
+}
+
+/* تصنيف المحرف متعدد البايتات عند الموضع الحالي. التسلسل غير الصالح
+ * يُعد حرفاً من بايت واحد */
+static inline utf8_kind_t lexer_utf8_kind(lexer_t* lexer, size_t* length) {
+    const unsigned char* s = (const unsigned char*)lexer->source + lexer->position;
+    unsigned int cp;
+    
+    /* حروف U+0600..U+063F (ومنها الألف واللام) تبدأ بـ D8 وهي الأكثر تكراراً */
+    if (s[0] == 0xD8 && (s[1] & 0xC0) == 0x80) {
+        *length = 2;
+        switch (s[1]) {
+            case 0x8C: return UTF8_COMMA;
+            case 0x9B: return UTF8_SEMICOLON;
+            case 0x9C: return UTF8_SPACE;
+            default:   return UTF8_LETTER;
+        }
+    }
+    
+    *length = utf8_decode(s, lexer->length - lexer->position, &cp);
+    if (*length == 0) {
+        *length = 1;
+        return UTF8_LETTER;
+    }
+    
+    switch (cp) {
+        case 0x060C: return UTF8_COMMA;
+        case 0x061B: return UTF8_SEMICOLON;
+        case 0x00A0:                     /* مسافة غير منقسمة */
+        case 0x061C:                     /* علامة الحرف العربي */
+        case 0x200B:                     /* مسافة صفرية */
+        case 0x200E: case 0x200F:        /* LRM و RLM */
+        case 0x2028: case 0x2029:
+        case 0xFEFF:                     /* BOM */
+            return UTF8_SPACE;
+        default:
+            /* تضمين الاتجاه وعزله (U+202A..U+202E و U+2066..U+2069) */
+            if ((cp >= 0x202A && cp <= 0x202E) || (cp >= 0x2066 && cp <= 0x2069)) {
+                return UTF8_SPACE;
+            }
+            return UTF8_LETTER;
+    }
+}
+
+/* تجاوز محرف واحد من bytes بايت؛ العمود يعد المحارف لا البايتات */
+static void lexer_advance_char(lexer_t* lexer, size_t bytes) {
+    lexer->position += bytes;
+    lexer->column++;
+}
+
+#ifdef SKP_LEXER_SSE2
+/* عدد البتات في قناع 16 بت. __builtin_popcount يصير استدعاء مكتبة
+ * دون -mpopcnt فنحسبه بالبتات المتوازية */
+static inline unsigned int popcount16(unsigned int x) {
+    x = x - ((x >> 1) & 0x5555);
+    x = (x & 0x3333) + ((x >> 2) & 0x3333);
+    x = (x + (x >> 4)) & 0x0F0F;
+    return (x + (x >> 8)) & 0x1F;
+}
+
+/* أطول بادئة من بايتات معرف مؤكدة: حروف ASCII وأرقامه و _ وبايتات التتمة
+ * وبدايات D9..DB وبداية D8 ما لم يتبعها 8C أو 9B أو 9C (، و ؛ وعلامة
+ * الحرف العربي). ما يتوقف عنده يحسمه المسار العددي. chars يُزاد بعدد
+ * المحارف المتخطاة */
+static size_t lexer_scan_ident_sse2(const unsigned char* p, size_t avail, int* chars) {
+    const __m128i lower_a = _mm_set1_epi8('a' - 1);
+    const __m128i lower_z = _mm_set1_epi8('z' + 1);
+    const __m128i digit_0 = _mm_set1_epi8('0' - 1);
+    const __m128i digit_9 = _mm_set1_epi8('9' + 1);
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i underscore = _mm_set1_epi8('_');
+    const __m128i lead_min = _mm_set1_epi8((char)0xC0);
+    const __m128i lead_d8 = _mm_set1_epi8((char)0xD8);
+    const __m128i lead_dc = _mm_set1_epi8((char)0xDC);
+    const __m128i comma_2 = _mm_set1_epi8((char)0x8C);
+    const __m128i semicolon_2 = _mm_set1_epi8((char)0x9B);
+    const __m128i mark_2 = _mm_set1_epi8((char)0x9C);
+    size_t scanned = 0;
+    
+    /* يُقرأ بايت بعد الكتلة لفحص ما يلي D8 */
+    while (avail - scanned >= 17) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + scanned));
+        __m128i next = _mm_loadu_si128((const __m128i*)(p + scanned + 1));
+        
+        __m128i folded = _mm_or_si128(v, case_bit);
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(folded, lower_a), _mm_cmplt_epi8(folded, lower_z));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, digit_0), _mm_cmplt_epi8(v, digit_9));
+        __m128i cont = _mm_cmplt_epi8(v, lead_min);
+        __m128i lead = _mm_and_si128(_mm_cmpgt_epi8(v, lead_d8), _mm_cmplt_epi8(v, lead_dc));
+        __m128i punct = _mm_or_si128(_mm_cmpeq_epi8(next, comma_2),
+                                     _mm_or_si128(_mm_cmpeq_epi8(next, semicolon_2), _mm_cmpeq_epi8(next, mark_2)));
+        __m128i d8 = _mm_andnot_si128(punct, _mm_cmpeq_epi8(v, lead_d8));
+        
+        __m128i accept = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, underscore));
+        accept = _mm_or_si128(accept, _mm_or_si128(_mm_or_si128(cont, lead), d8));
+        
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(accept);
+        unsigned int starts = ~(unsigned int)_mm_movemask_epi8(cont) & 0xFFFF;
+        
+        if (mask == 0xFFFF) {
+            *chars += popcount16(starts);
+            scanned += 16;
+            continue;
+        }
+        
+        unsigned int run = (unsigned int)__builtin_ctz(~mask);
+        *chars += popcount16(starts & ((1u << run) - 1));
+        scanned += run;
+        break;
+    }
+    
+    return scanned;
+}
+
+/* أطول بادئة من مسافات ASCII؛ يحدّث السطر والعمود */
+static size_t lexer_scan_space_sse2(lexer_t* lexer) {
+    const unsigned char* p = (const unsigned char*)lexer->source + lexer->position;
+    size_t avail = lexer->length - lexer->position;
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    size_t scanned = 0;
+    
+    while (avail - scanned >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + scanned));
+        __m128i nl = _mm_cmpeq_epi8(v, newline);
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), nl),
+                                  _mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, cr)));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(ws);
+        unsigned int run = mask == 0xFFFF ? 16 : (unsigned int)__builtin_ctz(~mask);
+        unsigned int lines = (unsigned int)_mm_movemask_epi8(nl) & ((1u << run) - 1);
+        
+        if (lines) {
+            unsigned int last = 31 - (unsigned int)__builtin_clz(lines);
+            lexer->line += popcount16(lines);
+            lexer->column = 1 + (int)(run - last - 1);
+        } else {
+            lexer->column += (int)run;
+        }
+        scanned += run;
+        if (run < 16) break;
+    }
+    
+    lexer->position += scanned;
+    return scanned;
+}
+#endif
+
 /* إنشاء معجم جديد */
 lexer_t* lexer_create(const char* source) {
     lexer_t* lexer = (lexer_t*)malloc(sizeof(lexer_t));
@@ -18,8 +248,14 @@ lexer_t* lexer_create(const char* source) {
     lexer->line = 1;
     lexer->column = 1;
     lexer->token_count = 0;
-    lexer->token_capacity = 64;
-    lexer->tokens = (token_t**)malloc(sizeof(token_t*) * lexer->token_capacity);
+    lexer->current_token = 0;
+    /* حجز سخي من حجم المصدر: الصفحات التي لا تُكتب لا تُخصص فعلياً،
+     * وإعادة التخصيص في منتصف التحليل تنسخ المصفوفة كلها */
+    lexer->token_capacity = lexer->length / 2 + 64;
+    lexer->tokens = (token_t*)malloc(sizeof(token_t) * lexer->token_capacity);
+    lexer->escaped = NULL;
+    lexer->escaped_count = 0;
+    lexer->escaped_capacity = 0;
     
     return lexer;
 }
@@ -28,31 +264,28 @@ lexer_t* lexer_create(const char* source) {
 void lexer_destroy(lexer_t* lexer) {
     if (!lexer) return;
     
-    for (size_t i = 0; i < lexer->token_count; i++) {
-        token_destroy(lexer->tokens[i]);
+    for (size_t i = 0; i < lexer->escaped_count; i++) {
+        free(lexer->escaped[i]);
     }
+    free(lexer->escaped);
     free(lexer->tokens);
     free(lexer);
 }
 
 /* إنشاء رمز جديد */
-token_t* token_create(token_type_t type, const char* value, int line, int column) {
-    token_t* token = (token_t*)malloc(sizeof(token_t));
-    if (!token) return NULL;
-    
-    token->type = type;
-    token->value = value ? strdup(value) : NULL;
-    token->line = line;
-    token->column = column;
-    
+token_t token_create(token_type_t type, const char* start, size_t length, int line, int column) {
+    token_t token;
+    token.type = type;
+    token.start = start;
+    token.length = (uint32_t)length;
+    token.line = line;
+    token.column = column;
     return token;
 }
 
-/* تحرير رمز */
-void token_destroy(token_t* token) {
-    if (!token) return;
-    if (token->value) free(token->value);
-    free(token);
+/* رمز نصه من start حتى الموضع الحالي */
+static token_t lexer_make_token(lexer_t* lexer, token_type_t type, size_t start, int line, int column) {
+    return token_create(type, lexer->source + start, lexer->position - start, line, column);
 }
 
 /* الحصول على الحرف الحالي */
@@ -74,17 +307,35 @@ void lexer_advance(lexer_t* lexer) {
         if (lexer->source[lexer->position] == '\n') {
             lexer->line++;
             lexer->column = 1;
-        } else {
+        } else if (!(char_class[(unsigned char)lexer->source[lexer->position]] & CC_CONT)) {
             lexer->column++;
         }
         lexer->position++;
     }
 }
 
-/* تخطي المسافات */
+/* تخطي المسافات، ومنها المسافات وعلامات الاتجاه غير ASCII */
 void lexer_skip_whitespace(lexer_t* lexer) {
-    while (isspace(lexer_current(lexer))) {
-        lexer_advance(lexer);
+    for (;;) {
+        unsigned char c = (unsigned char)lexer_current(lexer);
+        if (char_class[c] & CC_SPACE) {
+#ifdef SKP_LEXER_SSE2
+            /* المسافة المفردة بين رمزين لا تستحق المتجهات؛ الإزاحة البادئة تستحق */
+            if ((char_class[(unsigned char)lexer_peek(lexer, 1)] & CC_SPACE) &&
+                lexer_scan_space_sse2(lexer) > 0) {
+                continue;
+            }
+#endif
+            lexer_advance(lexer);
+            continue;
+        }
+        
+        size_t length;
+        if ((char_class[c] & CC_SPECIAL) && lexer_utf8_kind(lexer, &length) == UTF8_SPACE) {
+            lexer_advance_char(lexer, length);
+            continue;
+        }
+        return;
     }
 }
 
@@ -98,109 +349,201 @@ void lexer_skip_comment(lexer_t* lexer) {
 }
 
 /* قراءة رقم */
-token_t* lexer_read_number(lexer_t* lexer) {
+token_t lexer_read_number(lexer_t* lexer) {
     int line = lexer->line;
     int column = lexer->column;
-    char buffer[64];
-    int i = 0;
+    size_t start = lexer->position;
+    int is_float = 0;
     
-    while (isdigit(lexer_current(lexer)) || lexer_current(lexer) == '.') {
-        buffer[i++] = lexer_current(lexer);
+    while ((char_class[(unsigned char)lexer_current(lexer)] & CC_DIGIT) || lexer_current(lexer) == '.') {
+        if (lexer_current(lexer) == '.') is_float = 1;
         lexer_advance(lexer);
     }
-    buffer[i] = '\0';
     
-    /* التحقق إذا كان عشرياً */
-    if (strchr(buffer, '.')) {
-        return token_create(TOKEN_FLOAT, buffer, line, column);
-    }
-    return token_create(TOKEN_INT, buffer, line, column);
+    return lexer_make_token(lexer, is_float ? TOKEN_FLOAT : TOKEN_INT, start, line, column);
 }
 
-/* قراءة نص */
-token_t* lexer_read_string(lexer_t* lexer) {
+/* قراءة نص: يبقى شريحة من المصدر ما لم يحتوِ تسلسل هروب */
+token_t lexer_read_string(lexer_t* lexer) {
     int line = lexer->line;
     int column = lexer->column;
     char quote = lexer_current(lexer);
     lexer_advance(lexer);
     
-    char buffer[1024];
-    int i = 0;
+    size_t start = lexer->position;
+    int has_escape = 0;
     
     while (lexer_current(lexer) != quote && lexer_current(lexer) != '\0') {
         if (lexer_current(lexer) == '\\') {
+            has_escape = 1;
             lexer_advance(lexer);
-            switch (lexer_current(lexer)) {
-                case 'n': buffer[i++] = '\n'; break;
-                case 't': buffer[i++] = '\t'; break;
-                case '\\': buffer[i++] = '\\'; break;
-                case '"': buffer[i++] = '"'; break;
-                case '\'': buffer[i++] = '\''; break;
-                default: buffer[i++] = lexer_current(lexer); break;
-            }
-        } else {
-            buffer[i++] = lexer_current(lexer);
         }
         lexer_advance(lexer);
     }
     
+    size_t end = lexer->position < lexer->length ? lexer->position : lexer->length;
     if (lexer_current(lexer) == quote) {
         lexer_advance(lexer);
     }
     
+    if (!has_escape) {
+        return token_create(TOKEN_STRING, lexer->source + start, end - start, line, column);
+    }
+    
+    /* النص المفكوك لا يطول عن الأصل */
+    char* buffer = (char*)malloc(end - start + 1);
+    if (!buffer) {
+        return token_create(TOKEN_ERROR, lexer->source + start, end - start, line, column);
+    }
+    size_t i = 0;
+    for (size_t pos = start; pos < end; pos++) {
+        char c = lexer->source[pos];
+        if (c == '\\' && pos + 1 < end) {
+            c = lexer->source[++pos];
+            switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                default: break;
+            }
+        } else if (c == '\\') {
+            continue;
+        }
+        buffer[i++] = c;
+    }
     buffer[i] = '\0';
-    return token_create(TOKEN_STRING, buffer, line, column);
+    
+    if (lexer->escaped_count >= lexer->escaped_capacity) {
+        lexer->escaped_capacity = lexer->escaped_capacity == 0 ? 8 : lexer->escaped_capacity * 2;
+        lexer->escaped = (char**)realloc(lexer->escaped, sizeof(char*) * lexer->escaped_capacity);
+    }
+    lexer->escaped[lexer->escaped_count++] = buffer;
+    
+    return token_create(TOKEN_STRING, buffer, i, line, column);
 }
 
 /* قراءة معرف */
-token_t* lexer_read_identifier(lexer_t* lexer) {
+token_t lexer_read_identifier(lexer_t* lexer) {
     int line = lexer->line;
     int column = lexer->column;
-    char buffer[256];
-    int i = 0;
+    size_t start = lexer->position;
+    const unsigned char* source = (const unsigned char*)lexer->source;
+    size_t pos = start;
+    int chars = 0;
     
-    while (isalnum(lexer_current(lexer)) || lexer_current(lexer) == '_') {
-        buffer[i++] = lexer_current(lexer);
-        lexer_advance(lexer);
+    /* المصدر منتهٍ بـ '\0' وصنفه صفر، فلا حاجة لفحص الحد في كل بايت */
+    for (;;) {
+#ifdef SKP_LEXER_SSE2
+        pos += lexer_scan_ident_sse2(source + pos, lexer->length - pos, &chars);
+#endif
+        unsigned char cls = char_class[source[pos]];
+        if (cls & CC_WORD) {
+            chars += !(cls & CC_CONT);
+            pos++;
+            continue;
+        }
+        
+        if (cls & CC_SPECIAL) {
+            size_t length;
+            lexer->position = pos;
+            if (lexer_utf8_kind(lexer, &length) == UTF8_LETTER) {
+                chars++;
+                pos += length;
+                continue;
+            }
+        }
+        break;
     }
-    buffer[i] = '\0';
     
-    token_type_t type = lexer_keyword_type(buffer);
-    return token_create(type, buffer, line, column);
+    lexer->position = pos;
+    lexer->column = column + chars;
+    
+    token_type_t type = lexer_keyword_type(lexer->source + start, pos - start);
+    return lexer_make_token(lexer, type, start, line, column);
+}
+
+/* رمز يبدأ ببداية CC_SPECIAL: الفاصلتان العربيتان أو معرف */
+static token_t lexer_read_utf8(lexer_t* lexer) {
+    int line = lexer->line;
+    int column = lexer->column;
+    size_t start = lexer->position;
+    size_t length;
+    
+    switch (lexer_utf8_kind(lexer, &length)) {
+        case UTF8_COMMA:
+            lexer_advance_char(lexer, length);
+            return lexer_make_token(lexer, TOKEN_COMMA, start, line, column);
+        case UTF8_SEMICOLON:
+            lexer_advance_char(lexer, length);
+            return lexer_make_token(lexer, TOKEN_SEMICOLON, start, line, column);
+        default:
+            return lexer_read_identifier(lexer);
+    }
+}
+
+/* الكلمات المفتاحية في جدول تجزئة تام: لكل كلمة خانة مستقلة تحددها
+ * keyword_hash، فيكفي فحص خانة واحدة بمقارنة الطول ثم البايتات.
+ * الخانات محسوبة مسبقاً؛ عند إضافة كلمة تُحسب خانتها بالدالة نفسها، وأي
+ * تصادم يظهر تحذيراً من -Woverride-init (ضمن -Wextra) ويستلزم تغيير
+ * معاملات التجزئة */
+typedef struct {
+    const char* word;
+    size_t length;
+    token_type_t type;
+} keyword_t;
+
+#define KEYWORD_SLOTS 64
+#define KEYWORD(w, t) { w, sizeof(w) - 1, t }
+
+static const keyword_t keywords[KEYWORD_SLOTS] = {
+    [4] = KEYWORD("متغير", TOKEN_VAR),
+    [49] = KEYWORD("ثابت", TOKEN_CONST),
+    [46] = KEYWORD("دالة", TOKEN_FUNC),
+    [18] = KEYWORD("أرجع", TOKEN_RETURN),
+    [14] = KEYWORD("إذا", TOKEN_IF),
+    [57] = KEYWORD("وإلا", TOKEN_ELSE),
+    [50] = KEYWORD("أثناء", TOKEN_WHILE),
+    [56] = KEYWORD("لكل", TOKEN_FOR),
+    [23] = KEYWORD("في", TOKEN_IN),
+    [17] = KEYWORD("توقف", TOKEN_BREAK),
+    [38] = KEYWORD("استمر", TOKEN_CONTINUE),
+    [20] = KEYWORD("صنف", TOKEN_CLASS),
+    [21] = KEYWORD("جديد", TOKEN_NEW),
+    [48] = KEYWORD("هذا", TOKEN_THIS),
+    [32] = KEYWORD("استورد", TOKEN_IMPORT),
+    [36] = KEYWORD("صدر", TOKEN_EXPORT),
+    [16] = KEYWORD("صحيح", TOKEN_TRUE),
+    [59] = KEYWORD("خطأ", TOKEN_FALSE),
+    [55] = KEYWORD("فارغ", TOKEN_NULL_KW),
+    [8] = KEYWORD("و", TOKEN_AND),
+    [43] = KEYWORD("أو", TOKEN_OR),
+    [1] = KEYWORD("ليس", TOKEN_NOT),
+};
+
+#undef KEYWORD
+
+/* الطول والبايت الثاني (ذيل أول حرف عربي) والبايت الأخير تكفي لتمييز
+ * الكلمات كلها. يتطلب length >= 2 */
+static inline unsigned int keyword_hash(const unsigned char* word, size_t length) {
+    return (unsigned int)((length << 2) + word[1] + word[length - 1] * 7u) & (KEYWORD_SLOTS - 1);
 }
 
 /* التحقق من الكلمة المفتاحية */
-token_type_t lexer_keyword_type(const char* word) {
-    if (strcmp(word, "متغير") == 0) return TOKEN_VAR;
-    if (strcmp(word, "ثابت") == 0) return TOKEN_CONST;
-    if (strcmp(word, "دالة") == 0) return TOKEN_FUNC;
-    if (strcmp(word, "أرجع") == 0) return TOKEN_RETURN;
-    if (strcmp(word, "إذا") == 0) return TOKEN_IF;
-    if (strcmp(word, "وإلا") == 0) return TOKEN_ELSE;
-    if (strcmp(word, "أثناء") == 0) return TOKEN_WHILE;
-    if (strcmp(word, "لكل") == 0) return TOKEN_FOR;
-    if (strcmp(word, "في") == 0) return TOKEN_IN;
-    if (strcmp(word, "توقف") == 0) return TOKEN_BREAK;
-    if (strcmp(word, "استمر") == 0) return TOKEN_CONTINUE;
-    if (strcmp(word, "صنف") == 0) return TOKEN_CLASS;
-    if (strcmp(word, "جديد") == 0) return TOKEN_NEW;
-    if (strcmp(word, "هذا") == 0) return TOKEN_THIS;
-    if (strcmp(word, "استورد") == 0) return TOKEN_IMPORT;
-    if (strcmp(word, "صدر") == 0) return TOKEN_EXPORT;
-    if (strcmp(word, "صحيح") == 0) return TOKEN_TRUE;
-    if (strcmp(word, "خطأ") == 0) return TOKEN_FALSE;
-    if (strcmp(word, "فارغ") == 0) return TOKEN_NULL_KW;
-    if (strcmp(word, "و") == 0) return TOKEN_AND;
-    if (strcmp(word, "أو") == 0) return TOKEN_OR;
-    if (strcmp(word, "ليس") == 0) return TOKEN_NOT;
+token_type_t lexer_keyword_type(const char* word, size_t length) {
+    if (length < 2) return TOKEN_IDENTIFIER;
+    
+    const keyword_t* keyword = &keywords[keyword_hash((const unsigned char*)word, length)];
+    if (keyword->length == length && memcmp(keyword->word, word, length) == 0) {
+        return keyword->type;
+    }
     
     return TOKEN_IDENTIFIER;
 }
 
 /* قراءة عامل */
-token_t* lexer_read_operator(lexer_t* lexer) {
+token_t lexer_read_operator(lexer_t* lexer) {
     int line = lexer->line;
     int column = lexer->column;
+    size_t start = lexer->position;
     char c = lexer_current(lexer);
     
     switch (c) {
@@ -208,169 +551,233 @@ token_t* lexer_read_operator(lexer_t* lexer) {
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_PLUS_ASSIGN, "+=", line, column);
+                return lexer_make_token(lexer, TOKEN_PLUS_ASSIGN, start, line, column);
+            }
+            if (lexer_current(lexer) == '+') {
+                lexer_advance(lexer);
+                return lexer_make_token(lexer, TOKEN_INC, start, line, column);
             }
-            return token_create(TOKEN_PLUS, "+", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_PLUS, start, line, column);
+        
         case '-':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_MINUS_ASSIGN, "-=", line, column);
+                return lexer_make_token(lexer, TOKEN_MINUS_ASSIGN, start, line, column);
             }
             if (lexer_current(lexer) == '>') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_ARROW, "->", line, column);
+                return lexer_make_token(lexer, TOKEN_ARROW, start, line, column);
             }
-            return token_create(TOKEN_MINUS, "-", line, column);
-            
+            if (lexer_current(lexer) == '-') {
+                lexer_advance(lexer);
+                return lexer_make_token(lexer, TOKEN_DEC, start, line, column);
+            }
+            return lexer_make_token(lexer, TOKEN_MINUS, start, line, column);
+        
         case '*':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '*') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_POWER, "**", line, column);
+                return lexer_make_token(lexer, TOKEN_POWER, start, line, column);
             }
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_STAR_ASSIGN, "*=", line, column);
+                return lexer_make_token(lexer, TOKEN_STAR_ASSIGN, start, line, column);
             }
-            return token_create(TOKEN_STAR, "*", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_STAR, start, line, column);
+        
         case '/':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_SLASH_ASSIGN, "/=", line, column);
+                return lexer_make_token(lexer, TOKEN_SLASH_ASSIGN, start, line, column);
             }
-            return token_create(TOKEN_SLASH, "/", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_SLASH, start, line, column);
+        
         case '%':
             lexer_advance(lexer);
-            return token_create(TOKEN_PERCENT, "%", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_PERCENT, start, line, column);
+        
+        case '^':
+            lexer_advance(lexer);
+            return lexer_make_token(lexer, TOKEN_POWER, start, line, column);
+        
+        case '&':
+            lexer_advance(lexer);
+            return lexer_make_token(lexer, TOKEN_BIT_AND, start, line, column);
+        
+        case '|':
+            lexer_advance(lexer);
+            return lexer_make_token(lexer, TOKEN_BIT_OR, start, line, column);
+        
+        case '~':
+            lexer_advance(lexer);
+            return lexer_make_token(lexer, TOKEN_BIT_XOR, start, line, column);
+        
+        case '?':
+            lexer_advance(lexer);
+            return lexer_make_token(lexer, TOKEN_QUESTION, start, line, column);
+        
         case '=':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_EQ, "==", line, column);
+                return lexer_make_token(lexer, TOKEN_EQ, start, line, column);
             }
-            return token_create(TOKEN_ASSIGN, "=", line, column);
-            
+            if (lexer_current(lexer) == '>') {
+                lexer_advance(lexer);
+                return lexer_make_token(lexer, TOKEN_ARROW, start, line, column);
+            }
+            return lexer_make_token(lexer, TOKEN_ASSIGN, start, line, column);
+        
         case '!':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_NE, "!=", line, column);
+                return lexer_make_token(lexer, TOKEN_NE, start, line, column);
             }
-            return token_create(TOKEN_ERROR, "!", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_NOT, start, line, column);
+        
         case '<':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_LE, "<=", line, column);
+                return lexer_make_token(lexer, TOKEN_LE, start, line, column);
             }
-            return token_create(TOKEN_LT, "<", line, column);
-            
+            if (lexer_current(lexer) == '<') {
+                lexer_advance(lexer);
+                return lexer_make_token(lexer, TOKEN_SHL, start, line, column);
+            }
+            return lexer_make_token(lexer, TOKEN_LT, start, line, column);
+        
         case '>':
             lexer_advance(lexer);
             if (lexer_current(lexer) == '=') {
                 lexer_advance(lexer);
-                return token_create(TOKEN_GE, ">=", line, column);
+                return lexer_make_token(lexer, TOKEN_GE, start, line, column);
+            }
+            if (lexer_current(lexer) == '>') {
+                lexer_advance(lexer);
+                return lexer_make_token(lexer, TOKEN_SHR, start, line, column);
             }
-            return token_create(TOKEN_GT, ">", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_GT, start, line, column);
+        
         case '(':
             lexer_advance(lexer);
-            return token_create(TOKEN_LPAREN, "(", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_LPAREN, start, line, column);
+        
         case ')':
             lexer_advance(lexer);
-            return token_create(TOKEN_RPAREN, ")", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_RPAREN, start, line, column);
+        
         case '{':
             lexer_advance(lexer);
-            return token_create(TOKEN_LBRACE, "{", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_LBRACE, start, line, column);
+        
         case '}':
             lexer_advance(lexer);
-            return token_create(TOKEN_RBRACE, "}", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_RBRACE, start, line, column);
+        
         case '[':
             lexer_advance(lexer);
-            return token_create(TOKEN_LBRACKET, "[", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_LBRACKET, start, line, column);
+        
         case ']':
             lexer_advance(lexer);
-            return token_create(TOKEN_RBRACKET, "]", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_RBRACKET, start, line, column);
+        
         case ',':
-        case '،':
             lexer_advance(lexer);
-            return token_create(TOKEN_COMMA, "،", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_COMMA, start, line, column);
+        
         case ';':
-        case '؛':
             lexer_advance(lexer);
-            return token_create(TOKEN_SEMICOLON, "؛", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_SEMICOLON, start, line, column);
+        
         case ':':
             lexer_advance(lexer);
-            return token_create(TOKEN_COLON, ":", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_COLON, start, line, column);
+        
         case '.':
             lexer_advance(lexer);
-            return token_create(TOKEN_DOT, ".", line, column);
-            
+            return lexer_make_token(lexer, TOKEN_DOT, start, line, column);
+        
         default:
             lexer_advance(lexer);
-            return token_create(TOKEN_ERROR, "?", line, column);
+            return lexer_make_token(lexer, TOKEN_ERROR, start, line, column);
     }
 }
 
 /* تحليل المصدر إلى رموز */
-token_t** lexer_tokenize(lexer_t* lexer, size_t* count) {
+token_t* lexer_tokenize(lexer_t* lexer, size_t* count) {
     while (lexer->position < lexer->length) {
         lexer_skip_whitespace(lexer);
-        lexer_skip_comment(lexer);
-        lexer_skip_whitespace(lexer);
+        while (lexer_current(lexer) == '#') {
+            lexer_skip_comment(lexer);
+            lexer_skip_whitespace(lexer);
+        }
         
         if (lexer->position >= lexer->length) break;
         
         char c = lexer_current(lexer);
-        token_t* token = NULL;
+        token_t token;
+        
+        unsigned char cls = char_class[(unsigned char)c];
         
-        if (isdigit(c)) {
+        if (cls & CC_DIGIT) {
             token = lexer_read_number(lexer);
         } else if (c == '"' || c == '\'') {
             token = lexer_read_string(lexer);
-        } else if (isalpha(c) || c == '_') {
+        } else if (cls & CC_WORD) {
             token = lexer_read_identifier(lexer);
+        } else if (cls & CC_SPECIAL) {
+            token = lexer_read_utf8(lexer);
         } else {
             token = lexer_read_operator(lexer);
         }
         
-        if (token) {
-            if (lexer->token_count >= lexer->token_capacity) {
-                lexer->token_capacity *= 2;
-                lexer->tokens = (token_t**)realloc(lexer->tokens, sizeof(token_t*) * lexer->token_capacity);
-            }
-            lexer->tokens[lexer->token_count++] = token;
+        /* تبقى خانة لرمز النهاية */
+        if (lexer->token_count + 1 >= lexer->token_capacity) {
+            lexer->token_capacity *= 2;
+            lexer->tokens = (token_t*)realloc(lexer->tokens, sizeof(token_t) * lexer->token_capacity);
         }
+        lexer->tokens[lexer->token_count++] = token;
     }
     
     /* إضافة رمز النهاية */
-    token_t* eof = token_create(TOKEN_EOF, NULL, lexer->line, lexer->column);
-    if (lexer->token_count >= lexer->token_capacity) {
-        lexer->token_capacity++;
-        lexer->tokens = (token_t**)realloc(lexer->tokens, sizeof(token_t*) * lexer->token_capacity);
-    }
-    lexer->tokens[lexer->token_count++] = eof;
+    lexer->tokens[lexer->token_count++] = token_create(TOKEN_EOF, lexer->source + lexer->length, 0,
+                                                       lexer->line, lexer->column);
     
     if (count) *count = lexer->token_count;
     return lexer->tokens;
 }
 
+/* الرمز التالي للمحلل اللغوي (يُحلَّل المصدر عند أول طلب) */
+token_t* lexer_next_token(lexer_t* lexer) {
+    if (lexer->token_count == 0) {
+        lexer_tokenize(lexer, NULL);
+    }
+    token_t* token = &lexer->tokens[lexer->current_token];
+    /* نبقى على رمز النهاية بعد الوصول إليه */
+    if (lexer->current_token + 1 < lexer->token_count) {
+        lexer->current_token++;
+    }
+    return token;
+}
+
+/* نظرة للأمام على الرموز دون استهلاكها (0 = الرمز التالي) */
+token_t* lexer_peek_token(lexer_t* lexer, int offset) {
+    if (lexer->token_count == 0) {
+        lexer_tokenize(lexer, NULL);
+    }
+    size_t index = lexer->current_token + (size_t)offset;
+    if (index >= lexer->token_count) {
+        index = lexer->token_count - 1;
+    }
+    return &lexer->tokens[index];
+}
+
 /* اسم نوع الرمز */
 const char* token_type_name(token_type_t type) {
     switch (type) {
@@ -405,6 +812,13 @@ const char* token_type_name(token_type_t type) {
         case TOKEN_SLASH: return "SLASH";
         case TOKEN_PERCENT: return "PERCENT";
         case TOKEN_POWER: return "POWER";
+        case TOKEN_INC: return "INC";
+        case TOKEN_DEC: return "DEC";
+        case TOKEN_BIT_AND: return "BIT_AND";
+        case TOKEN_BIT_OR: return "BIT_OR";
+        case TOKEN_BIT_XOR: return "BIT_XOR";
+        case TOKEN_SHL: return "SHL";
+        case TOKEN_SHR: return "SHR";
         case TOKEN_AND: return "AND";
         case TOKEN_OR: return "OR";
         case TOKEN_NOT: return "NOT";
@@ -430,6 +844,7 @@ const char* token_type_name(token_type_t type) {
         case TOKEN_COLON: return "COLON";
         case TOKEN_DOT: return "DOT";
         case TOKEN_ARROW: return "ARROW";
+        case TOKEN_QUESTION: return "QUESTION";
         case TOKEN_EOF: return "EOF";
         case TOKEN_ERROR: return "ERROR";
         default: return "UNKNOWN";
@@ -46,7 +46,16 @@ typedef enum {
     TOKEN_STAR,          /* * */
     TOKEN_SLASH,         /* / */
     TOKEN_PERCENT,       /* % */
-    TOKEN_POWER,         /* ** */
+    TOKEN_POWER,         /* ** أو ^ */
+    TOKEN_INC,           /* ++ */
+    TOKEN_DEC,           /* -- */
+    
+    /* العمليات الثنائية على البتات */
+    TOKEN_BIT_AND,       /* & */
+    TOKEN_BIT_OR,        /* | */
+    TOKEN_BIT_XOR,       /* ~ */
+    TOKEN_SHL,           /* << */
+    TOKEN_SHR,           /* >> */
     
     /* العمليات المنطقية */
     TOKEN_AND,           /* و */
@@ -81,17 +90,20 @@ typedef enum {
     TOKEN_SEMICOLON,     /* ؛ */
     TOKEN_COLON,         /* : */
     TOKEN_DOT,           /* . */
-    TOKEN_ARROW,         /* -> */
+    TOKEN_ARROW,         /* -> أو => */
+    TOKEN_QUESTION,      /* ? */
     
     /* نهاية الملف */
     TOKEN_EOF,
     TOKEN_ERROR
 } token_type_t;
 
-/* هيكل الرمز */
+/* هيكل الرمز: نصه شريحة من المصدر دون نسخ ولا ينتهي بـ '\0'.
+ * النصوص التي فيها تسلسلات هروب وحدها تُفك في نسخة يملكها المعجم */
 typedef struct {
+    const char* start;
+    uint32_t length;
     token_type_t type;
-    char* value;
     int line;
     int column;
 } token_t;
@@ -103,19 +115,24 @@ typedef struct {
     size_t position;
     int line;
     int column;
-    token_t** tokens;
+    token_t* tokens;        /* مصفوفة متصلة؛ المؤشرات إليها ثابتة بعد التحليل */
     size_t token_count;
     size_t token_capacity;
+    size_t current_token;   /* مؤشر القراءة للمحلل اللغوي */
+    char** escaped;         /* نصوص الهروب المفكوكة */
+    size_t escaped_count;
+    size_t escaped_capacity;
 } lexer_t;
 
 /* دوال المعجم */
 lexer_t* lexer_create(const char* source);
 void lexer_destroy(lexer_t* lexer);
-token_t** lexer_tokenize(lexer_t* lexer, size_t* count);
+token_t* lexer_tokenize(lexer_t* lexer, size_t* count);
+token_t* lexer_next_token(lexer_t* lexer);
+token_t* lexer_peek_token(lexer_t* lexer, int offset);
 
 /* دوال الرموز */
-token_t* token_create(token_type_t type, const char* value, int line, int column);
-void token_destroy(token_t* token);
+token_t token_create(token_type_t type, const char* start, size_t length, int line, int column);
 const char* token_type_name(token_type_t type);
 
 /* دوال مساعدة */
@@ -125,11 +142,11 @@ void lexer_advance(lexer_t* lexer);
 void lexer_skip_whitespace(lexer_t* lexer);
 void lexer_skip_comment(lexer_t* lexer);
 
-token_t* lexer_read_number(lexer_t* lexer);
-token_t* lexer_read_string(lexer_t* lexer);
-token_t* lexer_read_identifier(lexer_t* lexer);
-token_t* lexer_read_operator(lexer_t* lexer);
+token_t lexer_read_number(lexer_t* lexer);
+token_t lexer_read_string(lexer_t* lexer);
+token_t lexer_read_identifier(lexer_t* lexer);
+token_t lexer_read_operator(lexer_t* lexer);
 
-token_type_t lexer_keyword_type(const char* word);
+token_type_t lexer_keyword_type(const char* word, size_t length);
 
 #endif /* SEEKEP_LEXER_H */
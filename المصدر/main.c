@@ -12,6 +12,9 @@
 #include "lexer.h"
 #include "parser.h"
 #include "compiler.h"
+#include "optimizer.h"
+#include "bytecode.h"
+#include "regvm.h"
 
 #define VERSION "1.0.0"
 #define MAX_INPUT_SIZE 65536
@@ -30,13 +33,27 @@ static void print_help(const char* program) {
     printf("  -o, --output      ملف الإخراج\n");
     printf("  -a, --ast         طباعة شجرة البنية المجردة\n");
     printf("  -b, --bytecode    طباعة البايتكود\n");
+    printf("  -O, -O<n>         مستوى التحسين: -O0 بلا تحسين (افتراضي)، -O1 طي الثوابت،\n");
+    printf("                    -O2 (أو -O) وتحسين البايتكود بعد الترجمة\n");
+    printf("  --no-cache        عدم استعمال ذاكرة الترجمة __skpcache__\n");
+    printf("  --reg             التنفيذ بالجهاز السجلي بدل المكدسي. البرنامج الذي فيه أصناف أو\n");
+    printf("                    خصائص أو استدعاء طرق أو إغلاقات تلتقط متغيرات محلية يُنفذ كله\n");
+    printf("                    بالجهاز المكدسي بعد ملاحظة على stderr، بالمخرج نفسه\n");
+    printf("  --gc-stats        طباعة إحصاءات جمع القمامة ومدرج التوقفات عند الخروج\n");
+    printf("  --gc-pause <us>   أقصى توقف لخطوة الجمع التدريجي بالميكروثانية (%d افتراضياً)؛\n",
+           SKP_GC_PAUSE_BUDGET_US);
+    printf("                    جمع الحضانة خارجها ويحده حجمها، وتوقفاته تُحصى وحدها،\n");
+    printf("                    وكذلك الدورات التي أُتم تعليمها دون ميزانية\n");
     printf("\n");
     printf("الأمثلة:\n");
     printf("  %s برنامج.سكيب          تشغيل ملف SEEKEP\n", program);
     printf("  %s -i                   وضع تفاعلي\n", program);
     printf("  %s -c برنامج.سكيب       ترجمة فقط\n", program);
+    printf("  %s برنامج.skpbc         تشغيل بايتكود مترجم\n", program);
     printf("  %s -a برنامج.سكيب       طباعة AST\n", program);
     printf("  %s -b برنامج.سكيب       طباعة البايتكود\n", program);
+    printf("  %s -O -b برنامج.سكيب    طباعة البايتكود بعد التحسين\n", program);
+    printf("  %s --reg -b برنامج.سكيب طباعة التعليمات السجلية\n", program);
 }
 
 /* عرض الإصدار */
@@ -80,56 +97,52 @@ static char* read_file(const char* path) {
     return buffer;
 }
 
-/* كتابة بايتكود إلى ملف */
-static int write_bytecode(chunk_t* chunk, const char* path) {
-    FILE* file = fopen(path, "wb");
-    if (!file) {
-        fprintf(stderr, "خطأ: لا يمكن إنشاء الملف '%s'\n", path);
-        return 0;
+/* تشغيل كتلة محملة من ملف بايتكود أو من ذاكرة الترجمة */
+static int run_loaded_chunk(skp_vm_t* vm, chunk_t* chunk, const char* path, int print_bytecode) {
+    if (print_bytecode) {
+        printf("=== البايتكود ===\n");
+        chunk_disassemble(chunk, path);
+        printf("\n");
     }
     
-    /* كتابة التوقيع والإصدار */
-    fwrite("SKPB", 1, 4, file);
-    uint8_t version[3] = {1, 0, 0};
-    fwrite(version, 1, 3, file);
+    skp_result_t result = vm_run(vm, chunk);
     
-    /* كتابة حجم البايتكود */
-    fwrite(&chunk->count, sizeof(size_t), 1, file);
-    fwrite(chunk->code, 1, chunk->count, file);
+    chunk_free(chunk);
+    free(chunk);
     
-    /* كتابة الثوابت */
-    fwrite(&chunk->constant_count, sizeof(size_t), 1, file);
-    for (size_t i = 0; i < chunk->constant_count; i++) {
-        constant_t* c = &chunk->constants[i];
-        fwrite(&c->type, sizeof(skp_type_t), 1, file);
-        
-        switch (c->type) {
-            case SKP_TYPE_INT:
-                fwrite(&c->value.int_val, sizeof(skp_int), 1, file);
-                break;
-            case SKP_TYPE_FLOAT:
-                fwrite(&c->value.float_val, sizeof(skp_float), 1, file);
-                break;
-            case SKP_TYPE_STRING:
-                size_t len = strlen(c->value.string_val);
-                fwrite(&len, sizeof(size_t), 1, file);
-                fwrite(c->value.string_val, 1, len, file);
-                break;
-            default:
-                break;
-        }
+    if (result == SKP_RUNTIME_ERROR) {
+        fprintf(stderr, "خطأ زمني\n");
+        return 1;
     }
     
-    fclose(file);
-    return 1;
+    return 0;
 }
 
 /* تشغيل ملف */
 static int run_file(skp_vm_t* vm, const char* path, int debug, int compile_only, 
-                    const char* output_path, int print_ast, int print_bytecode) {
+                    const char* output_path, int print_ast, int print_bytecode,
+                    int optimize, int use_cache, int registers) {
+    if (!compile_only && bytecode_is_file(path)) {
+        chunk_t* chunk = bytecode_load(path, vm->globals);
+        return chunk ? run_loaded_chunk(vm, chunk, path, print_bytecode) : 1;
+    }
+    
     char* source = read_file(path);
     if (!source) return 1;
     
+    /* نسخة مترجمة من المصدر نفسه تغني عن المعجم والمحلل والمترجم. التحميل
+     * يتحقق منها كما يتحقق من أي صورة، وما لا يجتازه يُترجم من المصدر
+     * وتُكتب فوقه نسخة جديدة */
+    use_cache = use_cache && !compile_only && !registers;
+    uint64_t source_key = use_cache ? bytecode_source_key(source, strlen(source), optimize) : 0;
+    if (use_cache && !print_ast) {
+        chunk_t* chunk = bytecode_cache_load(path, optimize, source_key, vm->globals);
+        if (chunk) {
+            free(source);
+            return run_loaded_chunk(vm, chunk, path, print_bytecode);
+        }
+    }
+    
     /* إنشاء الليكسر */
     lexer_t* lexer = lexer_create(source);
     if (!lexer) {
@@ -150,13 +163,15 @@ static int run_file(skp_vm_t* vm, const char* path, int debug, int compile_only,
     
     if (parser->had_error) {
         fprintf(stderr, "خطأ في التحليل اللغوي\n");
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         free(source);
         return 1;
     }
     
+    /* التحسين على الشجرة قبل الترجمة */
+    ast = optimizer_run(&parser->arena, ast, optimize);
+    
     /* طباعة AST إذا طُلب */
     if (print_ast) {
         printf("=== شجرة البنية المجردة ===\n");
@@ -164,15 +179,40 @@ static int run_file(skp_vm_t* vm, const char* path, int debug, int compile_only,
         printf("\n");
     }
     
+    /* الجهاز السجلي إن طُلب؛ وإن لم يُترجم له البرنامج يتولاه المكدسي */
+    if (registers && !compile_only) {
+        reg_proto_t* proto = reg_compile(ast, vm->globals);
+        if (proto) {
+            if (print_bytecode) {
+                printf("=== التعليمات السجلية ===\n");
+                reg_disassemble(proto, path);
+                printf("\n");
+            }
+            
+            skp_result_t result = reg_run(vm, proto);
+            
+            reg_proto_free(proto);
+            parser_destroy(parser);
+            lexer_destroy(lexer);
+            free(source);
+            
+            if (result == SKP_RUNTIME_ERROR) {
+                fprintf(stderr, "خطأ زمني\n");
+                return 1;
+            }
+            return 0;
+        }
+    }
+    
     /* إنشاء المترجم */
-    skp_compiler_t* compiler = compiler_create(parser);
+    skp_compiler_t* compiler = compiler_create(parser, vm->globals);
     if (!compiler) {
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         free(source);
         return 1;
     }
+    compiler_bind_globals(compiler, vm->global_values, vm->global_capacity);
     
     /* الترجمة */
     chunk_t* chunk = compiler_compile(compiler, ast);
@@ -184,13 +224,15 @@ static int run_file(skp_vm_t* vm, const char* path, int debug, int compile_only,
             free(chunk);
         }
         compiler_destroy(compiler);
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         free(source);
         return 1;
     }
     
+    /* التحسين على البايتكود بعد الترجمة */
+    optimizer_chunk(chunk, optimize);
+    
     /* طباعة البايتكود إذا طُلب */
     if (print_bytecode) {
         printf("=== البايتكود ===\n");
@@ -201,20 +243,23 @@ static int run_file(skp_vm_t* vm, const char* path, int debug, int compile_only,
     /* ترجمة فقط */
     if (compile_only) {
         const char* out_path = output_path ? output_path : "output.skpbc";
-        if (write_bytecode(chunk, out_path)) {
+        if (bytecode_write(chunk, vm->globals, out_path)) {
             printf("تم حفظ البايتكود في: %s\n", out_path);
         }
         
         chunk_free(chunk);
         free(chunk);
         compiler_destroy(compiler);
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         free(source);
         return 0;
     }
     
+    if (use_cache) {
+        bytecode_cache_store(path, optimize, source_key, chunk, vm->globals);
+    }
+    
     /* التشغيل */
     skp_result_t result = vm_run(vm, chunk);
     
@@ -222,7 +267,6 @@ static int run_file(skp_vm_t* vm, const char* path, int debug, int compile_only,
     chunk_free(chunk);
     free(chunk);
     compiler_destroy(compiler);
-    ast_destroy_node(ast);
     parser_destroy(parser);
     lexer_destroy(lexer);
     free(source);
@@ -284,6 +328,11 @@ int main(int argc, char* argv[]) {
     int interactive = 0;
     int print_ast = 0;
     int print_bytecode = 0;
+    int gc_stats = 0;
+    int optimize = SKP_OPTIMIZE_NONE;
+    int use_cache = 1;
+    int registers = 0;
+    long gc_pause = -1;
     char* output_path = NULL;
     char* input_file = NULL;
     
@@ -324,6 +373,44 @@ int main(int argc, char* argv[]) {
             continue;
         }
         
+        if (strcmp(argv[i], "--gc-stats") == 0) {
+            gc_stats = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "-O") == 0) {
+            optimize = SKP_OPTIMIZE_MAX;
+            continue;
+        }
+        
+        if (strncmp(argv[i], "-O", 2) == 0 && argv[i][2] >= '0' && argv[i][2] <= '9' &&
+            argv[i][3] == '\0') {
+            optimize = argv[i][2] - '0';
+            if (optimize > SKP_OPTIMIZE_MAX) optimize = SKP_OPTIMIZE_MAX;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--no-cache") == 0) {
+            use_cache = 0;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--reg") == 0) {
+            registers = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--gc-pause") == 0) {
+            if (i + 1 < argc) {
+                gc_pause = strtol(argv[++i], NULL, 10);
+            }
+            if (gc_pause <= 0) {
+                fprintf(stderr, "خطأ: --gc-pause يتطلب عدداً موجباً من الميكروثواني\n");
+                return 1;
+            }
+            continue;
+        }
+        
         if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
             if (i + 1 < argc) {
                 output_path = argv[++i];
@@ -349,12 +436,17 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (gc_pause > 0) {
+        vm->gc_pause_budget = (uint64_t)gc_pause * 1000;
+    }
+    
     int result = 0;
     
     /* تشغيل الملف أو الوضع التفاعلي */
     if (input_file) {
         result = run_file(vm, input_file, debug, compile_only, 
-                         output_path, print_ast, print_bytecode);
+                         output_path, print_ast, print_bytecode, optimize, use_cache,
+                         registers);
     } else if (interactive || argc == 1) {
         run_repl(vm);
     } else {
@@ -362,6 +454,10 @@ int main(int argc, char* argv[]) {
         result = 1;
     }
     
+    if (gc_stats) {
+        vm_print_gc_stats(vm, stderr);
+    }
+    
     /* تنظيف */
     vm_destroy(vm);
     
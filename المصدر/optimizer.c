@@ -0,0 +1,956 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * المحسّن (Optimizer) - AST and Bytecode Optimizer Implementation
+ *
+ * طي التعبيرات الثابتة وحذف الفروع الميتة قبل الترجمة، ثم تحسين نافذي
+ * على البايتكود بعدها
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "optimizer.h"
+
+/* أطول نص يُنتجه تكرار نص ثابت عند الطي؛ ما زاد يُترك لوقت التشغيل
+ * فلا يتضخم ملف البايتكود */
+#define MAX_FOLDED_REPEAT 4096
+
+/* قيمة ثابتة معروفة وقت الترجمة */
+typedef enum {
+    FOLD_NONE,          /* ليست ثابتة */
+    FOLD_INT,
+    FOLD_FLOAT,
+    FOLD_STRING,
+    FOLD_BOOL,
+    FOLD_NULL
+} fold_kind_t;
+
+typedef struct {
+    fold_kind_t kind;
+    skp_int int_val;
+    skp_float float_val;
+    const char* chars;
+    size_t length;
+} fold_value_t;
+
+/* ========== القيم الثابتة ========== */
+
+/* قيمة العقدة الحرفية، بالتحويل نفسه الذي يجريه compile_expression */
+static fold_value_t literal_value(ast_node_t* node) {
+    fold_value_t value;
+    memset(&value, 0, sizeof(value));
+    
+    switch (node->type) {
+        case AST_NUMBER: {
+            const char* text = node->data.number.value;
+            if (strchr(text, '.') || strchr(text, 'e') || strchr(text, 'E')) {
+                value.kind = FOLD_FLOAT;
+                value.float_val = strtod(text, NULL);
+            } else {
+                value.kind = FOLD_INT;
+                value.int_val = strtoll(text, NULL, 10);
+            }
+            break;
+        }
+        case AST_STRING:
+            value.kind = FOLD_STRING;
+            value.chars = node->data.string.value;
+            value.length = strlen(value.chars);
+            break;
+        case AST_BOOLEAN:
+            value.kind = FOLD_BOOL;
+            value.int_val = node->data.boolean.value != 0;
+            break;
+        case AST_NULL:
+            value.kind = FOLD_NULL;
+            break;
+        default:
+            value.kind = FOLD_NONE;
+            break;
+    }
+    
+    return value;
+}
+
+/* عقدة حرفية تحل محل node، أو NULL إن تعذر تمثيل القيمة بحرفية */
+static ast_node_t* literal_node(ast_arena_t* arena, ast_node_t* node, fold_value_t value) {
+    char text[64];
+    
+    switch (value.kind) {
+        case FOLD_INT:
+            snprintf(text, sizeof(text), "%lld", (long long)value.int_val);
+            return ast_create_number(arena, ast_arena_strndup(arena, text, strlen(text)),
+                                     node->line, node->column);
+        
+        case FOLD_FLOAT: {
+            /* لا حرفية للانهاية ولا لـ NaN */
+            if (!isfinite(value.float_val)) return NULL;
+            
+            /* أقصر صيغة تعيد العدد نفسه (17 رقماً تكفي دائماً)، والنقطة
+             * تُبقيه عشرياً عند الترجمة */
+            for (int digits = 15; digits <= 17; digits++) {
+                snprintf(text, sizeof(text), "%.*g", digits, value.float_val);
+                if (strtod(text, NULL) == value.float_val) break;
+            }
+            if (!strpbrk(text, ".eE")) strcat(text, ".0");
+            return ast_create_number(arena, ast_arena_strndup(arena, text, strlen(text)),
+                                     node->line, node->column);
+        }
+        
+        case FOLD_STRING:
+            return ast_create_string(arena, ast_arena_strndup(arena, value.chars, value.length),
+                                     node->line, node->column);
+        
+        case FOLD_BOOL:
+            return ast_create_boolean(arena, (int)value.int_val, node->line, node->column);
+        
+        case FOLD_NULL:
+            return ast_create_null(arena, node->line, node->column);
+        
+        default:
+            return NULL;
+    }
+}
+
+static int is_number(fold_value_t value) {
+    return value.kind == FOLD_INT || value.kind == FOLD_FLOAT;
+}
+
+static skp_float as_number(fold_value_t value) {
+    return value.kind == FOLD_INT ? (skp_float)value.int_val : value.float_val;
+}
+
+/* كـ skp_to_bool */
+static int truthy(fold_value_t value) {
+    switch (value.kind) {
+        case FOLD_INT: return value.int_val != 0;
+        case FOLD_FLOAT: return value.float_val != 0.0;
+        case FOLD_BOOL: return (int)value.int_val;
+        case FOLD_STRING: return value.length != 0;
+        case FOLD_NULL: return 0;
+        default: return 1;
+    }
+}
+
+/* كـ skp_to_int؛ يفشل حيث يكون التحويل غير معرف في C */
+static int to_int(fold_value_t value, skp_int* out) {
+    switch (value.kind) {
+        case FOLD_INT:
+        case FOLD_BOOL:
+            *out = value.int_val;
+            return 1;
+        case FOLD_FLOAT:
+            if (!(value.float_val > -9.2e18 && value.float_val < 9.2e18)) return 0;
+            *out = (skp_int)value.float_val;
+            return 1;
+        case FOLD_STRING:
+            *out = atoll(value.chars);
+            return 1;
+        case FOLD_NULL:
+            *out = 0;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static fold_value_t int_value(skp_int n) {
+    fold_value_t value = { FOLD_INT, n, 0, NULL, 0 };
+    return value;
+}
+
+static fold_value_t float_value(skp_float f) {
+    fold_value_t value = { FOLD_FLOAT, 0, f, NULL, 0 };
+    return value;
+}
+
+static fold_value_t bool_value(int b) {
+    fold_value_t value = { FOLD_BOOL, b != 0, 0, NULL, 0 };
+    return value;
+}
+
+static fold_value_t no_value(void) {
+    fold_value_t value = { FOLD_NONE, 0, 0, NULL, 0 };
+    return value;
+}
+
+/* ========== العمليات ========== */
+
+/* عمليات الأعداد الصحيحة تُطوى فقط إن لم تفض، فالفيض سلوك الجهاز وحده */
+static int checked_add(skp_int a, skp_int b, skp_int* out) {
+    if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b)) return 0;
+    *out = a + b;
+    return 1;
+}
+
+static int checked_sub(skp_int a, skp_int b, skp_int* out) {
+    if ((b < 0 && a > INT64_MAX + b) || (b > 0 && a < INT64_MIN + b)) return 0;
+    *out = a - b;
+    return 1;
+}
+
+static int checked_mul(skp_int a, skp_int b, skp_int* out) {
+    if (a != 0 && b != 0) {
+        if (a == -1 && b == INT64_MIN) return 0;
+        if (b == -1 && a == INT64_MIN) return 0;
+        if (a > 0 ? (b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a)
+                  : (b > 0 ? a < INT64_MIN / b : a < INT64_MAX / b)) return 0;
+    }
+    *out = a * b;
+    return 1;
+}
+
+/* ترتيب نصين كـ string_compare في seekep.c */
+static int compare_strings(fold_value_t a, fold_value_t b) {
+    size_t common = a.length < b.length ? a.length : b.length;
+    int order = memcmp(a.chars, b.chars, common);
+    if (order != 0) return order;
+    if (a.length == b.length) return 0;
+    return a.length < b.length ? -1 : 1;
+}
+
+/* كـ skp_eq. النصوص الثابتة كلها محتجزة، فتساويها تساوي محتواها */
+static int values_equal(fold_value_t a, fold_value_t b) {
+    if (is_number(a) && is_number(b)) {
+        if (a.kind == FOLD_INT && b.kind == FOLD_INT) return a.int_val == b.int_val;
+        return as_number(a) == as_number(b);
+    }
+    if (a.kind != b.kind) return 0;
+    
+    switch (a.kind) {
+        case FOLD_BOOL: return a.int_val == b.int_val;
+        case FOLD_STRING: return a.length == b.length && memcmp(a.chars, b.chars, a.length) == 0;
+        case FOLD_NULL: return 1;
+        default: return 0;
+    }
+}
+
+/* كـ skp_lt و skp_gt: غير الأعداد والنصوص ليست أصغر ولا أكبر */
+static int value_order(fold_value_t a, fold_value_t b, int* order) {
+    if (a.kind == FOLD_INT && b.kind == FOLD_INT) {
+        *order = (a.int_val > b.int_val) - (a.int_val < b.int_val);
+        return 1;
+    }
+    if (is_number(a) && is_number(b)) {
+        skp_float x = as_number(a);
+        skp_float y = as_number(b);
+        if (x != x || y != y) return 0;
+        *order = (x > y) - (x < y);
+        return 1;
+    }
+    if (a.kind == FOLD_STRING && b.kind == FOLD_STRING) {
+        int result = compare_strings(a, b);
+        *order = (result > 0) - (result < 0);
+        return 1;
+    }
+    return 0;
+}
+
+static fold_value_t fold_binary(ast_arena_t* arena, binop_type_t op, fold_value_t a, fold_value_t b) {
+    skp_int n;
+    int order;
+    
+    switch (op) {
+        case BINOP_ADD:
+            if (a.kind == FOLD_INT && b.kind == FOLD_INT) {
+                return checked_add(a.int_val, b.int_val, &n) ? int_value(n) : no_value();
+            }
+            if (is_number(a) && is_number(b)) return float_value(as_number(a) + as_number(b));
+            if (a.kind == FOLD_STRING && b.kind == FOLD_STRING) {
+                char* chars = (char*)ast_arena_alloc(arena, a.length + b.length + 1);
+                memcpy(chars, a.chars, a.length);
+                memcpy(chars + a.length, b.chars, b.length);
+                chars[a.length + b.length] = '\0';
+                fold_value_t value = { FOLD_STRING, 0, 0, chars, a.length + b.length };
+                return value;
+            }
+            return no_value();
+        
+        case BINOP_SUB:
+            if (a.kind == FOLD_INT && b.kind == FOLD_INT) {
+                return checked_sub(a.int_val, b.int_val, &n) ? int_value(n) : no_value();
+            }
+            if (is_number(a) && is_number(b)) return float_value(as_number(a) - as_number(b));
+            return no_value();
+        
+        case BINOP_MUL:
+            if (a.kind == FOLD_INT && b.kind == FOLD_INT) {
+                return checked_mul(a.int_val, b.int_val, &n) ? int_value(n) : no_value();
+            }
+            if (is_number(a) && is_number(b)) return float_value(as_number(a) * as_number(b));
+            if (a.kind == FOLD_STRING && b.kind == FOLD_INT) {
+                size_t times = b.int_val > 0 && a.length > 0 ? (size_t)b.int_val : 0;
+                if (times > MAX_FOLDED_REPEAT / (a.length ? a.length : 1)) return no_value();
+                
+                char* chars = (char*)ast_arena_alloc(arena, a.length * times + 1);
+                for (size_t i = 0; i < times; i++) {
+                    memcpy(chars + a.length * i, a.chars, a.length);
+                }
+                chars[a.length * times] = '\0';
+                fold_value_t value = { FOLD_STRING, 0, 0, chars, a.length * times };
+                return value;
+            }
+            return no_value();
+        
+        case BINOP_DIV:
+            /* القسمة عشرية دائماً، والقسمة على صفر خطأ وقت التشغيل */
+            if (!is_number(a) || !is_number(b) || as_number(b) == 0) return no_value();
+            return float_value(as_number(a) / as_number(b));
+        
+        case BINOP_MOD:
+            if (!is_number(a) || !is_number(b) || as_number(b) == 0) return no_value();
+            if (a.kind == FOLD_INT && b.kind == FOLD_INT) {
+                if (a.int_val == INT64_MIN && b.int_val == -1) return no_value();
+                return int_value(a.int_val % b.int_val);
+            }
+            return float_value(fmod(as_number(a), as_number(b)));
+        
+        case BINOP_POW:
+            if (!is_number(a) || !is_number(b)) return no_value();
+            if (a.kind == FOLD_INT && b.kind == FOLD_INT && b.int_val >= 0) {
+                /* الأساسات 0 و1 و-1 وحدها تحتمل أسساً كبيرة دون فيض */
+                if (b.int_val == 0) return int_value(1);
+                if (a.int_val == 0 || a.int_val == 1) return int_value(a.int_val);
+                if (a.int_val == -1) return int_value((b.int_val & 1) ? -1 : 1);
+                
+                skp_int result = 1;
+                for (skp_int i = 0; i < b.int_val; i++) {
+                    if (!checked_mul(result, a.int_val, &result)) return no_value();
+                }
+                return int_value(result);
+            }
+            return float_value(pow(as_number(a), as_number(b)));
+        
+        case BINOP_EQ:
+            return bool_value(values_equal(a, b));
+        
+        case BINOP_NE:
+            return bool_value(!values_equal(a, b));
+        
+        case BINOP_LT:
+            return bool_value(value_order(a, b, &order) && order < 0);
+        
+        case BINOP_GT:
+            return bool_value(value_order(a, b, &order) && order > 0);
+        
+        case BINOP_LE:
+            return bool_value((value_order(a, b, &order) && order < 0) || values_equal(a, b));
+        
+        case BINOP_GE:
+            return bool_value((value_order(a, b, &order) && order > 0) || values_equal(a, b));
+        
+        /* الجهاز يقيّم الطرفين دائماً، فلا يُطوى إلا إن كانا ثابتين معاً */
+        case BINOP_AND:
+            return bool_value(truthy(a) && truthy(b));
+        
+        case BINOP_OR:
+            return bool_value(truthy(a) || truthy(b));
+        
+        case BINOP_BIT_AND:
+        case BINOP_BIT_OR:
+        case BINOP_BIT_XOR:
+        case BINOP_SHL:
+        case BINOP_SHR: {
+            skp_int x, y;
+            if (!to_int(a, &x) || !to_int(b, &y)) return no_value();
+            
+            switch (op) {
+                case BINOP_BIT_AND: return int_value(x & y);
+                case BINOP_BIT_OR: return int_value(x | y);
+                case BINOP_BIT_XOR: return int_value(x ^ y);
+                case BINOP_SHL: return int_value(skp_int_shl(x, y));
+                default: return int_value(skp_int_shr(x, y));
+            }
+        }
+        
+        default:
+            return no_value();
+    }
+}
+
+static fold_value_t fold_unary(unop_type_t op, fold_value_t a) {
+    skp_int n;
+    
+    switch (op) {
+        case UNOP_NEG:
+            if (a.kind == FOLD_INT) return a.int_val == INT64_MIN ? no_value() : int_value(-a.int_val);
+            if (a.kind == FOLD_FLOAT) return float_value(-a.float_val);
+            return no_value();
+        
+        case UNOP_NOT:
+            return bool_value(!truthy(a));
+        
+        case UNOP_BIT_NOT:
+            return to_int(a, &n) ? int_value(~n) : no_value();
+        
+        default:
+            return no_value();
+    }
+}
+
+/* ========== المرور على الشجرة ========== */
+
+static ast_node_t* optimize(ast_arena_t* arena, ast_node_t* node);
+
+static void optimize_list(ast_arena_t* arena, ast_node_t** nodes, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        nodes[i] = optimize(arena, nodes[i]);
+    }
+}
+
+/* كتلة فارغة مكان عبارة حُذفت */
+static ast_node_t* empty_block(ast_arena_t* arena, ast_node_t* node) {
+    return ast_create_block(arena, NULL, 0, node->line, node->column);
+}
+
+static ast_node_t* optimize(ast_arena_t* arena, ast_node_t* node) {
+    if (!node) return NULL;
+    
+    switch (node->type) {
+        case AST_BINARY_OP: {
+            node->data.binary_op.left = optimize(arena, node->data.binary_op.left);
+            node->data.binary_op.right = optimize(arena, node->data.binary_op.right);
+            
+            fold_value_t a = literal_value(node->data.binary_op.left);
+            fold_value_t b = literal_value(node->data.binary_op.right);
+            if (a.kind == FOLD_NONE || b.kind == FOLD_NONE) return node;
+            
+            ast_node_t* folded = literal_node(arena, node, fold_binary(arena, node->data.binary_op.op, a, b));
+            return folded ? folded : node;
+        }
+        
+        case AST_UNARY_OP: {
+            node->data.unary_op.operand = optimize(arena, node->data.unary_op.operand);
+            
+            fold_value_t a = literal_value(node->data.unary_op.operand);
+            if (a.kind == FOLD_NONE) return node;
+            
+            ast_node_t* folded = literal_node(arena, node, fold_unary(node->data.unary_op.op, a));
+            return folded ? folded : node;
+        }
+        
+        case AST_TERNARY: {
+            node->data.ternary.condition = optimize(arena, node->data.ternary.condition);
+            node->data.ternary.true_expr = optimize(arena, node->data.ternary.true_expr);
+            node->data.ternary.false_expr = optimize(arena, node->data.ternary.false_expr);
+            
+            fold_value_t condition = literal_value(node->data.ternary.condition);
+            if (condition.kind == FOLD_NONE) return node;
+            return truthy(condition) ? node->data.ternary.true_expr : node->data.ternary.false_expr;
+        }
+        
+        case AST_IF: {
+            node->data.if_stmt.condition = optimize(arena, node->data.if_stmt.condition);
+            node->data.if_stmt.then_branch = optimize(arena, node->data.if_stmt.then_branch);
+            node->data.if_stmt.else_branch = optimize(arena, node->data.if_stmt.else_branch);
+            
+            /* الفرع المختار يُترجم كما كان سيُترجم داخل إذا، بنطاقه نفسه */
+            fold_value_t condition = literal_value(node->data.if_stmt.condition);
+            if (condition.kind == FOLD_NONE) return node;
+            if (truthy(condition)) return node->data.if_stmt.then_branch;
+            return node->data.if_stmt.else_branch ? node->data.if_stmt.else_branch
+                                                  : empty_block(arena, node);
+        }
+        
+        case AST_ASSIGNMENT:
+            /* الهدف يُترك: الطي لا يصنع هدف تعيين */
+            if (node->data.assignment.target->type == AST_MEMBER_ACCESS) {
+                ast_node_t* target = node->data.assignment.target;
+                target->data.member_access.object = optimize(arena, target->data.member_access.object);
+            } else if (node->data.assignment.target->type == AST_INDEX_ACCESS) {
+                ast_node_t* target = node->data.assignment.target;
+                target->data.index_access.object = optimize(arena, target->data.index_access.object);
+                target->data.index_access.index = optimize(arena, target->data.index_access.index);
+            }
+            node->data.assignment.value = optimize(arena, node->data.assignment.value);
+            return node;
+        
+        case AST_CALL:
+            node->data.call.callee = optimize(arena, node->data.call.callee);
+            optimize_list(arena, node->data.call.args, node->data.call.arg_count);
+            return node;
+        
+        case AST_MEMBER_ACCESS:
+            node->data.member_access.object = optimize(arena, node->data.member_access.object);
+            return node;
+        
+        case AST_INDEX_ACCESS:
+            node->data.index_access.object = optimize(arena, node->data.index_access.object);
+            node->data.index_access.index = optimize(arena, node->data.index_access.index);
+            return node;
+        
+        case AST_LIST_LITERAL:
+            optimize_list(arena, node->data.list_literal.elements, node->data.list_literal.element_count);
+            return node;
+        
+        case AST_DICT_LITERAL:
+            optimize_list(arena, node->data.dict_literal.keys, node->data.dict_literal.entry_count);
+            optimize_list(arena, node->data.dict_literal.values, node->data.dict_literal.entry_count);
+            return node;
+        
+        case AST_LAMBDA:
+            node->data.lambda.body = optimize(arena, node->data.lambda.body);
+            return node;
+        
+        case AST_VAR_DECL:
+        case AST_CONST_DECL:
+            node->data.var_decl.initializer = optimize(arena, node->data.var_decl.initializer);
+            return node;
+        
+        case AST_FUNC_DECL:
+            if (node->data.func_decl.defaults) {
+                optimize_list(arena, node->data.func_decl.defaults, node->data.func_decl.param_count);
+            }
+            node->data.func_decl.body = optimize(arena, node->data.func_decl.body);
+            return node;
+        
+        case AST_CLASS_DECL:
+            optimize_list(arena, node->data.class_decl.members, node->data.class_decl.member_count);
+            return node;
+        
+        case AST_RETURN:
+            node->data.return_stmt.value = optimize(arena, node->data.return_stmt.value);
+            return node;
+        
+        case AST_WHILE:
+            node->data.while_stmt.condition = optimize(arena, node->data.while_stmt.condition);
+            node->data.while_stmt.body = optimize(arena, node->data.while_stmt.body);
+            return node;
+        
+        case AST_FOR:
+            node->data.for_stmt.init_expr = optimize(arena, node->data.for_stmt.init_expr);
+            node->data.for_stmt.condition = optimize(arena, node->data.for_stmt.condition);
+            node->data.for_stmt.increment = optimize(arena, node->data.for_stmt.increment);
+            node->data.for_stmt.body = optimize(arena, node->data.for_stmt.body);
+            return node;
+        
+        case AST_FOREACH:
+            node->data.foreach_stmt.iterable = optimize(arena, node->data.foreach_stmt.iterable);
+            node->data.foreach_stmt.body = optimize(arena, node->data.foreach_stmt.body);
+            return node;
+        
+        case AST_BLOCK:
+            optimize_list(arena, node->data.block.statements, node->data.block.statement_count);
+            return node;
+        
+        case AST_EXPRESSION_STMT:
+            node->data.expression_stmt.expression = optimize(arena, node->data.expression_stmt.expression);
+            return node;
+        
+        case AST_PROGRAM:
+            optimize_list(arena, node->data.program.statements, node->data.program.statement_count);
+            return node;
+        
+        default:
+            return node;
+    }
+}
+
+ast_node_t* optimizer_run(ast_arena_t* arena, ast_node_t* node, int level) {
+    if (level < SKP_OPTIMIZE_FOLD) return node;
+    return optimize(arena, node);
+}
+
+/* ========== تحسين البايتكود ========== */
+
+/* أقصى عدد من القفزات يُتبع عند ربط قفزة بهدفها النهائي */
+#define MAX_THREAD_HOPS 16
+
+/* أقصى عدد من جولات التحسين على الكتلة الواحدة */
+#define MAX_PEEPHOLE_ROUNDS 32
+
+/* تعليمة مفكوكة من الكتلة. هدف القفزة رقم تعليمة لا إزاحة، فتُحذف التعليمات
+ * وتُستبدل بحرية ثم تُحسب الإزاحات من جديد عند إعادة كتابة الكتلة */
+typedef struct {
+    size_t offset;      /* موضعها في الكتلة الأصلية */
+    int length;         /* طولها بعد الاستبدال، ولا يزيد على الأصلي */
+    uint8_t op;
+    int target;         /* رقم تعليمة الهدف للقفزات، وإلا -1 */
+    int dead;           /* محذوفة */
+    int is_target;      /* تصل إليها قفزة، فلا تُدمج مع ما قبلها */
+    int reachable;
+} peephole_insn_t;
+
+typedef struct {
+    peephole_insn_t* insns;
+    int count;
+    int* work;          /* قائمة العمل لتمريرة البلوغ */
+} peephole_t;
+
+static int is_jump(uint8_t op) {
+    return op == OP_JUMP || op == OP_JUMP_IF_FALSE || op == OP_JUMP_IF_TRUE ||
+           op == OP_LOOP || op == OP_ITER_NEXT || op == OP_LT_JUMP_IF_FALSE;
+}
+
+/* القفزات الشرطية التي تترك الشرط على المكدس */
+static int is_conditional_jump(uint8_t op) {
+    return op == OP_JUMP_IF_FALSE || op == OP_JUMP_IF_TRUE;
+}
+
+/* هل يكمل التنفيذ بعدها إلى التعليمة التالية؟ */
+static int falls_through(uint8_t op) {
+    return op != OP_JUMP && op != OP_LOOP && op != OP_RETURN &&
+           op != OP_RETURN_VOID && op != OP_HALT;
+}
+
+/* أول تعليمة باقية من index فصاعداً؛ القفزة إلى تعليمة محذوفة تصل إليها */
+static int next_live(peephole_t* p, int index) {
+    while (index < p->count && p->insns[index].dead) index++;
+    return index;
+}
+
+static int jump_target(peephole_t* p, int index) {
+    return next_live(p, p->insns[index].target);
+}
+
+static int live_op_is(peephole_t* p, int index, uint8_t op) {
+    return index < p->count && p->insns[index].op == op;
+}
+
+/* حذف تعليمة: القفزات إليها تصل الآن إلى التي بعدها */
+static void kill(peephole_t* p, int index) {
+    p->insns[index].dead = 1;
+    if (p->insns[index].is_target) {
+        int next = next_live(p, index + 1);
+        if (next < p->count) p->insns[next].is_target = 1;
+    }
+}
+
+static void peephole_free(peephole_t* p) {
+    free(p->insns);
+    free(p->work);
+}
+
+/* فك الكتلة إلى تعليمات. يفشل إن لم تقع أهداف القفزات على بدايات تعليمات */
+static int peephole_decode(peephole_t* p, chunk_t* chunk) {
+    int* index_at = (int*)malloc(sizeof(int) * chunk->count);
+    p->insns = (peephole_insn_t*)malloc(sizeof(peephole_insn_t) * chunk->count);
+    p->work = (int*)malloc(sizeof(int) * chunk->count);
+    p->count = 0;
+    
+    int ok = index_at && p->insns && p->work;
+    for (size_t offset = 0; ok && offset < chunk->count; offset++) {
+        index_at[offset] = -1;
+    }
+    
+    for (size_t offset = 0; ok && offset < chunk->count;) {
+        int length = instruction_length(chunk, (int)offset);
+        if (offset + (size_t)length > chunk->count) {
+            ok = 0;
+            break;
+        }
+        
+        peephole_insn_t* insn = &p->insns[p->count];
+        memset(insn, 0, sizeof(*insn));
+        insn->offset = offset;
+        insn->length = length;
+        insn->op = chunk->code[offset];
+        insn->target = -1;
+        index_at[offset] = p->count++;
+        offset += (size_t)length;
+    }
+    
+    for (int i = 0; ok && i < p->count; i++) {
+        peephole_insn_t* insn = &p->insns[i];
+        if (!is_jump(insn->op)) continue;
+        
+        const uint8_t* operand = chunk->code + insn->offset + (insn->op == OP_ITER_NEXT ? 2 : 1);
+        long distance = (long)((operand[0] << 8) | operand[1]);
+        long end = (long)insn->offset + insn->length;
+        long target = insn->op == OP_LOOP ? end - distance : end + distance;
+        
+        if (target < 0 || target >= (long)chunk->count || index_at[target] < 0) {
+            ok = 0;
+        } else {
+            insn->target = index_at[target];
+        }
+    }
+    
+    free(index_at);
+    if (!ok) peephole_free(p);
+    return ok;
+}
+
+/* حذف ما لا يبلغه التنفيذ من أول تعليمة، وتعليم أهداف القفزات الباقية */
+static int peephole_reach(peephole_t* p) {
+    for (int i = 0; i < p->count; i++) {
+        p->insns[i].reachable = 0;
+        p->insns[i].is_target = 0;
+    }
+    
+    int top = 0;
+    int start = next_live(p, 0);
+    if (start < p->count) {
+        p->insns[start].reachable = 1;
+        p->work[top++] = start;
+    }
+    
+    while (top > 0) {
+        int index = p->work[--top];
+        int successors[2];
+        int count = 0;
+        
+        if (falls_through(p->insns[index].op)) {
+            successors[count++] = next_live(p, index + 1);
+        }
+        if (is_jump(p->insns[index].op)) {
+            int target = jump_target(p, index);
+            if (target < p->count) p->insns[target].is_target = 1;
+            successors[count++] = target;
+        }
+        
+        for (int i = 0; i < count; i++) {
+            int next = successors[i];
+            if (next < p->count && !p->insns[next].reachable) {
+                p->insns[next].reachable = 1;
+                p->work[top++] = next;
+            }
+        }
+    }
+    
+    int changed = 0;
+    for (int i = 0; i < p->count; i++) {
+        if (!p->insns[i].dead && !p->insns[i].reachable) {
+            p->insns[i].dead = 1;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+/* الهدف النهائي لقفزة تصل إلى قفزات أخرى */
+static int thread_jump(peephole_t* p, int index) {
+    peephole_insn_t* insn = &p->insns[index];
+    int peeks = is_conditional_jump(insn->op);
+    int conditional = peeks || insn->op == OP_LT_JUMP_IF_FALSE;
+    int target = jump_target(p, index);
+    
+    for (int hops = 0; hops < MAX_THREAD_HOPS && target < p->count; hops++) {
+        uint8_t op = p->insns[target].op;
+        int next;
+        
+        if (op == OP_JUMP || op == OP_LOOP) {
+            next = jump_target(p, target);
+        } else if (peeks && op == insn->op) {
+            /* القيمة نفسها ما زالت على المكدس، فالقفزة الثانية تقع أيضاً */
+            next = jump_target(p, target);
+        } else if (peeks && is_conditional_jump(op)) {
+            /* والمعاكسة لا تقع */
+            next = next_live(p, target + 1);
+        } else {
+            break;
+        }
+        
+        if (next >= p->count || next == target) break;
+        
+        /* القفزات الشرطية إلى الأمام فقط، والمسافة لا تتجاوز 16 بت. الحذف
+         * لا يزيد المسافات، فتكفي المسافة في الكتلة الأصلية */
+        long distance = (long)p->insns[next].offset - (long)insn->offset;
+        if (conditional && distance <= 0) break;
+        if (labs(distance) + insn->length > 65535) break;
+        
+        target = next;
+    }
+    
+    return target;
+}
+
+/* قفزة: ربطها بهدفها النهائي، وحذفها إن كان هدفها التالية */
+static int rewrite_jump(peephole_t* p, int index, int next) {
+    peephole_insn_t* insn = &p->insns[index];
+    int unconditional = insn->op == OP_JUMP || insn->op == OP_LOOP;
+    int changed = 0;
+    
+    int target = thread_jump(p, index);
+    if (target >= p->count) return 0;
+    if (target != jump_target(p, index)) {
+        insn->target = target;
+        p->insns[target].is_target = 1;
+        if (unconditional) {
+            insn->op = p->insns[target].offset > insn->offset ? OP_JUMP : OP_LOOP;
+        }
+        changed = 1;
+    }
+    
+    /* LT_JUMP_IF_FALSE تبقى لأنها تزيل معاملَيها */
+    if (target == next && insn->op != OP_LT_JUMP_IF_FALSE) {
+        kill(p, index);
+        return 1;
+    }
+    
+    /* القفز إلى إرجاع أو إيقاف يُغني عنه الإرجاع نفسه */
+    uint8_t op = p->insns[target].op;
+    if (unconditional && (op == OP_RETURN || op == OP_RETURN_VOID || op == OP_HALT)) {
+        insn->op = op;
+        insn->length = 1;
+        insn->target = -1;
+        changed = 1;
+    }
+    
+    return changed;
+}
+
+/* تمريرة واحدة على التعليمات الباقية بأنماط المترجم المعروفة */
+static int peephole_rewrite(peephole_t* p) {
+    int changed = 0;
+    
+    for (int i = next_live(p, 0); i < p->count; i = next_live(p, i + 1)) {
+        peephole_insn_t* insn = &p->insns[i];
+        int next = next_live(p, i + 1);
+        peephole_insn_t* after = next < p->count ? &p->insns[next] : NULL;
+        
+        if (insn->op == OP_JUMP || insn->op == OP_LOOP || is_conditional_jump(insn->op) ||
+            insn->op == OP_LT_JUMP_IF_FALSE) {
+            changed |= rewrite_jump(p, i, next);
+            continue;
+        }
+        
+        /* الدمج مع التالية يصح ما لم تصل إليها قفزة */
+        if (!after || after->is_target) continue;
+        
+        /* ليس ثم قفزة شرطية تُزال قيمتها في الطريقين: تكفي القفزة المعاكسة */
+        if (insn->op == OP_NOT && is_conditional_jump(after->op) &&
+            live_op_is(p, next_live(p, next + 1), OP_POP) &&
+            live_op_is(p, jump_target(p, next), OP_POP)) {
+            after->op = after->op == OP_JUMP_IF_FALSE ? OP_JUMP_IF_TRUE : OP_JUMP_IF_FALSE;
+            kill(p, i);
+            changed = 1;
+            continue;
+        }
+        
+        /* شرط ثابت: القفزة بعده إما دائمة أو لا تقع */
+        if ((insn->op == OP_CONST_TRUE || insn->op == OP_CONST_FALSE || insn->op == OP_CONST_NULL) &&
+            is_conditional_jump(after->op)) {
+            int truthy = insn->op == OP_CONST_TRUE;
+            int taken = after->op == OP_JUMP_IF_TRUE ? truthy : !truthy;
+            if (taken) {
+                after->op = OP_JUMP;
+            } else {
+                kill(p, next);
+            }
+            changed = 1;
+            continue;
+        }
+        
+        /* قيمة تُدفع ثم تُزال دون أثر */
+        if (after->op == OP_POP &&
+            (insn->op == OP_CONST_INT || insn->op == OP_CONST_FLOAT || insn->op == OP_CONST_STRING ||
+             insn->op == OP_CONST_TRUE || insn->op == OP_CONST_FALSE || insn->op == OP_CONST_NULL ||
+             insn->op == OP_GET_LOCAL || insn->op == OP_GET_UPVALUE)) {
+            kill(p, i);
+            kill(p, next);
+            changed = 1;
+            continue;
+        }
+        
+        /* تعيين في عبارة: القيمة لا تلزم بعد الكتابة */
+        if (after->op == OP_POP && (insn->op == OP_SET_LOCAL || insn->op == OP_SET_GLOBAL)) {
+            insn->op = insn->op == OP_SET_LOCAL ? OP_SET_LOCAL_POP : OP_SET_GLOBAL_POP;
+            kill(p, next);
+            changed = 1;
+            continue;
+        }
+        
+        /* المقارنة بفارغ */
+        if (insn->op == OP_CONST_NULL && after->op == OP_EQ) {
+            after->op = OP_IS_NULL;
+            kill(p, i);
+            changed = 1;
+            continue;
+        }
+    }
+    
+    return changed;
+}
+
+/* كتابة التعليمات الباقية بإزاحاتها الجديدة مع أسطرها */
+static int peephole_encode(peephole_t* p, chunk_t* chunk) {
+    size_t* new_offset = (size_t*)malloc(sizeof(size_t) * (size_t)p->count);
+    if (!new_offset) return 0;
+    
+    size_t size = 0;
+    for (int i = 0; i < p->count; i++) {
+        if (p->insns[i].dead) continue;
+        new_offset[i] = size;
+        size += (size_t)p->insns[i].length;
+    }
+    
+    uint8_t* code = (uint8_t*)malloc(size ? size : 1);
+    int* lines = (int*)malloc(sizeof(int) * (size ? size : 1));
+    int ok = code && lines;
+    
+    for (int i = 0; ok && i < p->count; i++) {
+        peephole_insn_t* insn = &p->insns[i];
+        if (insn->dead) continue;
+        
+        size_t at = new_offset[i];
+        memcpy(code + at, chunk->code + insn->offset, (size_t)insn->length);
+        memcpy(lines + at, chunk->lines + insn->offset, sizeof(int) * (size_t)insn->length);
+        code[at] = insn->op;
+        
+        if (is_jump(insn->op)) {
+            int target = jump_target(p, i);
+            if (target >= p->count) {
+                ok = 0;
+                break;
+            }
+            
+            long end = (long)(at + (size_t)insn->length);
+            long distance = insn->op == OP_LOOP ? end - (long)new_offset[target]
+                                                : (long)new_offset[target] - end;
+            if (distance < 0 || distance > 65535) {
+                ok = 0;
+                break;
+            }
+            
+            size_t operand = at + (insn->op == OP_ITER_NEXT ? 2 : 1);
+            code[operand] = (uint8_t)((distance >> 8) & 0xFF);
+            code[operand + 1] = (uint8_t)(distance & 0xFF);
+        }
+    }
+    
+    free(new_offset);
+    if (!ok) {
+        free(code);
+        free(lines);
+        return 0;
+    }
+    
+    free(chunk->code);
+    free(chunk->lines);
+    chunk->code = code;
+    chunk->lines = lines;
+    chunk->count = size;
+    chunk->capacity = size;
+    return 1;
+}
+
+static void peephole_chunk(chunk_t* chunk) {
+    peephole_t p;
+    if (chunk->borrowed || chunk->count == 0 || !peephole_decode(&p, chunk)) return;
+    
+    /* كل تبسيط قد يكشف غيره، فتُعاد التمريرتان حتى لا يتغير شيء */
+    int changed = 1;
+    for (int round = 0; changed && round < MAX_PEEPHOLE_ROUNDS; round++) {
+        changed = peephole_reach(&p);
+        changed |= peephole_rewrite(&p);
+    }
+    peephole_reach(&p);
+    
+    peephole_encode(&p, chunk);
+    peephole_free(&p);
+}
+
+void optimizer_chunk(chunk_t* chunk, int level) {
+    if (level < SKP_OPTIMIZE_PEEPHOLE || !chunk) return;
+    
+    /* الدوال المتداخلة في ثوابت الكتلة */
+    for (size_t i = 0; i < chunk->constant_count; i++) {
+        if (chunk->constants[i].type == SKP_TYPE_FUNC) {
+            optimizer_chunk(chunk->constants[i].value.func_val->data.v_func.chunk, level);
+        }
+    }
+    
+    peephole_chunk(chunk);
+}
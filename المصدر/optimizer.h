@@ -0,0 +1,30 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * المحسّن (Optimizer) - AST and Bytecode Optimizer
+ *
+ * تمريرة على شجرة البنية المجردة بين المحلل والمترجم، وأخرى على البايتكود بعده
+ */
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "parser.h"
+#include "compiler.h"
+
+/* مستويات التحسين (الخيار -O) */
+#define SKP_OPTIMIZE_NONE 0
+#define SKP_OPTIMIZE_FOLD 1     /* طي الثوابت وحذف فروع إذا الميتة */
+#define SKP_OPTIMIZE_PEEPHOLE 2 /* وتحسين البايتكود بعد الترجمة */
+#define SKP_OPTIMIZE_MAX SKP_OPTIMIZE_PEEPHOLE
+
+/* تحسين الشجرة في مكانها، والعقد الجديدة في ساحة المحلل. تعيد الجذر.
+ * الطي يحاكي الجهاز الافتراضي بالضبط: ما قد يختلف ناتجه أو يفشل وقت
+ * التشغيل (قسمة على صفر، فيض عدد صحيح، أنواع غير متوافقة) يُترك له */
+ast_node_t* optimizer_run(ast_arena_t* arena, ast_node_t* node, int level);
+
+/* تحسين نافذي (peephole) على كتلة مترجمة ودوالها المتداخلة: ربط القفزات
+ * المتتالية، وحذف ما لا يُبلغ، ودمج تسلسلات المترجم في تعليمات أرخص.
+ * الأسطر تبقى مطابقة للبايتات. الكتلة إما تُحسَّن كلها أو تبقى كما هي */
+void optimizer_chunk(chunk_t* chunk, int level);
+
+#endif /* OPTIMIZER_H */
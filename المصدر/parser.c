@@ -10,10 +10,73 @@
 #include <string.h>
 #include "parser.h"
 
-/* ========== إنشاء وإتلاف العقد ========== */
+/* ========== ساحة الشجرة ========== */
 
-ast_node_t* ast_create_node(ast_node_type_t type, int line, int column) {
-    ast_node_t* node = (ast_node_t*)malloc(sizeof(ast_node_t));
+void ast_arena_init(ast_arena_t* arena) {
+    arena->blocks = NULL;
+    arena->ptr = NULL;
+    arena->end = NULL;
+    arena->total = 0;
+}
+
+void ast_arena_free(ast_arena_t* arena) {
+    ast_arena_block_t* block = arena->blocks;
+    while (block) {
+        ast_arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    ast_arena_init(arena);
+}
+
+/* المسار البطيء لـ ast_arena_alloc: الطلبات الكبيرة تأخذ كتلة خاصة بها
+ * خلف الحالية حتى لا يُهدر ما تبقى منها */
+void* ast_arena_grow(ast_arena_t* arena, size_t size) {
+    int dedicated = size > AST_ARENA_BLOCK_SIZE / 4;
+    size_t block_size = dedicated ? size : AST_ARENA_BLOCK_SIZE;
+    
+    ast_arena_block_t* block = (ast_arena_block_t*)malloc(sizeof(ast_arena_block_t) + block_size);
+    if (!block) {
+        fprintf(stderr, "خطأ: فشل في تخصيص ذاكرة شجرة البنية\n");
+        return NULL;
+    }
+    block->size = block_size;
+    arena->total += block_size;
+    
+    if (dedicated && arena->blocks) {
+        block->next = arena->blocks->next;
+        arena->blocks->next = block;
+        return block->data;
+    }
+    
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->ptr = block->data + size;
+    arena->end = block->data + block_size;
+    return block->data;
+}
+
+char* ast_arena_strndup(ast_arena_t* arena, const char* str, size_t length) {
+    char* copy = (char*)ast_arena_alloc(arena, length + 1);
+    if (copy) {
+        memcpy(copy, str, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+void* ast_arena_copy(ast_arena_t* arena, const void* data, size_t size) {
+    void* result = ast_arena_alloc(arena, size);
+    if (result) {
+        memcpy(result, data, size);
+    }
+    return result;
+}
+
+/* ========== إنشاء العقد ========== */
+
+ast_node_t* ast_create_node(ast_arena_t* arena, ast_node_type_t type, int line, int column) {
+    ast_node_t* node = (ast_node_t*)ast_arena_alloc(arena, sizeof(ast_node_t));
     if (!node) {
         fprintf(stderr, "خطأ: فشل في تخصيص الذاكرة للعقدة\n");
         return NULL;
@@ -27,219 +90,46 @@ ast_node_t* ast_create_node(ast_node_type_t type, int line, int column) {
     return node;
 }
 
-void ast_destroy_node(ast_node_t* node) {
-    if (!node) return;
-    
-    switch (node->type) {
-        case AST_NUMBER:
-            free(node->data.number.value);
-            break;
-            
-        case AST_STRING:
-            free(node->data.string.value);
-            break;
-            
-        case AST_IDENTIFIER:
-            free(node->data.identifier.name);
-            break;
-            
-        case AST_BINARY_OP:
-            ast_destroy_node(node->data.binary_op.left);
-            ast_destroy_node(node->data.binary_op.right);
-            break;
-            
-        case AST_UNARY_OP:
-            ast_destroy_node(node->data.unary_op.operand);
-            break;
-            
-        case AST_ASSIGNMENT:
-            ast_destroy_node(node->data.assignment.target);
-            ast_destroy_node(node->data.assignment.value);
-            break;
-            
-        case AST_CALL:
-            ast_destroy_node(node->data.call.callee);
-            for (size_t i = 0; i < node->data.call.arg_count; i++) {
-                ast_destroy_node(node->data.call.args[i]);
-            }
-            free(node->data.call.args);
-            break;
-            
-        case AST_MEMBER_ACCESS:
-            ast_destroy_node(node->data.member_access.object);
-            free(node->data.member_access.member);
-            break;
-            
-        case AST_INDEX_ACCESS:
-            ast_destroy_node(node->data.index_access.object);
-            ast_destroy_node(node->data.index_access.index);
-            break;
-            
-        case AST_LIST_LITERAL:
-            for (size_t i = 0; i < node->data.list_literal.element_count; i++) {
-                ast_destroy_node(node->data.list_literal.elements[i]);
-            }
-            free(node->data.list_literal.elements);
-            break;
-            
-        case AST_DICT_LITERAL:
-            for (size_t i = 0; i < node->data.dict_literal.entry_count; i++) {
-                ast_destroy_node(node->data.dict_literal.keys[i]);
-                ast_destroy_node(node->data.dict_literal.values[i]);
-            }
-            free(node->data.dict_literal.keys);
-            free(node->data.dict_literal.values);
-            break;
-            
-        case AST_LAMBDA:
-            for (size_t i = 0; i < node->data.lambda.param_count; i++) {
-                free(node->data.lambda.params[i]);
-            }
-            free(node->data.lambda.params);
-            ast_destroy_node(node->data.lambda.body);
-            break;
-            
-        case AST_TERNARY:
-            ast_destroy_node(node->data.ternary.condition);
-            ast_destroy_node(node->data.ternary.true_expr);
-            ast_destroy_node(node->data.ternary.false_expr);
-            break;
-            
-        case AST_VAR_DECL:
-        case AST_CONST_DECL:
-            free(node->data.var_decl.name);
-            ast_destroy_node(node->data.var_decl.initializer);
-            break;
-            
-        case AST_FUNC_DECL:
-            free(node->data.func_decl.name);
-            for (size_t i = 0; i < node->data.func_decl.param_count; i++) {
-                free(node->data.func_decl.params[i]);
-            }
-            free(node->data.func_decl.params);
-            if (node->data.func_decl.defaults) {
-                for (size_t i = 0; i < node->data.func_decl.param_count; i++) {
-                    ast_destroy_node(node->data.func_decl.defaults[i]);
-                }
-                free(node->data.func_decl.defaults);
-            }
-            ast_destroy_node(node->data.func_decl.body);
-            break;
-            
-        case AST_CLASS_DECL:
-            free(node->data.class_decl.name);
-            if (node->data.class_decl.parent) {
-                free(node->data.class_decl.parent);
-            }
-            for (size_t i = 0; i < node->data.class_decl.member_count; i++) {
-                ast_destroy_node(node->data.class_decl.members[i]);
-            }
-            free(node->data.class_decl.members);
-            break;
-            
-        case AST_RETURN:
-            ast_destroy_node(node->data.return_stmt.value);
-            break;
-            
-        case AST_IF:
-            ast_destroy_node(node->data.if_stmt.condition);
-            ast_destroy_node(node->data.if_stmt.then_branch);
-            ast_destroy_node(node->data.if_stmt.else_branch);
-            break;
-            
-        case AST_WHILE:
-            ast_destroy_node(node->data.while_stmt.condition);
-            ast_destroy_node(node->data.while_stmt.body);
-            break;
-            
-        case AST_FOR:
-            free(node->data.for_stmt.init_var);
-            ast_destroy_node(node->data.for_stmt.init_expr);
-            ast_destroy_node(node->data.for_stmt.condition);
-            ast_destroy_node(node->data.for_stmt.increment);
-            ast_destroy_node(node->data.for_stmt.body);
-            break;
-            
-        case AST_FOREACH:
-            free(node->data.foreach_stmt.var);
-            ast_destroy_node(node->data.foreach_stmt.iterable);
-            ast_destroy_node(node->data.foreach_stmt.body);
-            break;
-            
-        case AST_BLOCK:
-        case AST_PROGRAM:
-            for (size_t i = 0; i < node->data.block.statement_count; i++) {
-                ast_destroy_node(node->data.block.statements[i]);
-            }
-            free(node->data.block.statements);
-            break;
-            
-        case AST_EXPRESSION_STMT:
-            ast_destroy_node(node->data.expression_stmt.expression);
-            break;
-            
-        case AST_IMPORT:
-            free(node->data.import.module);
-            for (size_t i = 0; i < node->data.import.name_count; i++) {
-                free(node->data.import.names[i]);
-            }
-            free(node->data.import.names);
-            break;
-            
-        case AST_EXPORT:
-            for (size_t i = 0; i < node->data.export_stmt.name_count; i++) {
-                free(node->data.export_stmt.names[i]);
-            }
-            free(node->data.export_stmt.names);
-            break;
-            
-        default:
-            break;
-    }
-    
-    free(node);
-}
-
-ast_node_t* ast_create_number(const char* value, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_NUMBER, line, column);
+ast_node_t* ast_create_number(ast_arena_t* arena, char* value, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_NUMBER, line, column);
     if (node) {
-        node->data.number.value = strdup(value);
+        node->data.number.value = value;
     }
     return node;
 }
 
-ast_node_t* ast_create_string(const char* value, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_STRING, line, column);
+ast_node_t* ast_create_string(ast_arena_t* arena, char* value, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_STRING, line, column);
     if (node) {
-        node->data.string.value = strdup(value);
+        node->data.string.value = value;
     }
     return node;
 }
 
-ast_node_t* ast_create_boolean(int value, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_BOOLEAN, line, column);
+ast_node_t* ast_create_boolean(ast_arena_t* arena, int value, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_BOOLEAN, line, column);
     if (node) {
         node->data.boolean.value = value;
     }
     return node;
 }
 
-ast_node_t* ast_create_null(int line, int column) {
-    return ast_create_node(AST_NULL, line, column);
+ast_node_t* ast_create_null(ast_arena_t* arena, int line, int column) {
+    return ast_create_node(arena, AST_NULL, line, column);
 }
 
-ast_node_t* ast_create_identifier(const char* name, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_IDENTIFIER, line, column);
+ast_node_t* ast_create_identifier(ast_arena_t* arena, char* name, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_IDENTIFIER, line, column);
     if (node) {
-        node->data.identifier.name = strdup(name);
+        node->data.identifier.name = name;
     }
     return node;
 }
 
 /* ========== إنشاء عقد التعبيرات ========== */
 
-ast_node_t* ast_create_binary_op(binop_type_t op, ast_node_t* left, ast_node_t* right, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_BINARY_OP, line, column);
+ast_node_t* ast_create_binary_op(ast_arena_t* arena, binop_type_t op, ast_node_t* left, ast_node_t* right, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_BINARY_OP, line, column);
     if (node) {
         node->data.binary_op.op = op;
         node->data.binary_op.left = left;
@@ -248,8 +138,8 @@ ast_node_t* ast_create_binary_op(binop_type_t op, ast_node_t* left, ast_node_t*
     return node;
 }
 
-ast_node_t* ast_create_unary_op(unop_type_t op, ast_node_t* operand, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_UNARY_OP, line, column);
+ast_node_t* ast_create_unary_op(ast_arena_t* arena, unop_type_t op, ast_node_t* operand, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_UNARY_OP, line, column);
     if (node) {
         node->data.unary_op.op = op;
         node->data.unary_op.operand = operand;
@@ -257,8 +147,8 @@ ast_node_t* ast_create_unary_op(unop_type_t op, ast_node_t* operand, int line, i
     return node;
 }
 
-ast_node_t* ast_create_assignment(ast_node_t* target, ast_node_t* value, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_ASSIGNMENT, line, column);
+ast_node_t* ast_create_assignment(ast_arena_t* arena, ast_node_t* target, ast_node_t* value, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_ASSIGNMENT, line, column);
     if (node) {
         node->data.assignment.target = target;
         node->data.assignment.value = value;
@@ -266,8 +156,8 @@ ast_node_t* ast_create_assignment(ast_node_t* target, ast_node_t* value, int lin
     return node;
 }
 
-ast_node_t* ast_create_call(ast_node_t* callee, ast_node_t** args, size_t arg_count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_CALL, line, column);
+ast_node_t* ast_create_call(ast_arena_t* arena, ast_node_t* callee, ast_node_t** args, size_t arg_count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_CALL, line, column);
     if (node) {
         node->data.call.callee = callee;
         node->data.call.args = args;
@@ -276,17 +166,17 @@ ast_node_t* ast_create_call(ast_node_t* callee, ast_node_t** args, size_t arg_co
     return node;
 }
 
-ast_node_t* ast_create_member_access(ast_node_t* object, const char* member, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_MEMBER_ACCESS, line, column);
+ast_node_t* ast_create_member_access(ast_arena_t* arena, ast_node_t* object, char* member, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_MEMBER_ACCESS, line, column);
     if (node) {
         node->data.member_access.object = object;
-        node->data.member_access.member = strdup(member);
+        node->data.member_access.member = member;
     }
     return node;
 }
 
-ast_node_t* ast_create_index_access(ast_node_t* object, ast_node_t* index, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_INDEX_ACCESS, line, column);
+ast_node_t* ast_create_index_access(ast_arena_t* arena, ast_node_t* object, ast_node_t* index, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_INDEX_ACCESS, line, column);
     if (node) {
         node->data.index_access.object = object;
         node->data.index_access.index = index;
@@ -294,8 +184,8 @@ ast_node_t* ast_create_index_access(ast_node_t* object, ast_node_t* index, int l
     return node;
 }
 
-ast_node_t* ast_create_list_literal(ast_node_t** elements, size_t count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_LIST_LITERAL, line, column);
+ast_node_t* ast_create_list_literal(ast_arena_t* arena, ast_node_t** elements, size_t count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_LIST_LITERAL, line, column);
     if (node) {
         node->data.list_literal.elements = elements;
         node->data.list_literal.element_count = count;
@@ -303,8 +193,8 @@ ast_node_t* ast_create_list_literal(ast_node_t** elements, size_t count, int lin
     return node;
 }
 
-ast_node_t* ast_create_dict_literal(ast_node_t** keys, ast_node_t** values, size_t count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_DICT_LITERAL, line, column);
+ast_node_t* ast_create_dict_literal(ast_arena_t* arena, ast_node_t** keys, ast_node_t** values, size_t count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_DICT_LITERAL, line, column);
     if (node) {
         node->data.dict_literal.keys = keys;
         node->data.dict_literal.values = values;
@@ -313,8 +203,8 @@ ast_node_t* ast_create_dict_literal(ast_node_t** keys, ast_node_t** values, size
     return node;
 }
 
-ast_node_t* ast_create_lambda(char** params, size_t param_count, ast_node_t* body, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_LAMBDA, line, column);
+ast_node_t* ast_create_lambda(ast_arena_t* arena, char** params, size_t param_count, ast_node_t* body, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_LAMBDA, line, column);
     if (node) {
         node->data.lambda.params = params;
         node->data.lambda.param_count = param_count;
@@ -323,8 +213,8 @@ ast_node_t* ast_create_lambda(char** params, size_t param_count, ast_node_t* bod
     return node;
 }
 
-ast_node_t* ast_create_ternary(ast_node_t* cond, ast_node_t* true_expr, ast_node_t* false_expr, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_TERNARY, line, column);
+ast_node_t* ast_create_ternary(ast_arena_t* arena, ast_node_t* cond, ast_node_t* true_expr, ast_node_t* false_expr, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_TERNARY, line, column);
     if (node) {
         node->data.ternary.condition = cond;
         node->data.ternary.true_expr = true_expr;
@@ -335,25 +225,25 @@ ast_node_t* ast_create_ternary(ast_node_t* cond, ast_node_t* true_expr, ast_node
 
 /* ========== إنشاء عقد التصريحات ========== */
 
-ast_node_t* ast_create_var_decl(const char* name, ast_node_t* init, int is_mutable, int line, int column) {
-    ast_node_t* node = ast_create_node(is_mutable ? AST_VAR_DECL : AST_CONST_DECL, line, column);
+ast_node_t* ast_create_var_decl(ast_arena_t* arena, char* name, ast_node_t* init, int is_mutable, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, is_mutable ? AST_VAR_DECL : AST_CONST_DECL, line, column);
     if (node) {
-        node->data.var_decl.name = strdup(name);
+        node->data.var_decl.name = name;
         node->data.var_decl.initializer = init;
         node->data.var_decl.is_mutable = is_mutable;
     }
     return node;
 }
 
-ast_node_t* ast_create_const_decl(const char* name, ast_node_t* init, int line, int column) {
-    return ast_create_var_decl(name, init, 0, line, column);
+ast_node_t* ast_create_const_decl(ast_arena_t* arena, char* name, ast_node_t* init, int line, int column) {
+    return ast_create_var_decl(arena, name, init, 0, line, column);
 }
 
-ast_node_t* ast_create_func_decl(const char* name, char** params, size_t param_count,
+ast_node_t* ast_create_func_decl(ast_arena_t* arena, char* name, char** params, size_t param_count,
                                    ast_node_t** defaults, ast_node_t* body, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_FUNC_DECL, line, column);
+    ast_node_t* node = ast_create_node(arena, AST_FUNC_DECL, line, column);
     if (node) {
-        node->data.func_decl.name = strdup(name);
+        node->data.func_decl.name = name;
         node->data.func_decl.params = params;
         node->data.func_decl.param_count = param_count;
         node->data.func_decl.defaults = defaults;
@@ -362,28 +252,28 @@ ast_node_t* ast_create_func_decl(const char* name, char** params, size_t param_c
     return node;
 }
 
-ast_node_t* ast_create_class_decl(const char* name, const char* parent,
+ast_node_t* ast_create_class_decl(ast_arena_t* arena, char* name, char* parent,
                                     ast_node_t** members, size_t member_count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_CLASS_DECL, line, column);
+    ast_node_t* node = ast_create_node(arena, AST_CLASS_DECL, line, column);
     if (node) {
-        node->data.class_decl.name = strdup(name);
-        node->data.class_decl.parent = parent ? strdup(parent) : NULL;
+        node->data.class_decl.name = name;
+        node->data.class_decl.parent = parent;
         node->data.class_decl.members = members;
         node->data.class_decl.member_count = member_count;
     }
     return node;
 }
 
-ast_node_t* ast_create_return(ast_node_t* value, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_RETURN, line, column);
+ast_node_t* ast_create_return(ast_arena_t* arena, ast_node_t* value, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_RETURN, line, column);
     if (node) {
         node->data.return_stmt.value = value;
     }
     return node;
 }
 
-ast_node_t* ast_create_if(ast_node_t* cond, ast_node_t* then_branch, ast_node_t* else_branch, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_IF, line, column);
+ast_node_t* ast_create_if(ast_arena_t* arena, ast_node_t* cond, ast_node_t* then_branch, ast_node_t* else_branch, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_IF, line, column);
     if (node) {
         node->data.if_stmt.condition = cond;
         node->data.if_stmt.then_branch = then_branch;
@@ -392,8 +282,8 @@ ast_node_t* ast_create_if(ast_node_t* cond, ast_node_t* then_branch, ast_node_t*
     return node;
 }
 
-ast_node_t* ast_create_while(ast_node_t* cond, ast_node_t* body, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_WHILE, line, column);
+ast_node_t* ast_create_while(ast_arena_t* arena, ast_node_t* cond, ast_node_t* body, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_WHILE, line, column);
     if (node) {
         node->data.while_stmt.condition = cond;
         node->data.while_stmt.body = body;
@@ -401,11 +291,11 @@ ast_node_t* ast_create_while(ast_node_t* cond, ast_node_t* body, int line, int c
     return node;
 }
 
-ast_node_t* ast_create_for(const char* var, ast_node_t* init, ast_node_t* cond,
+ast_node_t* ast_create_for(ast_arena_t* arena, char* var, ast_node_t* init, ast_node_t* cond,
                              ast_node_t* inc, ast_node_t* body, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_FOR, line, column);
+    ast_node_t* node = ast_create_node(arena, AST_FOR, line, column);
     if (node) {
-        node->data.for_stmt.init_var = var ? strdup(var) : NULL;
+        node->data.for_stmt.init_var = var;
         node->data.for_stmt.init_expr = init;
         node->data.for_stmt.condition = cond;
         node->data.for_stmt.increment = inc;
@@ -414,26 +304,26 @@ ast_node_t* ast_create_for(const char* var, ast_node_t* init, ast_node_t* cond,
     return node;
 }
 
-ast_node_t* ast_create_foreach(const char* var, ast_node_t* iterable, ast_node_t* body, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_FOREACH, line, column);
+ast_node_t* ast_create_foreach(ast_arena_t* arena, char* var, ast_node_t* iterable, ast_node_t* body, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_FOREACH, line, column);
     if (node) {
-        node->data.foreach_stmt.var = strdup(var);
+        node->data.foreach_stmt.var = var;
         node->data.foreach_stmt.iterable = iterable;
         node->data.foreach_stmt.body = body;
     }
     return node;
 }
 
-ast_node_t* ast_create_break(int line, int column) {
-    return ast_create_node(AST_BREAK, line, column);
+ast_node_t* ast_create_break(ast_arena_t* arena, int line, int column) {
+    return ast_create_node(arena, AST_BREAK, line, column);
 }
 
-ast_node_t* ast_create_continue(int line, int column) {
-    return ast_create_node(AST_CONTINUE, line, column);
+ast_node_t* ast_create_continue(ast_arena_t* arena, int line, int column) {
+    return ast_create_node(arena, AST_CONTINUE, line, column);
 }
 
-ast_node_t* ast_create_block(ast_node_t** stmts, size_t count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_BLOCK, line, column);
+ast_node_t* ast_create_block(ast_arena_t* arena, ast_node_t** stmts, size_t count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_BLOCK, line, column);
     if (node) {
         node->data.block.statements = stmts;
         node->data.block.statement_count = count;
@@ -441,26 +331,26 @@ ast_node_t* ast_create_block(ast_node_t** stmts, size_t count, int line, int col
     return node;
 }
 
-ast_node_t* ast_create_expression_stmt(ast_node_t* expr, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_EXPRESSION_STMT, line, column);
+ast_node_t* ast_create_expression_stmt(ast_arena_t* arena, ast_node_t* expr, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_EXPRESSION_STMT, line, column);
     if (node) {
         node->data.expression_stmt.expression = expr;
     }
     return node;
 }
 
-ast_node_t* ast_create_import(const char* module, char** names, size_t count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_IMPORT, line, column);
+ast_node_t* ast_create_import(ast_arena_t* arena, char* module, char** names, size_t count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_IMPORT, line, column);
     if (node) {
-        node->data.import.module = strdup(module);
+        node->data.import.module = module;
         node->data.import.names = names;
         node->data.import.name_count = count;
     }
     return node;
 }
 
-ast_node_t* ast_create_export(char** names, size_t count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_EXPORT, line, column);
+ast_node_t* ast_create_export(ast_arena_t* arena, char** names, size_t count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_EXPORT, line, column);
     if (node) {
         node->data.export_stmt.names = names;
         node->data.export_stmt.name_count = count;
@@ -468,8 +358,8 @@ ast_node_t* ast_create_export(char** names, size_t count, int line, int column)
     return node;
 }
 
-ast_node_t* ast_create_program(ast_node_t** stmts, size_t count, int line, int column) {
-    ast_node_t* node = ast_create_node(AST_PROGRAM, line, column);
+ast_node_t* ast_create_program(ast_arena_t* arena, ast_node_t** stmts, size_t count, int line, int column) {
+    ast_node_t* node = ast_create_node(arena, AST_PROGRAM, line, column);
     if (node) {
         node->data.program.statements = stmts;
         node->data.program.statement_count = count;
@@ -491,6 +381,10 @@ parser_t* parser_create(lexer_t* lexer) {
     parser->previous = NULL;
     parser->had_error = 0;
     parser->panic_mode = 0;
+    ast_arena_init(&parser->arena);
+    parser->scratch = NULL;
+    parser->scratch_count = 0;
+    parser->scratch_capacity = 0;
     
     /* الحصول على أول رمز */
     parser->current = lexer_next_token(lexer);
@@ -501,13 +395,9 @@ parser_t* parser_create(lexer_t* lexer) {
 void parser_destroy(parser_t* parser) {
     if (!parser) return;
     
-    if (parser->current) {
-        token_destroy(parser->current);
-    }
-    if (parser->previous) {
-        token_destroy(parser->previous);
-    }
-    
+    /* الرموز مملوكة للمعجم ويحررها lexer_destroy، والشجرة كلها في الساحة */
+    ast_arena_free(&parser->arena);
+    free(parser->scratch);
     free(parser);
 }
 
@@ -517,11 +407,54 @@ ast_node_t* parser_parse(parser_t* parser) {
 
 /* ========== دوال المساعدة ========== */
 
+/* نص الرمز شريحة من المصدر؛ يُنسخ إلى الساحة منتهياً بـ '\0' */
+static char* parser_token_text(parser_t* parser, token_t* token) {
+    return ast_arena_strndup(&parser->arena, token->start, token->length);
+}
+
+/* تجمع القوائم عناصرها فوق المكدس المؤقت بدءاً من علامة تؤخذ قبلها */
+static void parser_scratch_push(parser_t* parser, void* item) {
+    if (parser->scratch_count >= parser->scratch_capacity) {
+        parser->scratch_capacity = parser->scratch_capacity == 0 ? 64 : parser->scratch_capacity * 2;
+        parser->scratch = (void**)realloc(parser->scratch, parser->scratch_capacity * sizeof(void*));
+    }
+    parser->scratch[parser->scratch_count++] = item;
+}
+
+/* نقل العناصر فوق العلامة إلى مصفوفة في الساحة وإزالتها من المكدس */
+static void** parser_scratch_take(parser_t* parser, size_t mark, size_t* count) {
+    size_t n = parser->scratch_count - mark;
+    void** items = NULL;
+    if (n > 0) {
+        items = (void**)ast_arena_copy(&parser->arena, parser->scratch + mark, n * sizeof(void*));
+    }
+    parser->scratch_count = mark;
+    *count = n;
+    return items;
+}
+
+/* مثل parser_scratch_take لعناصر دُفعت أزواجاً: الأول من كل زوج إلى
+ * firsts والثاني إلى seconds */
+static size_t parser_scratch_take_pairs(parser_t* parser, size_t mark, void*** firsts, void*** seconds) {
+    size_t n = (parser->scratch_count - mark) / 2;
+    *firsts = NULL;
+    *seconds = NULL;
+    if (n > 0) {
+        *firsts = (void**)ast_arena_alloc(&parser->arena, n * sizeof(void*));
+        *seconds = (void**)ast_arena_alloc(&parser->arena, n * sizeof(void*));
+        if (*firsts && *seconds) {
+            for (size_t i = 0; i < n; i++) {
+                (*firsts)[i] = parser->scratch[mark + 2 * i];
+                (*seconds)[i] = parser->scratch[mark + 2 * i + 1];
+            }
+        }
+    }
+    parser->scratch_count = mark;
+    return n;
+}
+
 int parser_match(parser_t* parser, token_type_t type) {
     if (parser_check(parser, type)) {
-        if (parser->previous) {
-            token_destroy(parser->previous);
-        }
         parser->previous = parser->current;
         parser->current = lexer_next_token(parser->lexer);
         return 1;
@@ -534,9 +467,6 @@ int parser_check(parser_t* parser, token_type_t type) {
 }
 
 token_t* parser_advance(parser_t* parser) {
-    if (parser->previous) {
-        token_destroy(parser->previous);
-    }
     parser->previous = parser->current;
     parser->current = lexer_next_token(parser->lexer);
     return parser->previous;
@@ -553,6 +483,10 @@ token_t* parser_consume(parser_t* parser, token_type_t type, const char* message
             message);
     parser->had_error = 1;
     parser->panic_mode = 1;
+    /* تجاوز الرمز غير المتوقع لضمان التقدم عند الاستعادة */
+    if (!parser_check(parser, TOKEN_EOF)) {
+        parser_advance(parser);
+    }
     return NULL;
 }
 
@@ -585,22 +519,15 @@ void parser_synchronize(parser_t* parser) {
 /* ========== تحليل القواعد - البرنامج ========== */
 
 ast_node_t* parse_program(parser_t* parser) {
-    ast_node_t** statements = NULL;
-    size_t count = 0;
-    size_t capacity = 0;
+    size_t mark = parser->scratch_count;
     
     int line = parser->current ? parser->current->line : 1;
     int column = parser->current ? parser->current->column : 1;
     
     while (!parser_check(parser, TOKEN_EOF)) {
-        if (count >= capacity) {
-            capacity = capacity == 0 ? 8 : capacity * 2;
-            statements = (ast_node_t**)realloc(statements, capacity * sizeof(ast_node_t*));
-        }
-        
         ast_node_t* decl = parse_declaration(parser);
         if (decl) {
-            statements[count++] = decl;
+            parser_scratch_push(parser, decl);
         }
         
         if (parser->panic_mode) {
@@ -608,7 +535,9 @@ ast_node_t* parse_program(parser_t* parser) {
         }
     }
     
-    return ast_create_program(statements, count, line, column);
+    size_t count;
+    ast_node_t** statements = (ast_node_t**)parser_scratch_take(parser, mark, &count);
+    return ast_create_program(&parser->arena, statements, count, line, column);
 }
 
 ast_node_t* parse_declaration(parser_t* parser) {
@@ -648,8 +577,7 @@ ast_node_t* parse_var_declaration(parser_t* parser, int is_mutable) {
     
     parser_match(parser, TOKEN_SEMICOLON);
     
-    ast_node_t* node = ast_create_var_decl(name->value, initializer, is_mutable, line, column);
-    token_destroy(name);
+    ast_node_t* node = ast_create_var_decl(&parser->arena, parser_token_text(parser, name), initializer, is_mutable, line, column);
     return node;
 }
 
@@ -662,51 +590,38 @@ ast_node_t* parse_func_declaration(parser_t* parser) {
     
     parser_consume(parser, TOKEN_LPAREN, "متوقع '(' بعد اسم الدالة");
     
-    char** params = NULL;
-    ast_node_t** defaults = NULL;
-    size_t param_count = 0;
-    size_t capacity = 0;
+    size_t mark = parser->scratch_count;
     
     if (!parser_check(parser, TOKEN_RPAREN)) {
         do {
-            if (param_count >= capacity) {
-                capacity = capacity == 0 ? 4 : capacity * 2;
-                params = (char**)realloc(params, capacity * sizeof(char*));
-                defaults = (ast_node_t**)realloc(defaults, capacity * sizeof(ast_node_t*));
-            }
-            
             token_t* param = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم المعامل");
             if (!param) {
-                /* تنظيف */
-                for (size_t i = 0; i < param_count; i++) {
-                    free(params[i]);
-                    ast_destroy_node(defaults[i]);
-                }
-                free(params);
-                free(defaults);
-                token_destroy(name);
+                /* ما جُمع يبقى في الساحة ويُحرر معها */
+                parser->scratch_count = mark;
                 return NULL;
             }
             
-            params[param_count] = strdup(param->value);
+            parser_scratch_push(parser, parser_token_text(parser, param));
             
             if (parser_match(parser, TOKEN_ASSIGN)) {
-                defaults[param_count] = parse_expression(parser);
+                parser_scratch_push(parser, parse_expression(parser));
             } else {
-                defaults[param_count] = NULL;
+                parser_scratch_push(parser, NULL);
             }
-            
-            param_count++;
-            token_destroy(param);
         } while (parser_match(parser, TOKEN_COMMA));
     }
     
+    void** params;
+    void** defaults;
+    size_t param_count = parser_scratch_take_pairs(parser, mark, &params, &defaults);
+    
     parser_consume(parser, TOKEN_RPAREN, "متوقع ')' بعد المعاملات");
+    parser_consume(parser, TOKEN_LBRACE, "متوقع '{' قبل جسم الدالة");
     
     ast_node_t* body = parse_block(parser);
     
-    ast_node_t* node = ast_create_func_decl(name->value, params, param_count, defaults, body, line, column);
-    token_destroy(name);
+    ast_node_t* node = ast_create_func_decl(&parser->arena, parser_token_text(parser, name), (char**)params, param_count,
+                                         (ast_node_t**)defaults, body, line, column);
     return node;
 }
 
@@ -721,31 +636,24 @@ ast_node_t* parse_class_declaration(parser_t* parser) {
     if (parser_match(parser, TOKEN_COLON)) {
         token_t* parent_token = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الصنف الأب");
         if (parent_token) {
-            parent = strdup(parent_token->value);
-            token_destroy(parent_token);
+            parent = parser_token_text(parser, parent_token);
         }
     }
     
     parser_consume(parser, TOKEN_LBRACE, "متوقع '{' قبل أعضاء الصنف");
     
-    ast_node_t** members = NULL;
-    size_t member_count = 0;
-    size_t capacity = 0;
+    size_t mark = parser->scratch_count;
     
     while (!parser_check(parser, TOKEN_RBRACE) && !parser_check(parser, TOKEN_EOF)) {
-        if (member_count >= capacity) {
-            capacity = capacity == 0 ? 4 : capacity * 2;
-            members = (ast_node_t**)realloc(members, capacity * sizeof(ast_node_t*));
-        }
-        
-        members[member_count++] = parse_declaration(parser);
+        parser_scratch_push(parser, parse_declaration(parser));
     }
     
     parser_consume(parser, TOKEN_RBRACE, "متوقع '}' بعد أعضاء الصنف");
     
-    ast_node_t* node = ast_create_class_decl(name->value, parent, members, member_count, line, column);
-    token_destroy(name);
-    free(parent);
+    size_t member_count;
+    ast_node_t** members = (ast_node_t**)parser_scratch_take(parser, mark, &member_count);
+    
+    ast_node_t* node = ast_create_class_decl(&parser->arena, parser_token_text(parser, name), parent, members, member_count, line, column);
     return node;
 }
 
@@ -792,7 +700,7 @@ ast_node_t* parse_if_statement(parser_t* parser) {
         else_branch = parse_statement(parser);
     }
     
-    return ast_create_if(condition, then_branch, else_branch, line, column);
+    return ast_create_if(&parser->arena, condition, then_branch, else_branch, line, column);
 }
 
 ast_node_t* parse_while_statement(parser_t* parser) {
@@ -805,7 +713,7 @@ ast_node_t* parse_while_statement(parser_t* parser) {
     
     ast_node_t* body = parse_statement(parser);
     
-    return ast_create_while(condition, body, line, column);
+    return ast_create_while(&parser->arena, condition, body, line, column);
 }
 
 ast_node_t* parse_for_statement(parser_t* parser) {
@@ -816,13 +724,10 @@ ast_node_t* parse_for_statement(parser_t* parser) {
     
     /* التحقق مما إذا كان لكل-في */
     if (parser_check(parser, TOKEN_IDENTIFIER)) {
-        token_t* lookahead = lexer_next_token(parser->lexer);
+        token_t* lookahead = lexer_peek_token(parser->lexer, 0);
         if (lookahead->type == TOKEN_IN) {
-            token_destroy(lookahead);
             return parse_foreach_statement(parser);
         }
-        /* إرجاع الرمز */
-        /* ملاحظة: هذا يتطلب دعم إعادة الرموز في الليكسر */
     }
     
     /* لكل التقليدية */
@@ -832,8 +737,8 @@ ast_node_t* parse_for_statement(parser_t* parser) {
     if (!parser_check(parser, TOKEN_SEMICOLON)) {
         if (parser_match(parser, TOKEN_VAR)) {
             token_t* var = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم المتغير");
-            init_var = strdup(var->value);
-            token_destroy(var);
+            if (!var) return NULL;
+            init_var = parser_token_text(parser, var);
             if (parser_match(parser, TOKEN_ASSIGN)) {
                 init = parse_expression(parser);
             }
@@ -857,7 +762,7 @@ ast_node_t* parse_for_statement(parser_t* parser) {
     
     ast_node_t* body = parse_statement(parser);
     
-    return ast_create_for(init_var, init, condition, increment, body, line, column);
+    return ast_create_for(&parser->arena, init_var, init, condition, increment, body, line, column);
 }
 
 ast_node_t* parse_foreach_statement(parser_t* parser) {
@@ -874,8 +779,7 @@ ast_node_t* parse_foreach_statement(parser_t* parser) {
     
     ast_node_t* body = parse_statement(parser);
     
-    ast_node_t* node = ast_create_foreach(var->value, iterable, body, line, column);
-    token_destroy(var);
+    ast_node_t* node = ast_create_foreach(&parser->arena, parser_token_text(parser, var), iterable, body, line, column);
     return node;
 }
 
@@ -890,21 +794,21 @@ ast_node_t* parse_return_statement(parser_t* parser) {
     
     parser_match(parser, TOKEN_SEMICOLON);
     
-    return ast_create_return(value, line, column);
+    return ast_create_return(&parser->arena, value, line, column);
 }
 
 ast_node_t* parse_break_statement(parser_t* parser) {
     int line = parser->previous->line;
     int column = parser->previous->column;
     parser_match(parser, TOKEN_SEMICOLON);
-    return ast_create_break(line, column);
+    return ast_create_break(&parser->arena, line, column);
 }
 
 ast_node_t* parse_continue_statement(parser_t* parser) {
     int line = parser->previous->line;
     int column = parser->previous->column;
     parser_match(parser, TOKEN_SEMICOLON);
-    return ast_create_continue(line, column);
+    return ast_create_continue(&parser->arena, line, column);
 }
 
 ast_node_t* parse_import_statement(parser_t* parser) {
@@ -914,8 +818,7 @@ ast_node_t* parse_import_statement(parser_t* parser) {
     token_t* module = parser_consume(parser, TOKEN_STRING, "متوقع اسم الوحدة");
     if (!module) return NULL;
     
-    char** names = NULL;
-    size_t name_count = 0;
+    size_t mark = parser->scratch_count;
     
     if (parser_match(parser, TOKEN_IMPORT)) {
         /* استيراد محدد */
@@ -924,9 +827,7 @@ ast_node_t* parse_import_statement(parser_t* parser) {
         do {
             token_t* name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم للاستيراد");
             if (name) {
-                names = (char**)realloc(names, (name_count + 1) * sizeof(char*));
-                names[name_count++] = strdup(name->value);
-                token_destroy(name);
+                parser_scratch_push(parser, parser_token_text(parser, name));
             }
         } while (parser_match(parser, TOKEN_COMMA));
         
@@ -935,8 +836,10 @@ ast_node_t* parse_import_statement(parser_t* parser) {
     
     parser_match(parser, TOKEN_SEMICOLON);
     
-    ast_node_t* node = ast_create_import(module->value, names, name_count, line, column);
-    token_destroy(module);
+    size_t name_count;
+    char** names = (char**)parser_scratch_take(parser, mark, &name_count);
+    
+    ast_node_t* node = ast_create_import(&parser->arena, parser_token_text(parser, module), names, name_count, line, column);
     return node;
 }
 
@@ -944,16 +847,13 @@ ast_node_t* parse_export_statement(parser_t* parser) {
     int line = parser->previous->line;
     int column = parser->previous->column;
     
-    char** names = NULL;
-    size_t name_count = 0;
+    size_t mark = parser->scratch_count;
     
     if (parser_match(parser, TOKEN_LBRACE)) {
         do {
             token_t* name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم للتصدير");
             if (name) {
-                names = (char**)realloc(names, (name_count + 1) * sizeof(char*));
-                names[name_count++] = strdup(name->value);
-                token_destroy(name);
+                parser_scratch_push(parser, parser_token_text(parser, name));
             }
         } while (parser_match(parser, TOKEN_COMMA));
         
@@ -962,26 +862,22 @@ ast_node_t* parse_export_statement(parser_t* parser) {
     
     parser_match(parser, TOKEN_SEMICOLON);
     
-    return ast_create_export(names, name_count, line, column);
+    size_t name_count;
+    char** names = (char**)parser_scratch_take(parser, mark, &name_count);
+    
+    return ast_create_export(&parser->arena, names, name_count, line, column);
 }
 
 ast_node_t* parse_block(parser_t* parser) {
     int line = parser->previous->line;
     int column = parser->previous->column;
     
-    ast_node_t** statements = NULL;
-    size_t count = 0;
-    size_t capacity = 0;
+    size_t mark = parser->scratch_count;
     
     while (!parser_check(parser, TOKEN_RBRACE) && !parser_check(parser, TOKEN_EOF)) {
-        if (count >= capacity) {
-            capacity = capacity == 0 ? 8 : capacity * 2;
-            statements = (ast_node_t**)realloc(statements, capacity * sizeof(ast_node_t*));
-        }
-        
         ast_node_t* stmt = parse_declaration(parser);
         if (stmt) {
-            statements[count++] = stmt;
+            parser_scratch_push(parser, stmt);
         }
         
         if (parser->panic_mode) {
@@ -991,7 +887,10 @@ ast_node_t* parse_block(parser_t* parser) {
     
     parser_consume(parser, TOKEN_RBRACE, "متوقع '}' في نهاية الكتلة");
     
-    return ast_create_block(statements, count, line, column);
+    size_t count;
+    ast_node_t** statements = (ast_node_t**)parser_scratch_take(parser, mark, &count);
+    
+    return ast_create_block(&parser->arena, statements, count, line, column);
 }
 
 ast_node_t* parse_expression_statement(parser_t* parser) {
@@ -1001,7 +900,7 @@ ast_node_t* parse_expression_statement(parser_t* parser) {
     ast_node_t* expr = parse_expression(parser);
     parser_match(parser, TOKEN_SEMICOLON);
     
-    return ast_create_expression_stmt(expr, line, column);
+    return ast_create_expression_stmt(&parser->arena, expr, line, column);
 }
 
 /* ========== تحليل التعبيرات ========== */
@@ -1012,32 +911,33 @@ ast_node_t* parse_expression(parser_t* parser) {
 
 ast_node_t* parse_assignment(parser_t* parser) {
     ast_node_t* expr = parse_ternary(parser);
+    if (!expr) return NULL;
     
     if (parser_match(parser, TOKEN_ASSIGN)) {
         ast_node_t* value = parse_assignment(parser);
-        return ast_create_assignment(expr, value, expr->line, expr->column);
+        return ast_create_assignment(&parser->arena, expr, value, expr->line, expr->column);
     }
     
     /* تعيينات مركبة */
     if (parser_match(parser, TOKEN_PLUS_ASSIGN)) {
         ast_node_t* value = parse_assignment(parser);
-        ast_node_t* add = ast_create_binary_op(BINOP_ADD, expr, value, expr->line, expr->column);
-        return ast_create_assignment(expr, add, expr->line, expr->column);
+        ast_node_t* add = ast_create_binary_op(&parser->arena, BINOP_ADD, expr, value, expr->line, expr->column);
+        return ast_create_assignment(&parser->arena, expr, add, expr->line, expr->column);
     }
     if (parser_match(parser, TOKEN_MINUS_ASSIGN)) {
         ast_node_t* value = parse_assignment(parser);
-        ast_node_t* sub = ast_create_binary_op(BINOP_SUB, expr, value, expr->line, expr->column);
-        return ast_create_assignment(expr, sub, expr->line, expr->column);
+        ast_node_t* sub = ast_create_binary_op(&parser->arena, BINOP_SUB, expr, value, expr->line, expr->column);
+        return ast_create_assignment(&parser->arena, expr, sub, expr->line, expr->column);
     }
-    if (parser_match(parser, TOKEN_MUL_ASSIGN)) {
+    if (parser_match(parser, TOKEN_STAR_ASSIGN)) {
         ast_node_t* value = parse_assignment(parser);
-        ast_node_t* mul = ast_create_binary_op(BINOP_MUL, expr, value, expr->line, expr->column);
-        return ast_create_assignment(expr, mul, expr->line, expr->column);
+        ast_node_t* mul = ast_create_binary_op(&parser->arena, BINOP_MUL, expr, value, expr->line, expr->column);
+        return ast_create_assignment(&parser->arena, expr, mul, expr->line, expr->column);
     }
-    if (parser_match(parser, TOKEN_DIV_ASSIGN)) {
+    if (parser_match(parser, TOKEN_SLASH_ASSIGN)) {
         ast_node_t* value = parse_assignment(parser);
-        ast_node_t* div = ast_create_binary_op(BINOP_DIV, expr, value, expr->line, expr->column);
-        return ast_create_assignment(expr, div, expr->line, expr->column);
+        ast_node_t* div = ast_create_binary_op(&parser->arena, BINOP_DIV, expr, value, expr->line, expr->column);
+        return ast_create_assignment(&parser->arena, expr, div, expr->line, expr->column);
     }
     
     return expr;
@@ -1050,7 +950,7 @@ ast_node_t* parse_ternary(parser_t* parser) {
         ast_node_t* true_expr = parse_expression(parser);
         parser_consume(parser, TOKEN_COLON, "متوقع ':' في العملية الثلاثية");
         ast_node_t* false_expr = parse_ternary(parser);
-        return ast_create_ternary(condition, true_expr, false_expr, condition->line, condition->column);
+        return ast_create_ternary(&parser->arena, condition, true_expr, false_expr, condition->line, condition->column);
     }
     
     return condition;
@@ -1061,7 +961,7 @@ ast_node_t* parse_or(parser_t* parser) {
     
     while (parser_match(parser, TOKEN_OR)) {
         ast_node_t* right = parse_and(parser);
-        left = ast_create_binary_op(BINOP_OR, left, right, left->line, left->column);
+        left = ast_create_binary_op(&parser->arena, BINOP_OR, left, right, left->line, left->column);
     }
     
     return left;
@@ -1072,7 +972,7 @@ ast_node_t* parse_and(parser_t* parser) {
     
     while (parser_match(parser, TOKEN_AND)) {
         ast_node_t* right = parse_equality(parser);
-        left = ast_create_binary_op(BINOP_AND, left, right, left->line, left->column);
+        left = ast_create_binary_op(&parser->arena, BINOP_AND, left, right, left->line, left->column);
     }
     
     return left;
@@ -1084,10 +984,10 @@ ast_node_t* parse_equality(parser_t* parser) {
     while (1) {
         if (parser_match(parser, TOKEN_EQ)) {
             ast_node_t* right = parse_comparison(parser);
-            left = ast_create_binary_op(BINOP_EQ, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_EQ, left, right, left->line, left->column);
         } else if (parser_match(parser, TOKEN_NE)) {
             ast_node_t* right = parse_comparison(parser);
-            left = ast_create_binary_op(BINOP_NE, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_NE, left, right, left->line, left->column);
         } else {
             break;
         }
@@ -1102,16 +1002,16 @@ ast_node_t* parse_comparison(parser_t* parser) {
     while (1) {
         if (parser_match(parser, TOKEN_LT)) {
             ast_node_t* right = parse_bitwise_or(parser);
-            left = ast_create_binary_op(BINOP_LT, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_LT, left, right, left->line, left->column);
         } else if (parser_match(parser, TOKEN_GT)) {
             ast_node_t* right = parse_bitwise_or(parser);
-            left = ast_create_binary_op(BINOP_GT, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_GT, left, right, left->line, left->column);
         } else if (parser_match(parser, TOKEN_LE)) {
             ast_node_t* right = parse_bitwise_or(parser);
-            left = ast_create_binary_op(BINOP_LE, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_LE, left, right, left->line, left->column);
         } else if (parser_match(parser, TOKEN_GE)) {
             ast_node_t* right = parse_bitwise_or(parser);
-            left = ast_create_binary_op(BINOP_GE, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_GE, left, right, left->line, left->column);
         } else {
             break;
         }
@@ -1125,7 +1025,7 @@ ast_node_t* parse_bitwise_or(parser_t* parser) {
     
     while (parser_match(parser, TOKEN_BIT_OR)) {
         ast_node_t* right = parse_bitwise_xor(parser);
-        left = ast_create_binary_op(BINOP_BIT_OR, left, right, left->line, left->column);
+        left = ast_create_binary_op(&parser->arena, BINOP_BIT_OR, left, right, left->line, left->column);
     }
     
     return left;
@@ -1136,7 +1036,7 @@ ast_node_t* parse_bitwise_xor(parser_t* parser) {
     
     while (parser_match(parser, TOKEN_BIT_XOR)) {
         ast_node_t* right = parse_bitwise_and(parser);
-        left = ast_create_binary_op(BINOP_BIT_XOR, left, right, left->line, left->column);
+        left = ast_create_binary_op(&parser->arena, BINOP_BIT_XOR, left, right, left->line, left->column);
     }
     
     return left;
@@ -1147,7 +1047,7 @@ ast_node_t* parse_bitwise_and(parser_t* parser) {
     
     while (parser_match(parser, TOKEN_BIT_AND)) {
         ast_node_t* right = parse_shift(parser);
-        left = ast_create_binary_op(BINOP_BIT_AND, left, right, left->line, left->column);
+        left = ast_create_binary_op(&parser->arena, BINOP_BIT_AND, left, right, left->line, left->column);
     }
     
     return left;
@@ -1159,10 +1059,10 @@ ast_node_t* parse_shift(parser_t* parser) {
     while (1) {
         if (parser_match(parser, TOKEN_SHL)) {
             ast_node_t* right = parse_additive(parser);
-            left = ast_create_binary_op(BINOP_SHL, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_SHL, left, right, left->line, left->column);
         } else if (parser_match(parser, TOKEN_SHR)) {
             ast_node_t* right = parse_additive(parser);
-            left = ast_create_binary_op(BINOP_SHR, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_SHR, left, right, left->line, left->column);
         } else {
             break;
         }
@@ -1177,10 +1077,10 @@ ast_node_t* parse_additive(parser_t* parser) {
     while (1) {
         if (parser_match(parser, TOKEN_PLUS)) {
             ast_node_t* right = parse_multiplicative(parser);
-            left = ast_create_binary_op(BINOP_ADD, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_ADD, left, right, left->line, left->column);
         } else if (parser_match(parser, TOKEN_MINUS)) {
             ast_node_t* right = parse_multiplicative(parser);
-            left = ast_create_binary_op(BINOP_SUB, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_SUB, left, right, left->line, left->column);
         } else {
             break;
         }
@@ -1193,18 +1093,18 @@ ast_node_t* parse_multiplicative(parser_t* parser) {
     ast_node_t* left = parse_unary(parser);
     
     while (1) {
-        if (parser_match(parser, TOKEN_MUL)) {
+        if (parser_match(parser, TOKEN_STAR)) {
             ast_node_t* right = parse_unary(parser);
-            left = ast_create_binary_op(BINOP_MUL, left, right, left->line, left->column);
-        } else if (parser_match(parser, TOKEN_DIV)) {
+            left = ast_create_binary_op(&parser->arena, BINOP_MUL, left, right, left->line, left->column);
+        } else if (parser_match(parser, TOKEN_SLASH)) {
             ast_node_t* right = parse_unary(parser);
-            left = ast_create_binary_op(BINOP_DIV, left, right, left->line, left->column);
-        } else if (parser_match(parser, TOKEN_MOD)) {
+            left = ast_create_binary_op(&parser->arena, BINOP_DIV, left, right, left->line, left->column);
+        } else if (parser_match(parser, TOKEN_PERCENT)) {
             ast_node_t* right = parse_unary(parser);
-            left = ast_create_binary_op(BINOP_MOD, left, right, left->line, left->column);
-        } else if (parser_match(parser, TOKEN_POW)) {
+            left = ast_create_binary_op(&parser->arena, BINOP_MOD, left, right, left->line, left->column);
+        } else if (parser_match(parser, TOKEN_POWER)) {
             ast_node_t* right = parse_unary(parser);
-            left = ast_create_binary_op(BINOP_POW, left, right, left->line, left->column);
+            left = ast_create_binary_op(&parser->arena, BINOP_POW, left, right, left->line, left->column);
         } else {
             break;
         }
@@ -1216,23 +1116,23 @@ ast_node_t* parse_multiplicative(parser_t* parser) {
 ast_node_t* parse_unary(parser_t* parser) {
     if (parser_match(parser, TOKEN_NOT)) {
         ast_node_t* operand = parse_unary(parser);
-        return ast_create_unary_op(UNOP_NOT, operand, parser->previous->line, parser->previous->column);
+        return ast_create_unary_op(&parser->arena, UNOP_NOT, operand, parser->previous->line, parser->previous->column);
     }
     if (parser_match(parser, TOKEN_MINUS)) {
         ast_node_t* operand = parse_unary(parser);
-        return ast_create_unary_op(UNOP_NEG, operand, parser->previous->line, parser->previous->column);
+        return ast_create_unary_op(&parser->arena, UNOP_NEG, operand, parser->previous->line, parser->previous->column);
     }
-    if (parser_match(parser, TOKEN_BIT_NOT)) {
+    if (parser_match(parser, TOKEN_BIT_XOR)) {
         ast_node_t* operand = parse_unary(parser);
-        return ast_create_unary_op(UNOP_BIT_NOT, operand, parser->previous->line, parser->previous->column);
+        return ast_create_unary_op(&parser->arena, UNOP_BIT_NOT, operand, parser->previous->line, parser->previous->column);
     }
     if (parser_match(parser, TOKEN_INC)) {
         ast_node_t* operand = parse_unary(parser);
-        return ast_create_unary_op(UNOP_INC, operand, parser->previous->line, parser->previous->column);
+        return ast_create_unary_op(&parser->arena, UNOP_INC, operand, parser->previous->line, parser->previous->column);
     }
     if (parser_match(parser, TOKEN_DEC)) {
         ast_node_t* operand = parse_unary(parser);
-        return ast_create_unary_op(UNOP_DEC, operand, parser->previous->line, parser->previous->column);
+        return ast_create_unary_op(&parser->arena, UNOP_DEC, operand, parser->previous->line, parser->previous->column);
     }
     
     return parse_postfix(parser);
@@ -1240,6 +1140,7 @@ ast_node_t* parse_unary(parser_t* parser) {
 
 ast_node_t* parse_postfix(parser_t* parser) {
     ast_node_t* expr = parse_primary(parser);
+    if (!expr) return NULL;
     
     while (1) {
         if (parser_match(parser, TOKEN_LPAREN)) {
@@ -1247,17 +1148,16 @@ ast_node_t* parse_postfix(parser_t* parser) {
         } else if (parser_match(parser, TOKEN_DOT)) {
             token_t* member = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم العضو بعد '.'");
             if (member) {
-                expr = ast_create_member_access(expr, member->value, expr->line, expr->column);
-                token_destroy(member);
+                expr = ast_create_member_access(&parser->arena, expr, parser_token_text(parser, member), expr->line, expr->column);
             }
         } else if (parser_match(parser, TOKEN_LBRACKET)) {
             ast_node_t* index = parse_expression(parser);
             parser_consume(parser, TOKEN_RBRACKET, "متوقع ']' بعد الفهرس");
-            expr = ast_create_index_access(expr, index, expr->line, expr->column);
+            expr = ast_create_index_access(&parser->arena, expr, index, expr->line, expr->column);
         } else if (parser_match(parser, TOKEN_INC)) {
-            expr = ast_create_unary_op(UNOP_INC, expr, expr->line, expr->column);
+            expr = ast_create_unary_op(&parser->arena, UNOP_INC, expr, expr->line, expr->column);
         } else if (parser_match(parser, TOKEN_DEC)) {
-            expr = ast_create_unary_op(UNOP_DEC, expr, expr->line, expr->column);
+            expr = ast_create_unary_op(&parser->arena, UNOP_DEC, expr, expr->line, expr->column);
         } else {
             break;
         }
@@ -1267,44 +1167,45 @@ ast_node_t* parse_postfix(parser_t* parser) {
 }
 
 ast_node_t* parse_call(parser_t* parser, ast_node_t* callee) {
-    ast_node_t** args = NULL;
-    size_t arg_count = 0;
+    size_t mark = parser->scratch_count;
     
     if (!parser_check(parser, TOKEN_RPAREN)) {
         do {
-            args = (ast_node_t**)realloc(args, (arg_count + 1) * sizeof(ast_node_t*));
-            args[arg_count++] = parse_expression(parser);
+            parser_scratch_push(parser, parse_expression(parser));
         } while (parser_match(parser, TOKEN_COMMA));
     }
     
     parser_consume(parser, TOKEN_RPAREN, "متوقع ')' بعد المعاملات");
     
-    return ast_create_call(callee, args, arg_count, callee->line, callee->column);
+    size_t arg_count;
+    ast_node_t** args = (ast_node_t**)parser_scratch_take(parser, mark, &arg_count);
+    
+    return ast_create_call(&parser->arena, callee, args, arg_count, callee->line, callee->column);
 }
 
 ast_node_t* parse_primary(parser_t* parser) {
-    if (parser_match(parser, TOKEN_NUMBER)) {
-        return ast_create_number(parser->previous->value, parser->previous->line, parser->previous->column);
+    if (parser_match(parser, TOKEN_INT) || parser_match(parser, TOKEN_FLOAT)) {
+        return ast_create_number(&parser->arena, parser_token_text(parser, parser->previous), parser->previous->line, parser->previous->column);
     }
     
     if (parser_match(parser, TOKEN_STRING)) {
-        return ast_create_string(parser->previous->value, parser->previous->line, parser->previous->column);
+        return ast_create_string(&parser->arena, parser_token_text(parser, parser->previous), parser->previous->line, parser->previous->column);
     }
     
     if (parser_match(parser, TOKEN_TRUE)) {
-        return ast_create_boolean(1, parser->previous->line, parser->previous->column);
+        return ast_create_boolean(&parser->arena, 1, parser->previous->line, parser->previous->column);
     }
     
     if (parser_match(parser, TOKEN_FALSE)) {
-        return ast_create_boolean(0, parser->previous->line, parser->previous->column);
+        return ast_create_boolean(&parser->arena, 0, parser->previous->line, parser->previous->column);
     }
     
-    if (parser_match(parser, TOKEN_NULL)) {
-        return ast_create_null(parser->previous->line, parser->previous->column);
+    if (parser_match(parser, TOKEN_NULL_KW)) {
+        return ast_create_null(&parser->arena, parser->previous->line, parser->previous->column);
     }
     
     if (parser_match(parser, TOKEN_IDENTIFIER)) {
-        return ast_create_identifier(parser->previous->value, parser->previous->line, parser->previous->column);
+        return ast_create_identifier(&parser->arena, parser_token_text(parser, parser->previous), parser->previous->line, parser->previous->column);
     }
     
     if (parser_match(parser, TOKEN_LPAREN)) {
@@ -1326,12 +1227,22 @@ ast_node_t* parse_primary(parser_t* parser) {
     }
     
     if (parser_match(parser, TOKEN_THIS)) {
-        return ast_create_identifier("هذا", parser->previous->line, parser->previous->column);
+        return ast_create_identifier(&parser->arena, "هذا", parser->previous->line, parser->previous->column);
+    }
+    
+    /* جديد صنف(...) يكافئ استدعاء الصنف مباشرة */
+    if (parser_match(parser, TOKEN_NEW)) {
+        return parse_postfix(parser);
     }
     
     fprintf(stderr, "خطأ في السطر %d، العمود %d: تعبير غير متوقع\n",
             parser->current->line, parser->current->column);
     parser->had_error = 1;
+    parser->panic_mode = 1;
+    /* تجاوز الرمز غير المتوقع لضمان التقدم عند الاستعادة */
+    if (!parser_check(parser, TOKEN_EOF)) {
+        parser_advance(parser);
+    }
     return NULL;
 }
 
@@ -1339,28 +1250,27 @@ ast_node_t* parse_list_literal(parser_t* parser) {
     int line = parser->previous->line;
     int column = parser->previous->column;
     
-    ast_node_t** elements = NULL;
-    size_t count = 0;
+    size_t mark = parser->scratch_count;
     
     if (!parser_check(parser, TOKEN_RBRACKET)) {
         do {
-            elements = (ast_node_t**)realloc(elements, (count + 1) * sizeof(ast_node_t*));
-            elements[count++] = parse_expression(parser);
+            parser_scratch_push(parser, parse_expression(parser));
         } while (parser_match(parser, TOKEN_COMMA));
     }
     
     parser_consume(parser, TOKEN_RBRACKET, "متوقع ']' في نهاية القائمة");
     
-    return ast_create_list_literal(elements, count, line, column);
+    size_t count;
+    ast_node_t** elements = (ast_node_t**)parser_scratch_take(parser, mark, &count);
+    
+    return ast_create_list_literal(&parser->arena, elements, count, line, column);
 }
 
 ast_node_t* parse_dict_literal(parser_t* parser) {
     int line = parser->previous->line;
     int column = parser->previous->column;
     
-    ast_node_t** keys = NULL;
-    ast_node_t** values = NULL;
-    size_t count = 0;
+    size_t mark = parser->scratch_count;
     
     if (!parser_check(parser, TOKEN_RBRACE)) {
         do {
@@ -1368,17 +1278,18 @@ ast_node_t* parse_dict_literal(parser_t* parser) {
             parser_consume(parser, TOKEN_COLON, "متوقع ':' بين المفتاح والقيمة");
             ast_node_t* value = parse_expression(parser);
             
-            keys = (ast_node_t**)realloc(keys, (count + 1) * sizeof(ast_node_t*));
-            values = (ast_node_t**)realloc(values, (count + 1) * sizeof(ast_node_t*));
-            keys[count] = key;
-            values[count] = value;
-            count++;
+            parser_scratch_push(parser, key);
+            parser_scratch_push(parser, value);
         } while (parser_match(parser, TOKEN_COMMA));
     }
     
     parser_consume(parser, TOKEN_RBRACE, "متوقع '}' في نهاية القاموس");
     
-    return ast_create_dict_literal(keys, values, count, line, column);
+    void** keys;
+    void** values;
+    size_t count = parser_scratch_take_pairs(parser, mark, &keys, &values);
+    
+    return ast_create_dict_literal(&parser->arena, (ast_node_t**)keys, (ast_node_t**)values, count, line, column);
 }
 
 ast_node_t* parse_lambda(parser_t* parser) {
@@ -1387,22 +1298,22 @@ ast_node_t* parse_lambda(parser_t* parser) {
     
     parser_consume(parser, TOKEN_LPAREN, "متوقع '(' بعد 'دالة'");
     
-    char** params = NULL;
-    size_t param_count = 0;
+    size_t mark = parser->scratch_count;
     
     if (!parser_check(parser, TOKEN_RPAREN)) {
         do {
             token_t* param = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم المعامل");
             if (param) {
-                params = (char**)realloc(params, (param_count + 1) * sizeof(char*));
-                params[param_count++] = strdup(param->value);
-                token_destroy(param);
+                parser_scratch_push(parser, parser_token_text(parser, param));
             }
         } while (parser_match(parser, TOKEN_COMMA));
     }
     
     parser_consume(parser, TOKEN_RPAREN, "متوقع ')' بعد المعاملات");
     
+    size_t param_count;
+    char** params = (char**)parser_scratch_take(parser, mark, &param_count);
+    
     ast_node_t* body;
     if (parser_match(parser, TOKEN_LBRACE)) {
         body = parse_block(parser);
@@ -1411,7 +1322,7 @@ ast_node_t* parse_lambda(parser_t* parser) {
         body = parse_expression(parser);
     }
     
-    return ast_create_lambda(params, param_count, body, line, column);
+    return ast_create_lambda(&parser->arena, params, param_count, body, line, column);
 }
 
 /* ========== دوال الطباعة والتصحيح ========== */
@@ -1510,35 +1421,35 @@ void ast_print(ast_node_t* node, int indent) {
             print_indent(indent + 1);
             printf("قيمة: %s\n", node->data.number.value);
             break;
-            
+        
         case AST_STRING:
             print_indent(indent + 1);
             printf("قيمة: \"%s\"\n", node->data.string.value);
             break;
-            
+        
         case AST_BOOLEAN:
             print_indent(indent + 1);
             printf("قيمة: %s\n", node->data.boolean.value ? "صحيح" : "خطأ");
             break;
-            
+        
         case AST_IDENTIFIER:
             print_indent(indent + 1);
             printf("اسم: %s\n", node->data.identifier.name);
             break;
-            
+        
         case AST_BINARY_OP:
             print_indent(indent + 1);
             printf("عملية: %s\n", binop_type_name(node->data.binary_op.op));
             ast_print(node->data.binary_op.left, indent + 1);
             ast_print(node->data.binary_op.right, indent + 1);
             break;
-            
+        
         case AST_UNARY_OP:
             print_indent(indent + 1);
             printf("عملية: %s\n", unop_type_name(node->data.unary_op.op));
             ast_print(node->data.unary_op.operand, indent + 1);
             break;
-            
+        
         case AST_ASSIGNMENT:
             print_indent(indent + 1);
             printf("هدف:\n");
@@ -1547,7 +1458,7 @@ void ast_print(ast_node_t* node, int indent) {
             printf("قيمة:\n");
             ast_print(node->data.assignment.value, indent + 2);
             break;
-            
+        
         case AST_CALL:
             print_indent(indent + 1);
             printf("دالة:\n");
@@ -1558,7 +1469,7 @@ void ast_print(ast_node_t* node, int indent) {
                 ast_print(node->data.call.args[i], indent + 2);
             }
             break;
-            
+        
         case AST_VAR_DECL:
         case AST_CONST_DECL:
             print_indent(indent + 1);
@@ -1571,7 +1482,7 @@ void ast_print(ast_node_t* node, int indent) {
                 ast_print(node->data.var_decl.initializer, indent + 2);
             }
             break;
-            
+        
         case AST_FUNC_DECL:
             print_indent(indent + 1);
             printf("اسم: %s\n", node->data.func_decl.name);
@@ -1585,7 +1496,7 @@ void ast_print(ast_node_t* node, int indent) {
             printf("جسم:\n");
             ast_print(node->data.func_decl.body, indent + 2);
             break;
-            
+        
         case AST_IF:
             print_indent(indent + 1);
             printf("شرط:\n");
@@ -1599,7 +1510,7 @@ void ast_print(ast_node_t* node, int indent) {
                 ast_print(node->data.if_stmt.else_branch, indent + 2);
             }
             break;
-            
+        
         case AST_WHILE:
             print_indent(indent + 1);
             printf("شرط:\n");
@@ -1608,18 +1519,18 @@ void ast_print(ast_node_t* node, int indent) {
             printf("جسم:\n");
             ast_print(node->data.while_stmt.body, indent + 2);
             break;
-            
+        
         case AST_BLOCK:
         case AST_PROGRAM:
             for (size_t i = 0; i < node->data.block.statement_count; i++) {
                 ast_print(node->data.block.statements[i], indent + 1);
             }
             break;
-            
+        
         case AST_EXPRESSION_STMT:
             ast_print(node->data.expression_stmt.expression, indent + 1);
             break;
-            
+        
         case AST_RETURN:
             if (node->data.return_stmt.value) {
                 print_indent(indent + 1);
@@ -1627,7 +1538,7 @@ void ast_print(ast_node_t* node, int indent) {
                 ast_print(node->data.return_stmt.value, indent + 2);
             }
             break;
-            
+        
         case AST_LIST_LITERAL:
             print_indent(indent + 1);
             printf("عناصر (%zu):\n", node->data.list_literal.element_count);
@@ -1635,7 +1546,7 @@ void ast_print(ast_node_t* node, int indent) {
                 ast_print(node->data.list_literal.elements[i], indent + 2);
             }
             break;
-            
+        
         case AST_DICT_LITERAL:
             print_indent(indent + 1);
             printf("إدخالات (%zu):\n", node->data.dict_literal.entry_count);
@@ -1648,7 +1559,7 @@ void ast_print(ast_node_t* node, int indent) {
                 ast_print(node->data.dict_literal.values[i], indent + 3);
             }
             break;
-            
+        
         default:
             break;
     }
@@ -241,6 +241,41 @@ typedef struct ast_node {
     } data;
 } ast_node_t;
 
+/* ساحة الشجرة: كتل كبيرة تُقتطع منها العقد ونصوصها ومصفوفاتها
+ * بالتتابع، وتُحرر كلها دفعة واحدة مع المحلل. لا تُحرر عقدة منفردة */
+#define AST_ARENA_BLOCK_SIZE (64 * 1024)
+#define AST_ARENA_ALIGN 8
+
+typedef struct ast_arena_block {
+    struct ast_arena_block* next;
+    size_t size;
+    char data[];
+} ast_arena_block_t;
+
+typedef struct {
+    ast_arena_block_t* blocks;       /* الكتلة الحالية أولاً */
+    char* ptr;
+    char* end;
+    size_t total;                    /* مجموع أحجام الكتل */
+} ast_arena_t;
+
+void ast_arena_init(ast_arena_t* arena);
+void ast_arena_free(ast_arena_t* arena);
+void* ast_arena_grow(ast_arena_t* arena, size_t size);
+char* ast_arena_strndup(ast_arena_t* arena, const char* str, size_t length);
+void* ast_arena_copy(ast_arena_t* arena, const void* data, size_t size);
+
+/* المسار السريع: تقديم المؤشر داخل الكتلة الحالية */
+static inline void* ast_arena_alloc(ast_arena_t* arena, size_t size) {
+    size = (size + AST_ARENA_ALIGN - 1) & ~(size_t)(AST_ARENA_ALIGN - 1);
+    if ((size_t)(arena->end - arena->ptr) >= size) {
+        void* result = arena->ptr;
+        arena->ptr += size;
+        return result;
+    }
+    return ast_arena_grow(arena, size);
+}
+
 /* هيكل المحلل اللغوي */
 typedef struct {
     lexer_t* lexer;
@@ -248,49 +283,58 @@ typedef struct {
     token_t* previous;
     int had_error;
     int panic_mode;
+    
+    /* الشجرة الناتجة تعيش في الساحة حتى parser_destroy */
+    ast_arena_t arena;
+    
+    /* مكدس مؤقت تُجمع فيه عناصر القوائم أثناء تحليلها ثم تُنسخ
+     * إلى الساحة بحجمها النهائي. القوائم المتداخلة تشترك فيه */
+    void** scratch;
+    size_t scratch_count;
+    size_t scratch_capacity;
 } parser_t;
 
-/* إنشاء وإتلاف العقد */
-ast_node_t* ast_create_node(ast_node_type_t type, int line, int column);
-void ast_destroy_node(ast_node_t* node);
-ast_node_t* ast_create_number(const char* value, int line, int column);
-ast_node_t* ast_create_string(const char* value, int line, int column);
-ast_node_t* ast_create_boolean(int value, int line, int column);
-ast_node_t* ast_create_null(int line, int column);
-ast_node_t* ast_create_identifier(const char* name, int line, int column);
+/* إنشاء العقد (في ساحة المحلل). النصوص الممررة تُخزن كما هي دون نسخ،
+ * فيجب أن تعيش في الساحة نفسها أو أن تكون ثابتة */
+ast_node_t* ast_create_node(ast_arena_t* arena, ast_node_type_t type, int line, int column);
+ast_node_t* ast_create_number(ast_arena_t* arena, char* value, int line, int column);
+ast_node_t* ast_create_string(ast_arena_t* arena, char* value, int line, int column);
+ast_node_t* ast_create_boolean(ast_arena_t* arena, int value, int line, int column);
+ast_node_t* ast_create_null(ast_arena_t* arena, int line, int column);
+ast_node_t* ast_create_identifier(ast_arena_t* arena, char* name, int line, int column);
 
 /* إنشاء عقد التعبيرات */
-ast_node_t* ast_create_binary_op(binop_type_t op, ast_node_t* left, ast_node_t* right, int line, int column);
-ast_node_t* ast_create_unary_op(unop_type_t op, ast_node_t* operand, int line, int column);
-ast_node_t* ast_create_assignment(ast_node_t* target, ast_node_t* value, int line, int column);
-ast_node_t* ast_create_call(ast_node_t* callee, ast_node_t** args, size_t arg_count, int line, int column);
-ast_node_t* ast_create_member_access(ast_node_t* object, const char* member, int line, int column);
-ast_node_t* ast_create_index_access(ast_node_t* object, ast_node_t* index, int line, int column);
-ast_node_t* ast_create_list_literal(ast_node_t** elements, size_t count, int line, int column);
-ast_node_t* ast_create_dict_literal(ast_node_t** keys, ast_node_t** values, size_t count, int line, int column);
-ast_node_t* ast_create_lambda(char** params, size_t param_count, ast_node_t* body, int line, int column);
-ast_node_t* ast_create_ternary(ast_node_t* cond, ast_node_t* true_expr, ast_node_t* false_expr, int line, int column);
+ast_node_t* ast_create_binary_op(ast_arena_t* arena, binop_type_t op, ast_node_t* left, ast_node_t* right, int line, int column);
+ast_node_t* ast_create_unary_op(ast_arena_t* arena, unop_type_t op, ast_node_t* operand, int line, int column);
+ast_node_t* ast_create_assignment(ast_arena_t* arena, ast_node_t* target, ast_node_t* value, int line, int column);
+ast_node_t* ast_create_call(ast_arena_t* arena, ast_node_t* callee, ast_node_t** args, size_t arg_count, int line, int column);
+ast_node_t* ast_create_member_access(ast_arena_t* arena, ast_node_t* object, char* member, int line, int column);
+ast_node_t* ast_create_index_access(ast_arena_t* arena, ast_node_t* object, ast_node_t* index, int line, int column);
+ast_node_t* ast_create_list_literal(ast_arena_t* arena, ast_node_t** elements, size_t count, int line, int column);
+ast_node_t* ast_create_dict_literal(ast_arena_t* arena, ast_node_t** keys, ast_node_t** values, size_t count, int line, int column);
+ast_node_t* ast_create_lambda(ast_arena_t* arena, char** params, size_t param_count, ast_node_t* body, int line, int column);
+ast_node_t* ast_create_ternary(ast_arena_t* arena, ast_node_t* cond, ast_node_t* true_expr, ast_node_t* false_expr, int line, int column);
 
 /* إنشاء عقد التصريحات */
-ast_node_t* ast_create_var_decl(const char* name, ast_node_t* init, int is_mutable, int line, int column);
-ast_node_t* ast_create_const_decl(const char* name, ast_node_t* init, int line, int column);
-ast_node_t* ast_create_func_decl(const char* name, char** params, size_t param_count, 
+ast_node_t* ast_create_var_decl(ast_arena_t* arena, char* name, ast_node_t* init, int is_mutable, int line, int column);
+ast_node_t* ast_create_const_decl(ast_arena_t* arena, char* name, ast_node_t* init, int line, int column);
+ast_node_t* ast_create_func_decl(ast_arena_t* arena, char* name, char** params, size_t param_count, 
                                    ast_node_t** defaults, ast_node_t* body, int line, int column);
-ast_node_t* ast_create_class_decl(const char* name, const char* parent, 
+ast_node_t* ast_create_class_decl(ast_arena_t* arena, char* name, char* parent, 
                                     ast_node_t** members, size_t member_count, int line, int column);
-ast_node_t* ast_create_return(ast_node_t* value, int line, int column);
-ast_node_t* ast_create_if(ast_node_t* cond, ast_node_t* then_branch, ast_node_t* else_branch, int line, int column);
-ast_node_t* ast_create_while(ast_node_t* cond, ast_node_t* body, int line, int column);
-ast_node_t* ast_create_for(const char* var, ast_node_t* init, ast_node_t* cond, 
+ast_node_t* ast_create_return(ast_arena_t* arena, ast_node_t* value, int line, int column);
+ast_node_t* ast_create_if(ast_arena_t* arena, ast_node_t* cond, ast_node_t* then_branch, ast_node_t* else_branch, int line, int column);
+ast_node_t* ast_create_while(ast_arena_t* arena, ast_node_t* cond, ast_node_t* body, int line, int column);
+ast_node_t* ast_create_for(ast_arena_t* arena, char* var, ast_node_t* init, ast_node_t* cond, 
                              ast_node_t* inc, ast_node_t* body, int line, int column);
-ast_node_t* ast_create_foreach(const char* var, ast_node_t* iterable, ast_node_t* body, int line, int column);
-ast_node_t* ast_create_break(int line, int column);
-ast_node_t* ast_create_continue(int line, int column);
-ast_node_t* ast_create_block(ast_node_t** stmts, size_t count, int line, int column);
-ast_node_t* ast_create_expression_stmt(ast_node_t* expr, int line, int column);
-ast_node_t* ast_create_import(const char* module, char** names, size_t count, int line, int column);
-ast_node_t* ast_create_export(char** names, size_t count, int line, int column);
-ast_node_t* ast_create_program(ast_node_t** stmts, size_t count, int line, int column);
+ast_node_t* ast_create_foreach(ast_arena_t* arena, char* var, ast_node_t* iterable, ast_node_t* body, int line, int column);
+ast_node_t* ast_create_break(ast_arena_t* arena, int line, int column);
+ast_node_t* ast_create_continue(ast_arena_t* arena, int line, int column);
+ast_node_t* ast_create_block(ast_arena_t* arena, ast_node_t** stmts, size_t count, int line, int column);
+ast_node_t* ast_create_expression_stmt(ast_arena_t* arena, ast_node_t* expr, int line, int column);
+ast_node_t* ast_create_import(ast_arena_t* arena, char* module, char** names, size_t count, int line, int column);
+ast_node_t* ast_create_export(ast_arena_t* arena, char** names, size_t count, int line, int column);
+ast_node_t* ast_create_program(ast_arena_t* arena, ast_node_t** stmts, size_t count, int line, int column);
 
 /* دوال المحلل اللغوي */
 parser_t* parser_create(lexer_t* lexer);
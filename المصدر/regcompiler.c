@@ -0,0 +1,1111 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * مترجم الجهاز السجلي (Register Compiler)
+ *
+ * يحول شجرة البنية المجردة إلى تعليمات ثلاثية العناوين. المتغيرات المحلية
+ * سجلات ثابتة في الإطار، والقيم المؤقتة تُحجز فوقها كالمكدس وتُحرر بعد كل
+ * تعبير، فتقرأ العمليات المتغيرات من سجلاتها دون نسخ
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "regvm.h"
+
+/* متغير محلي: الاسم في ساحة الشجرة، والسجل ثابت ما دام في نطاقه */
+typedef struct {
+    const char* name;
+    int depth;
+    int reg;
+} reg_local_t;
+
+/* حلقة قيد الترجمة */
+typedef struct reg_loop {
+    struct reg_loop* enclosing;
+    int continue_target;            /* هدف استمر، أو -1 إن كان بعد الجسم (زيادة لكل) */
+    int continue_jumps[256];        /* قفزات استمر بانتظار الترقيع */
+    int continue_count;
+    int break_jumps[256];           /* قفزات توقف بانتظار الترقيع */
+    int break_count;
+} reg_loop_t;
+
+/* سياق الدالة الجاري ترجمتها */
+typedef struct reg_function {
+    struct reg_function* enclosing;
+    function_type_t type;
+    reg_proto_t* proto;
+    
+    reg_local_t locals[REG_MAX_REGISTERS];
+    int local_count;
+    int scope_depth;
+    
+    int free_reg;                   /* أول سجل مؤقت حر */
+    reg_loop_t* loop;
+} reg_function_t;
+
+typedef struct {
+    reg_function_t* current;
+    skp_object_t* globals;          /* جدول الأسماء المشترك مع الجهاز */
+    int line;
+    int had_error;
+} reg_compiler_t;
+
+static void expr_to(reg_compiler_t* rc, ast_node_t* node, int target);
+static void reg_compile_statement(reg_compiler_t* rc, ast_node_t* node);
+
+/* ========== الأخطاء ========== */
+
+/* ما لا يدعمه الجهاز السجلي بعد: ملاحظة واحدة ثم يتولى الجهاز المكدسي */
+static void unsupported(reg_compiler_t* rc, const char* what) {
+    if (!rc->had_error) {
+        fprintf(stderr, "ملاحظة: الجهاز السجلي لا يدعم %s بعد (السطر %d)، "
+                "فيُنفذ البرنامج بالجهاز المكدسي\n", what, rc->line);
+    }
+    rc->had_error = 1;
+}
+
+/* خطأ في البرنامج نفسه: يُترك الإبلاغ عنه للمترجم المكدسي */
+static void fail(reg_compiler_t* rc) {
+    rc->had_error = 1;
+}
+
+/* ========== الدالة المترجمة ========== */
+
+static reg_proto_t* proto_create(void) {
+    reg_proto_t* proto = (reg_proto_t*)calloc(1, sizeof(reg_proto_t));
+    return proto;
+}
+
+void reg_proto_free(reg_proto_t* proto) {
+    if (!proto) return;
+    
+    for (size_t i = 0; i < proto->constant_count; i++) {
+        if (proto->constants[i].type == SKP_TYPE_STRING) {
+            skp_decref(proto->constants[i].value.string_val);
+        } else if (proto->constants[i].type == SKP_TYPE_FUNC) {
+            skp_decref(proto->constants[i].value.func_val);
+        }
+    }
+    
+    free(proto->code);
+    free(proto->lines);
+    free(proto->constants);
+    free(proto->values);
+    free(proto);
+}
+
+static int emit(reg_compiler_t* rc, uint32_t instruction) {
+    reg_proto_t* proto = rc->current->proto;
+    if (proto->count >= proto->capacity) {
+        proto->capacity = proto->capacity == 0 ? 16 : proto->capacity * 2;
+        proto->code = (uint32_t*)realloc(proto->code, proto->capacity * sizeof(uint32_t));
+        proto->lines = (int*)realloc(proto->lines, proto->capacity * sizeof(int));
+    }
+    
+    proto->code[proto->count] = instruction;
+    proto->lines[proto->count] = rc->line;
+    return (int)proto->count++;
+}
+
+/* قيمة الثابت كما يراها الجهاز */
+static skp_value_t constant_value(constant_t constant) {
+    switch (constant.type) {
+        case SKP_TYPE_INT:    return SKP_INT_VAL(constant.value.int_val);
+        case SKP_TYPE_FLOAT:  return SKP_FLOAT_VAL(constant.value.float_val);
+        case SKP_TYPE_BOOL:   return SKP_BOOL_VAL(constant.value.int_val);
+        case SKP_TYPE_STRING: return SKP_OBJ_VAL(constant.value.string_val);
+        case SKP_TYPE_FUNC:   return SKP_OBJ_VAL(constant.value.func_val);
+        default:              return SKP_NULL_VAL;
+    }
+}
+
+/* رقم الثابت في تجمع الدالة. القيم المتساوية تشترك في ثابت واحد، والنص
+ * المحتجز المكرر يتخلى عن مرجعه الجديد */
+static int add_constant(reg_compiler_t* rc, constant_t constant) {
+    reg_proto_t* proto = rc->current->proto;
+    
+    if (constant.type != SKP_TYPE_FUNC) {
+        for (size_t i = 0; i < proto->constant_count; i++) {
+            constant_t* existing = &proto->constants[i];
+            if (existing->type != constant.type) continue;
+            
+            int same;
+            switch (constant.type) {
+                case SKP_TYPE_FLOAT:  same = existing->value.float_val == constant.value.float_val; break;
+                case SKP_TYPE_STRING: same = existing->value.string_val == constant.value.string_val; break;
+                case SKP_TYPE_NULL:   same = 1; break;
+                default:              same = existing->value.int_val == constant.value.int_val; break;
+            }
+            if (!same) continue;
+            
+            if (constant.type == SKP_TYPE_STRING) skp_decref(constant.value.string_val);
+            return (int)i;
+        }
+    }
+    
+    if (proto->constant_count >= proto->constant_capacity) {
+        proto->constant_capacity = proto->constant_capacity == 0 ? 8 : proto->constant_capacity * 2;
+        proto->constants = (constant_t*)realloc(proto->constants,
+                                                proto->constant_capacity * sizeof(constant_t));
+        proto->values = (skp_value_t*)realloc(proto->values,
+                                              proto->constant_capacity * sizeof(skp_value_t));
+    }
+    
+    proto->constants[proto->constant_count] = constant;
+    proto->values[proto->constant_count] = constant_value(constant);
+    
+    if (proto->constant_count > UINT16_MAX) {
+        unsupported(rc, "أكثر من 65536 ثابتاً في دالة واحدة");
+    }
+    return (int)proto->constant_count++;
+}
+
+/* ثابت القيمة الحرفية إن كانت العقدة حرفية، وإلا -1 */
+static int literal_constant(reg_compiler_t* rc, ast_node_t* node) {
+    constant_t constant;
+    switch (node->type) {
+        case AST_NUMBER:
+            constant = number_constant(node);
+            break;
+        case AST_STRING:
+            constant.type = SKP_TYPE_STRING;
+            constant.value.string_val = skp_intern(node->data.string.value,
+                                                   strlen(node->data.string.value));
+            break;
+        case AST_BOOLEAN:
+            constant.type = SKP_TYPE_BOOL;
+            constant.value.int_val = node->data.boolean.value;
+            break;
+        case AST_NULL:
+            constant.type = SKP_TYPE_NULL;
+            constant.value.int_val = 0;
+            break;
+        default:
+            return -1;
+    }
+    return add_constant(rc, constant);
+}
+
+/* ========== السجلات والمتغيرات ========== */
+
+/* أول سجل بعد المتغيرات المرئية؛ ما فوقه مؤقت */
+static int visible_top(reg_function_t* fn) {
+    return fn->local_count > 0 ? fn->locals[fn->local_count - 1].reg + 1 : 0;
+}
+
+static int alloc_reg(reg_compiler_t* rc) {
+    reg_function_t* fn = rc->current;
+    if (fn->free_reg >= REG_MAX_REGISTERS) {
+        unsupported(rc, "دالة تحتاج أكثر من 256 سجلاً");
+        return REG_MAX_REGISTERS - 1;
+    }
+    
+    int reg = fn->free_reg++;
+    if (fn->free_reg > fn->proto->register_count) {
+        fn->proto->register_count = fn->free_reg;
+    }
+    return reg;
+}
+
+/* المتغير يصير مرئياً بعد حساب قيمته الأولى في سجله */
+static void reg_add_local(reg_compiler_t* rc, const char* name, int reg) {
+    reg_function_t* fn = rc->current;
+    
+    for (int i = fn->local_count - 1; i >= 0 && fn->locals[i].depth >= fn->scope_depth; i--) {
+        if (strcmp(fn->locals[i].name, name) == 0) {
+            fail(rc);
+            return;
+        }
+    }
+    
+    if (fn->local_count >= REG_MAX_REGISTERS) {
+        unsupported(rc, "أكثر من 256 متغيراً محلياً");
+        return;
+    }
+    
+    fn->locals[fn->local_count].name = name;
+    fn->locals[fn->local_count].depth = fn->scope_depth;
+    fn->locals[fn->local_count].reg = reg;
+    fn->local_count++;
+}
+
+static int find_local(reg_function_t* fn, const char* name) {
+    for (int i = fn->local_count - 1; i >= 0; i--) {
+        if (strcmp(fn->locals[i].name, name) == 0) {
+            return fn->locals[i].reg;
+        }
+    }
+    return -1;
+}
+
+/* سجل المتغير المحلي، أو -1 للمتغير العام. متغير دالة محيطة يحتاج
+ * upvalue، والإغلاقات لا يدعمها الجهاز السجلي */
+static int local_reg(reg_compiler_t* rc, const char* name) {
+    int reg = find_local(rc->current, name);
+    if (reg >= 0) return reg;
+    
+    for (reg_function_t* fn = rc->current->enclosing; fn; fn = fn->enclosing) {
+        if (find_local(fn, name) >= 0) {
+            unsupported(rc, "الإغلاقات التي تلتقط متغيرات محلية");
+            break;
+        }
+    }
+    return -1;
+}
+
+static uint16_t global_slot(reg_compiler_t* rc, const char* name) {
+    int slot = resolve_global(rc->globals, name);
+    if (slot < 0) {
+        fail(rc);
+        return 0;
+    }
+    return (uint16_t)slot;
+}
+
+static void reg_begin_scope(reg_compiler_t* rc) {
+    rc->current->scope_depth++;
+}
+
+static void reg_end_scope(reg_compiler_t* rc) {
+    reg_function_t* fn = rc->current;
+    fn->scope_depth--;
+    while (fn->local_count > 0 && fn->locals[fn->local_count - 1].depth > fn->scope_depth) {
+        fn->local_count--;
+    }
+    fn->free_reg = visible_top(fn);
+}
+
+/* ========== القفزات ========== */
+
+static int reg_emit_jump(reg_compiler_t* rc, reg_opcode_t op, int reg) {
+    return emit(rc, REG_ABX(op, reg, REG_SBX_BIAS));
+}
+
+static void reg_patch_jump_to(reg_compiler_t* rc, int jump, int target) {
+    reg_proto_t* proto = rc->current->proto;
+    int offset = target - (jump + 1);
+    if (offset < -REG_SBX_BIAS || offset > REG_SBX_BIAS) {
+        unsupported(rc, "قفزة أبعد من 32767 تعليمة");
+        return;
+    }
+    
+    proto->code[jump] = (proto->code[jump] & 0xFFFF) | ((uint32_t)(offset + REG_SBX_BIAS) << 16);
+}
+
+static void reg_patch_jump(reg_compiler_t* rc, int jump) {
+    reg_patch_jump_to(rc, jump, (int)rc->current->proto->count);
+}
+
+static void reg_emit_loop(reg_compiler_t* rc, int start) {
+    int distance = (int)rc->current->proto->count + 1 - start;
+    if (distance > UINT16_MAX) {
+        unsupported(rc, "حلقة أطول من 65535 تعليمة");
+        return;
+    }
+    emit(rc, REG_ABX(ROP_LOOP, 0, distance));
+}
+
+/* ========== التعبيرات ========== */
+
+/* هل في التعبير تعيين قد يغير متغيراً قبل أن يُقرأ ما حُسب قبله؟ */
+static int writes_variables(ast_node_t* node) {
+    if (!node) return 0;
+    
+    switch (node->type) {
+        case AST_ASSIGNMENT:
+            return 1;
+        case AST_UNARY_OP:
+            return node->data.unary_op.op == UNOP_INC || node->data.unary_op.op == UNOP_DEC ||
+                   writes_variables(node->data.unary_op.operand);
+        case AST_BINARY_OP:
+            return writes_variables(node->data.binary_op.left) ||
+                   writes_variables(node->data.binary_op.right);
+        case AST_CALL:
+            if (writes_variables(node->data.call.callee)) return 1;
+            for (size_t i = 0; i < node->data.call.arg_count; i++) {
+                if (writes_variables(node->data.call.args[i])) return 1;
+            }
+            return 0;
+        case AST_MEMBER_ACCESS:
+            return writes_variables(node->data.member_access.object);
+        case AST_INDEX_ACCESS:
+            return writes_variables(node->data.index_access.object) ||
+                   writes_variables(node->data.index_access.index);
+        case AST_LIST_LITERAL:
+            for (size_t i = 0; i < node->data.list_literal.element_count; i++) {
+                if (writes_variables(node->data.list_literal.elements[i])) return 1;
+            }
+            return 0;
+        case AST_DICT_LITERAL:
+            for (size_t i = 0; i < node->data.dict_literal.entry_count; i++) {
+                if (writes_variables(node->data.dict_literal.keys[i]) ||
+                    writes_variables(node->data.dict_literal.values[i])) return 1;
+            }
+            return 0;
+        case AST_TERNARY:
+            return writes_variables(node->data.ternary.condition) ||
+                   writes_variables(node->data.ternary.true_expr) ||
+                   writes_variables(node->data.ternary.false_expr);
+        default:
+            return 0;
+    }
+}
+
+/* سجل يحمل قيمة التعبير: المتغير المحلي يُقرأ من سجله مباشرة، وغيره يُحسب
+ * في سجل مؤقت جديد */
+static int expr_any(reg_compiler_t* rc, ast_node_t* node) {
+    if (node->type == AST_IDENTIFIER) {
+        int reg = local_reg(rc, node->data.identifier.name);
+        if (reg >= 0) return reg;
+    }
+    
+    int reg = alloc_reg(rc);
+    expr_to(rc, node, reg);
+    return reg;
+}
+
+/* معامل يُقرأ قبل تعبير يكتب المتغيرات (guard): يُنسخ المحلي حتى تبقى
+ * قيمته قبل الكتابة كما في الجهاز المكدسي */
+static int operand(reg_compiler_t* rc, ast_node_t* node, int guard) {
+    if (guard && node->type == AST_IDENTIFIER) {
+        int reg = alloc_reg(rc);
+        expr_to(rc, node, reg);
+        return reg;
+    }
+    return expr_any(rc, node);
+}
+
+static void emit_move(reg_compiler_t* rc, int target, int source) {
+    if (target != source) emit(rc, REG_ABC(ROP_MOVE, target, source, 0));
+}
+
+static reg_opcode_t binary_opcode(binop_type_t op) {
+    switch (op) {
+        case BINOP_ADD:     return ROP_ADD;
+        case BINOP_SUB:     return ROP_SUB;
+        case BINOP_MUL:     return ROP_MUL;
+        case BINOP_DIV:     return ROP_DIV;
+        case BINOP_MOD:     return ROP_MOD;
+        case BINOP_POW:     return ROP_POW;
+        case BINOP_EQ:      return ROP_EQ;
+        case BINOP_NE:      return ROP_NE;
+        case BINOP_LT:      return ROP_LT;
+        case BINOP_GT:      return ROP_GT;
+        case BINOP_LE:      return ROP_LE;
+        case BINOP_GE:      return ROP_GE;
+        case BINOP_AND:     return ROP_AND;
+        case BINOP_OR:      return ROP_OR;
+        case BINOP_BIT_AND: return ROP_BIT_AND;
+        case BINOP_BIT_OR:  return ROP_BIT_OR;
+        case BINOP_BIT_XOR: return ROP_BIT_XOR;
+        case BINOP_SHL:     return ROP_SHL;
+        default:            return ROP_SHR;
+    }
+}
+
+/* الصيغة ذات المعامل الثابت، أو ROP_HALT إن لم تكن للعملية صيغة كهذه */
+static reg_opcode_t binary_constant_opcode(binop_type_t op) {
+    switch (op) {
+        case BINOP_ADD: return ROP_ADDK;
+        case BINOP_SUB: return ROP_SUBK;
+        case BINOP_MUL: return ROP_MULK;
+        case BINOP_DIV: return ROP_DIVK;
+        case BINOP_MOD: return ROP_MODK;
+        default:        return ROP_HALT;
+    }
+}
+
+static void reg_compile_binary(reg_compiler_t* rc, ast_node_t* node, int target) {
+    ast_node_t* left = node->data.binary_op.left;
+    ast_node_t* right = node->data.binary_op.right;
+    binop_type_t op = node->data.binary_op.op;
+    
+    int a = operand(rc, left, writes_variables(right));
+    
+    reg_opcode_t constant_op = binary_constant_opcode(op);
+    if (constant_op != ROP_HALT) {
+        int constant = literal_constant(rc, right);
+        if (constant >= 0 && constant <= UINT8_MAX) {
+            rc->line = node->line;
+            emit(rc, REG_ABC(constant_op, target, a, constant));
+            return;
+        }
+    }
+    
+    int b = expr_any(rc, right);
+    rc->line = node->line;
+    emit(rc, REG_ABC(binary_opcode(op), target, a, b));
+}
+
+/* ++س و --س تعيين س = س ± 1، بعقد مؤقتة على المكدس */
+static void reg_compile_step(reg_compiler_t* rc, ast_node_t* node, int target);
+static void reg_compile_assignment(reg_compiler_t* rc, ast_node_t* node, int target);
+
+static void reg_compile_unary(reg_compiler_t* rc, ast_node_t* node, int target) {
+    unop_type_t op = node->data.unary_op.op;
+    if (op == UNOP_INC || op == UNOP_DEC) {
+        reg_compile_step(rc, node, target);
+        return;
+    }
+    
+    int source = expr_any(rc, node->data.unary_op.operand);
+    rc->line = node->line;
+    
+    reg_opcode_t code = op == UNOP_NEG ? ROP_NEG : op == UNOP_NOT ? ROP_NOT : ROP_BIT_NOT;
+    emit(rc, REG_ABC(code, target, source, 0));
+}
+
+static void reg_compile_step(reg_compiler_t* rc, ast_node_t* node, int target) {
+    ast_node_t one, step, assign;
+    memset(&one, 0, sizeof(one));
+    memset(&step, 0, sizeof(step));
+    memset(&assign, 0, sizeof(assign));
+    
+    one.type = AST_NUMBER;
+    one.line = node->line;
+    one.data.number.value = "1";
+    
+    step.type = AST_BINARY_OP;
+    step.line = node->line;
+    step.data.binary_op.op = node->data.unary_op.op == UNOP_INC ? BINOP_ADD : BINOP_SUB;
+    step.data.binary_op.left = node->data.unary_op.operand;
+    step.data.binary_op.right = &one;
+    
+    assign.type = AST_ASSIGNMENT;
+    assign.line = node->line;
+    assign.data.assignment.target = node->data.unary_op.operand;
+    assign.data.assignment.value = &step;
+    
+    reg_compile_assignment(rc, &assign, target);
+}
+
+/* التعيين، والهدف -1 إن أُهملت قيمته في عبارة */
+static void reg_compile_assignment(reg_compiler_t* rc, ast_node_t* node, int target) {
+    ast_node_t* dest = node->data.assignment.target;
+    ast_node_t* value = node->data.assignment.value;
+    
+    if (dest->type == AST_IDENTIFIER) {
+        int reg = local_reg(rc, dest->data.identifier.name);
+        if (reg >= 0) {
+            expr_to(rc, value, reg);
+            if (target >= 0) emit_move(rc, target, reg);
+            return;
+        }
+        
+        uint16_t slot = global_slot(rc, dest->data.identifier.name);
+        int source = target >= 0 ? target : alloc_reg(rc);
+        expr_to(rc, value, source);
+        rc->line = node->line;
+        emit(rc, REG_ABX(ROP_SETGLOBAL, source, slot));
+        return;
+    }
+    
+    if (dest->type == AST_INDEX_ACCESS) {
+        ast_node_t* index = dest->data.index_access.index;
+        int object = operand(rc, dest->data.index_access.object,
+                             writes_variables(index) || writes_variables(value));
+        int key = operand(rc, index, writes_variables(value));
+        int source = expr_any(rc, value);
+        rc->line = node->line;
+        emit(rc, REG_ABC(ROP_SETINDEX, object, key, source));
+        if (target >= 0) emit_move(rc, target, source);
+        return;
+    }
+    
+    if (dest->type == AST_MEMBER_ACCESS) {
+        unsupported(rc, "الخصائص");
+        return;
+    }
+    
+    fail(rc);
+}
+
+/* الدالة ومعاملاتها في سجلات متتالية أعلى الإطار، والناتج مكان الدالة.
+ * الهدف الحر في القمة يصلح قاعدة للاستدعاء فلا يلزم نقل الناتج */
+static void reg_compile_call(reg_compiler_t* rc, ast_node_t* node, int target) {
+    reg_function_t* fn = rc->current;
+    ast_node_t* callee = node->data.call.callee;
+    
+    if (callee->type == AST_MEMBER_ACCESS) {
+        unsupported(rc, "استدعاء الطرق");
+        return;
+    }
+    if (node->data.call.arg_count > UINT8_MAX) {
+        fail(rc);
+        return;
+    }
+    
+    int base;
+    if (target >= 0 && target + 1 == fn->free_reg && target >= visible_top(fn)) {
+        base = target;
+    } else {
+        base = alloc_reg(rc);
+    }
+    
+    expr_to(rc, callee, base);
+    for (size_t i = 0; i < node->data.call.arg_count; i++) {
+        expr_to(rc, node->data.call.args[i], alloc_reg(rc));
+    }
+    
+    rc->line = node->line;
+    emit(rc, REG_ABC(ROP_CALL, base, node->data.call.arg_count, 0));
+    if (target >= 0) emit_move(rc, target, base);
+}
+
+/* عناصر متتالية في سجلات جديدة، ويُرجع أولها */
+static int reg_compile_sequence(reg_compiler_t* rc, ast_node_t** first, ast_node_t** second,
+                            size_t count) {
+    int start = rc->current->free_reg;
+    for (size_t i = 0; i < count; i++) {
+        expr_to(rc, first[i], alloc_reg(rc));
+        if (second) expr_to(rc, second[i], alloc_reg(rc));
+    }
+    return start;
+}
+
+static int reg_compile_function(reg_compiler_t* rc, const char* name, char** params,
+                            size_t param_count, ast_node_t** defaults, ast_node_t* body);
+static int emit_condition(reg_compiler_t* rc, ast_node_t* condition);
+
+/* يترجم التعبير بحيث تكون الكتابة في الهدف آخر ما يفعله، فيصح أن يكون
+ * الهدف متغيراً يقرؤه التعبير نفسه */
+static void expr_to(reg_compiler_t* rc, ast_node_t* node, int target) {
+    reg_function_t* fn = rc->current;
+    int saved = fn->free_reg;
+    rc->line = node->line;
+    
+    switch (node->type) {
+        case AST_NUMBER: {
+            constant_t constant = number_constant(node);
+            if (constant.type == SKP_TYPE_INT && constant.value.int_val >= -REG_SBX_BIAS &&
+                constant.value.int_val <= REG_SBX_BIAS) {
+                emit(rc, REG_ABX(ROP_LOADI, target, constant.value.int_val + REG_SBX_BIAS));
+            } else {
+                emit(rc, REG_ABX(ROP_LOADK, target, add_constant(rc, constant)));
+            }
+            break;
+        }
+        
+        case AST_STRING:
+            emit(rc, REG_ABX(ROP_LOADK, target, literal_constant(rc, node)));
+            break;
+        
+        case AST_BOOLEAN:
+            emit(rc, REG_ABC(ROP_LOADBOOL, target, node->data.boolean.value ? 1 : 0, 0));
+            break;
+        
+        case AST_NULL:
+            emit(rc, REG_ABC(ROP_LOADNULL, target, 0, 0));
+            break;
+        
+        case AST_IDENTIFIER: {
+            int reg = local_reg(rc, node->data.identifier.name);
+            if (reg >= 0) {
+                emit_move(rc, target, reg);
+            } else {
+                emit(rc, REG_ABX(ROP_GETGLOBAL, target,
+                                 global_slot(rc, node->data.identifier.name)));
+            }
+            break;
+        }
+        
+        case AST_BINARY_OP:
+            reg_compile_binary(rc, node, target);
+            break;
+        
+        case AST_UNARY_OP:
+            reg_compile_unary(rc, node, target);
+            break;
+        
+        case AST_ASSIGNMENT:
+            reg_compile_assignment(rc, node, target);
+            break;
+        
+        case AST_CALL:
+            reg_compile_call(rc, node, target);
+            break;
+        
+        case AST_INDEX_ACCESS: {
+            ast_node_t* index = node->data.index_access.index;
+            int object = operand(rc, node->data.index_access.object, writes_variables(index));
+            int key = expr_any(rc, index);
+            rc->line = node->line;
+            emit(rc, REG_ABC(ROP_GETINDEX, target, object, key));
+            break;
+        }
+        
+        case AST_LIST_LITERAL: {
+            size_t count = node->data.list_literal.element_count;
+            if (count > UINT8_MAX) {
+                fail(rc);
+                break;
+            }
+            int start = reg_compile_sequence(rc, node->data.list_literal.elements, NULL, count);
+            rc->line = node->line;
+            emit(rc, REG_ABC(ROP_NEWLIST, target, start, count));
+            break;
+        }
+        
+        case AST_DICT_LITERAL: {
+            size_t count = node->data.dict_literal.entry_count;
+            if (count > UINT8_MAX) {
+                fail(rc);
+                break;
+            }
+            int start = reg_compile_sequence(rc, node->data.dict_literal.keys,
+                                         node->data.dict_literal.values, count);
+            rc->line = node->line;
+            emit(rc, REG_ABC(ROP_NEWDICT, target, start, count));
+            break;
+        }
+        
+        case AST_LAMBDA: {
+            int function = reg_compile_function(rc, "<lambda>", node->data.lambda.params,
+                                            node->data.lambda.param_count, NULL,
+                                            node->data.lambda.body);
+            rc->line = node->line;
+            emit(rc, REG_ABX(ROP_CLOSURE, target, function));
+            break;
+        }
+        
+        case AST_TERNARY: {
+            int else_jump = emit_condition(rc, node->data.ternary.condition);
+            expr_to(rc, node->data.ternary.true_expr, target);
+            int end_jump = reg_emit_jump(rc, ROP_JMP, 0);
+            reg_patch_jump(rc, else_jump);
+            expr_to(rc, node->data.ternary.false_expr, target);
+            reg_patch_jump(rc, end_jump);
+            break;
+        }
+        
+        case AST_MEMBER_ACCESS:
+            unsupported(rc, "الخصائص");
+            break;
+        
+        default:
+            fail(rc);
+            break;
+    }
+    
+    fn->free_reg = saved;
+}
+
+/* ========== الشروط ========== */
+
+static int is_comparison(binop_type_t op) {
+    return op == BINOP_EQ || op == BINOP_NE || op == BINOP_LT ||
+           op == BINOP_LE || op == BINOP_GT || op == BINOP_GE;
+}
+
+/* مقارنة R[a] بالتعبير الأيمن تتبعها القفزة المُرجعة، وتُنفذ إذا لم يتحقق الشرط */
+static int emit_compare_jump(reg_compiler_t* rc, binop_type_t op, int a, ast_node_t* right) {
+    static const reg_opcode_t registers[] = {
+        [BINOP_EQ] = ROP_IF_EQ, [BINOP_NE] = ROP_IF_NE, [BINOP_LT] = ROP_IF_LT,
+        [BINOP_LE] = ROP_IF_LE, [BINOP_GT] = ROP_IF_GT, [BINOP_GE] = ROP_IF_GE
+    };
+    static const reg_opcode_t constants[] = {
+        [BINOP_EQ] = ROP_IF_EQK, [BINOP_NE] = ROP_IF_NEK, [BINOP_LT] = ROP_IF_LTK,
+        [BINOP_LE] = ROP_IF_LEK, [BINOP_GT] = ROP_IF_GTK, [BINOP_GE] = ROP_IF_GEK
+    };
+    
+    int line = rc->line;
+    int constant = literal_constant(rc, right);
+    if (constant >= 0 && constant <= UINT8_MAX) {
+        emit(rc, REG_ABC(constants[op], a, constant, 0));
+    } else {
+        int b = expr_any(rc, right);
+        rc->line = line;
+        emit(rc, REG_ABC(registers[op], a, b, 0));
+    }
+    return reg_emit_jump(rc, ROP_JMP, 0);
+}
+
+/* قفزة تُنفذ إذا كان الشرط خطأ، ويُرجع موضعها لترقيعها. المقارنة تقفز
+ * مباشرة دون أن تكتب ناتجها في سجل */
+static int emit_condition(reg_compiler_t* rc, ast_node_t* condition) {
+    reg_function_t* fn = rc->current;
+    int saved = fn->free_reg;
+    int jump;
+    
+    rc->line = condition->line;
+    if (condition->type == AST_BINARY_OP && is_comparison(condition->data.binary_op.op)) {
+        ast_node_t* right = condition->data.binary_op.right;
+        int a = operand(rc, condition->data.binary_op.left, writes_variables(right));
+        rc->line = condition->line;
+        jump = emit_compare_jump(rc, condition->data.binary_op.op, a, right);
+    } else {
+        int reg = expr_any(rc, condition);
+        rc->line = condition->line;
+        jump = reg_emit_jump(rc, ROP_JMPIFNOT, reg);
+    }
+    
+    fn->free_reg = saved;
+    return jump;
+}
+
+/* ========== الدوال ========== */
+
+static void init_function(reg_function_t* fn, reg_function_t* enclosing, function_type_t type) {
+    fn->enclosing = enclosing;
+    fn->type = type;
+    fn->proto = proto_create();
+    fn->local_count = 0;
+    fn->scope_depth = 0;
+    fn->free_reg = 0;
+    fn->loop = NULL;
+}
+
+static void reg_compile_block(reg_compiler_t* rc, ast_node_t* node) {
+    reg_begin_scope(rc);
+    for (size_t i = 0; i < node->data.block.statement_count; i++) {
+        reg_compile_statement(rc, node->data.block.statements[i]);
+    }
+    reg_end_scope(rc);
+}
+
+/* جسم الدالة في سياق فرعي، ويُرجع ثابت الدالة في السياق الحالي. السجل 0
+ * للدالة نفسها والمعاملات بعده، كفتحات الجهاز المكدسي */
+static int reg_compile_function(reg_compiler_t* rc, const char* name, char** params,
+                            size_t param_count, ast_node_t** defaults, ast_node_t* body) {
+    reg_function_t fn;
+    init_function(&fn, rc->current, TYPE_FUNCTION);
+    fn.proto->arity = (int)param_count;
+    rc->current = &fn;
+    
+    reg_begin_scope(rc);
+    reg_add_local(rc, "", alloc_reg(rc));
+    for (size_t i = 0; i < param_count; i++) {
+        reg_add_local(rc, params[i], alloc_reg(rc));
+    }
+    
+    /* القيم الافتراضية: المعامل الناقص يصل فارغاً */
+    for (size_t i = 0; defaults && i < param_count; i++) {
+        if (!defaults[i]) continue;
+        
+        ast_node_t null_node;
+        memset(&null_node, 0, sizeof(null_node));
+        null_node.type = AST_NULL;
+        null_node.line = defaults[i]->line;
+        
+        rc->line = defaults[i]->line;
+        int skip = emit_compare_jump(rc, BINOP_EQ, (int)i + 1, &null_node);
+        expr_to(rc, defaults[i], (int)i + 1);
+        reg_patch_jump(rc, skip);
+    }
+    
+    if (body && body->type == AST_BLOCK) {
+        reg_compile_block(rc, body);
+        emit(rc, REG_ABC(ROP_RETURN_VOID, 0, 0, 0));
+    } else if (body) {
+        /* دالة تعبيرية: (س) => س * 3 */
+        int reg = expr_any(rc, body);
+        emit(rc, REG_ABC(ROP_RETURN, reg, 0, 0));
+    } else {
+        emit(rc, REG_ABC(ROP_RETURN_VOID, 0, 0, 0));
+    }
+    
+    rc->current = fn.enclosing;
+    
+    skp_object_t* function = skp_new_function(name, (int)param_count, NULL);
+    function->data.v_func.regs = fn.proto;
+    
+    constant_t constant;
+    constant.type = SKP_TYPE_FUNC;
+    constant.value.func_val = function;
+    return add_constant(rc, constant);
+}
+
+/* ========== العبارات ========== */
+
+/* تعبير تُهمل قيمته: التعيين والاستدعاء دون سجل للناتج */
+static void reg_compile_effect(reg_compiler_t* rc, ast_node_t* node) {
+    if (node->type == AST_ASSIGNMENT) {
+        reg_compile_assignment(rc, node, -1);
+    } else if (node->type == AST_UNARY_OP &&
+               (node->data.unary_op.op == UNOP_INC || node->data.unary_op.op == UNOP_DEC)) {
+        rc->line = node->line;
+        reg_compile_step(rc, node, -1);
+    } else if (node->type == AST_CALL) {
+        rc->line = node->line;
+        reg_compile_call(rc, node, -1);
+    } else {
+        expr_to(rc, node, alloc_reg(rc));
+    }
+}
+
+static void reg_compile_var_decl(reg_compiler_t* rc, ast_node_t* node) {
+    ast_node_t* initializer = node->data.var_decl.initializer;
+    int reg = alloc_reg(rc);
+    
+    if (initializer) {
+        expr_to(rc, initializer, reg);
+    } else {
+        emit(rc, REG_ABC(ROP_LOADNULL, reg, 0, 0));
+    }
+    
+    rc->line = node->line;
+    if (rc->current->scope_depth == 0) {
+        emit(rc, REG_ABX(ROP_DEFGLOBAL, reg, global_slot(rc, node->data.var_decl.name)));
+    } else {
+        reg_add_local(rc, node->data.var_decl.name, reg);
+    }
+}
+
+/* الدالة المحلية مرئية قبل جسمها كما في الجهاز المكدسي، فاستدعاؤها نفسها
+ * التقاط لا يدعمه الجهاز السجلي */
+static void reg_compile_func_decl(reg_compiler_t* rc, ast_node_t* node) {
+    int reg = alloc_reg(rc);
+    int local = rc->current->scope_depth > 0;
+    if (local) reg_add_local(rc, node->data.func_decl.name, reg);
+    
+    int function = reg_compile_function(rc, node->data.func_decl.name, node->data.func_decl.params,
+                                    node->data.func_decl.param_count,
+                                    node->data.func_decl.defaults, node->data.func_decl.body);
+    
+    rc->line = node->line;
+    emit(rc, REG_ABX(ROP_CLOSURE, reg, function));
+    if (!local) {
+        emit(rc, REG_ABX(ROP_DEFGLOBAL, reg, global_slot(rc, node->data.func_decl.name)));
+    }
+}
+
+static void reg_begin_loop(reg_compiler_t* rc, reg_loop_t* loop, int continue_target) {
+    loop->enclosing = rc->current->loop;
+    loop->continue_target = continue_target;
+    loop->continue_count = 0;
+    loop->break_count = 0;
+    rc->current->loop = loop;
+}
+
+static void reg_end_loop(reg_compiler_t* rc) {
+    reg_loop_t* loop = rc->current->loop;
+    for (int i = 0; i < loop->break_count; i++) {
+        reg_patch_jump(rc, loop->break_jumps[i]);
+    }
+    rc->current->loop = loop->enclosing;
+}
+
+static void reg_compile_break(reg_compiler_t* rc) {
+    reg_loop_t* loop = rc->current->loop;
+    if (!loop || loop->break_count >= 256) {
+        fail(rc);
+        return;
+    }
+    loop->break_jumps[loop->break_count++] = reg_emit_jump(rc, ROP_JMP, 0);
+}
+
+static void reg_compile_continue(reg_compiler_t* rc) {
+    reg_loop_t* loop = rc->current->loop;
+    if (!loop || loop->continue_count >= 256) {
+        fail(rc);
+        return;
+    }
+    
+    if (loop->continue_target >= 0) {
+        reg_emit_loop(rc, loop->continue_target);
+    } else {
+        loop->continue_jumps[loop->continue_count++] = reg_emit_jump(rc, ROP_JMP, 0);
+    }
+}
+
+static void reg_compile_if(reg_compiler_t* rc, ast_node_t* node) {
+    int then_jump = emit_condition(rc, node->data.if_stmt.condition);
+    reg_compile_statement(rc, node->data.if_stmt.then_branch);
+    
+    if (!node->data.if_stmt.else_branch) {
+        reg_patch_jump(rc, then_jump);
+        return;
+    }
+    
+    int else_jump = reg_emit_jump(rc, ROP_JMP, 0);
+    reg_patch_jump(rc, then_jump);
+    reg_compile_statement(rc, node->data.if_stmt.else_branch);
+    reg_patch_jump(rc, else_jump);
+}
+
+static void reg_compile_while(reg_compiler_t* rc, ast_node_t* node) {
+    reg_loop_t loop;
+    int start = (int)rc->current->proto->count;
+    reg_begin_loop(rc, &loop, start);
+    
+    int exit_jump = emit_condition(rc, node->data.while_stmt.condition);
+    reg_compile_statement(rc, node->data.while_stmt.body);
+    reg_emit_loop(rc, start);
+    
+    reg_patch_jump(rc, exit_jump);
+    reg_end_loop(rc);
+}
+
+/* الشرط في رأس الحلقة والزيادة بعد الجسم، وإليها تقفز استمر */
+static void reg_compile_for(reg_compiler_t* rc, ast_node_t* node) {
+    reg_begin_scope(rc);
+    
+    if (node->data.for_stmt.init_var) {
+        int reg = alloc_reg(rc);
+        if (node->data.for_stmt.init_expr) {
+            expr_to(rc, node->data.for_stmt.init_expr, reg);
+        } else {
+            emit(rc, REG_ABC(ROP_LOADNULL, reg, 0, 0));
+        }
+        reg_add_local(rc, node->data.for_stmt.init_var, reg);
+    } else if (node->data.for_stmt.init_expr) {
+        reg_compile_effect(rc, node->data.for_stmt.init_expr);
+        rc->current->free_reg = visible_top(rc->current);
+    }
+    
+    reg_loop_t loop;
+    int start = (int)rc->current->proto->count;
+    int exit_jump = -1;
+    if (node->data.for_stmt.condition) {
+        exit_jump = emit_condition(rc, node->data.for_stmt.condition);
+    }
+    
+    reg_begin_loop(rc, &loop, -1);
+    reg_compile_statement(rc, node->data.for_stmt.body);
+    
+    for (int i = 0; i < loop.continue_count; i++) {
+        reg_patch_jump(rc, loop.continue_jumps[i]);
+    }
+    if (node->data.for_stmt.increment) {
+        reg_compile_effect(rc, node->data.for_stmt.increment);
+        rc->current->free_reg = visible_top(rc->current);
+    }
+    reg_emit_loop(rc, start);
+    
+    if (exit_jump != -1) reg_patch_jump(rc, exit_jump);
+    reg_end_loop(rc);
+    
+    reg_end_scope(rc);
+}
+
+/* المجموعة وموضع التكرار في سجلين متتاليين مخفيين، ومتغير الحلقة بعدهما */
+static void reg_compile_foreach(reg_compiler_t* rc, ast_node_t* node) {
+    reg_begin_scope(rc);
+    
+    int collection = alloc_reg(rc);
+    expr_to(rc, node->data.foreach_stmt.iterable, collection);
+    reg_add_local(rc, "(مجموعة)", collection);
+    
+    int position = alloc_reg(rc);
+    emit(rc, REG_ABX(ROP_LOADI, position, REG_SBX_BIAS));
+    reg_add_local(rc, "(فهرس)", position);
+    
+    reg_begin_scope(rc);
+    int item = alloc_reg(rc);
+    reg_add_local(rc, node->data.foreach_stmt.var, item);
+    
+    reg_loop_t loop;
+    rc->line = node->line;
+    int start = emit(rc, REG_ABC(ROP_ITER, collection, item, 0));
+    int exit_jump = reg_emit_jump(rc, ROP_JMP, 0);
+    reg_begin_loop(rc, &loop, start);
+    
+    reg_compile_statement(rc, node->data.foreach_stmt.body);
+    reg_emit_loop(rc, start);
+    
+    reg_patch_jump(rc, exit_jump);
+    reg_end_loop(rc);
+    
+    reg_end_scope(rc);
+    reg_end_scope(rc);
+}
+
+static void reg_compile_return(reg_compiler_t* rc, ast_node_t* node) {
+    if (rc->current->type == TYPE_SCRIPT) {
+        fail(rc);
+        return;
+    }
+    
+    if (node->data.return_stmt.value) {
+        int reg = expr_any(rc, node->data.return_stmt.value);
+        rc->line = node->line;
+        emit(rc, REG_ABC(ROP_RETURN, reg, 0, 0));
+    } else {
+        emit(rc, REG_ABC(ROP_RETURN_VOID, 0, 0, 0));
+    }
+}
+
+static void reg_compile_statement(reg_compiler_t* rc, ast_node_t* node) {
+    if (!node) return;
+    rc->line = node->line;
+    
+    switch (node->type) {
+        case AST_VAR_DECL:
+        case AST_CONST_DECL:
+            reg_compile_var_decl(rc, node);
+            break;
+        case AST_FUNC_DECL:
+            reg_compile_func_decl(rc, node);
+            break;
+        case AST_CLASS_DECL:
+            unsupported(rc, "الأصناف");
+            break;
+        case AST_IMPORT:
+        case AST_EXPORT:
+            /* لا يفعلان شيئاً في الجهاز المكدسي أيضاً */
+            break;
+        case AST_IF:
+            reg_compile_if(rc, node);
+            break;
+        case AST_WHILE:
+            reg_compile_while(rc, node);
+            break;
+        case AST_FOR:
+            reg_compile_for(rc, node);
+            break;
+        case AST_FOREACH:
+            reg_compile_foreach(rc, node);
+            break;
+        case AST_RETURN:
+            reg_compile_return(rc, node);
+            break;
+        case AST_BREAK:
+            reg_compile_break(rc);
+            break;
+        case AST_CONTINUE:
+            reg_compile_continue(rc);
+            break;
+        case AST_BLOCK:
+            reg_compile_block(rc, node);
+            break;
+        case AST_EXPRESSION_STMT:
+            reg_compile_effect(rc, node->data.expression_stmt.expression);
+            break;
+        default:
+            reg_compile_effect(rc, node);
+            break;
+    }
+    
+    /* لا يبقى مؤقت حي بين عبارتين */
+    rc->current->free_reg = visible_top(rc->current);
+}
+
+/* ========== الواجهة ========== */
+
+reg_proto_t* reg_compile(ast_node_t* ast, skp_object_t* globals) {
+    if (!ast) return NULL;
+    
+    reg_compiler_t rc;
+    rc.globals = globals;
+    rc.line = ast->line;
+    rc.had_error = 0;
+    
+    reg_function_t script;
+    init_function(&script, NULL, TYPE_SCRIPT);
+    rc.current = &script;
+    
+    if (ast->type == AST_PROGRAM) {
+        for (size_t i = 0; i < ast->data.program.statement_count; i++) {
+            reg_compile_statement(&rc, ast->data.program.statements[i]);
+        }
+    } else {
+        reg_compile_statement(&rc, ast);
+    }
+    emit(&rc, REG_ABC(ROP_HALT, 0, 0, 0));
+    
+    if (rc.had_error) {
+        reg_proto_free(script.proto);
+        return NULL;
+    }
+    return script.proto;
+}
@@ -0,0 +1,895 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * الجهاز السجلي (Register VM) - Register-based Backend
+ *
+ * ينفذ تعليمات المترجم السجلي على مكدس الجهاز نفسه: سجلات الإطار فتحات
+ * متجاورة في المكدس، فيراها جامع القمامة جذوراً كفتحات الجهاز المكدسي
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "regvm.h"
+
+/* إطار استدعاء. الدالة NULL للبرنامج الرئيسي */
+typedef struct {
+    skp_object_t* function;
+    reg_proto_t* proto;
+    uint32_t* pc;
+    skp_value_t* base;
+} reg_frame_t;
+
+/* تتبع الاستدعاءات بعد رسالة الخطأ */
+static void reg_print_trace(reg_frame_t* frames, int frame_count) {
+    for (int i = frame_count - 1; i >= 0; i--) {
+        reg_frame_t* frame = &frames[i];
+        int instruction = (int)(frame->pc - frame->proto->code - 1);
+        int line = frame->proto->lines[instruction];
+        if (frame->function) {
+            const char* name = frame->function->data.v_func.name;
+            fprintf(stderr, "[سطر %d] في الدالة %s\n", line, name ? name : "");
+        } else {
+            fprintf(stderr, "[سطر %d] في البرنامج\n", line);
+        }
+    }
+}
+
+static skp_result_t reg_execute(skp_vm_t* vm, reg_proto_t* script) {
+    reg_frame_t frames[SKP_FRAMES_MAX];
+    int frame_count = 1;
+    
+    reg_frame_t* frame = &frames[0];
+    frame->function = NULL;
+    frame->proto = script;
+    frame->pc = script->code;
+    frame->base = vm->stack;
+    
+    /* حالة الإطار الجاري في متغيرات محلية، وتُحفظ فيه عند الاستدعاء */
+    uint32_t* pc = frame->pc;
+    skp_value_t* base = frame->base;
+    skp_value_t* k = script->values;
+    uint32_t instruction;
+    
+    for (int i = 0; i < script->register_count; i++) base[i] = SKP_NULL_VAL;
+    vm->stack_top = base + script->register_count;
+
+#define RA() (base[REG_A(instruction)])
+#define RB() (base[REG_B(instruction)])
+#define RC() (base[REG_C(instruction)])
+#define KB() (k[REG_B(instruction)])
+#define KC() (k[REG_C(instruction)])
+#define RUNTIME_ERROR(...) \
+    do { \
+        frame->pc = pc; \
+        vm_runtime_error(vm, __VA_ARGS__); \
+        reg_print_trace(frames, frame_count); \
+        return SKP_RUNTIME_ERROR; \
+    } while (false)
+/* عملية حسابية بمسارين سريعين للصحيح والعشري دون تخصيص */
+#define ARITH(b_value, op, int_op, func, symbol) \
+    do { \
+        skp_value_t a = RB(); \
+        skp_value_t b = (b_value); \
+        if (SKP_IS_INT(a) && SKP_IS_INT(b)) { \
+            RA() = SKP_INT_VAL(int_op(SKP_AS_INT(a), SKP_AS_INT(b))); \
+        } else if (SKP_IS_FLOAT(a) && SKP_IS_FLOAT(b)) { \
+            RA() = SKP_FLOAT_VAL(SKP_AS_FLOAT(a) op SKP_AS_FLOAT(b)); \
+        } else { \
+            skp_value_t result = func(a, b); \
+            if (SKP_IS_NULL(result)) { \
+                RUNTIME_ERROR("العملية '%s' غير مدعومة بين %s و %s", symbol, \
+                              skp_type_name(a.type), skp_type_name(b.type)); \
+            } \
+            RA() = result; \
+        } \
+    } while (false)
+#define DIVIDE(b_value, func, symbol) \
+    do { \
+        skp_value_t a = RB(); \
+        skp_value_t b = (b_value); \
+        if (SKP_IS_NUMBER(b) && SKP_AS_NUMBER(b) == 0) { \
+            RUNTIME_ERROR("قسمة على صفر"); \
+        } \
+        skp_value_t result = func(a, b); \
+        if (SKP_IS_NULL(result)) { \
+            RUNTIME_ERROR("العملية '%s' غير مدعومة بين %s و %s", symbol, \
+                          skp_type_name(a.type), skp_type_name(b.type)); \
+        } \
+        RA() = result; \
+    } while (false)
+#define LESS(a, b, op, func) \
+    (SKP_IS_INT(a) && SKP_IS_INT(b) ? SKP_AS_INT(a) op SKP_AS_INT(b) : func(a, b))
+#define COMPARE(op, func) \
+    do { \
+        skp_value_t a = RB(); \
+        skp_value_t b = RC(); \
+        RA() = SKP_BOOL_VAL(LESS(a, b, op, func)); \
+    } while (false)
+/* الشرط المتحقق يتخطى القفزة التالية، وإلا تُنفذ في مكانها */
+#define BRANCH(condition) \
+    do { \
+        if (condition) { \
+            pc++; \
+        } else { \
+            pc += REG_SBX(*pc) + 1; \
+        } \
+    } while (false)
+#define BITWISE(op) \
+    do { \
+        RA() = SKP_INT_VAL(skp_to_int(RB()) op skp_to_int(RC())); \
+    } while (false)
+#define SHIFT(func) \
+    do { \
+        RA() = SKP_INT_VAL(func(skp_to_int(RB()), skp_to_int(RC()))); \
+    } while (false)
+/* نقطة آمنة للجمع: كل السجلات الحية تحت stack_top */
+#define SAFEPOINT() \
+    do { \
+        if (vm->heap.gc_requested) vm_collect_step(vm); \
+    } while (false)
+
+#ifdef DEBUG_TRACE_EXECUTION
+#define TRACE_INSTRUCTION() \
+    do { \
+        printf("          "); \
+        for (skp_value_t* slot = base; slot < vm->stack_top; slot++) { \
+            printf("[ "); \
+            skp_print(*slot); \
+            printf(" ]"); \
+        } \
+        printf("\n"); \
+        reg_disassemble_instruction(frame->proto, (int)(pc - frame->proto->code)); \
+    } while (false)
+#else
+#define TRACE_INSTRUCTION() do { } while (false)
+#endif
+
+#ifdef SKP_COMPUTED_GOTO
+    /* جدول القفز بترتيب reg_opcode_t */
+    static void* dispatch_table[] = {
+        &&code_ROP_MOVE,
+        &&code_ROP_LOADK,
+        &&code_ROP_LOADI,
+        &&code_ROP_LOADBOOL,
+        &&code_ROP_LOADNULL,
+        &&code_ROP_GETGLOBAL,
+        &&code_ROP_SETGLOBAL,
+        &&code_ROP_DEFGLOBAL,
+        &&code_ROP_GETINDEX,
+        &&code_ROP_SETINDEX,
+        &&code_ROP_NEWLIST,
+        &&code_ROP_NEWDICT,
+        &&code_ROP_ADD,
+        &&code_ROP_SUB,
+        &&code_ROP_MUL,
+        &&code_ROP_DIV,
+        &&code_ROP_MOD,
+        &&code_ROP_POW,
+        &&code_ROP_ADDK,
+        &&code_ROP_SUBK,
+        &&code_ROP_MULK,
+        &&code_ROP_DIVK,
+        &&code_ROP_MODK,
+        &&code_ROP_EQ,
+        &&code_ROP_NE,
+        &&code_ROP_LT,
+        &&code_ROP_LE,
+        &&code_ROP_GT,
+        &&code_ROP_GE,
+        &&code_ROP_AND,
+        &&code_ROP_OR,
+        &&code_ROP_BIT_AND,
+        &&code_ROP_BIT_OR,
+        &&code_ROP_BIT_XOR,
+        &&code_ROP_SHL,
+        &&code_ROP_SHR,
+        &&code_ROP_NEG,
+        &&code_ROP_NOT,
+        &&code_ROP_BIT_NOT,
+        &&code_ROP_JMP,
+        &&code_ROP_LOOP,
+        &&code_ROP_JMPIFNOT,
+        &&code_ROP_IF_EQ,
+        &&code_ROP_IF_NE,
+        &&code_ROP_IF_LT,
+        &&code_ROP_IF_LE,
+        &&code_ROP_IF_GT,
+        &&code_ROP_IF_GE,
+        &&code_ROP_IF_EQK,
+        &&code_ROP_IF_NEK,
+        &&code_ROP_IF_LTK,
+        &&code_ROP_IF_LEK,
+        &&code_ROP_IF_GTK,
+        &&code_ROP_IF_GEK,
+        &&code_ROP_ITER,
+        &&code_ROP_CLOSURE,
+        &&code_ROP_CALL,
+        &&code_ROP_RETURN,
+        &&code_ROP_RETURN_VOID,
+        &&code_ROP_HALT,
+        &&code_unknown
+    };
+
+#define CASE(op) code_##op
+#define CASE_UNKNOWN code_unknown
+#define DISPATCH() \
+    do { \
+        TRACE_INSTRUCTION(); \
+        instruction = *pc++; \
+        goto *dispatch_table[REG_OP(instruction)]; \
+    } while (false)
+    
+    DISPATCH();
+#else
+#define CASE(op) case op
+#define CASE_UNKNOWN default
+#define DISPATCH() goto dispatch
+
+dispatch:
+    TRACE_INSTRUCTION();
+    instruction = *pc++;
+    switch (REG_OP(instruction))
+#endif
+    {
+        CASE(ROP_MOVE):
+            RA() = RB();
+            DISPATCH();
+        
+        CASE(ROP_LOADK): {
+            /* النص محتجز؛ المرجع الإضافي يقوم مقام مرجع الإنشاء */
+            skp_value_t value = k[REG_BX(instruction)];
+            if (SKP_IS_STRING(value)) skp_incref(SKP_AS_OBJ(value));
+            RA() = value;
+            DISPATCH();
+        }
+        
+        CASE(ROP_LOADI):
+            RA() = SKP_INT_VAL(REG_SBX(instruction));
+            DISPATCH();
+        
+        CASE(ROP_LOADBOOL):
+            RA() = SKP_BOOL_VAL(REG_B(instruction));
+            DISPATCH();
+        
+        CASE(ROP_LOADNULL):
+            RA() = SKP_NULL_VAL;
+            DISPATCH();
+        
+        CASE(ROP_GETGLOBAL): {
+            uint16_t slot = REG_BX(instruction);
+            skp_value_t value = vm->global_values[slot];
+            if (value.type == SKP_TYPE_UNDEFINED) {
+                RUNTIME_ERROR("متغير غير معرف: %s", vm_global_name(vm, slot));
+            }
+            RA() = value;
+            DISPATCH();
+        }
+        
+        CASE(ROP_SETGLOBAL): {
+            uint16_t slot = REG_BX(instruction);
+            if (vm->global_values[slot].type == SKP_TYPE_UNDEFINED) {
+                RUNTIME_ERROR("متغير غير معرف: %s", vm_global_name(vm, slot));
+            }
+            vm->global_values[slot] = RA();
+            DISPATCH();
+        }
+        
+        CASE(ROP_DEFGLOBAL):
+            vm->global_values[REG_BX(instruction)] = RA();
+            DISPATCH();
+        
+        CASE(ROP_GETINDEX): {
+            skp_value_t result;
+            if (!skp_get_index(RB(), RC(), &result)) {
+                RUNTIME_ERROR("فهرس غير صالح");
+            }
+            RA() = result;
+            DISPATCH();
+        }
+        
+        CASE(ROP_SETINDEX):
+            if (!skp_set_index(RA(), RB(), RC())) {
+                RUNTIME_ERROR("فهرس غير صالح");
+            }
+            DISPATCH();
+        
+        CASE(ROP_NEWLIST): {
+            skp_value_t* items = &RB();
+            int count = REG_C(instruction);
+            skp_object_t* list = skp_new_list();
+            for (int i = 0; i < count; i++) {
+                skp_list_append(list, items[i]);
+            }
+            RA() = SKP_OBJ_VAL(list);
+            DISPATCH();
+        }
+        
+        CASE(ROP_NEWDICT): {
+            /* الأزواج في سجلات متتالية: مفتاح، قيمة، مفتاح، قيمة... */
+            skp_value_t* pairs = &RB();
+            int count = REG_C(instruction);
+            skp_object_t* dict = skp_new_dict();
+            for (int i = 0; i < count; i++) {
+                skp_value_t key = pairs[i * 2];
+                if (!SKP_IS_STRING(key)) {
+                    RUNTIME_ERROR("المفتاح يجب أن يكون نصاً");
+                }
+                skp_dict_set_key(dict, SKP_AS_OBJ(key), pairs[i * 2 + 1]);
+            }
+            RA() = SKP_OBJ_VAL(dict);
+            DISPATCH();
+        }
+        
+        CASE(ROP_ADD):
+            ARITH(RC(), +, skp_int_add, skp_add, "+");
+            DISPATCH();
+        
+        CASE(ROP_SUB):
+            ARITH(RC(), -, skp_int_sub, skp_sub, "-");
+            DISPATCH();
+        
+        CASE(ROP_MUL):
+            ARITH(RC(), *, skp_int_mul, skp_mul, "*");
+            DISPATCH();
+        
+        CASE(ROP_DIV):
+            DIVIDE(RC(), skp_div, "/");
+            DISPATCH();
+        
+        CASE(ROP_MOD):
+            DIVIDE(RC(), skp_mod, "%");
+            DISPATCH();
+        
+        CASE(ROP_POW): {
+            skp_value_t a = RB();
+            skp_value_t b = RC();
+            skp_value_t result = skp_pow(a, b);
+            if (SKP_IS_NULL(result)) {
+                RUNTIME_ERROR("العملية '^' غير مدعومة بين %s و %s",
+                              skp_type_name(a.type), skp_type_name(b.type));
+            }
+            RA() = result;
+            DISPATCH();
+        }
+        
+        CASE(ROP_ADDK):
+            ARITH(KC(), +, skp_int_add, skp_add, "+");
+            DISPATCH();
+        
+        CASE(ROP_SUBK):
+            ARITH(KC(), -, skp_int_sub, skp_sub, "-");
+            DISPATCH();
+        
+        CASE(ROP_MULK):
+            ARITH(KC(), *, skp_int_mul, skp_mul, "*");
+            DISPATCH();
+        
+        CASE(ROP_DIVK):
+            DIVIDE(KC(), skp_div, "/");
+            DISPATCH();
+        
+        CASE(ROP_MODK):
+            DIVIDE(KC(), skp_mod, "%");
+            DISPATCH();
+        
+        CASE(ROP_EQ):
+            RA() = SKP_BOOL_VAL(skp_eq(RB(), RC()));
+            DISPATCH();
+        
+        CASE(ROP_NE):
+            RA() = SKP_BOOL_VAL(!skp_eq(RB(), RC()));
+            DISPATCH();
+        
+        CASE(ROP_LT):
+            COMPARE(<, skp_lt);
+            DISPATCH();
+        
+        CASE(ROP_LE):
+            COMPARE(<=, skp_le);
+            DISPATCH();
+        
+        CASE(ROP_GT):
+            COMPARE(>, skp_gt);
+            DISPATCH();
+        
+        CASE(ROP_GE):
+            COMPARE(>=, skp_ge);
+            DISPATCH();
+        
+        CASE(ROP_AND):
+            RA() = SKP_BOOL_VAL(skp_to_bool(RB()) && skp_to_bool(RC()));
+            DISPATCH();
+        
+        CASE(ROP_OR):
+            RA() = SKP_BOOL_VAL(skp_to_bool(RB()) || skp_to_bool(RC()));
+            DISPATCH();
+        
+        CASE(ROP_BIT_AND):
+            BITWISE(&);
+            DISPATCH();
+        
+        CASE(ROP_BIT_OR):
+            BITWISE(|);
+            DISPATCH();
+        
+        CASE(ROP_BIT_XOR):
+            BITWISE(^);
+            DISPATCH();
+        
+        CASE(ROP_SHL):
+            SHIFT(skp_int_shl);
+            DISPATCH();
+        
+        CASE(ROP_SHR):
+            SHIFT(skp_int_shr);
+            DISPATCH();
+        
+        CASE(ROP_NEG): {
+            skp_value_t value = RB();
+            if (!SKP_IS_NUMBER(value)) {
+                RUNTIME_ERROR("لا يمكن نفي قيمة من نوع %s", skp_type_name(value.type));
+            }
+            RA() = skp_neg(value);
+            DISPATCH();
+        }
+        
+        CASE(ROP_NOT):
+            RA() = SKP_BOOL_VAL(!skp_to_bool(RB()));
+            DISPATCH();
+        
+        CASE(ROP_BIT_NOT):
+            RA() = SKP_INT_VAL(~skp_to_int(RB()));
+            DISPATCH();
+        
+        CASE(ROP_JMP):
+            pc += REG_SBX(instruction);
+            DISPATCH();
+        
+        CASE(ROP_LOOP):
+            pc -= REG_BX(instruction);
+            SAFEPOINT();
+            DISPATCH();
+        
+        CASE(ROP_JMPIFNOT):
+            if (!skp_to_bool(RA())) pc += REG_SBX(instruction);
+            DISPATCH();
+        
+        CASE(ROP_IF_EQ):
+            BRANCH(skp_eq(RA(), RB()));
+            DISPATCH();
+        
+        CASE(ROP_IF_NE):
+            BRANCH(!skp_eq(RA(), RB()));
+            DISPATCH();
+        
+        CASE(ROP_IF_LT):
+            BRANCH(LESS(RA(), RB(), <, skp_lt));
+            DISPATCH();
+        
+        CASE(ROP_IF_LE):
+            BRANCH(LESS(RA(), RB(), <=, skp_le));
+            DISPATCH();
+        
+        CASE(ROP_IF_GT):
+            BRANCH(LESS(RA(), RB(), >, skp_gt));
+            DISPATCH();
+        
+        CASE(ROP_IF_GE):
+            BRANCH(LESS(RA(), RB(), >=, skp_ge));
+            DISPATCH();
+        
+        CASE(ROP_IF_EQK):
+            BRANCH(skp_eq(RA(), KB()));
+            DISPATCH();
+        
+        CASE(ROP_IF_NEK):
+            BRANCH(!skp_eq(RA(), KB()));
+            DISPATCH();
+        
+        CASE(ROP_IF_LTK):
+            BRANCH(LESS(RA(), KB(), <, skp_lt));
+            DISPATCH();
+        
+        CASE(ROP_IF_LEK):
+            BRANCH(LESS(RA(), KB(), <=, skp_le));
+            DISPATCH();
+        
+        CASE(ROP_IF_GTK):
+            BRANCH(LESS(RA(), KB(), >, skp_gt));
+            DISPATCH();
+        
+        CASE(ROP_IF_GEK):
+            BRANCH(LESS(RA(), KB(), >=, skp_ge));
+            DISPATCH();
+        
+        CASE(ROP_ITER): {
+            /* R[A] المجموعة و R[A + 1] موضع التكرار */
+            skp_value_t collection = RA();
+            skp_value_t* position = &base[REG_A(instruction) + 1];
+            
+            if (SKP_IS_LIST(collection)) {
+                skp_object_t* list = SKP_AS_OBJ(collection);
+                skp_int index = SKP_AS_INT(*position);
+                if (index >= (skp_int)list->data.v_list.count) {
+                    pc += REG_SBX(*pc) + 1;
+                    DISPATCH();
+                }
+                RB() = list->data.v_list.items[index];
+                *position = SKP_INT_VAL(index + 1);
+                pc++;
+                DISPATCH();
+            }
+            
+            if (SKP_IS_RANGE(collection)) {
+                skp_object_t* range = SKP_AS_OBJ(collection);
+                skp_int index = SKP_AS_INT(*position);
+                if (index >= range->data.v_range.count) {
+                    pc += REG_SBX(*pc) + 1;
+                    DISPATCH();
+                }
+                RB() = SKP_INT_VAL(skp_range_at(range, index));
+                *position = SKP_INT_VAL(index + 1);
+                pc++;
+                DISPATCH();
+            }
+            
+            skp_value_t item;
+            int status = vm_iter_next(collection, position, &item);
+            if (status < 0) {
+                RUNTIME_ERROR("لا يمكن التكرار على قيمة من نوع %s",
+                              skp_type_name(collection.type));
+            }
+            BRANCH(status);
+            if (status) RB() = item;
+            DISPATCH();
+        }
+        
+        CASE(ROP_CLOSURE): {
+            skp_object_t* function = k[REG_BX(instruction)].as.v_obj;
+            RA() = SKP_OBJ_VAL(skp_new_closure(function));
+            DISPATCH();
+        }
+        
+        CASE(ROP_CALL): {
+            int arg_count = REG_B(instruction);
+            SAFEPOINT();
+            skp_value_t* callee_base = &RA();
+            skp_value_t callee = *callee_base;
+            
+            if (callee.type == SKP_TYPE_NATIVE) {
+                /* الدوال المدمجة تقرأ بيانات النصوص مباشرة، فتُدمج الحبال قبلها */
+                skp_value_t* args = callee_base + 1;
+                for (int i = 0; i < arg_count; i++) {
+                    if (SKP_IS_STRING(args[i])) skp_string_flatten(SKP_AS_OBJ(args[i]));
+                }
+                
+                skp_native_func_t native = SKP_AS_OBJ(callee)->data.v_native.func;
+                skp_value_t result = native(vm, arg_count, args);
+                if (vm->had_error) {
+                    frame->pc = pc;
+                    reg_print_trace(frames, frame_count);
+                    return SKP_RUNTIME_ERROR;
+                }
+                *callee_base = result;
+                DISPATCH();
+            }
+            
+            skp_object_t* function = callee.type == SKP_TYPE_CLOSURE
+                ? SKP_AS_OBJ(callee)->data.v_closure.function : NULL;
+            if (!function || !function->data.v_func.regs) {
+                RUNTIME_ERROR("لا يمكن استدعاء قيمة من نوع %s", skp_type_name(callee.type));
+            }
+            
+            reg_proto_t* proto = function->data.v_func.regs;
+            if (arg_count > proto->arity) {
+                RUNTIME_ERROR("توقع %d معاملات لكن تم تمرير %d", proto->arity, arg_count);
+            }
+            if (frame_count >= SKP_FRAMES_MAX) {
+                RUNTIME_ERROR("تجاوز الحد الأقصى لعمق الاستدعاء");
+            }
+            
+            /* المعاملات الناقصة تصل فارغة، وما فوقها من سجلات يبدأ فارغاً */
+            for (int i = arg_count + 1; i < proto->register_count; i++) {
+                callee_base[i] = SKP_NULL_VAL;
+            }
+            
+            frame->pc = pc;
+            frame = &frames[frame_count++];
+            frame->function = function;
+            frame->proto = proto;
+            frame->base = callee_base;
+            
+            pc = proto->code;
+            base = callee_base;
+            k = proto->values;
+            vm->stack_top = base + proto->register_count;
+            DISPATCH();
+        }
+        
+        CASE(ROP_RETURN):
+        CASE(ROP_RETURN_VOID): {
+            /* الناتج مكان الدالة في سجلات المستدعي */
+            base[0] = REG_OP(instruction) == ROP_RETURN ? RA() : SKP_NULL_VAL;
+            frame_count--;
+            if (frame_count == 0) return SKP_OK;
+            
+            frame = &frames[frame_count - 1];
+            pc = frame->pc;
+            base = frame->base;
+            k = frame->proto->values;
+            vm->stack_top = base + frame->proto->register_count;
+            DISPATCH();
+        }
+        
+        CASE(ROP_HALT):
+            vm->running = 0;
+            return SKP_OK;
+        
+        CASE_UNKNOWN:
+            RUNTIME_ERROR("كود عملية غير معروف: %d", REG_OP(instruction));
+    }
+
+#undef RA
+#undef RB
+#undef RC
+#undef KB
+#undef KC
+#undef RUNTIME_ERROR
+#undef ARITH
+#undef DIVIDE
+#undef LESS
+#undef COMPARE
+#undef BRANCH
+#undef BITWISE
+#undef SHIFT
+#undef SAFEPOINT
+    
+    return SKP_OK;
+}
+
+skp_result_t reg_run(skp_vm_t* vm, reg_proto_t* proto) {
+    vm_sync_globals(vm);
+    
+    vm->running = 1;
+    vm->had_error = 0;
+    
+    /* الكائنات المُنشأة أثناء التنفيذ وحدها تُخصص في كومة الجهاز */
+    skp_heap_t* previous = skp_heap_use(&vm->heap);
+    skp_result_t result = reg_execute(vm, proto);
+    skp_heap_use(previous);
+    
+    vm->stack_top = vm->stack;
+    return result;
+}
+
+/* ========== التصحيح ========== */
+
+const char* reg_opcode_name(reg_opcode_t op) {
+    switch (op) {
+        case ROP_MOVE: return "MOVE";
+        case ROP_LOADK: return "LOADK";
+        case ROP_LOADI: return "LOADI";
+        case ROP_LOADBOOL: return "LOADBOOL";
+        case ROP_LOADNULL: return "LOADNULL";
+        case ROP_GETGLOBAL: return "GETGLOBAL";
+        case ROP_SETGLOBAL: return "SETGLOBAL";
+        case ROP_DEFGLOBAL: return "DEFGLOBAL";
+        case ROP_GETINDEX: return "GETINDEX";
+        case ROP_SETINDEX: return "SETINDEX";
+        case ROP_NEWLIST: return "NEWLIST";
+        case ROP_NEWDICT: return "NEWDICT";
+        case ROP_ADD: return "ADD";
+        case ROP_SUB: return "SUB";
+        case ROP_MUL: return "MUL";
+        case ROP_DIV: return "DIV";
+        case ROP_MOD: return "MOD";
+        case ROP_POW: return "POW";
+        case ROP_ADDK: return "ADDK";
+        case ROP_SUBK: return "SUBK";
+        case ROP_MULK: return "MULK";
+        case ROP_DIVK: return "DIVK";
+        case ROP_MODK: return "MODK";
+        case ROP_EQ: return "EQ";
+        case ROP_NE: return "NE";
+        case ROP_LT: return "LT";
+        case ROP_LE: return "LE";
+        case ROP_GT: return "GT";
+        case ROP_GE: return "GE";
+        case ROP_AND: return "AND";
+        case ROP_OR: return "OR";
+        case ROP_BIT_AND: return "BIT_AND";
+        case ROP_BIT_OR: return "BIT_OR";
+        case ROP_BIT_XOR: return "BIT_XOR";
+        case ROP_SHL: return "SHL";
+        case ROP_SHR: return "SHR";
+        case ROP_NEG: return "NEG";
+        case ROP_NOT: return "NOT";
+        case ROP_BIT_NOT: return "BIT_NOT";
+        case ROP_JMP: return "JMP";
+        case ROP_LOOP: return "LOOP";
+        case ROP_JMPIFNOT: return "JMPIFNOT";
+        case ROP_IF_EQ: return "IF_EQ";
+        case ROP_IF_NE: return "IF_NE";
+        case ROP_IF_LT: return "IF_LT";
+        case ROP_IF_LE: return "IF_LE";
+        case ROP_IF_GT: return "IF_GT";
+        case ROP_IF_GE: return "IF_GE";
+        case ROP_IF_EQK: return "IF_EQK";
+        case ROP_IF_NEK: return "IF_NEK";
+        case ROP_IF_LTK: return "IF_LTK";
+        case ROP_IF_LEK: return "IF_LEK";
+        case ROP_IF_GTK: return "IF_GTK";
+        case ROP_IF_GEK: return "IF_GEK";
+        case ROP_ITER: return "ITER";
+        case ROP_CLOSURE: return "CLOSURE";
+        case ROP_CALL: return "CALL";
+        case ROP_RETURN: return "RETURN";
+        case ROP_RETURN_VOID: return "RETURN_VOID";
+        case ROP_HALT: return "HALT";
+        default: return "UNKNOWN";
+    }
+}
+
+/* قيمة الثابت بين علامتي اقتباس */
+static void print_constant(reg_proto_t* proto, int constant) {
+    printf("'");
+    
+    constant_t c = proto->constants[constant];
+    switch (c.type) {
+        case SKP_TYPE_INT:
+            printf("%lld", (long long)c.value.int_val);
+            break;
+        case SKP_TYPE_FLOAT:
+            printf("%f", c.value.float_val);
+            break;
+        case SKP_TYPE_STRING:
+            printf("%s", c.value.string_val->data.v_string.chars);
+            break;
+        case SKP_TYPE_BOOL:
+            printf("%s", c.value.int_val ? "صح" : "خطأ");
+            break;
+        case SKP_TYPE_NULL:
+            printf("فارغ");
+            break;
+        case SKP_TYPE_FUNC:
+            printf("<دالة %s>", c.value.func_val->data.v_func.name);
+            break;
+        default:
+            printf("?");
+    }
+    printf("'");
+}
+
+int reg_disassemble_instruction(reg_proto_t* proto, int offset) {
+    printf("%04d ", offset);
+    
+    if (offset > 0 && proto->lines[offset] == proto->lines[offset - 1]) {
+        printf("   | ");
+    } else {
+        printf("%4d ", proto->lines[offset]);
+    }
+    
+    uint32_t instruction = proto->code[offset];
+    reg_opcode_t op = (reg_opcode_t)REG_OP(instruction);
+    int a = REG_A(instruction);
+    int b = REG_B(instruction);
+    int c = REG_C(instruction);
+    printf("%-12s ", reg_opcode_name(op));
+    
+    switch (op) {
+        case ROP_MOVE:
+        case ROP_NEG:
+        case ROP_NOT:
+        case ROP_BIT_NOT:
+            printf("r%d r%d\n", a, b);
+            break;
+        
+        case ROP_LOADK:
+        case ROP_CLOSURE:
+            printf("r%d %d ", a, REG_BX(instruction));
+            print_constant(proto, REG_BX(instruction));
+            printf("\n");
+            break;
+        
+        case ROP_LOADI:
+            printf("r%d %d\n", a, REG_SBX(instruction));
+            break;
+        
+        case ROP_LOADBOOL:
+            printf("r%d %d\n", a, b);
+            break;
+        
+        case ROP_LOADNULL:
+        case ROP_RETURN:
+            printf("r%d\n", a);
+            break;
+        
+        case ROP_GETGLOBAL:
+        case ROP_SETGLOBAL:
+        case ROP_DEFGLOBAL:
+            printf("r%d [%d]\n", a, REG_BX(instruction));
+            break;
+        
+        case ROP_NEWLIST:
+        case ROP_NEWDICT:
+            printf("r%d r%d %d\n", a, b, c);
+            break;
+        
+        case ROP_ADDK:
+        case ROP_SUBK:
+        case ROP_MULK:
+        case ROP_DIVK:
+        case ROP_MODK:
+            printf("r%d r%d ", a, b);
+            print_constant(proto, c);
+            printf("\n");
+            break;
+        
+        case ROP_JMP:
+            printf("-> %d\n", offset + 1 + REG_SBX(instruction));
+            break;
+        
+        case ROP_LOOP:
+            printf("-> %d\n", offset + 1 - REG_BX(instruction));
+            break;
+        
+        case ROP_JMPIFNOT:
+            printf("r%d -> %d\n", a, offset + 1 + REG_SBX(instruction));
+            break;
+        
+        case ROP_IF_EQ:
+        case ROP_IF_NE:
+        case ROP_IF_LT:
+        case ROP_IF_LE:
+        case ROP_IF_GT:
+        case ROP_IF_GE:
+        case ROP_ITER:
+            printf("r%d r%d\n", a, b);
+            break;
+        
+        case ROP_IF_EQK:
+        case ROP_IF_NEK:
+        case ROP_IF_LTK:
+        case ROP_IF_LEK:
+        case ROP_IF_GTK:
+        case ROP_IF_GEK:
+            printf("r%d ", a);
+            print_constant(proto, b);
+            printf("\n");
+            break;
+        
+        case ROP_CALL:
+            printf("r%d (%d)\n", a, b);
+            break;
+        
+        case ROP_RETURN_VOID:
+        case ROP_HALT:
+            printf("\n");
+            break;
+        
+        default:
+            printf("r%d r%d r%d\n", a, b, c);
+            break;
+    }
+    
+    return offset + 1;
+}
+
+/* الدالة ثم الدوال المترجمة في ثوابتها */
+void reg_disassemble(reg_proto_t* proto, const char* name) {
+    printf("== %s (%d سجلاً) ==\n", name, proto->register_count);
+    
+    for (size_t offset = 0; offset < proto->count;) {
+        offset = (size_t)reg_disassemble_instruction(proto, (int)offset);
+    }
+    
+    for (size_t i = 0; i < proto->constant_count; i++) {
+        if (proto->constants[i].type != SKP_TYPE_FUNC) continue;
+        
+        skp_object_t* function = proto->constants[i].value.func_val;
+        if (function->data.v_func.regs) {
+            printf("\n");
+            reg_disassemble(function->data.v_func.regs, function->data.v_func.name);
+        }
+    }
+}
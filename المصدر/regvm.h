@@ -0,0 +1,143 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * الجهاز السجلي (Register VM) - Register-based Backend
+ *
+ * واجهة خلفية بديلة للجهاز المكدسي: تعليمات ثلاثية العناوين تخاطب فتحات
+ * الإطار (السجلات) مباشرة، فلا تُنقل القيم إلى المكدس وعنه. تُترجم من
+ * الشجرة نفسها ويُختار تنفيذها بالخيار --reg
+ */
+
+#ifndef REGVM_H
+#define REGVM_H
+
+#include "parser.h"
+#include "compiler.h"
+#include "vm.h"
+
+/* أكبر عدد من السجلات في إطار واحد (حقل السجل 8 بت) */
+#define REG_MAX_REGISTERS 256
+
+/* التعليمة كلمة 32 بت: الكود ثم A ثم B ثم C، بايت لكل منها. التعليمات
+ * ذات المعامل الواسع تجمع B و C في Bx، والقفزات تحمل فيه إزاحة بإشارة
+ * (sBx) نسبة إلى التعليمة التالية */
+#define REG_OP(i)        ((uint8_t)((i) & 0xFF))
+#define REG_A(i)         ((uint8_t)(((i) >> 8) & 0xFF))
+#define REG_B(i)         ((uint8_t)(((i) >> 16) & 0xFF))
+#define REG_C(i)         ((uint8_t)((i) >> 24))
+#define REG_BX(i)        ((uint16_t)((i) >> 16))
+#define REG_SBX_BIAS     32767
+#define REG_SBX(i)       ((int)REG_BX(i) - REG_SBX_BIAS)
+
+#define REG_ABC(op, a, b, c) \
+    ((uint32_t)(op) | ((uint32_t)(a) << 8) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 24))
+#define REG_ABX(op, a, bx) \
+    ((uint32_t)(op) | ((uint32_t)(a) << 8) | ((uint32_t)(bx) << 16))
+
+/* أكواد العمليات. R[x] سجل و K[x] ثابت من تجمع الدالة */
+typedef enum {
+    /* النقل والثوابت */
+    ROP_MOVE,           /* R[A] = R[B] */
+    ROP_LOADK,          /* R[A] = K[Bx] */
+    ROP_LOADI,          /* R[A] = sBx (عدد صحيح صغير دون ثابت) */
+    ROP_LOADBOOL,       /* R[A] = B != 0 */
+    ROP_LOADNULL,       /* R[A] = فارغ */
+
+    /* المتغيرات العامة والمجموعات */
+    ROP_GETGLOBAL,      /* R[A] = عام[Bx] */
+    ROP_SETGLOBAL,      /* عام[Bx] = R[A]، والمتغير معرف مسبقاً */
+    ROP_DEFGLOBAL,      /* تعريف عام[Bx] = R[A] */
+    ROP_GETINDEX,       /* R[A] = R[B][R[C]] */
+    ROP_SETINDEX,       /* R[A][R[B]] = R[C] */
+    ROP_NEWLIST,        /* R[A] = قائمة من R[B] .. R[B + C - 1] */
+    ROP_NEWDICT,        /* R[A] = قاموس من C زوجاً مفتاح، قيمة بدءاً من R[B] */
+
+    /* الحساب */
+    ROP_ADD,            /* R[A] = R[B] + R[C] */
+    ROP_SUB,            /* R[A] = R[B] - R[C] */
+    ROP_MUL,            /* R[A] = R[B] * R[C] */
+    ROP_DIV,            /* R[A] = R[B] / R[C] */
+    ROP_MOD,            /* R[A] = R[B] % R[C] */
+    ROP_POW,            /* R[A] = R[B] ^ R[C] */
+    ROP_ADDK,           /* R[A] = R[B] + K[C] */
+    ROP_SUBK,           /* R[A] = R[B] - K[C] */
+    ROP_MULK,           /* R[A] = R[B] * K[C] */
+    ROP_DIVK,           /* R[A] = R[B] / K[C] */
+    ROP_MODK,           /* R[A] = R[B] % K[C] */
+
+    /* المقارنة والمنطق والبتات */
+    ROP_EQ,             /* R[A] = R[B] == R[C] */
+    ROP_NE,             /* R[A] = R[B] != R[C] */
+    ROP_LT,             /* R[A] = R[B] < R[C] */
+    ROP_LE,             /* R[A] = R[B] <= R[C] */
+    ROP_GT,             /* R[A] = R[B] > R[C] */
+    ROP_GE,             /* R[A] = R[B] >= R[C] */
+    ROP_AND,            /* R[A] = R[B] و R[C] */
+    ROP_OR,             /* R[A] = R[B] أو R[C] */
+    ROP_BIT_AND,        /* R[A] = R[B] & R[C] */
+    ROP_BIT_OR,         /* R[A] = R[B] | R[C] */
+    ROP_BIT_XOR,        /* R[A] = R[B] ~ R[C] */
+    ROP_SHL,            /* R[A] = R[B] << R[C] */
+    ROP_SHR,            /* R[A] = R[B] >> R[C] */
+    ROP_NEG,            /* R[A] = -R[B] */
+    ROP_NOT,            /* R[A] = ليس R[B] */
+    ROP_BIT_NOT,        /* R[A] = ~R[B] */
+
+    /* التحكم في التدفق */
+    ROP_JMP,            /* قفز بالإزاحة sBx */
+    ROP_LOOP,           /* قفز للخلف Bx تعليمة، مع نقطة آمنة للجمع */
+    ROP_JMPIFNOT,       /* قفز بالإزاحة sBx إذا كان R[A] خطأ */
+
+    /* مقارنة وقفز: إذا تحقق الشرط تُتخطى القفزة التالية، وإلا تُنفذ */
+    ROP_IF_EQ,          /* R[A] == R[B] */
+    ROP_IF_NE,          /* R[A] != R[B] */
+    ROP_IF_LT,          /* R[A] < R[B] */
+    ROP_IF_LE,          /* R[A] <= R[B] */
+    ROP_IF_GT,          /* R[A] > R[B] */
+    ROP_IF_GE,          /* R[A] >= R[B] */
+    ROP_IF_EQK,         /* R[A] == K[B] */
+    ROP_IF_NEK,         /* R[A] != K[B] */
+    ROP_IF_LTK,         /* R[A] < K[B] */
+    ROP_IF_LEK,         /* R[A] <= K[B] */
+    ROP_IF_GTK,         /* R[A] > K[B] */
+    ROP_IF_GEK,         /* R[A] >= K[B] */
+    ROP_ITER,           /* R[B] = عنصر R[A] التالي (الموضع في R[A + 1])، وعند النهاية تُنفذ القفزة التالية */
+
+    /* الدوال */
+    ROP_CLOSURE,        /* R[A] = إغلاق للدالة K[Bx] */
+    ROP_CALL,           /* R[A] = R[A](R[A + 1] .. R[A + B]) */
+    ROP_RETURN,         /* إرجاع R[A] */
+    ROP_RETURN_VOID,    /* إرجاع فارغ */
+    ROP_HALT            /* إيقاف */
+} reg_opcode_t;
+
+/* دالة مترجمة للجهاز السجلي */
+typedef struct reg_proto {
+    uint32_t* code;             /* التعليمات */
+    int* lines;                 /* السطر لكل تعليمة */
+    size_t count;
+    size_t capacity;
+
+    constant_t* constants;      /* تجمع الثوابت كما في البايتكود */
+    skp_value_t* values;        /* الثوابت نفسها قيماً جاهزة للتنفيذ */
+    size_t constant_count;
+    size_t constant_capacity;
+
+    int register_count;         /* حجم الإطار: أعلى سجل مستعمل + 1 */
+    int arity;
+} reg_proto_t;
+
+/* الترجمة من الشجرة. تُرجع NULL إن لم يُترجم البرنامج، مع ملاحظة إن كان
+ * فيه ما لا يدعمه الجهاز السجلي بعد؛ فيتولاه الجهاز المكدسي ومترجمه
+ * الذي يبلغ عن أخطاء البرنامج نفسه */
+reg_proto_t* reg_compile(ast_node_t* ast, skp_object_t* globals);
+void reg_proto_free(reg_proto_t* proto);
+
+/* التنفيذ على مكدس الجهاز ومتغيراته العامة وكومته */
+skp_result_t reg_run(skp_vm_t* vm, reg_proto_t* proto);
+
+/* التصحيح */
+const char* reg_opcode_name(reg_opcode_t op);
+void reg_disassemble(reg_proto_t* proto, const char* name);
+int reg_disassemble_instruction(reg_proto_t* proto, int offset);
+
+#endif /* REGVM_H */
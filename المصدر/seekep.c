@@ -4,498 +4,2131 @@
  * Version 1.0.0
  * ============================================ */
 
+#include <ctype.h>
 #include "seekep.h"
+#include "compiler.h"
+#include "regvm.h"
 
 /* ============================================
  * إنشاء كائنات جديدة
  * ============================================ */
 
-skp_object_t* skp_new_int(skp_int value) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
-    if (!obj) return NULL;
+/* كومة الجهاز أثناء التشغيل؛ خارج التشغيل تُخصص الكائنات غير مُدارة */
+static skp_heap_t* active_heap = NULL;
+
+typedef enum {
+    ALLOC_NURSERY,      /* الحضانة إن وُجدت كومة نشطة */
+    ALLOC_TENURED,      /* الجيل القديم مباشرة: كائنات طويلة العمر لا يجوز نقلها */
+    ALLOC_UNMANAGED     /* بعدّ المراجع دائماً (النصوص المحتجزة) */
+} alloc_space_t;
+
+static void push_object(skp_object_t*** items, size_t* count, size_t* capacity, skp_object_t* object) {
+    if (*count >= *capacity) {
+        *capacity = *capacity < 64 ? 64 : *capacity * 2;
+        *items = (skp_object_t**)realloc(*items, *capacity * sizeof(skp_object_t*));
+    }
+    (*items)[(*count)++] = object;
+}
+
+/* ============================================
+ * مجمّع فئات الأحجام
+ * ============================================ */
+
+/* الفئات: 16..128 بخطوة 16، ثم 160..256 بخطوة 32، ثم 320..512 بخطوة 64 */
+static int pool_class_of(size_t size) {
+    if (size <= 128) return (int)((size - 1) >> 4);
+    if (size <= 256) return 8 + (int)((size - 129) >> 5);
+    return 12 + (int)((size - 257) >> 6);
+}
+
+static size_t pool_class_size(int pool_class) {
+    if (pool_class < 8) return (size_t)(pool_class + 1) << 4;
+    if (pool_class < 12) return 128 + ((size_t)(pool_class - 7) << 5);
+    return 256 + ((size_t)(pool_class - 11) << 6);
+}
+
+static void* pool_alloc_class(skp_pool_t* pool, int pool_class) {
+    void* block = pool->free_lists[pool_class];
+    if (block) {
+        pool->free_lists[pool_class] = *(void**)block;
+        return block;
+    }
+    
+    size_t size = pool_class_size(pool_class);
+    if ((size_t)(pool->slab_end - pool->slab_top) < size) {
+        if (pool->slab_count >= pool->slab_capacity) {
+            pool->slab_capacity = pool->slab_capacity < 16 ? 16 : pool->slab_capacity * 2;
+            pool->slabs = (char**)realloc(pool->slabs, pool->slab_capacity * sizeof(char*));
+        }
+        char* slab = (char*)malloc(SKP_POOL_SLAB);
+        if (!slab) return NULL;
+        pool->slabs[pool->slab_count++] = slab;
+        pool->slab_top = slab;
+        pool->slab_end = slab + SKP_POOL_SLAB;
+    }
+    
+    block = pool->slab_top;
+    pool->slab_top += size;
+    return block;
+}
+
+static void pool_free_class(skp_pool_t* pool, void* block, int pool_class) {
+    *(void**)block = pool->free_lists[pool_class];
+    pool->free_lists[pool_class] = block;
+}
+
+static void pool_destroy(skp_pool_t* pool) {
+    for (size_t i = 0; i < pool->slab_count; i++) {
+        free(pool->slabs[i]);
+    }
+    free(pool->slabs);
+    memset(pool, 0, sizeof(skp_pool_t));
+}
+
+/* الذاكرة الخارجية للكائن المُدار من مجمّع الكومة، ولغيره من malloc. لا
+ * يُلمس كائن مُدار إلا وكومته نشطة، فالمجمّع هو دائماً مجمّع active_heap */
+static skp_pool_t* buffer_pool(skp_object_t* owner, size_t size) {
+    if (!(owner->gc & SKP_GC_MANAGED) || size == 0 || size > SKP_POOL_MAX) return NULL;
+    return &active_heap->pool;
+}
+
+static void* buffer_alloc(skp_object_t* owner, size_t size) {
+    skp_pool_t* pool = buffer_pool(owner, size);
+    return pool ? pool_alloc_class(pool, pool_class_of(size)) : malloc(size);
+}
+
+static void buffer_free(skp_object_t* owner, void* buffer, size_t size) {
+    if (!buffer) return;
+    skp_pool_t* pool = buffer_pool(owner, size);
+    if (pool) {
+        pool_free_class(pool, buffer, pool_class_of(size));
+    } else {
+        free(buffer);
+    }
+}
+
+static void* buffer_resize(skp_object_t* owner, void* buffer, size_t old_size, size_t new_size) {
+    skp_pool_t* old_pool = buffer ? buffer_pool(owner, old_size) : NULL;
+    skp_pool_t* new_pool = buffer_pool(owner, new_size);
     
-    obj->type = SKP_TYPE_INT;
+    if (!old_pool && !new_pool) return realloc(buffer, new_size);
+    if (old_pool && new_pool && pool_class_of(old_size) == pool_class_of(new_size)) return buffer;
+    
+    void* resized = buffer_alloc(owner, new_size);
+    if (buffer) {
+        memcpy(resized, buffer, old_size < new_size ? old_size : new_size);
+        buffer_free(owner, buffer, old_size);
+    }
+    return resized;
+}
+
+/* رأس كائن في الجيل القديم: من المجمّع إن صغر */
+static skp_object_t* heap_alloc_header(skp_heap_t* heap, size_t size) {
+    if (size > SKP_POOL_MAX) {
+        skp_object_t* obj = (skp_object_t*)malloc(size);
+        if (obj) obj->pool_class = 0;
+        return obj;
+    }
+    
+    int pool_class = pool_class_of(size);
+    skp_object_t* obj = (skp_object_t*)pool_alloc_class(&heap->pool, pool_class);
+    if (obj) obj->pool_class = (uint8_t)(pool_class + 1);
+    return obj;
+}
+
+static void heap_free_header(skp_heap_t* heap, skp_object_t* obj) {
+    if (obj->pool_class) {
+        pool_free_class(&heap->pool, obj, obj->pool_class - 1);
+    } else {
+        free(obj);
+    }
+}
+
+/* امتلأت الحضانة والجمع ينتظر نقطة آمنة في الجهاز: كتلة مؤقتة حتى ذلك */
+static void nursery_grow(skp_heap_t* heap) {
+    if (heap->overflow_count >= heap->overflow_capacity) {
+        heap->overflow_capacity = heap->overflow_capacity < 4 ? 4 : heap->overflow_capacity * 2;
+        heap->overflow = (char**)realloc(heap->overflow, heap->overflow_capacity * sizeof(char*));
+    }
+    
+    char* block = (char*)malloc(SKP_NURSERY_SIZE);
+    heap->overflow[heap->overflow_count++] = block;
+    heap->nursery_top = block;
+    heap->nursery_end = block + SKP_NURSERY_SIZE;
+    heap->nursery_full = SKP_TRUE;
+    heap->gc_requested = SKP_TRUE;
+}
+
+/* حساب بايتات جديدة في الجيل القديم، وطلب خطوة جمع إن استحقت */
+static void heap_account(skp_heap_t* heap, size_t size) {
+    heap->bytes_allocated += size;
+    heap->debt += size;
+    
+    if (heap->phase == SKP_GC_IDLE ? heap->bytes_allocated > heap->next_gc
+                                   : heap->debt >= SKP_GC_STEP_DEBT) {
+        heap->gc_requested = SKP_TRUE;
+    }
+}
+
+/* ربط كائن جديد بالجيل القديم. أثناء التعليم يولد رمادياً، فيُفحص في خطوة
+ * لاحقة بعد أن يكتمل بناؤه */
+static void heap_link(skp_heap_t* heap, skp_object_t* obj, size_t size) {
+    obj->next = heap->objects;
+    heap->objects = obj;
+    if (heap->phase == SKP_GC_MARKING) skp_heap_mark(heap, obj);
+    heap_account(heap, size);
+}
+
+/* extra: بايتات تُلحق بالكائن في الكتلة نفسها (بيانات النصوص) */
+static skp_object_t* allocate_in(alloc_space_t space, skp_type_t type, size_t extra) {
+    size_t size = sizeof(skp_object_t) + extra;
+    skp_heap_t* heap = space == ALLOC_UNMANAGED ? NULL : active_heap;
+    skp_object_t* obj;
+    
+    if (heap && space == ALLOC_NURSERY && size <= SKP_NURSERY_LARGE) {
+        size = (size + 7) & ~(size_t)7;
+        if ((size_t)(heap->nursery_end - heap->nursery_top) < size) nursery_grow(heap);
+        obj = (skp_object_t*)heap->nursery_top;
+        heap->nursery_top += size;
+        obj->gc = SKP_GC_MANAGED | SKP_GC_YOUNG;
+        obj->pool_class = 0;
+        obj->next = NULL;
+    } else if (heap) {
+        obj = heap_alloc_header(heap, size);
+        if (!obj) return NULL;
+        obj->gc = SKP_GC_MANAGED;
+        heap_link(heap, obj, size);
+    } else {
+        obj = (skp_object_t*)malloc(size);
+        if (!obj) return NULL;
+        obj->gc = 0;
+        obj->pool_class = 0;
+        obj->next = NULL;
+    }
+    
+    obj->type = type;
     obj->refcount = 1;
-    obj->data.v_int = value;
     
     return obj;
 }
 
-skp_object_t* skp_new_float(skp_float value) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
+static skp_object_t* allocate_object_extra(skp_type_t type, size_t extra) {
+    return allocate_in(ALLOC_NURSERY, type, extra);
+}
+
+/* كائن صغير يملك ذاكرة خارجية أو مراجع: يُسجل ليُطلق إن مات في الحضانة */
+static void track_young(skp_object_t* obj) {
+    if (obj && (obj->gc & SKP_GC_YOUNG)) {
+        push_object(&active_heap->owners, &active_heap->owner_count,
+                    &active_heap->owner_capacity, obj);
+    }
+}
+
+static skp_object_t* allocate_object(skp_type_t type) {
+    return allocate_object_extra(type, 0);
+}
+
+/* عدد محارف UTF-8 غير محسوب بعد */
+#define STRING_CHARS_UNKNOWN ((size_t)-1)
+
+static skp_object_t* string_reserve_in(alloc_space_t space, size_t length) {
+    skp_object_t* obj = allocate_in(space, SKP_TYPE_STRING, length + 1);
     if (!obj) return NULL;
     
-    obj->type = SKP_TYPE_FLOAT;
-    obj->refcount = 1;
-    obj->data.v_float = value;
+    obj->data.v_string.chars = (char*)(obj + 1);
+    obj->data.v_string.chars[length] = '\0';
+    obj->data.v_string.length = length;
+    obj->data.v_string.char_count = STRING_CHARS_UNKNOWN;
+    obj->data.v_string.hash = 0;
+    obj->data.v_string.interned = SKP_FALSE;
+    obj->data.v_string.borrowed = SKP_FALSE;
     
     return obj;
 }
 
-skp_object_t* skp_new_bool(skp_bool value) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
+/* نص بطول معروف تُملأ بياناته بعد الإنشاء، ثم يُختم بـ skp_string_seal */
+skp_object_t* skp_string_reserve(size_t length) {
+    return string_reserve_in(ALLOC_NURSERY, length);
+}
+
+/* حساب التجزئة بعد ملء البيانات */
+void skp_string_seal(skp_object_t* string) {
+    string->data.v_string.hash = skp_hash_bytes(string->data.v_string.chars,
+                                                string->data.v_string.length);
+}
+
+static skp_object_t* new_string_bytes(alloc_space_t space, const char* chars, size_t length,
+                                      uint32_t hash) {
+    skp_object_t* obj = string_reserve_in(space, length);
     if (!obj) return NULL;
     
-    obj->type = SKP_TYPE_BOOL;
-    obj->refcount = 1;
-    obj->data.v_bool = value;
+    memcpy(obj->data.v_string.chars, chars, length);
+    obj->data.v_string.hash = hash;
     
     return obj;
 }
 
+skp_object_t* skp_new_string_len(const char* chars, size_t length) {
+    return new_string_bytes(ALLOC_NURSERY, chars, length, skp_hash_bytes(chars, length));
+}
+
 skp_object_t* skp_new_string(const char* value) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
+    if (!value) value = "";
+    return skp_new_string_len(value, strlen(value));
+}
+
+/* عدد المحارف: كل بايت ليس من بايتات الاستمرار 10xxxxxx يبدأ محرفاً */
+size_t skp_string_char_count(skp_object_t* string) {
+    if (string->data.v_string.char_count == STRING_CHARS_UNKNOWN) {
+        skp_string_flatten(string);
+        const unsigned char* chars = (const unsigned char*)string->data.v_string.chars;
+        size_t count = 0;
+        for (size_t i = 0; i < string->data.v_string.length; i++) {
+            count += (chars[i] & 0xC0) != 0x80;
+        }
+        string->data.v_string.char_count = count;
+    }
+    return string->data.v_string.char_count;
+}
+
+/* المحرف يبدأ ببايت ليس من بايتات الاستمرار ويمتد حتى بداية التالي، كما
+ * يعده skp_string_char_count، وما يسبق أول بداية في UTF-8 غير سليم يلحق
+ * بالمحرف الأول. الدوال الثلاث التالية تعمل على نص مسطح، والنص الذي كل
+ * بايت فيه محرف لا يُمسح */
+#define UTF8_CONTINUATION(byte) (((byte) & 0xC0) == 0x80)
+
+/* موضع المحرف index بالبايت؛ index يساوي عدد المحارف يعطي الطول. يُمسح
+ * من الطرف الأقرب، فالفهارس السالبة لا تمر بالنص كله */
+size_t skp_string_char_offset(skp_object_t* string, size_t index) {
+    size_t length = string->data.v_string.length;
+    size_t count = skp_string_char_count(string);
+    if (count == length) return index;
+    if (index == 0) return 0;
+    if (index >= count) return length;
+    
+    const unsigned char* chars = (const unsigned char*)string->data.v_string.chars;
+    if (index > count / 2) {
+        size_t remaining = count - index;
+        for (size_t i = length; i-- > 0;) {
+            if (!UTF8_CONTINUATION(chars[i]) && --remaining == 0) return i;
+        }
+        return length;
+    }
+    
+    size_t seen = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (!UTF8_CONTINUATION(chars[i]) && seen++ == index) return i;
+    }
+    return length;
+}
+
+/* رقم المحرف الذي يقع فيه البايت offset */
+size_t skp_string_char_index(skp_object_t* string, size_t offset) {
+    size_t length = string->data.v_string.length;
+    if (skp_string_char_count(string) == length) return offset;
+    if (offset >= length) return skp_string_char_count(string);
+    
+    const unsigned char* chars = (const unsigned char*)string->data.v_string.chars;
+    size_t starts = 0;
+    for (size_t i = 0; i <= offset; i++) {
+        starts += !UTF8_CONTINUATION(chars[i]);
+    }
+    return starts > 0 ? starts - 1 : 0;
+}
+
+/* بداية المحرف الذي يلي المحرف المبتدئ عند offset */
+size_t skp_string_next_char(skp_object_t* string, size_t offset) {
+    size_t length = string->data.v_string.length;
+    const unsigned char* chars = (const unsigned char*)string->data.v_string.chars;
+    
+    if (offset == 0) {
+        while (offset < length && UTF8_CONTINUATION(chars[offset])) offset++;
+    }
+    if (offset >= length) return length;
+    
+    offset++;
+    while (offset < length && UTF8_CONTINUATION(chars[offset])) offset++;
+    return offset;
+}
+
+/* ============================================
+ * الحبال
+ * ============================================ */
+
+/* جمع النصوص في حلقة يعيد نسخ الناتج كله كل مرة، فيصير البناء تربيعياً.
+ * لذلك يُنشئ الجمع الطويل عقدة حبل تحفظ طرفيها فقط، ولا تُنسخ البيانات إلا
+ * عند أول قراءة. العقدة نص عادي للطول ولعدد المحارف، وchars فيها فارغ حتى
+ * الدمج؛ بعده تشير chars إلى كتلة منفصلة. */
+
+/* أقصر ناتج جمع يُبنى حبلاً؛ ما دونه يُنسخ مباشرة، فلا يكون طرفاه حبلين */
+#define ROPE_MIN_LENGTH 256
+
+/* طرفا الحبل ملحقان بالكائن مكان بيانات النص */
+#define ROPE_CHILDREN(obj) ((skp_object_t**)((obj) + 1))
+
+static skp_object_t* new_rope(skp_object_t* left, skp_object_t* right) {
+    skp_object_t* obj = allocate_object_extra(SKP_TYPE_STRING, 2 * sizeof(skp_object_t*));
     if (!obj) return NULL;
     
-    obj->type = SKP_TYPE_STRING;
-    obj->refcount = 1;
-    obj->data.v_string = strdup(value);
+    size_t left_count = left->data.v_string.char_count;
+    size_t right_count = right->data.v_string.char_count;
+    
+    obj->data.v_string.chars = NULL;
+    obj->data.v_string.length = left->data.v_string.length + right->data.v_string.length;
+    obj->data.v_string.char_count = left_count == STRING_CHARS_UNKNOWN ||
+                                    right_count == STRING_CHARS_UNKNOWN
+        ? STRING_CHARS_UNKNOWN : left_count + right_count;
+    obj->data.v_string.hash = 0;
+    obj->data.v_string.interned = SKP_FALSE;
+    obj->data.v_string.borrowed = SKP_FALSE;
+    
+    skp_incref(left);
+    skp_incref(right);
+    ROPE_CHILDREN(obj)[0] = left;
+    ROPE_CHILDREN(obj)[1] = right;
+    track_young(obj);
     
     return obj;
 }
 
+/* تحرير طرفي حبل لم يُدمج. الحبال المبنية في حلقة عميقة من اليسار،
+ * فيُفك عمودها الأيسر بحلقة بدل العودية */
+static void rope_release(skp_object_t* rope) {
+    skp_object_t* left = ROPE_CHILDREN(rope)[0];
+    skp_decref(ROPE_CHILDREN(rope)[1]);
+    
+    while (!(left->gc & SKP_GC_MANAGED) && --left->refcount <= 0) {
+        if (left->data.v_string.chars != NULL) {
+            skp_free(left);
+            return;
+        }
+        skp_object_t* next = ROPE_CHILDREN(left)[0];
+        skp_decref(ROPE_CHILDREN(left)[1]);
+        free(left);
+        left = next;
+    }
+}
+
+void skp_rope_flatten(skp_object_t* rope) {
+    size_t length = rope->data.v_string.length;
+    char* chars = (char*)malloc(length + 1);
+    chars[length] = '\0';
+    
+    /* الملء من النهاية: يُؤخذ الطرف الأيمن قبل الأيسر، فيبقى المكدس
+     * صغيراً مع الحبال العميقة يساراً */
+    size_t stack_capacity = 16;
+    size_t stack_count = 0;
+    skp_object_t** stack = (skp_object_t**)malloc(stack_capacity * sizeof(skp_object_t*));
+    stack[stack_count++] = rope;
+    
+    size_t end = length;
+    while (stack_count > 0) {
+        skp_object_t* node = stack[--stack_count];
+        if (node->data.v_string.chars != NULL) {
+            end -= node->data.v_string.length;
+            memcpy(chars + end, node->data.v_string.chars, node->data.v_string.length);
+            continue;
+        }
+        
+        if (stack_count + 2 > stack_capacity) {
+            stack_capacity *= 2;
+            stack = (skp_object_t**)realloc(stack, stack_capacity * sizeof(skp_object_t*));
+        }
+        stack[stack_count++] = ROPE_CHILDREN(node)[0];
+        stack[stack_count++] = ROPE_CHILDREN(node)[1];
+    }
+    free(stack);
+    
+    rope_release(rope);
+    rope->data.v_string.chars = chars;
+    rope->data.v_string.hash = skp_hash_bytes(chars, length);
+}
+
 skp_object_t* skp_new_list(void) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
+    skp_object_t* obj = allocate_object(SKP_TYPE_LIST);
     if (!obj) return NULL;
     
-    obj->type = SKP_TYPE_LIST;
-    obj->refcount = 1;
     obj->data.v_list.items = NULL;
     obj->data.v_list.count = 0;
     obj->data.v_list.capacity = 0;
+    track_young(obj);
+    
+    return obj;
+}
+
+static skp_object_t* new_dict_in(alloc_space_t space) {
+    skp_object_t* obj = allocate_in(space, SKP_TYPE_DICT, 0);
+    if (!obj) return NULL;
+    
+    obj->data.v_dict.entries = NULL;
+    obj->data.v_dict.count = 0;
+    obj->data.v_dict.used = 0;
+    obj->data.v_dict.capacity = 0;
+    obj->data.v_dict.slots = NULL;
+    obj->data.v_dict.slot_capacity = 0;
+    
+    return obj;
+}
+
+skp_object_t* skp_new_dict(void) {
+    skp_object_t* obj = new_dict_in(ALLOC_NURSERY);
+    track_young(obj);
+    return obj;
+}
+
+skp_object_t* skp_new_function(const char* name, int arity, struct chunk* chunk) {
+    skp_object_t* obj = allocate_object(SKP_TYPE_FUNC);
+    if (!obj) return NULL;
+    
+    obj->data.v_func.chunk = chunk;
+    obj->data.v_func.regs = NULL;
+    obj->data.v_func.arity = arity;
+    obj->data.v_func.upvalue_count = 0;
+    obj->data.v_func.name = name ? strdup(name) : NULL;
+    
+    return obj;
+}
+
+/* الإغلاقات والأصناف تُنشأ في الجيل القديم: تعيش عادة طوال البرنامج،
+ * والذاكرات المضمنة تحفظ مؤشرات الطرق فلا يجوز نقلها */
+skp_object_t* skp_new_closure(skp_object_t* function) {
+    skp_object_t* obj = allocate_in(ALLOC_TENURED, SKP_TYPE_CLOSURE, 0);
+    if (!obj) return NULL;
+    
+    int count = function->data.v_func.upvalue_count;
+    
+    skp_incref(function);
+    obj->data.v_closure.function = function;
+    obj->data.v_closure.upvalue_count = count;
+    obj->data.v_closure.upvalues = NULL;
+    
+    if (count > 0) {
+        size_t size = count * sizeof(skp_upvalue_t*);
+        obj->data.v_closure.upvalues = (skp_upvalue_t**)buffer_alloc(obj, size);
+        memset(obj->data.v_closure.upvalues, 0, size);
+    }
+    
+    return obj;
+}
+
+skp_object_t* skp_new_native(skp_native_func_t func, const char* name) {
+    skp_object_t* obj = allocate_object(SKP_TYPE_NATIVE);
+    if (!obj) return NULL;
+    
+    obj->data.v_native.func = func;
+    obj->data.v_native.name = name;
+    
+    return obj;
+}
+
+skp_object_t* skp_new_class(const char* name) {
+    skp_object_t* obj = allocate_in(ALLOC_TENURED, SKP_TYPE_CLASS, 0);
+    if (!obj) return NULL;
+    
+    skp_class_t* klass = (skp_class_t*)malloc(sizeof(skp_class_t));
+    klass->name = strdup(name);
+    klass->parent = NULL;
+    klass->object = obj;
+    klass->methods = new_dict_in(ALLOC_TENURED);
+    klass->shape = skp_new_shape();
+    klass->field_hint = 0;
+    
+    obj->data.v_class.klass = klass;
+    
+    return obj;
+}
+
+skp_object_t* skp_new_object(skp_class_t* klass) {
+    skp_object_t* obj = allocate_object(SKP_TYPE_OBJECT);
+    if (!obj) return NULL;
+    
+    /* تُحجز فتحات بقدر ما بلغته كائنات الصنف السابقة فلا تتكرر إعادة الحجز */
+    obj->data.v_object.klass = klass;
+    obj->data.v_object.shape = klass->shape;
+    obj->data.v_object.count = 0;
+    obj->data.v_object.capacity = klass->field_hint;
+    obj->data.v_object.fields = klass->field_hint == 0 ? NULL
+        : (skp_value_t*)buffer_alloc(obj, klass->field_hint * sizeof(skp_value_t));
+    track_young(obj);
+    
+    return obj;
+}
+
+skp_object_t* skp_new_bound_method(skp_value_t receiver, skp_object_t* method) {
+    skp_object_t* obj = allocate_object(SKP_TYPE_BOUND_METHOD);
+    if (!obj) return NULL;
+    
+    skp_value_incref(receiver);
+    skp_incref(method);
+    obj->data.v_bound_method.receiver = receiver;
+    obj->data.v_bound_method.method = method;
+    track_young(obj);
+    
+    return obj;
+}
+
+skp_object_t* skp_new_builder(void) {
+    skp_object_t* obj = allocate_object(SKP_TYPE_BUILDER);
+    if (!obj) return NULL;
+    
+    obj->data.v_builder.chars = NULL;
+    obj->data.v_builder.length = 0;
+    obj->data.v_builder.char_count = 0;
+    obj->data.v_builder.capacity = 0;
+    track_young(obj);
+    
+    return obj;
+}
+
+/* المدى لا يملك ذاكرة خارجية ولا مراجع، فلا يُتتبع في الحضانة */
+/* عدد عناصر المدى بلا إشارة: الفرق بين طرفين بعيدين يفيض skp_int، وقد
+ * يبلغ العدد نفسه 2^64 - 1 فلا يُخزن إلا بعد التحقق منه */
+uint64_t skp_range_count(skp_int start, skp_int end, skp_int step) {
+    if (step > 0 && start < end) {
+        return ((uint64_t)end - (uint64_t)start - 1) / (uint64_t)step + 1;
+    } else if (step < 0 && start > end) {
+        return ((uint64_t)start - (uint64_t)end - 1) / (0 - (uint64_t)step) + 1;
+    }
+    return 0;
+}
+
+skp_object_t* skp_new_range(skp_int start, skp_int end, skp_int step) {
+    uint64_t count = skp_range_count(start, end, step);
+    if (count > (uint64_t)INT64_MAX) return NULL;
+    
+    skp_object_t* obj = allocate_object(SKP_TYPE_RANGE);
+    if (!obj) return NULL;
+    
+    obj->data.v_range.start = start;
+    obj->data.v_range.step = step;
+    obj->data.v_range.count = (skp_int)count;
     
     return obj;
 }
 
-skp_object_t* skp_new_dict(void) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
-    if (!obj) return NULL;
-    
-    obj->type = SKP_TYPE_DICT;
-    obj->refcount = 1;
-    obj->data.v_dict.entries = NULL;
-    obj->data.v_dict.count = 0;
-    obj->data.v_dict.capacity = 0;
+/* الـ upvalue يولد مفتوحاً ومالكه القائمة المفتوحة. أثناء التشغيل يُخصص من
+ * مجمّع الكومة ويُحسب في حجم الجيل القديم، فما يبقى منه حتى إتلاف الكومة
+ * (كالمفتوح عند خطأ زمني) يذهب مع ألواحها */
+skp_upvalue_t* skp_new_upvalue(skp_value_t* slot) {
+    skp_heap_t* heap = active_heap;
+    skp_upvalue_t* upvalue = heap
+        ? (skp_upvalue_t*)pool_alloc_class(&heap->pool, pool_class_of(sizeof(skp_upvalue_t)))
+        : (skp_upvalue_t*)malloc(sizeof(skp_upvalue_t));
+    if (!upvalue) return NULL;
+    
+    upvalue->location = slot;
+    upvalue->closed = SKP_NULL_VAL;
+    upvalue->next = NULL;
+    upvalue->owners = 1;
+    upvalue->pooled = heap != NULL;
+    if (heap) heap_account(heap, sizeof(skp_upvalue_t));
+    
+    return upvalue;
+}
+
+/* ترك مالك للـ upvalue، وتحريره إن كان الأخير. لا يصل هذا إلى upvalue في
+ * المجموعة المتذكرة: المغلق لا يُتذكر إلا بكتابة من إغلاق حي يملكه، وهي
+ * تُفرغ في الجمع الصغير الذي يسبق الكنس في كل خطوة */
+void skp_upvalue_decref(skp_upvalue_t* upvalue) {
+    if (--upvalue->owners > 0) return;
+    
+    if (upvalue->pooled) {
+        active_heap->bytes_allocated -= sizeof(skp_upvalue_t);
+        pool_free_class(&active_heap->pool, upvalue, pool_class_of(sizeof(skp_upvalue_t)));
+    } else {
+        free(upvalue);
+    }
+}
+
+/* ============================================
+ * احتجاز النصوص
+ * ============================================ */
+
+/* جدول النصوص المحتجزة: نسخة واحدة لكل محتوى، فتكفي مقارنة المؤشرات بين
+ * نصين محتجزين. مراجع الجدول ضعيفة: النص يبقى ما دام له مالك، ويُزال من
+ * الجدول عند تحريره. */
+static skp_object_t** intern_slots = NULL;
+static size_t intern_count = 0;
+static size_t intern_capacity = 0;   /* قوة للعدد 2 */
+
+static skp_bool string_equals(skp_object_t* string, const char* chars, size_t length, uint32_t hash) {
+    return string->data.v_string.hash == hash &&
+           string->data.v_string.length == length &&
+           memcmp(string->data.v_string.chars, chars, length) == 0;
+}
+
+/* فتحة النص المساوي في الجدول، أو الفتحة الفارغة التي يُضاف فيها */
+static size_t intern_find(const char* chars, size_t length, uint32_t hash) {
+    size_t mask = intern_capacity - 1;
+    size_t slot = hash & mask;
+    while (intern_slots[slot] && !string_equals(intern_slots[slot], chars, length, hash)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/* الحفاظ على معامل تحميل لا يتجاوز النصف قبل كل إضافة */
+static void intern_reserve(void) {
+    if ((intern_count + 1) * 2 <= intern_capacity) return;
+    
+    skp_object_t** old_slots = intern_slots;
+    size_t old_capacity = intern_capacity;
+    
+    intern_capacity = old_capacity == 0 ? 256 : old_capacity * 2;
+    intern_slots = (skp_object_t**)calloc(intern_capacity, sizeof(skp_object_t*));
+    
+    size_t mask = intern_capacity - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!old_slots[i]) continue;
+        size_t slot = old_slots[i]->data.v_string.hash & mask;
+        while (intern_slots[slot]) slot = (slot + 1) & mask;
+        intern_slots[slot] = old_slots[i];
+    }
+    free(old_slots);
+}
+
+/* إزالة نص محتجز عند تحريره، مع إزاحة ما بعده للخلف بدل شاهد قبر */
+static void intern_remove(skp_object_t* string) {
+    size_t mask = intern_capacity - 1;
+    size_t slot = string->data.v_string.hash & mask;
+    while (intern_slots[slot] != string) slot = (slot + 1) & mask;
+    
+    size_t next = (slot + 1) & mask;
+    while (intern_slots[next]) {
+        size_t ideal = intern_slots[next]->data.v_string.hash & mask;
+        /* يُنقل المدخل إلى الفراغ إلا إذا وقع موضعه المثالي بعد الفراغ */
+        if (((next - ideal) & mask) >= ((next - slot) & mask)) {
+            intern_slots[slot] = intern_slots[next];
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+    intern_slots[slot] = NULL;
+    intern_count--;
+}
+
+/* النسخة المحتجزة من النص، تُنشأ إن لم توجد (مرجع جديد) */
+skp_object_t* skp_intern(const char* chars, size_t length) {
+    uint32_t hash = skp_hash_bytes(chars, length);
+    intern_reserve();
+    
+    size_t slot = intern_find(chars, length, hash);
+    if (intern_slots[slot]) {
+        skp_incref(intern_slots[slot]);
+        return intern_slots[slot];
+    }
+    
+    skp_object_t* string = new_string_bytes(ALLOC_UNMANAGED, chars, length, hash);
+    string->data.v_string.interned = SKP_TRUE;
+    intern_slots[slot] = string;
+    intern_count++;
+    return string;
+}
+
+/* كـ skp_intern لكن النص الجديد يشير إلى chars دون نسخها. chars تنتهي بصفر
+ * ويجب أن تبقى حية ما دام النص محتجزاً (صور البايتكود المخططة لا تُلغى) */
+skp_object_t* skp_intern_borrowed(const char* chars, size_t length) {
+    uint32_t hash = skp_hash_bytes(chars, length);
+    intern_reserve();
+    
+    size_t slot = intern_find(chars, length, hash);
+    if (intern_slots[slot]) {
+        skp_incref(intern_slots[slot]);
+        return intern_slots[slot];
+    }
+    
+    skp_object_t* string = allocate_in(ALLOC_UNMANAGED, SKP_TYPE_STRING, 0);
+    if (!string) return NULL;
+    
+    string->data.v_string.chars = (char*)chars;
+    string->data.v_string.length = length;
+    string->data.v_string.char_count = STRING_CHARS_UNKNOWN;
+    string->data.v_string.hash = hash;
+    string->data.v_string.interned = SKP_TRUE;
+    string->data.v_string.borrowed = SKP_TRUE;
+    intern_slots[slot] = string;
+    intern_count++;
+    return string;
+}
+
+/* النسخة المحتجزة إن وجدت، دون إنشاء ولا مرجع جديد */
+skp_object_t* skp_intern_lookup(const char* chars, size_t length) {
+    if (intern_count == 0) return NULL;
+    return intern_slots[intern_find(chars, length, skp_hash_bytes(chars, length))];
+}
+
+/* ============================================
+ * إدارة الذاكرة
+ * ============================================ */
+
+void skp_incref(skp_object_t* obj) {
+    if (obj) obj->refcount++;
+}
+
+/* الكائنات المُدارة يحررها جمع القمامة وحده */
+void skp_decref(skp_object_t* obj) {
+    if (obj && !(obj->gc & SKP_GC_MANAGED) && --obj->refcount <= 0) {
+        skp_free(obj);
+    }
+}
+
+/* إطلاق ما يملكه الكائن دون تحرير الكائن نفسه */
+static void object_release(skp_object_t* obj) {
+    switch (obj->type) {
+        case SKP_TYPE_STRING:
+            if (obj->data.v_string.interned) intern_remove(obj);
+            if (obj->data.v_string.chars == NULL) {
+                rope_release(obj);
+            } else if (obj->data.v_string.chars != (char*)(obj + 1) &&
+                       !obj->data.v_string.borrowed) {
+                free(obj->data.v_string.chars);   /* حبل مدموج */
+            }
+            break;
+        
+        case SKP_TYPE_LIST:
+            for (size_t i = 0; i < obj->data.v_list.count; i++) {
+                skp_value_decref(obj->data.v_list.items[i]);
+            }
+            buffer_free(obj, obj->data.v_list.items, obj->data.v_list.capacity * sizeof(skp_value_t));
+            break;
+        
+        case SKP_TYPE_DICT:
+            skp_dict_clear(obj);
+            buffer_free(obj, obj->data.v_dict.entries,
+                        obj->data.v_dict.capacity * sizeof(skp_dict_entry_t));
+            buffer_free(obj, obj->data.v_dict.slots, obj->data.v_dict.slot_capacity * sizeof(uint32_t));
+            break;
+        
+        case SKP_TYPE_FUNC:
+            if (obj->data.v_func.chunk) {
+                chunk_free(obj->data.v_func.chunk);
+                free(obj->data.v_func.chunk);
+            }
+            if (obj->data.v_func.regs) {
+                reg_proto_free(obj->data.v_func.regs);
+            }
+            free(obj->data.v_func.name);
+            break;
+        
+        case SKP_TYPE_CLOSURE:
+            skp_decref(obj->data.v_closure.function);
+            for (int i = 0; i < obj->data.v_closure.upvalue_count; i++) {
+                skp_upvalue_t* upvalue = obj->data.v_closure.upvalues[i];
+                if (upvalue) skp_upvalue_decref(upvalue);
+            }
+            buffer_free(obj, obj->data.v_closure.upvalues,
+                        obj->data.v_closure.upvalue_count * sizeof(skp_upvalue_t*));
+            break;
+        
+        case SKP_TYPE_CLASS:
+            free(obj->data.v_class.klass->name);
+            skp_decref(obj->data.v_class.klass->methods);
+            skp_free_shape(obj->data.v_class.klass->shape);
+            free(obj->data.v_class.klass);
+            break;
+        
+        case SKP_TYPE_OBJECT:
+            for (size_t i = 0; i < obj->data.v_object.count; i++) {
+                skp_value_decref(obj->data.v_object.fields[i]);
+            }
+            buffer_free(obj, obj->data.v_object.fields,
+                        obj->data.v_object.capacity * sizeof(skp_value_t));
+            break;
+        
+        case SKP_TYPE_BOUND_METHOD:
+            skp_value_decref(obj->data.v_bound_method.receiver);
+            skp_decref(obj->data.v_bound_method.method);
+            break;
+        
+        case SKP_TYPE_BUILDER:
+            free(obj->data.v_builder.chars);
+            break;
+        
+        default:
+            break;
+    }
+}
+
+void skp_free(skp_object_t* obj) {
+    if (!obj) return;
+    object_release(obj);
+    free(obj);
+}
+
+/* ============================================
+ * الكومة
+ * ============================================ */
+
+void skp_heap_init(skp_heap_t* heap, size_t threshold) {
+    memset(heap, 0, sizeof(skp_heap_t));
+    heap->nursery = (char*)malloc(SKP_NURSERY_SIZE);
+    heap->nursery_top = heap->nursery;
+    heap->nursery_end = heap->nursery + SKP_NURSERY_SIZE;
+    heap->next_gc = threshold;
+}
+
+/* تفعيل كومة للتخصيص (أو NULL لإيقافه)، مع إرجاع السابقة */
+skp_heap_t* skp_heap_use(skp_heap_t* heap) {
+    skp_heap_t* previous = active_heap;
+    active_heap = heap;
+    return previous;
+}
+
+/* حجم الكائن مع بياناته الملحقة */
+static size_t object_size(skp_object_t* obj) {
+    size_t size = sizeof(skp_object_t);
+    if (obj->type == SKP_TYPE_STRING) {
+        if (obj->data.v_string.chars == (char*)(obj + 1)) {
+            size += obj->data.v_string.length + 1;
+        } else {
+            size += 2 * sizeof(skp_object_t*);   /* طرفا الحبل */
+        }
+    }
+    return size;
+}
+
+void skp_heap_remember(skp_object_t* object) {
+    if (!active_heap) return;
+    object->gc |= SKP_GC_REMEMBERED;
+    push_object(&active_heap->remembered, &active_heap->remembered_count,
+                &active_heap->remembered_capacity, object);
+}
+
+void skp_heap_remember_upvalue(skp_upvalue_t* upvalue) {
+    skp_heap_t* heap = active_heap;
+    if (!heap) return;
+    
+    if (heap->remembered_upvalue_count >= heap->remembered_upvalue_capacity) {
+        heap->remembered_upvalue_capacity = heap->remembered_upvalue_capacity < 16
+            ? 16 : heap->remembered_upvalue_capacity * 2;
+        heap->remembered_upvalues = (skp_upvalue_t**)realloc(
+            heap->remembered_upvalues, heap->remembered_upvalue_capacity * sizeof(skp_upvalue_t*));
+    }
+    heap->remembered_upvalues[heap->remembered_upvalue_count++] = upvalue;
+}
+
+/* نسخ كائن ناجٍ من الحضانة إلى الجيل القديم، وترك عنوان النسخة في الأصل */
+skp_object_t* skp_heap_promote(skp_heap_t* heap, skp_object_t* object) {
+    size_t size = object_size(object);
+    skp_object_t* copy = heap_alloc_header(heap, size);
+    uint8_t pool_class = copy->pool_class;
+    memcpy(copy, object, size);
+    copy->pool_class = pool_class;
+    
+    if (object->type == SKP_TYPE_STRING && object->data.v_string.chars == (char*)(object + 1)) {
+        copy->data.v_string.chars = (char*)(copy + 1);
+    }
+    
+    copy->gc = SKP_GC_MANAGED;
+    heap_link(heap, copy, size);
+    
+    object->gc |= SKP_GC_FORWARDED;
+    object->next = copy;
+    return copy;
+}
+
+/* نهاية الجمع الصغير: ما لم يُنقل من الحضانة ميت، فتُطلق ذاكرته الخارجية
+ * وتعود الحضانة فارغة */
+void skp_heap_finish_minor(skp_heap_t* heap) {
+    for (size_t i = 0; i < heap->owner_count; i++) {
+        if (!(heap->owners[i]->gc & SKP_GC_FORWARDED)) {
+            object_release(heap->owners[i]);
+        }
+    }
+    heap->owner_count = 0;
+    
+    for (size_t i = 0; i < heap->remembered_count; i++) {
+        heap->remembered[i]->gc &= ~SKP_GC_REMEMBERED;
+    }
+    heap->remembered_count = 0;
+    heap->remembered_upvalue_count = 0;
+    
+    for (size_t i = 0; i < heap->overflow_count; i++) {
+        free(heap->overflow[i]);
+    }
+    heap->overflow_count = 0;
+    heap->nursery_top = heap->nursery;
+    heap->nursery_end = heap->nursery + SKP_NURSERY_SIZE;
+    heap->nursery_full = SKP_FALSE;
+}
+
+/* تحرير قائمة كائنات ميتة: الإطلاق كله أولاً، فإطلاق كائن قد يقرأ رأس كائن
+ * ميت آخر في القائمة نفسها */
+static void release_object_list(skp_object_t* dead) {
+    for (skp_object_t* obj = dead; obj; obj = obj->next) {
+        object_release(obj);
+    }
+}
+
+/* تحرير الرؤوس المخصصة بـ malloc فقط؛ رؤوس المجمّع تذهب مع ألواحه */
+static void free_object_list(skp_object_t* dead) {
+    while (dead) {
+        skp_object_t* next = dead->next;
+        if (!dead->pool_class) free(dead);
+        dead = next;
+    }
+}
+
+uint64_t skp_clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/* كل كم كائن يُراجع الوقت أثناء خطوة الكنس */
+#define GC_CLOCK_INTERVAL 256
+
+/* كل كم فتحة يُراجع الوقت أثناء خطوة التعليم، وهو أيضاً طول الشريحة التي
+ * تُفحص من حاوية كبيرة في المرة الواحدة */
+#define GC_MARK_SLICE 256
+
+static skp_bool past_deadline(uint64_t deadline, size_t* work) {
+    if (++*work % GC_CLOCK_INTERVAL != 0) return SKP_FALSE;
+    return deadline != 0 && skp_clock_ns() >= deadline;
+}
+
+/* تلوين كائن قديم أبيض بالرمادي */
+void skp_heap_mark(skp_heap_t* heap, skp_object_t* object) {
+    if (!object || (object->gc & (SKP_GC_MANAGED | SKP_GC_YOUNG | SKP_GC_MARKED)) != SKP_GC_MANAGED) {
+        return;
+    }
+    object->gc |= SKP_GC_MARKED;
+    push_object(&heap->gray, &heap->gray_count, &heap->gray_capacity, object);
+}
+
+/* مدخل حاجز ديكسترا: لا يُلوَّن شيء خارج مرحلة التعليم، فأعلام التعليم
+ * الباقية على كائنات لم تُكنس بعد لا تعني شيئاً */
+void skp_heap_shade(skp_object_t* object) {
+    if (active_heap && active_heap->phase == SKP_GC_MARKING) skp_heap_mark(active_heap, object);
+}
+
+static void mark_slot(skp_object_t** slot, void* context) {
+    skp_heap_mark((skp_heap_t*)context, *slot);
+}
+
+/* الحاوية التي فُحص بعضها إن تحركت عناصرها (إدراج، حذف، ترتيب، قلب،
+ * ضغط) قد ينتقل عنصر لم يُفحص إلى موضع فُحص، فيُفحص باقيها قبل التحريك.
+ * حاجز ديكسترا يغطي ما يُكتب فيها بعد ذلك. العلم يغني غيرها عن البحث */
+void skp_heap_reorder(skp_object_t* container) {
+    skp_heap_t* heap = active_heap;
+    if (!heap || !(container->gc & SKP_GC_PARTIAL)) return;
+    
+    for (size_t i = 0; i < heap->partial_count; i++) {
+        if (heap->partial[i].object != container) continue;
+        
+        skp_object_visit_slice(container, heap->partial[i].position, SIZE_MAX, mark_slot, heap);
+        heap->partial[i] = heap->partial[--heap->partial_count];
+        container->gc &= ~SKP_GC_PARTIAL;
+        return;
+    }
+}
+
+static void push_cursor(skp_heap_t* heap, skp_object_t* object, size_t position) {
+    if (heap->partial_count >= heap->partial_capacity) {
+        heap->partial_capacity = heap->partial_capacity < 8 ? 8 : heap->partial_capacity * 2;
+        heap->partial = (skp_gc_cursor_t*)realloc(heap->partial,
+                                                  heap->partial_capacity * sizeof(skp_gc_cursor_t));
+    }
+    heap->partial[heap->partial_count].object = object;
+    heap->partial[heap->partial_count].position = position;
+    heap->partial_count++;
+    object->gc |= SKP_GC_PARTIAL;
+}
+
+/* فحص الكائنات الرمادية حتى تفرغ أو يحين deadline (0 = بلا حد). العمل
+ * يُعد بالفتحات لا بالكائنات، والحاوية الطويلة تُفحص شريحة بعد شريحة
+ * فلا تطيل خطوة واحدة. ما لونته الشريحة يُفحص قبل الشريحة التالية، فلا
+ * يحمل gray عناصر الحاوية كلها. ترجع SKP_TRUE إن فرغت */
+skp_bool skp_heap_mark_step(skp_heap_t* heap, uint64_t deadline) {
+    size_t work = 0;
+    while (heap->gray_count > 0 || heap->partial_count > 0) {
+        skp_object_t* object;
+        size_t from = 0;
+        if (heap->gray_count > 0) {
+            object = heap->gray[--heap->gray_count];
+        } else {
+            skp_gc_cursor_t* cursor = &heap->partial[--heap->partial_count];
+            object = cursor->object;
+            from = cursor->position;
+            object->gc &= ~SKP_GC_PARTIAL;
+        }
+        
+        size_t to = from + GC_MARK_SLICE;
+        skp_object_visit_slice(object, from, to, mark_slot, heap);
+        
+        size_t length = skp_object_length(object);
+        if (to < length) {
+            push_cursor(heap, object, to);
+        } else {
+            to = length > from ? length : from;
+        }
+        
+        /* الرأس يُعد فتحة، فلا تمر آلاف الكائنات الصغيرة دون مراجعة */
+        work += to - from + 1;
+        if (work >= GC_MARK_SLICE) {
+            work = 0;
+            if (deadline != 0 && skp_clock_ns() >= deadline) break;
+        }
+    }
+    return heap->gray_count == 0 && heap->partial_count == 0;
+}
+
+/* فصل الجيل القديم للكنس: ما يُنقل إليه بعد الآن يبقى في objects أبيض،
+ * ولا يمسه هذا الكنس */
+void skp_heap_begin_sweep(skp_heap_t* heap) {
+    heap->phase = SKP_GC_SWEEPING;
+    heap->sweeping = heap->objects;
+    heap->objects = NULL;
+}
+
+/* كنس على خطوات: الأحياء تعود إلى objects، والموتى تُطلق ذاكرتهم
+ * الخارجية وتُجمع في dead. لا يُحرر ميت قبل إطلاق الجميع، فالإطلاق
+ * قد يقرأ رأس ميت آخر. ترجع SKP_TRUE عند انتهاء الدورة */
+skp_bool skp_heap_sweep_step(skp_heap_t* heap, uint64_t deadline) {
+    size_t work = 0;
+    
+    while (heap->sweeping) {
+        skp_object_t* obj = heap->sweeping;
+        heap->sweeping = obj->next;
+        
+        if (obj->gc & SKP_GC_MARKED) {
+            obj->gc &= ~SKP_GC_MARKED;
+            obj->next = heap->objects;
+            heap->objects = obj;
+        } else {
+            heap->bytes_allocated -= object_size(obj);
+            object_release(obj);
+            obj->next = heap->dead;
+            heap->dead = obj;
+        }
+        if (past_deadline(deadline, &work)) return SKP_FALSE;
+    }
+    
+    while (heap->dead) {
+        skp_object_t* next = heap->dead->next;
+        heap_free_header(heap, heap->dead);
+        heap->dead = next;
+        if (past_deadline(deadline, &work)) return SKP_FALSE;
+    }
+    
+    heap->phase = SKP_GC_IDLE;
+    heap->debt = 0;
+    return SKP_TRUE;
+}
+
+void skp_heap_destroy(skp_heap_t* heap) {
+    skp_heap_t* previous = skp_heap_use(heap);
+    
+    for (size_t i = 0; i < heap->owner_count; i++) {
+        if (!(heap->owners[i]->gc & SKP_GC_FORWARDED)) {
+            object_release(heap->owners[i]);
+        }
+    }
+    release_object_list(heap->objects);
+    release_object_list(heap->sweeping);
+    free_object_list(heap->objects);
+    free_object_list(heap->sweeping);
+    free_object_list(heap->dead);
+    pool_destroy(&heap->pool);
+    skp_heap_use(previous);
+    
+    for (size_t i = 0; i < heap->overflow_count; i++) {
+        free(heap->overflow[i]);
+    }
+    free(heap->overflow);
+    free(heap->nursery);
+    free(heap->owners);
+    free(heap->remembered);
+    free(heap->remembered_upvalues);
+    free(heap->gray);
+    free(heap->partial);
+    memset(heap, 0, sizeof(skp_heap_t));
+}
+
+static void visit_value(skp_value_t* value, skp_visit_fn visit, void* context) {
+    if (skp_is_obj_type(value->type) && value->as.v_obj) visit(&value->as.v_obj, context);
+}
+
+/* عدد عناصر الكائن التي تُزار شريحة بعد شريحة: عناصر القائمة، ومدخلات
+ * القاموس، وحقول النسخة. لغيرها صفر فيُزار كله مرة واحدة */
+size_t skp_object_length(skp_object_t* obj) {
+    switch (obj->type) {
+        case SKP_TYPE_LIST: return obj->data.v_list.count;
+        case SKP_TYPE_DICT: return obj->data.v_dict.used;
+        case SKP_TYPE_OBJECT: return obj->data.v_object.count;
+        default: return 0;
+    }
+}
+
+/* زيارة مؤشرات الكائن في العناصر [from, to)؛ ما ليس عنصراً (صنف النسخة،
+ * وكل مؤشرات الأنواع الأخرى) يُزار مع الشريحة الأولى */
+void skp_object_visit_slice(skp_object_t* obj, size_t from, size_t to,
+                            skp_visit_fn visit, void* context) {
+    size_t end = skp_object_length(obj);
+    if (to < end) end = to;
+    
+    switch (obj->type) {
+        case SKP_TYPE_STRING:
+            if (from == 0 && obj->data.v_string.chars == NULL) {
+                visit(&ROPE_CHILDREN(obj)[0], context);
+                visit(&ROPE_CHILDREN(obj)[1], context);
+            }
+            break;
+        
+        case SKP_TYPE_LIST:
+            for (size_t i = from; i < end; i++) {
+                visit_value(&obj->data.v_list.items[i], visit, context);
+            }
+            break;
+        
+        case SKP_TYPE_DICT:
+            for (size_t i = from; i < end; i++) {
+                skp_dict_entry_t* entry = &obj->data.v_dict.entries[i];
+                if (!entry->key) continue;
+                visit(&entry->key, context);
+                visit_value(&entry->value, visit, context);
+            }
+            break;
+        
+        case SKP_TYPE_CLOSURE:
+            if (from > 0) break;
+            visit(&obj->data.v_closure.function, context);
+            for (int i = 0; i < obj->data.v_closure.upvalue_count; i++) {
+                skp_upvalue_t* upvalue = obj->data.v_closure.upvalues[i];
+                if (upvalue) visit_value(&upvalue->closed, visit, context);
+            }
+            break;
+        
+        case SKP_TYPE_CLASS: {
+            if (from > 0) break;
+            skp_class_t* klass = obj->data.v_class.klass;
+            visit(&klass->methods, context);
+            if (klass->parent) visit(&klass->parent->object, context);
+            break;
+        }
+        
+        case SKP_TYPE_OBJECT:
+            if (from == 0) visit(&obj->data.v_object.klass->object, context);
+            for (size_t i = from; i < end; i++) {
+                visit_value(&obj->data.v_object.fields[i], visit, context);
+            }
+            break;
+        
+        case SKP_TYPE_BOUND_METHOD:
+            if (from > 0) break;
+            visit_value(&obj->data.v_bound_method.receiver, visit, context);
+            visit(&obj->data.v_bound_method.method, context);
+            break;
+        
+        default:
+            break;
+    }
+}
+
+/* زيارة كل مؤشر كائن يحمله الكائن */
+void skp_object_visit(skp_object_t* obj, skp_visit_fn visit, void* context) {
+    skp_object_visit_slice(obj, 0, SIZE_MAX, visit, context);
+}
+
+/* ============================================
+ * عمليات على القوائم
+ * ============================================ */
+
+static void list_reserve(skp_object_t* list, size_t needed) {
+    if (needed <= list->data.v_list.capacity) return;
+    
+    size_t capacity = list->data.v_list.capacity == 0 ? 8 : list->data.v_list.capacity;
+    while (capacity < needed) capacity *= 2;
+    
+    list->data.v_list.items = (skp_value_t*)buffer_resize(
+        list, list->data.v_list.items,
+        sizeof(skp_value_t) * list->data.v_list.capacity,
+        sizeof(skp_value_t) * capacity
+    );
+    list->data.v_list.capacity = capacity;
+}
+
+void skp_list_append(skp_object_t* list, skp_value_t item) {
+    if (!list || list->type != SKP_TYPE_LIST) return;
+    
+    list_reserve(list, list->data.v_list.count + 1);
+    
+    skp_write_barrier(list, item);
+    skp_value_incref(item);
+    list->data.v_list.items[list->data.v_list.count++] = item;
+}
+
+skp_value_t skp_list_get(skp_object_t* list, size_t index) {
+    if (!list || list->type != SKP_TYPE_LIST) return SKP_NULL_VAL;
+    if (index >= list->data.v_list.count) return SKP_NULL_VAL;
+    
+    return list->data.v_list.items[index];
+}
+
+void skp_list_set(skp_object_t* list, size_t index, skp_value_t item) {
+    if (!list || list->type != SKP_TYPE_LIST) return;
+    if (index >= list->data.v_list.count) return;
+    
+    skp_write_barrier(list, item);
+    skp_value_incref(item);
+    skp_value_decref(list->data.v_list.items[index]);
+    list->data.v_list.items[index] = item;
+}
+
+size_t skp_list_len(skp_object_t* list) {
+    if (!list || list->type != SKP_TYPE_LIST) return 0;
+    return list->data.v_list.count;
+}
+
+skp_object_t* skp_list_slice(skp_object_t* list, skp_int start, skp_int end) {
+    if (!list || list->type != SKP_TYPE_LIST) return NULL;
+    
+    size_t len = list->data.v_list.count;
+    
+    if (start < 0) start = len + start;
+    if (end < 0) end = len + end;
+    if (start < 0) start = 0;
+    if (end > (skp_int)len) end = len;
+    if (start >= end) return skp_new_list();
+    
+    skp_object_t* result = skp_new_list();
+    for (skp_int i = start; i < end; i++) {
+        skp_list_append(result, list->data.v_list.items[i]);
+    }
+    
+    return result;
+}
+
+static int compare_values(const void* a, const void* b) {
+    skp_value_t va = *(const skp_value_t*)a;
+    skp_value_t vb = *(const skp_value_t*)b;
+    
+    if (skp_lt(va, vb)) return -1;
+    if (skp_gt(va, vb)) return 1;
+    return 0;
+}
+
+void skp_list_sort(skp_object_t* list) {
+    if (!list || list->type != SKP_TYPE_LIST) return;
+    
+    skp_heap_reorder(list);
+    qsort(list->data.v_list.items, list->data.v_list.count,
+          sizeof(skp_value_t), compare_values);
+}
+
+void skp_list_insert(skp_object_t* list, skp_int index, skp_value_t item) {
+    if (!list || list->type != SKP_TYPE_LIST) return;
+    
+    skp_int len = (skp_int)list->data.v_list.count;
+    if (index < 0) index = len + index;
+    if (index < 0) index = 0;
+    if (index > len) index = len;
+    
+    list_reserve(list, list->data.v_list.count + 1);
+    
+    if (index < len) skp_heap_reorder(list);
+    memmove(&list->data.v_list.items[index + 1],
+            &list->data.v_list.items[index],
+            sizeof(skp_value_t) * (len - index));
+    
+    skp_write_barrier(list, item);
+    skp_value_incref(item);
+    list->data.v_list.items[index] = item;
+    list->data.v_list.count++;
+}
+
+void skp_list_remove(skp_object_t* list, skp_int index) {
+    if (!list || list->type != SKP_TYPE_LIST) return;
+    
+    skp_int len = (skp_int)list->data.v_list.count;
+    if (index < 0) index = len + index;
+    if (index < 0 || index >= len) return;
+    
+    skp_value_decref(list->data.v_list.items[index]);
+    
+    if (index < len - 1) skp_heap_reorder(list);
+    memmove(&list->data.v_list.items[index],
+            &list->data.v_list.items[index + 1],
+            sizeof(skp_value_t) * (len - index - 1));
+    list->data.v_list.count--;
+}
+
+void skp_list_clear(skp_object_t* list) {
+    if (!list || list->type != SKP_TYPE_LIST) return;
+    
+    for (size_t i = 0; i < list->data.v_list.count; i++) {
+        skp_value_decref(list->data.v_list.items[i]);
+    }
+    list->data.v_list.count = 0;
+}
+
+skp_object_t* skp_list_copy(skp_object_t* list) {
+    if (!list || list->type != SKP_TYPE_LIST) return NULL;
+    
+    skp_object_t* result = skp_new_list();
+    list_reserve(result, list->data.v_list.count);
+    
+    for (size_t i = 0; i < list->data.v_list.count; i++) {
+        skp_list_append(result, list->data.v_list.items[i]);
+    }
+    
+    return result;
+}
+
+/* ============================================
+ * عمليات على المديات
+ * ============================================ */
+
+skp_object_t* skp_range_to_list(skp_object_t* range) {
+    if (!range || range->type != SKP_TYPE_RANGE) return NULL;
+    
+    /* مدى يتسع عدده في عدد صحيح قد لا يتسع حجم قائمته في size_t، وسعتها
+     * تبلغ ضعف عددها */
+    if ((uint64_t)range->data.v_range.count > SIZE_MAX / sizeof(skp_value_t) / 2) return NULL;
+    
+    skp_object_t* result = skp_new_list();
+    list_reserve(result, (size_t)range->data.v_range.count);
+    
+    for (skp_int i = 0; i < range->data.v_range.count; i++) {
+        result->data.v_list.items[i] = SKP_INT_VAL(skp_range_at(range, i));
+    }
+    result->data.v_list.count = (size_t)range->data.v_range.count;
+    
+    return result;
+}
+
+/* ============================================
+ * عمليات على القواميس
+ * ============================================ */
+
+/*
+ * القاموس جدول تجزئة مضغوط: المدخلات مخزنة متتالية بترتيب الإدخال،
+ * وجدول الفتحات (عنونة مفتوحة بأسلوب روبن هود) يشير إليها بفهارسها.
+ * الحذف يزيح الفتحات التالية للخلف فلا تبقى شواهد قبور في الجدول،
+ * ويترك ثقباً في المدخلات يُضغط عند الحاجة إلى مساحة.
+ */
+
+#define DICT_MIN_SLOTS 8
+
+/* تجزئة FNV-1a */
+uint32_t skp_hash_bytes(const char* chars, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)chars[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t skp_hash_string(const char* key) {
+    return skp_hash_bytes(key, strlen(key));
+}
+
+/* بُعد المدخل عن فتحته المثالية */
+static size_t dict_probe_distance(skp_object_t* dict, size_t slot) {
+    size_t mask = dict->data.v_dict.slot_capacity - 1;
+    uint32_t hash = dict->data.v_dict.entries[dict->data.v_dict.slots[slot] - 1].hash;
+    return (slot - (hash & mask)) & mask;
+}
+
+/* وضع فهرس مدخل في جدول الفتحات */
+static void dict_insert_slot(skp_object_t* dict, uint32_t entry_index, uint32_t hash) {
+    uint32_t* slots = dict->data.v_dict.slots;
+    size_t mask = dict->data.v_dict.slot_capacity - 1;
+    size_t slot = hash & mask;
+    size_t distance = 0;
+    uint32_t current = entry_index + 1;
+    
+    for (;;) {
+        if (slots[slot] == 0) {
+            slots[slot] = current;
+            return;
+        }
+        
+        /* روبن هود: المدخل الأبعد عن موضعه يأخذ الفتحة */
+        size_t existing = dict_probe_distance(dict, slot);
+        if (existing < distance) {
+            uint32_t displaced = slots[slot];
+            slots[slot] = current;
+            current = displaced;
+            distance = existing;
+        }
+        
+        slot = (slot + 1) & mask;
+        distance++;
+    }
+}
+
+/* إعادة بناء جدول الفتحات من المدخلات */
+static void dict_rebuild_slots(skp_object_t* dict, size_t slot_capacity) {
+    buffer_free(dict, dict->data.v_dict.slots, dict->data.v_dict.slot_capacity * sizeof(uint32_t));
+    dict->data.v_dict.slots = (uint32_t*)buffer_alloc(dict, slot_capacity * sizeof(uint32_t));
+    memset(dict->data.v_dict.slots, 0, slot_capacity * sizeof(uint32_t));
+    dict->data.v_dict.slot_capacity = slot_capacity;
+    
+    for (size_t i = 0; i < dict->data.v_dict.used; i++) {
+        skp_dict_entry_t* entry = &dict->data.v_dict.entries[i];
+        if (entry->key) {
+            dict_insert_slot(dict, (uint32_t)i, entry->hash);
+        }
+    }
+}
+
+/* إزالة ثقوب المدخلات المحذوفة مع الحفاظ على الترتيب */
+static void dict_compact(skp_object_t* dict) {
+    skp_dict_entry_t* entries = dict->data.v_dict.entries;
+    size_t live = 0;
+    
+    skp_heap_reorder(dict);
+    for (size_t i = 0; i < dict->data.v_dict.used; i++) {
+        if (entries[i].key) {
+            entries[live++] = entries[i];
+        }
+    }
+    
+    dict->data.v_dict.used = live;
+    dict_rebuild_slots(dict, dict->data.v_dict.slot_capacity);
+}
+
+/* تجهيز مساحة لمدخل جديد */
+static void dict_reserve(skp_object_t* dict) {
+    if (dict->data.v_dict.used >= dict->data.v_dict.capacity) {
+        size_t holes = dict->data.v_dict.used - dict->data.v_dict.count;
+        if (holes > 0 && holes >= dict->data.v_dict.used / 4) {
+            dict_compact(dict);
+        } else {
+            size_t capacity = dict->data.v_dict.capacity == 0 ? 8 : dict->data.v_dict.capacity * 2;
+            dict->data.v_dict.entries = (skp_dict_entry_t*)buffer_resize(
+                dict, dict->data.v_dict.entries,
+                sizeof(skp_dict_entry_t) * dict->data.v_dict.capacity,
+                sizeof(skp_dict_entry_t) * capacity
+            );
+            dict->data.v_dict.capacity = capacity;
+        }
+    }
+    
+    /* الحفاظ على معامل تحميل لا يتجاوز 3/4 */
+    if ((dict->data.v_dict.count + 1) * 4 > dict->data.v_dict.slot_capacity * 3) {
+        size_t slot_capacity = dict->data.v_dict.slot_capacity == 0
+            ? DICT_MIN_SLOTS : dict->data.v_dict.slot_capacity * 2;
+        dict_rebuild_slots(dict, slot_capacity);
+    }
+}
+
+/* البحث عن فتحة المفتاح، أو -1 إذا لم يوجد. object هو كائن النص المطلوب إن وُجد:
+ * يطابق المدخل الذي يحمله نفسه، ولا يُقارن محتوى نصين محتجزين مختلفين */
+static long dict_find_slot(skp_object_t* dict, const char* key, size_t length, uint32_t hash,
+                           skp_object_t* object) {
+    if (dict->data.v_dict.count == 0) return -1;
+    
+    uint32_t* slots = dict->data.v_dict.slots;
+    size_t mask = dict->data.v_dict.slot_capacity - 1;
+    size_t slot = hash & mask;
+    
+    for (size_t distance = 0; slots[slot] != 0; distance++) {
+        skp_dict_entry_t* entry = &dict->data.v_dict.entries[slots[slot] - 1];
+        if (entry->key == object) {
+            return (long)slot;
+        }
+        if (entry->hash == hash &&
+            !(object && object->data.v_string.interned && entry->key->data.v_string.interned) &&
+            string_equals(entry->key, key, length, hash)) {
+            return (long)slot;
+        }
+        
+        /* لو كان المفتاح موجوداً لما تجاوزه مدخل أقرب منه إلى موضعه */
+        if (dict_probe_distance(dict, slot) < distance) {
+            return -1;
+        }
+        
+        slot = (slot + 1) & mask;
+    }
+    
+    return -1;
+}
+
+static long dict_find_cstring(skp_object_t* dict, const char* key) {
+    size_t length = strlen(key);
+    return dict_find_slot(dict, key, length, skp_hash_bytes(key, length), NULL);
+}
+
+static long dict_find_string(skp_object_t* dict, skp_object_t* key) {
+    skp_string_flatten(key);
+    return dict_find_slot(dict, key->data.v_string.chars, key->data.v_string.length,
+                          key->data.v_string.hash, key);
+}
+
+static skp_dict_entry_t* dict_entry_at(skp_object_t* dict, long slot) {
+    if (slot < 0) return NULL;
+    return &dict->data.v_dict.entries[dict->data.v_dict.slots[slot] - 1];
+}
+
+static void dict_replace(skp_object_t* dict, skp_dict_entry_t* entry, skp_value_t value) {
+    skp_write_barrier(dict, value);
+    skp_value_incref(value);
+    skp_value_decref(entry->value);
+    entry->value = value;
+}
+
+/* إلحاق مفتاح جديد؛ يأخذ القاموس مرجع كائن المفتاح */
+static void dict_append(skp_object_t* dict, skp_object_t* key, skp_value_t value) {
+    dict_reserve(dict);
+    
+    size_t index = dict->data.v_dict.used++;
+    skp_dict_entry_t* entry = &dict->data.v_dict.entries[index];
+    entry->key = key;
+    entry->hash = key->data.v_string.hash;
+    skp_write_barrier(dict, SKP_OBJ_VAL(key));
+    skp_write_barrier(dict, value);
+    skp_value_incref(value);
+    entry->value = value;
+    
+    dict_insert_slot(dict, (uint32_t)index, entry->hash);
+    dict->data.v_dict.count++;
+}
+
+void skp_dict_set(skp_object_t* dict, const char* key, skp_value_t value) {
+    if (!dict || dict->type != SKP_TYPE_DICT || !key) return;
+    
+    size_t length = strlen(key);
+    uint32_t hash = skp_hash_bytes(key, length);
+    skp_dict_entry_t* existing = dict_entry_at(dict, dict_find_slot(dict, key, length, hash, NULL));
+    if (existing) {
+        dict_replace(dict, existing, value);
+        return;
+    }
+    
+    dict_append(dict, new_string_bytes(ALLOC_NURSERY, key, length, hash), value);
+}
+
+/* مثل skp_dict_set بمفتاح من نوع نص: لا يُنسخ المفتاح ولا تُعاد تجزئته */
+void skp_dict_set_key(skp_object_t* dict, skp_object_t* key, skp_value_t value) {
+    if (!dict || dict->type != SKP_TYPE_DICT || !key) return;
+    
+    skp_dict_entry_t* existing = dict_entry_at(dict, dict_find_string(dict, key));
+    if (existing) {
+        dict_replace(dict, existing, value);
+        return;
+    }
+    
+    skp_incref(key);
+    dict_append(dict, key, value);
+}
+
+skp_bool skp_dict_get(skp_object_t* dict, const char* key, skp_value_t* out) {
+    if (!dict || dict->type != SKP_TYPE_DICT || !key) return SKP_FALSE;
+    
+    skp_dict_entry_t* entry = dict_entry_at(dict, dict_find_cstring(dict, key));
+    if (!entry) return SKP_FALSE;
+    
+    if (out) *out = entry->value;
+    return SKP_TRUE;
+}
+
+/* البحث بمفتاح من نوع نص، مع إرجاع المدخل نفسه لمعرفة موضعه */
+skp_dict_entry_t* skp_dict_find(skp_object_t* dict, skp_object_t* key) {
+    if (!dict || dict->type != SKP_TYPE_DICT || !key) return NULL;
+    return dict_entry_at(dict, dict_find_string(dict, key));
+}
+
+skp_bool skp_dict_has(skp_object_t* dict, const char* key) {
+    return skp_dict_get(dict, key, NULL);
+}
+
+void skp_dict_remove(skp_object_t* dict, const char* key) {
+    if (!dict || dict->type != SKP_TYPE_DICT || !key) return;
+    
+    long found = dict_find_cstring(dict, key);
+    if (found < 0) return;
+    
+    uint32_t* slots = dict->data.v_dict.slots;
+    size_t mask = dict->data.v_dict.slot_capacity - 1;
+    size_t slot = (size_t)found;
+    
+    skp_dict_entry_t* entry = &dict->data.v_dict.entries[slots[slot] - 1];
+    skp_decref(entry->key);
+    entry->key = NULL;
+    skp_value_decref(entry->value);
+    entry->value = SKP_NULL_VAL;
+    dict->data.v_dict.count--;
+    
+    /* إزاحة المدخلات التالية للخلف بدل ترك شاهد قبر */
+    size_t next = (slot + 1) & mask;
+    while (slots[next] != 0 && dict_probe_distance(dict, next) > 0) {
+        slots[slot] = slots[next];
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    slots[slot] = 0;
+}
+
+/* المرور على المدخلات الحية بالترتيب؛ position يبدأ من 0 */
+skp_bool skp_dict_next(skp_object_t* dict, size_t* position, skp_dict_entry_t** entry) {
+    while (*position < dict->data.v_dict.used) {
+        skp_dict_entry_t* current = &dict->data.v_dict.entries[(*position)++];
+        if (current->key) {
+            *entry = current;
+            return SKP_TRUE;
+        }
+    }
+    return SKP_FALSE;
+}
+
+size_t skp_dict_len(skp_object_t* dict) {
+    if (!dict || dict->type != SKP_TYPE_DICT) return 0;
+    return dict->data.v_dict.count;
+}
+
+void skp_dict_clear(skp_object_t* dict) {
+    if (!dict || dict->type != SKP_TYPE_DICT) return;
+    
+    for (size_t i = 0; i < dict->data.v_dict.used; i++) {
+        if (dict->data.v_dict.entries[i].key) {
+            skp_decref(dict->data.v_dict.entries[i].key);
+            skp_value_decref(dict->data.v_dict.entries[i].value);
+        }
+    }
+    dict->data.v_dict.count = 0;
+    dict->data.v_dict.used = 0;
+    if (dict->data.v_dict.slots) {
+        memset(dict->data.v_dict.slots, 0, sizeof(uint32_t) * dict->data.v_dict.slot_capacity);
+    }
+}
+
+skp_object_t* skp_dict_copy(skp_object_t* dict) {
+    if (!dict || dict->type != SKP_TYPE_DICT) return NULL;
+    
+    skp_object_t* result = skp_new_dict();
+    skp_dict_merge(result, dict);
+    return result;
+}
+
+void skp_dict_merge(skp_object_t* dest, skp_object_t* src) {
+    if (!dest || dest->type != SKP_TYPE_DICT) return;
+    if (!src || src->type != SKP_TYPE_DICT) return;
     
-    return obj;
+    size_t position = 0;
+    skp_dict_entry_t* entry;
+    while (skp_dict_next(src, &position, &entry)) {
+        skp_dict_set_key(dest, entry->key, entry->value);
+    }
 }
 
-skp_object_t* skp_new_null(void) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
-    if (!obj) return NULL;
-    
-    obj->type = SKP_TYPE_NULL;
-    obj->refcount = 1;
+skp_object_t* skp_dict_keys(skp_object_t* dict) {
+    if (!dict || dict->type != SKP_TYPE_DICT) return NULL;
     
-    return obj;
+    skp_object_t* result = skp_new_list();
+    size_t position = 0;
+    skp_dict_entry_t* entry;
+    while (skp_dict_next(dict, &position, &entry)) {
+        skp_list_append(result, SKP_OBJ_VAL(entry->key));
+    }
+    return result;
 }
 
-skp_object_t* skp_new_func(skp_object_t* (*func)(skp_object_t** args, size_t argc)) {
-    skp_object_t* obj = (skp_object_t*)malloc(sizeof(skp_object_t));
-    if (!obj) return NULL;
+skp_object_t* skp_dict_values(skp_object_t* dict) {
+    if (!dict || dict->type != SKP_TYPE_DICT) return NULL;
     
-    obj->type = SKP_TYPE_FUNC;
-    obj->refcount = 1;
-    obj->data.v_func.func = func;
-    obj->data.v_func.closure = NULL;
+    skp_object_t* result = skp_new_list();
+    size_t position = 0;
+    skp_dict_entry_t* entry;
+    while (skp_dict_next(dict, &position, &entry)) {
+        skp_list_append(result, entry->value);
+    }
+    return result;
+}
+
+skp_object_t* skp_dict_items(skp_object_t* dict) {
+    if (!dict || dict->type != SKP_TYPE_DICT) return NULL;
     
-    return obj;
+    skp_object_t* result = skp_new_list();
+    size_t position = 0;
+    skp_dict_entry_t* entry;
+    while (skp_dict_next(dict, &position, &entry)) {
+        skp_object_t* pair = skp_new_list();
+        skp_list_append(pair, SKP_OBJ_VAL(entry->key));
+        skp_list_append(pair, entry->value);
+        skp_list_append(result, SKP_OBJ_VAL(pair));
+        skp_decref(pair);
+    }
+    return result;
 }
 
 /* ============================================
- * إدارة الذاكرة
+ * الأشكال وحقول الكائنات
  * ============================================ */
 
-void skp_incref(skp_object_t* obj) {
-    if (obj) obj->refcount++;
-}
+/* معرفات الأشكال تبدأ من 1، فالصفر يعني مدخلاً فارغاً في الذواكر المخبئية */
+static uint32_t next_shape_id = 0;
 
-void skp_decref(skp_object_t* obj) {
-    if (obj && --obj->refcount <= 0) {
-        skp_free(obj);
-    }
+skp_shape_t* skp_new_shape(void) {
+    skp_shape_t* shape = (skp_shape_t*)calloc(1, sizeof(skp_shape_t));
+    shape->id = ++next_shape_id;
+    return shape;
 }
 
-void skp_free(skp_object_t* obj) {
-    if (!obj) return;
+/* تحرير الشكل وكل الأشكال المنتقلة منه */
+void skp_free_shape(skp_shape_t* shape) {
+    if (!shape) return;
     
-    switch (obj->type) {
-        case SKP_TYPE_STRING:
-            if (obj->data.v_string) free(obj->data.v_string);
-            break;
-            
-        case SKP_TYPE_LIST:
-            for (size_t i = 0; i < obj->data.v_list.count; i++) {
-                skp_decref(obj->data.v_list.items[i]);
-            }
-            free(obj->data.v_list.items);
-            break;
-            
-        case SKP_TYPE_DICT:
-            for (size_t i = 0; i < obj->data.v_dict.count; i++) {
-                free(obj->data.v_dict.entries[i]->key);
-                skp_decref(obj->data.v_dict.entries[i]->value);
-                free(obj->data.v_dict.entries[i]);
-            }
-            free(obj->data.v_dict.entries);
-            break;
-            
-        default:
-            break;
+    for (size_t i = 0; i < shape->transition_count; i++) {
+        skp_free_shape(shape->transitions[i]);
     }
-    
-    free(obj);
+    free(shape->transitions);
+    skp_decref(shape->name);
+    free(shape);
 }
 
-/* ============================================
- * عمليات على القوائم
- * ============================================ */
-
-void skp_list_append(skp_object_t* list, skp_object_t* item) {
-    if (!list || list->type != SKP_TYPE_LIST || !item) return;
+/* الشكل الناتج عن إضافة الحقل name (نص محتجز)، يُنشأ عند أول إضافة ثم يُعاد استعماله */
+skp_shape_t* skp_shape_transition(skp_shape_t* shape, skp_object_t* name) {
+    for (size_t i = 0; i < shape->transition_count; i++) {
+        if (shape->transitions[i]->name == name) {
+            return shape->transitions[i];
+        }
+    }
     
-    if (list->data.v_list.count >= list->data.v_list.capacity) {
-        list->data.v_list.capacity = list->data.v_list.capacity == 0 ? 8 : list->data.v_list.capacity * 2;
-        list->data.v_list.items = (skp_object_t**)realloc(
-            list->data.v_list.items,
-            sizeof(skp_object_t*) * list->data.v_list.capacity
-        );
+    if (shape->transition_count >= shape->transition_capacity) {
+        shape->transition_capacity = shape->transition_capacity == 0 ? 2 : shape->transition_capacity * 2;
+        shape->transitions = (skp_shape_t**)realloc(shape->transitions,
+                                                    shape->transition_capacity * sizeof(skp_shape_t*));
     }
     
-    skp_incref(item);
-    list->data.v_list.items[list->data.v_list.count++] = item;
+    skp_shape_t* child = skp_new_shape();
+    child->parent = shape;
+    skp_incref(name);
+    child->name = name;
+    child->field_count = shape->field_count + 1;
+    shape->transitions[shape->transition_count++] = child;
+    return child;
 }
 
-skp_object_t* skp_list_get(skp_object_t* list, size_t index) {
-    if (!list || list->type != SKP_TYPE_LIST) return NULL;
-    if (index >= list->data.v_list.count) return NULL;
-    
-    return list->data.v_list.items[index];
+/* فتحة الحقل name (نص محتجز) في الشكل، أو -1 إذا لم يكن فيه */
+int skp_shape_find(skp_shape_t* shape, skp_object_t* name) {
+    for (; shape->parent; shape = shape->parent) {
+        if (shape->name == name) {
+            return (int)shape->field_count - 1;
+        }
+    }
+    return -1;
 }
 
-void skp_list_set(skp_object_t* list, size_t index, skp_object_t* item) {
-    if (!list || list->type != SKP_TYPE_LIST || !item) return;
-    if (index >= list->data.v_list.count) return;
+skp_bool skp_object_get_field(skp_object_t* obj, const char* name, skp_value_t* out) {
+    /* اسم لم يُحتجز قط لا يمكن أن يكون حقلاً */
+    skp_object_t* key = skp_intern_lookup(name, strlen(name));
+    int slot = key ? skp_shape_find(obj->data.v_object.shape, key) : -1;
+    if (slot < 0) return SKP_FALSE;
     
-    skp_decref(list->data.v_list.items[index]);
-    skp_incref(item);
-    list->data.v_list.items[index] = item;
+    if (out) *out = obj->data.v_object.fields[slot];
+    return SKP_TRUE;
 }
 
-size_t skp_list_len(skp_object_t* list) {
-    if (!list || list->type != SKP_TYPE_LIST) return 0;
-    return list->data.v_list.count;
+void skp_object_set_field(skp_object_t* obj, const char* name, skp_value_t value) {
+    skp_object_t* key = skp_intern(name, strlen(name));
+    int slot = skp_shape_find(obj->data.v_object.shape, key);
+    if (slot < 0) {
+        skp_object_add_field(obj, skp_shape_transition(obj->data.v_object.shape, key), value);
+        skp_decref(key);
+        return;
+    }
+    skp_decref(key);
+    
+    skp_write_barrier(obj, value);
+    skp_value_incref(value);
+    skp_value_decref(obj->data.v_object.fields[slot]);
+    obj->data.v_object.fields[slot] = value;
 }
 
-skp_object_t* skp_list_slice(skp_object_t* list, skp_int start, skp_int end) {
-    if (!list || list->type != SKP_TYPE_LIST) return NULL;
+/* إلحاق حقل جديد؛ shape هو انتقال الشكل الحالي بهذا الحقل */
+void skp_object_add_field(skp_object_t* obj, skp_shape_t* shape, skp_value_t value) {
+    uint32_t slot = shape->field_count - 1;
     
-    size_t len = list->data.v_list.count;
+    if (slot >= obj->data.v_object.capacity) {
+        size_t capacity = obj->data.v_object.capacity < 4 ? 4 : obj->data.v_object.capacity * 2;
+        obj->data.v_object.fields = (skp_value_t*)buffer_resize(
+            obj, obj->data.v_object.fields,
+            obj->data.v_object.capacity * sizeof(skp_value_t), capacity * sizeof(skp_value_t));
+        obj->data.v_object.capacity = capacity;
+    }
     
-    if (start < 0) start = len + start;
-    if (end < 0) end = len + end;
-    if (start < 0) start = 0;
-    if (end > (skp_int)len) end = len;
-    if (start >= end) return skp_new_list();
+    skp_write_barrier(obj, value);
+    skp_value_incref(value);
+    obj->data.v_object.fields[slot] = value;
+    obj->data.v_object.shape = shape;
+    obj->data.v_object.count = shape->field_count;
     
-    skp_object_t* result = skp_new_list();
-    for (skp_int i = start; i < end; i++) {
-        skp_list_append(result, list->data.v_list.items[i]);
+    skp_class_t* klass = obj->data.v_object.klass;
+    if (shape->field_count > klass->field_hint) {
+        klass->field_hint = shape->field_count;
     }
-    
-    return result;
 }
 
 /* ============================================
- * عمليات على القواميس
+ * الفهرسة
  * ============================================ */
 
-void skp_dict_set(skp_object_t* dict, const char* key, skp_object_t* value) {
-    if (!dict || dict->type != SKP_TYPE_DICT || !key || !value) return;
-    
-    /* البحث عن المفتاح */
-    for (size_t i = 0; i < dict->data.v_dict.count; i++) {
-        if (strcmp(dict->data.v_dict.entries[i]->key, key) == 0) {
-            skp_decref(dict->data.v_dict.entries[i]->value);
-            skp_incref(value);
-            dict->data.v_dict.entries[i]->value = value;
-            return;
-        }
+skp_bool skp_get_index(skp_value_t object, skp_value_t index, skp_value_t* out) {
+    if (SKP_IS_LIST(object) && SKP_IS_INT(index)) {
+        skp_object_t* list = SKP_AS_OBJ(object);
+        skp_int i = SKP_AS_INT(index);
+        if (i < 0) i += (skp_int)list->data.v_list.count;
+        if (i < 0 || i >= (skp_int)list->data.v_list.count) return SKP_FALSE;
+        *out = list->data.v_list.items[i];
+        return SKP_TRUE;
     }
     
-    /* إضافة مفتاح جديد */
-    if (dict->data.v_dict.count >= dict->data.v_dict.capacity) {
-        dict->data.v_dict.capacity = dict->data.v_dict.capacity == 0 ? 8 : dict->data.v_dict.capacity * 2;
-        dict->data.v_dict.entries = (skp_dict_entry_t**)realloc(
-            dict->data.v_dict.entries,
-            sizeof(skp_dict_entry_t*) * dict->data.v_dict.capacity
-        );
+    if (SKP_IS_RANGE(object) && SKP_IS_INT(index)) {
+        skp_object_t* range = SKP_AS_OBJ(object);
+        skp_int i = SKP_AS_INT(index);
+        if (i < 0) i += range->data.v_range.count;
+        if (i < 0 || i >= range->data.v_range.count) return SKP_FALSE;
+        *out = SKP_INT_VAL(skp_range_at(range, i));
+        return SKP_TRUE;
     }
     
-    skp_dict_entry_t* entry = (skp_dict_entry_t*)malloc(sizeof(skp_dict_entry_t));
-    entry->key = strdup(key);
-    skp_incref(value);
-    entry->value = value;
-    
-    dict->data.v_dict.entries[dict->data.v_dict.count++] = entry;
-}
-
-skp_object_t* skp_dict_get(skp_object_t* dict, const char* key) {
-    if (!dict || dict->type != SKP_TYPE_DICT || !key) return NULL;
+    if (SKP_IS_DICT(object) && SKP_IS_STRING(index)) {
+        skp_dict_entry_t* entry = skp_dict_find(SKP_AS_OBJ(object), SKP_AS_OBJ(index));
+        *out = entry ? entry->value : SKP_NULL_VAL;
+        return SKP_TRUE;
+    }
     
-    for (size_t i = 0; i < dict->data.v_dict.count; i++) {
-        if (strcmp(dict->data.v_dict.entries[i]->key, key) == 0) {
-            return dict->data.v_dict.entries[i]->value;
-        }
+    if (SKP_IS_STRING(object) && SKP_IS_INT(index)) {
+        /* الفهرس بالمحارف كالطول والتكرار، لا بالبايتات */
+        skp_object_t* string = SKP_AS_OBJ(object);
+        skp_string_flatten(string);
+        skp_int count = (skp_int)skp_string_char_count(string);
+        skp_int i = SKP_AS_INT(index);
+        if (i < 0) i += count;
+        if (i < 0 || i >= count) return SKP_FALSE;
+        
+        size_t start = skp_string_char_offset(string, (size_t)i);
+        size_t end = skp_string_next_char(string, start);
+        *out = SKP_OBJ_VAL(skp_new_string_len(string->data.v_string.chars + start, end - start));
+        return SKP_TRUE;
     }
     
-    return NULL;
-}
-
-skp_bool skp_dict_has(skp_object_t* dict, const char* key) {
-    return skp_dict_get(dict, key) != NULL;
+    return SKP_FALSE;
 }
 
-void skp_dict_remove(skp_object_t* dict, const char* key) {
-    if (!dict || dict->type != SKP_TYPE_DICT || !key) return;
+skp_bool skp_set_index(skp_value_t object, skp_value_t index, skp_value_t value) {
+    if (SKP_IS_LIST(object) && SKP_IS_INT(index)) {
+        skp_object_t* list = SKP_AS_OBJ(object);
+        skp_int i = SKP_AS_INT(index);
+        if (i < 0) i += (skp_int)list->data.v_list.count;
+        if (i < 0 || i >= (skp_int)list->data.v_list.count) return SKP_FALSE;
+        skp_list_set(list, (size_t)i, value);
+        return SKP_TRUE;
+    }
     
-    for (size_t i = 0; i < dict->data.v_dict.count; i++) {
-        if (strcmp(dict->data.v_dict.entries[i]->key, key) == 0) {
-            free(dict->data.v_dict.entries[i]->key);
-            skp_decref(dict->data.v_dict.entries[i]->value);
-            free(dict->data.v_dict.entries[i]);
-            
-            /* إزالة العنصر */
-            for (size_t j = i; j < dict->data.v_dict.count - 1; j++) {
-                dict->data.v_dict.entries[j] = dict->data.v_dict.entries[j + 1];
-            }
-            dict->data.v_dict.count--;
-            return;
-        }
+    if (SKP_IS_DICT(object) && SKP_IS_STRING(index)) {
+        skp_dict_set_key(SKP_AS_OBJ(object), SKP_AS_OBJ(index), value);
+        return SKP_TRUE;
     }
-}
-
-size_t skp_dict_len(skp_object_t* dict) {
-    if (!dict || dict->type != SKP_TYPE_DICT) return 0;
-    return dict->data.v_dict.count;
+    
+    return SKP_FALSE;
 }
 
 /* ============================================
  * العمليات الحسابية
  * ============================================ */
 
-skp_object_t* skp_add(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return skp_new_null();
-    
+skp_value_t skp_add(skp_value_t a, skp_value_t b) {
     /* جمع أعداد */
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        return skp_new_int(a->data.v_int + b->data.v_int);
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_float + b->data.v_float);
+    if (SKP_IS_INT(a) && SKP_IS_INT(b)) {
+        return SKP_INT_VAL(skp_int_add(SKP_AS_INT(a), SKP_AS_INT(b)));
     }
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_int + b->data.v_float);
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_INT) {
-        return skp_new_float(a->data.v_float + b->data.v_int);
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) {
+        return SKP_FLOAT_VAL(SKP_AS_NUMBER(a) + SKP_AS_NUMBER(b));
     }
     
     /* جمع نصوص */
-    if (a->type == SKP_TYPE_STRING && b->type == SKP_TYPE_STRING) {
-        size_t len = strlen(a->data.v_string) + strlen(b->data.v_string) + 1;
-        char* result = (char*)malloc(len);
-        strcpy(result, a->data.v_string);
-        strcat(result, b->data.v_string);
-        skp_object_t* obj = skp_new_string(result);
-        free(result);
-        return obj;
+    if (SKP_IS_STRING(a) && SKP_IS_STRING(b)) {
+        return SKP_OBJ_VAL(skp_str_concat(SKP_AS_OBJ(a), SKP_AS_OBJ(b)));
     }
     
     /* جمع قوائم */
-    if (a->type == SKP_TYPE_LIST && b->type == SKP_TYPE_LIST) {
+    if (SKP_IS_LIST(a) && SKP_IS_LIST(b)) {
+        skp_object_t* la = SKP_AS_OBJ(a);
+        skp_object_t* lb = SKP_AS_OBJ(b);
         skp_object_t* result = skp_new_list();
-        for (size_t i = 0; i < a->data.v_list.count; i++) {
-            skp_list_append(result, a->data.v_list.items[i]);
+        for (size_t i = 0; i < la->data.v_list.count; i++) {
+            skp_list_append(result, la->data.v_list.items[i]);
         }
-        for (size_t i = 0; i < b->data.v_list.count; i++) {
-            skp_list_append(result, b->data.v_list.items[i]);
+        for (size_t i = 0; i < lb->data.v_list.count; i++) {
+            skp_list_append(result, lb->data.v_list.items[i]);
         }
-        return result;
+        return SKP_OBJ_VAL(result);
     }
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* skp_sub(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return skp_new_null();
-    
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        return skp_new_int(a->data.v_int - b->data.v_int);
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_float - b->data.v_float);
-    }
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_int - b->data.v_float);
+skp_value_t skp_sub(skp_value_t a, skp_value_t b) {
+    if (SKP_IS_INT(a) && SKP_IS_INT(b)) {
+        return SKP_INT_VAL(skp_int_sub(SKP_AS_INT(a), SKP_AS_INT(b)));
     }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_INT) {
-        return skp_new_float(a->data.v_float - b->data.v_int);
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) {
+        return SKP_FLOAT_VAL(SKP_AS_NUMBER(a) - SKP_AS_NUMBER(b));
     }
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* skp_mul(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return skp_new_null();
-    
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        return skp_new_int(a->data.v_int * b->data.v_int);
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_float * b->data.v_float);
+skp_value_t skp_mul(skp_value_t a, skp_value_t b) {
+    if (SKP_IS_INT(a) && SKP_IS_INT(b)) {
+        return SKP_INT_VAL(skp_int_mul(SKP_AS_INT(a), SKP_AS_INT(b)));
     }
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_int * b->data.v_float);
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_INT) {
-        return skp_new_float(a->data.v_float * b->data.v_int);
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) {
+        return SKP_FLOAT_VAL(SKP_AS_NUMBER(a) * SKP_AS_NUMBER(b));
     }
     
     /* تكرار نص */
-    if (a->type == SKP_TYPE_STRING && b->type == SKP_TYPE_INT) {
-        size_t len = strlen(a->data.v_string) * b->data.v_int + 1;
-        char* result = (char*)malloc(len);
-        result[0] = '\0';
-        for (skp_int i = 0; i < b->data.v_int; i++) {
-            strcat(result, a->data.v_string);
-        }
-        skp_object_t* obj = skp_new_string(result);
-        free(result);
-        return obj;
+    if (SKP_IS_STRING(a) && SKP_IS_INT(b)) {
+        skp_string_flatten(SKP_AS_OBJ(a));
+        const char* chars = SKP_AS_CSTRING(a);
+        skp_int times = SKP_AS_INT(b) > 0 ? SKP_AS_INT(b) : 0;
+        size_t unit = SKP_AS_OBJ(a)->data.v_string.length;
+        skp_object_t* obj = skp_string_reserve(unit * times);
+        for (skp_int i = 0; i < times; i++) {
+            memcpy(obj->data.v_string.chars + unit * i, chars, unit);
+        }
+        skp_string_seal(obj);
+        return SKP_OBJ_VAL(obj);
     }
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* skp_div(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return skp_new_null();
-    
-    skp_float divisor = 0;
-    if (b->type == SKP_TYPE_INT) divisor = b->data.v_int;
-    else if (b->type == SKP_TYPE_FLOAT) divisor = b->data.v_float;
-    else return skp_new_null();
+skp_value_t skp_div(skp_value_t a, skp_value_t b) {
+    if (!SKP_IS_NUMBER(a) || !SKP_IS_NUMBER(b)) return SKP_NULL_VAL;
     
+    skp_float divisor = SKP_AS_NUMBER(b);
     if (divisor == 0) {
         fprintf(stderr, "خطأ: قسمة على صفر\n");
-        return skp_new_null();
+        return SKP_NULL_VAL;
     }
     
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        return skp_new_float((skp_float)a->data.v_int / b->data.v_int);
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_float / b->data.v_float);
-    }
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(a->data.v_int / b->data.v_float);
+    return SKP_FLOAT_VAL(SKP_AS_NUMBER(a) / divisor);
+}
+
+skp_value_t skp_mod(skp_value_t a, skp_value_t b) {
+    if (SKP_IS_INT(a) && SKP_IS_INT(b)) {
+        if (SKP_AS_INT(b) == 0) {
+            fprintf(stderr, "خطأ: قسمة على صفر\n");
+            return SKP_NULL_VAL;
+        }
+        /* أدنى عدد على -1 يفيض في القسمة نفسها، وباقيه صفر */
+        if (SKP_AS_INT(b) == -1) return SKP_INT_VAL(0);
+        return SKP_INT_VAL(SKP_AS_INT(a) % SKP_AS_INT(b));
     }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_INT) {
-        return skp_new_float(a->data.v_float / b->data.v_int);
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) {
+        return SKP_FLOAT_VAL(fmod(SKP_AS_NUMBER(a), SKP_AS_NUMBER(b)));
     }
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* skp_mod(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return skp_new_null();
+skp_value_t skp_pow(skp_value_t a, skp_value_t b) {
+    if (!SKP_IS_NUMBER(a) || !SKP_IS_NUMBER(b)) return SKP_NULL_VAL;
     
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        if (b->data.v_int == 0) {
-            fprintf(stderr, "خطأ: قسمة على صفر\n");
-            return skp_new_null();
+    /* أس صحيح غير سالب يبقى صحيحاً */
+    if (SKP_IS_INT(a) && SKP_IS_INT(b) && SKP_AS_INT(b) >= 0) {
+        skp_int base = SKP_AS_INT(a);
+        skp_int exp = SKP_AS_INT(b);
+        skp_int result = 1;
+        while (exp > 0) {
+            if (exp & 1) result = skp_int_mul(result, base);
+            base = skp_int_mul(base, base);
+            exp >>= 1;
         }
-        return skp_new_int(a->data.v_int % b->data.v_int);
+        return SKP_INT_VAL(result);
     }
     
-    return skp_new_null();
+    return SKP_FLOAT_VAL(pow(SKP_AS_NUMBER(a), SKP_AS_NUMBER(b)));
 }
 
-skp_object_t* skp_pow(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return skp_new_null();
-    
-    skp_float base = 0, exp = 0;
-    
-    if (a->type == SKP_TYPE_INT) base = a->data.v_int;
-    else if (a->type == SKP_TYPE_FLOAT) base = a->data.v_float;
-    else return skp_new_null();
-    
-    if (b->type == SKP_TYPE_INT) exp = b->data.v_int;
-    else if (b->type == SKP_TYPE_FLOAT) exp = b->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(pow(base, exp));
+skp_value_t skp_neg(skp_value_t a) {
+    if (SKP_IS_INT(a)) return SKP_INT_VAL(skp_int_neg(SKP_AS_INT(a)));
+    if (SKP_IS_FLOAT(a)) return SKP_FLOAT_VAL(-SKP_AS_FLOAT(a));
+    return SKP_NULL_VAL;
 }
 
 /* ============================================
  * العمليات المنطقية
  * ============================================ */
 
-skp_bool skp_eq(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return a == b;
-    if (a->type != b->type) return SKP_FALSE;
+skp_bool skp_eq(skp_value_t a, skp_value_t b) {
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) {
+        if (SKP_IS_INT(a) && SKP_IS_INT(b)) return SKP_AS_INT(a) == SKP_AS_INT(b);
+        return SKP_AS_NUMBER(a) == SKP_AS_NUMBER(b);
+    }
+    if (a.type != b.type) return SKP_FALSE;
     
-    switch (a->type) {
-        case SKP_TYPE_INT:
-            return a->data.v_int == b->data.v_int;
-        case SKP_TYPE_FLOAT:
-            return a->data.v_float == b->data.v_float;
+    switch (a.type) {
         case SKP_TYPE_BOOL:
-            return a->data.v_bool == b->data.v_bool;
-        case SKP_TYPE_STRING:
-            return strcmp(a->data.v_string, b->data.v_string) == 0;
+            return SKP_AS_BOOL(a) == SKP_AS_BOOL(b);
+        case SKP_TYPE_STRING: {
+            /* نصان محتجزان متساويان فقط إذا كانا الكائن نفسه */
+            skp_object_t* x = SKP_AS_OBJ(a);
+            skp_object_t* y = SKP_AS_OBJ(b);
+            if (x == y) return SKP_TRUE;
+            if (x->data.v_string.interned && y->data.v_string.interned) return SKP_FALSE;
+            if (x->data.v_string.length != y->data.v_string.length) return SKP_FALSE;
+            skp_string_flatten(x);
+            skp_string_flatten(y);
+            return string_equals(x, y->data.v_string.chars, y->data.v_string.length,
+                                 y->data.v_string.hash);
+        }
         case SKP_TYPE_NULL:
             return SKP_TRUE;
         default:
-            return SKP_FALSE;
+            return SKP_AS_OBJ(a) == SKP_AS_OBJ(b);
     }
 }
 
-skp_bool skp_ne(skp_object_t* a, skp_object_t* b) {
+skp_bool skp_ne(skp_value_t a, skp_value_t b) {
     return !skp_eq(a, b);
 }
 
-skp_bool skp_lt(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return SKP_FALSE;
+/* ترتيب البايتات، والأقصر أولاً عند تساوي البادئة */
+static int string_compare(skp_value_t a, skp_value_t b) {
+    skp_object_t* x = SKP_AS_OBJ(a);
+    skp_object_t* y = SKP_AS_OBJ(b);
+    skp_string_flatten(x);
+    skp_string_flatten(y);
+    size_t common = x->data.v_string.length < y->data.v_string.length
+        ? x->data.v_string.length : y->data.v_string.length;
     
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        return a->data.v_int < b->data.v_int;
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_FLOAT) {
-        return a->data.v_float < b->data.v_float;
+    int order = memcmp(x->data.v_string.chars, y->data.v_string.chars, common);
+    if (order != 0) return order;
+    if (x->data.v_string.length == y->data.v_string.length) return 0;
+    return x->data.v_string.length < y->data.v_string.length ? -1 : 1;
+}
+
+skp_bool skp_lt(skp_value_t a, skp_value_t b) {
+    if (SKP_IS_INT(a) && SKP_IS_INT(b)) return SKP_AS_INT(a) < SKP_AS_INT(b);
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) return SKP_AS_NUMBER(a) < SKP_AS_NUMBER(b);
+    if (SKP_IS_STRING(a) && SKP_IS_STRING(b)) {
+        return string_compare(a, b) < 0;
     }
     
     return SKP_FALSE;
 }
 
-skp_bool skp_gt(skp_object_t* a, skp_object_t* b) {
-    if (!a || !b) return SKP_FALSE;
-    
-    if (a->type == SKP_TYPE_INT && b->type == SKP_TYPE_INT) {
-        return a->data.v_int > b->data.v_int;
-    }
-    if (a->type == SKP_TYPE_FLOAT && b->type == SKP_TYPE_FLOAT) {
-        return a->data.v_float > b->data.v_float;
+skp_bool skp_gt(skp_value_t a, skp_value_t b) {
+    if (SKP_IS_INT(a) && SKP_IS_INT(b)) return SKP_AS_INT(a) > SKP_AS_INT(b);
+    if (SKP_IS_NUMBER(a) && SKP_IS_NUMBER(b)) return SKP_AS_NUMBER(a) > SKP_AS_NUMBER(b);
+    if (SKP_IS_STRING(a) && SKP_IS_STRING(b)) {
+        return string_compare(a, b) > 0;
     }
     
     return SKP_FALSE;
 }
 
-skp_bool skp_le(skp_object_t* a, skp_object_t* b) {
+skp_bool skp_le(skp_value_t a, skp_value_t b) {
     return skp_lt(a, b) || skp_eq(a, b);
 }
 
-skp_bool skp_ge(skp_object_t* a, skp_object_t* b) {
+skp_bool skp_ge(skp_value_t a, skp_value_t b) {
     return skp_gt(a, b) || skp_eq(a, b);
 }
 
@@ -515,78 +2148,162 @@ skp_bool skp_not(skp_bool a) {
  * التحويل بين الأنواع
  * ============================================ */
 
-skp_object_t* skp_to_string(skp_object_t* obj) {
-    if (!obj) return skp_new_string("null");
-    
+/* مخزن نصي ينمو حسب الحاجة لتمثيل القوائم والقواميس */
+typedef struct {
+    char* chars;
+    size_t length;
+    size_t capacity;
+} skp_text_buffer_t;
+
+static void text_buffer_append_len(skp_text_buffer_t* buffer, const char* chars, size_t len) {
+    if (buffer->length + len + 1 > buffer->capacity) {
+        while (buffer->length + len + 1 > buffer->capacity) {
+            buffer->capacity = buffer->capacity < 64 ? 64 : buffer->capacity * 2;
+        }
+        buffer->chars = (char*)realloc(buffer->chars, buffer->capacity);
+    }
+    memcpy(buffer->chars + buffer->length, chars, len);
+    buffer->length += len;
+    buffer->chars[buffer->length] = '\0';
+}
+
+static void text_buffer_append(skp_text_buffer_t* buffer, const char* chars) {
+    text_buffer_append_len(buffer, chars, strlen(chars));
+}
+
+static void text_buffer_append_value(skp_text_buffer_t* buffer, skp_value_t value) {
+    skp_object_t* str = skp_to_string(value);
+    text_buffer_append_len(buffer, str->data.v_string.chars, str->data.v_string.length);
+    skp_decref(str);
+}
+
+skp_object_t* skp_to_string(skp_value_t value) {
     char buffer[256];
     
-    switch (obj->type) {
+    switch (value.type) {
         case SKP_TYPE_INT:
-            snprintf(buffer, sizeof(buffer), "%ld", obj->data.v_int);
+            snprintf(buffer, sizeof(buffer), "%ld", (long)SKP_AS_INT(value));
             return skp_new_string(buffer);
         case SKP_TYPE_FLOAT:
-            snprintf(buffer, sizeof(buffer), "%g", obj->data.v_float);
+            snprintf(buffer, sizeof(buffer), "%g", SKP_AS_FLOAT(value));
             return skp_new_string(buffer);
         case SKP_TYPE_BOOL:
-            return skp_new_string(obj->data.v_bool ? "صحيح" : "خطأ");
+            return skp_new_string(SKP_AS_BOOL(value) ? "صحيح" : "خطأ");
         case SKP_TYPE_STRING:
-            skp_incref(obj);
-            return obj;
+            skp_string_flatten(SKP_AS_OBJ(value));
+            skp_incref(SKP_AS_OBJ(value));
+            return SKP_AS_OBJ(value);
         case SKP_TYPE_NULL:
             return skp_new_string("فارغ");
+        case SKP_TYPE_LIST: {
+            skp_object_t* list = SKP_AS_OBJ(value);
+            skp_text_buffer_t text = {NULL, 0, 0};
+            text_buffer_append(&text, "[");
+            for (size_t i = 0; i < list->data.v_list.count; i++) {
+                if (i > 0) text_buffer_append(&text, ", ");
+                text_buffer_append_value(&text, list->data.v_list.items[i]);
+            }
+            text_buffer_append(&text, "]");
+            skp_object_t* result = skp_new_string_len(text.chars, text.length);
+            free(text.chars);
+            return result;
+        }
+        case SKP_TYPE_RANGE: {
+            /* يُعرض كالقائمة التي كان المدى يُنشئها */
+            skp_object_t* range = SKP_AS_OBJ(value);
+            skp_text_buffer_t text = {NULL, 0, 0};
+            text_buffer_append(&text, "[");
+            for (skp_int i = 0; i < range->data.v_range.count; i++) {
+                if (i > 0) text_buffer_append(&text, ", ");
+                snprintf(buffer, sizeof(buffer), "%ld", (long)skp_range_at(range, i));
+                text_buffer_append(&text, buffer);
+            }
+            text_buffer_append(&text, "]");
+            skp_object_t* result = skp_new_string_len(text.chars, text.length);
+            free(text.chars);
+            return result;
+        }
+        case SKP_TYPE_DICT: {
+            skp_object_t* dict = SKP_AS_OBJ(value);
+            skp_text_buffer_t text = {NULL, 0, 0};
+            size_t position = 0;
+            skp_dict_entry_t* entry;
+            text_buffer_append(&text, "{");
+            while (skp_dict_next(dict, &position, &entry)) {
+                if (text.length > 1) text_buffer_append(&text, ", ");
+                text_buffer_append_len(&text, entry->key->data.v_string.chars,
+                                       entry->key->data.v_string.length);
+                text_buffer_append(&text, ": ");
+                text_buffer_append_value(&text, entry->value);
+            }
+            text_buffer_append(&text, "}");
+            skp_object_t* result = skp_new_string_len(text.chars, text.length);
+            free(text.chars);
+            return result;
+        }
+        case SKP_TYPE_CLASS:
+            snprintf(buffer, sizeof(buffer), "<صنف %s>",
+                     SKP_AS_OBJ(value)->data.v_class.klass->name);
+            return skp_new_string(buffer);
+        case SKP_TYPE_OBJECT:
+            snprintf(buffer, sizeof(buffer), "<كائن %s>",
+                     SKP_AS_OBJ(value)->data.v_object.klass->name);
+            return skp_new_string(buffer);
+        case SKP_TYPE_FUNC:
+        case SKP_TYPE_CLOSURE:
+        case SKP_TYPE_NATIVE:
+        case SKP_TYPE_BOUND_METHOD:
+            return skp_new_string("<دالة>");
+        case SKP_TYPE_BUILDER:
+            return skp_new_string_len(SKP_AS_OBJ(value)->data.v_builder.chars,
+                                      SKP_AS_OBJ(value)->data.v_builder.length);
         default:
             return skp_new_string("<object>");
     }
 }
 
-skp_object_t* skp_to_int(skp_object_t* obj) {
-    if (!obj) return skp_new_int(0);
-    
-    switch (obj->type) {
+skp_int skp_to_int(skp_value_t value) {
+    switch (value.type) {
         case SKP_TYPE_INT:
-            skp_incref(obj);
-            return obj;
+            return SKP_AS_INT(value);
         case SKP_TYPE_FLOAT:
-            return skp_new_int((skp_int)obj->data.v_float);
+            return (skp_int)SKP_AS_FLOAT(value);
         case SKP_TYPE_STRING:
-            return skp_new_int(atoll(obj->data.v_string));
+            skp_string_flatten(SKP_AS_OBJ(value));
+            return atoll(SKP_AS_CSTRING(value));
         case SKP_TYPE_BOOL:
-            return skp_new_int(obj->data.v_bool ? 1 : 0);
+            return SKP_AS_BOOL(value) ? 1 : 0;
         default:
-            return skp_new_int(0);
+            return 0;
     }
 }
 
-skp_object_t* skp_to_float(skp_object_t* obj) {
-    if (!obj) return skp_new_float(0.0);
-    
-    switch (obj->type) {
+skp_float skp_to_float(skp_value_t value) {
+    switch (value.type) {
         case SKP_TYPE_INT:
-            return skp_new_float((skp_float)obj->data.v_int);
+            return (skp_float)SKP_AS_INT(value);
         case SKP_TYPE_FLOAT:
-            skp_incref(obj);
-            return obj;
+            return SKP_AS_FLOAT(value);
         case SKP_TYPE_STRING:
-            return skp_new_float(atof(obj->data.v_string));
+            skp_string_flatten(SKP_AS_OBJ(value));
+            return atof(SKP_AS_CSTRING(value));
         case SKP_TYPE_BOOL:
-            return skp_new_float(obj->data.v_bool ? 1.0 : 0.0);
+            return SKP_AS_BOOL(value) ? 1.0 : 0.0;
         default:
-            return skp_new_float(0.0);
+            return 0.0;
     }
 }
 
-skp_bool skp_to_bool(skp_object_t* obj) {
-    if (!obj) return SKP_FALSE;
-    
-    switch (obj->type) {
+skp_bool skp_to_bool(skp_value_t value) {
+    switch (value.type) {
         case SKP_TYPE_INT:
-            return obj->data.v_int != 0;
+            return SKP_AS_INT(value) != 0;
         case SKP_TYPE_FLOAT:
-            return obj->data.v_float != 0.0;
+            return SKP_AS_FLOAT(value) != 0.0;
         case SKP_TYPE_BOOL:
-            return obj->data.v_bool;
+            return SKP_AS_BOOL(value);
         case SKP_TYPE_STRING:
-            return strlen(obj->data.v_string) > 0;
+            return SKP_AS_OBJ(value)->data.v_string.length != 0;
         case SKP_TYPE_NULL:
             return SKP_FALSE;
         default:
@@ -598,261 +2315,363 @@ skp_bool skp_to_bool(skp_object_t* obj) {
  * المكتبة القياسية - النصوص
  * ============================================ */
 
-skp_object_t* skp_str_length(skp_object_t* str) {
-    if (!str || str->type != SKP_TYPE_STRING) return skp_new_int(0);
-    return skp_new_int(strlen(str->data.v_string));
+skp_value_t skp_str_length(skp_object_t* str) {
+    if (!str || str->type != SKP_TYPE_STRING) return SKP_INT_VAL(0);
+    return SKP_INT_VAL(skp_string_char_count(str));
 }
 
 skp_object_t* skp_str_concat(skp_object_t* a, skp_object_t* b) {
-    return skp_add(a, b);
+    if (!a || a->type != SKP_TYPE_STRING || !b || b->type != SKP_TYPE_STRING) {
+        return skp_new_string("");
+    }
+    
+    size_t len_a = a->data.v_string.length;
+    size_t len_b = b->data.v_string.length;
+    if (len_a + len_b >= ROPE_MIN_LENGTH) return new_rope(a, b);
+    
+    skp_object_t* obj = skp_string_reserve(len_a + len_b);
+    memcpy(obj->data.v_string.chars, a->data.v_string.chars, len_a);
+    memcpy(obj->data.v_string.chars + len_a, b->data.v_string.chars, len_b);
+    skp_string_seal(obj);
+    return obj;
 }
 
+/* المحارف [start, end) */
 skp_object_t* skp_str_substring(skp_object_t* str, skp_int start, skp_int end) {
     if (!str || str->type != SKP_TYPE_STRING) return skp_new_string("");
+    skp_string_flatten(str);
     
-    size_t len = strlen(str->data.v_string);
+    skp_int len = (skp_int)skp_string_char_count(str);
     
     if (start < 0) start = len + start;
     if (end < 0) end = len + end;
     if (start < 0) start = 0;
-    if (end > (skp_int)len) end = len;
+    if (end > len) end = len;
     if (start >= end) return skp_new_string("");
     
-    size_t sublen = end - start;
-    char* result = (char*)malloc(sublen + 1);
-    strncpy(result, str->data.v_string + start, sublen);
-    result[sublen] = '\0';
+    size_t from = skp_string_char_offset(str, (size_t)start);
+    size_t to = skp_string_char_offset(str, (size_t)end);
+    return skp_new_string_len(str->data.v_string.chars + from, to - from);
+}
+
+/* موضع needle في haystack بدءاً من from، أو -1؛ يقبل البايتات الصفرية */
+static long string_search(const char* haystack, size_t haystack_len,
+                          const char* needle, size_t needle_len, size_t from) {
+    if (needle_len == 0) return from <= haystack_len ? (long)from : -1;
+    if (needle_len > haystack_len) return -1;
     
-    skp_object_t* obj = skp_new_string(result);
-    free(result);
-    return obj;
+    size_t last = haystack_len - needle_len;
+    for (size_t i = from; i <= last; i++) {
+        const char* p = memchr(haystack + i, needle[0], last - i + 1);
+        if (!p) return -1;
+        i = (size_t)(p - haystack);
+        if (memcmp(p, needle, needle_len) == 0) return (long)i;
+    }
+    return -1;
 }
 
-skp_object_t* skp_str_contains(skp_object_t* str, skp_object_t* substr) {
+skp_int skp_str_find(skp_object_t* str, skp_object_t* substr) {
     if (!str || str->type != SKP_TYPE_STRING || !substr || substr->type != SKP_TYPE_STRING) {
-        return skp_new_bool(SKP_FALSE);
+        return -1;
     }
-    return skp_new_bool(strstr(str->data.v_string, substr->data.v_string) != NULL);
+    skp_string_flatten(str);
+    skp_string_flatten(substr);
+    long at = string_search(str->data.v_string.chars, str->data.v_string.length,
+                            substr->data.v_string.chars, substr->data.v_string.length, 0);
+    return at < 0 ? -1 : (skp_int)skp_string_char_index(str, (size_t)at);
 }
 
-skp_object_t* skp_str_upper(skp_object_t* str) {
-    if (!str || str->type != SKP_TYPE_STRING) return skp_new_string("");
+skp_value_t skp_str_contains(skp_object_t* str, skp_object_t* substr) {
+    return SKP_BOOL_VAL(skp_str_find(str, substr) >= 0);
+}
+
+skp_object_t* skp_str_split(skp_object_t* str, skp_object_t* delim) {
+    skp_object_t* result = skp_new_list();
+    if (!str || str->type != SKP_TYPE_STRING) return result;
+    skp_string_flatten(str);
+    
+    const char* sep = " ";
+    size_t sep_len = 1;
+    if (delim && delim->type == SKP_TYPE_STRING) {
+        skp_string_flatten(delim);
+        sep = delim->data.v_string.chars;
+        sep_len = delim->data.v_string.length;
+    }
+    
+    if (sep_len == 0) {
+        skp_list_append(result, SKP_OBJ_VAL(str));
+        return result;
+    }
     
-    char* result = strdup(str->data.v_string);
-    for (char* p = result; *p; p++) {
-        *p = toupper(*p);
+    const char* chars = str->data.v_string.chars;
+    size_t length = str->data.v_string.length;
+    size_t start = 0;
+    long found;
+    while ((found = string_search(chars, length, sep, sep_len, start)) >= 0) {
+        skp_object_t* item = skp_new_string_len(chars + start, (size_t)found - start);
+        skp_list_append(result, SKP_OBJ_VAL(item));
+        skp_decref(item);
+        start = (size_t)found + sep_len;
     }
     
-    skp_object_t* obj = skp_new_string(result);
-    free(result);
-    return obj;
+    skp_object_t* last = skp_new_string_len(chars + start, length - start);
+    skp_list_append(result, SKP_OBJ_VAL(last));
+    skp_decref(last);
+    
+    return result;
 }
 
-skp_object_t* skp_str_lower(skp_object_t* str) {
+skp_object_t* skp_str_replace(skp_object_t* str, skp_object_t* old, skp_object_t* new) {
     if (!str || str->type != SKP_TYPE_STRING) return skp_new_string("");
+    if (!old || old->type != SKP_TYPE_STRING || !new || new->type != SKP_TYPE_STRING) {
+        skp_incref(str);
+        return str;
+    }
+    skp_string_flatten(str);
+    skp_string_flatten(old);
+    skp_string_flatten(new);
+    
+    const char* src = str->data.v_string.chars;
+    size_t src_len = str->data.v_string.length;
+    const char* from = old->data.v_string.chars;
+    size_t from_len = old->data.v_string.length;
+    const char* to = new->data.v_string.chars;
+    size_t to_len = new->data.v_string.length;
+    
+    if (from_len == 0) {
+        skp_incref(str);
+        return str;
+    }
     
-    char* result = strdup(str->data.v_string);
-    for (char* p = result; *p; p++) {
-        *p = tolower(*p);
+    /* حساب الحجم النهائي */
+    size_t count = 0;
+    for (long p = string_search(src, src_len, from, from_len, 0); p >= 0;
+         p = string_search(src, src_len, from, from_len, (size_t)p + from_len)) {
+        count++;
     }
     
-    skp_object_t* obj = skp_new_string(result);
-    free(result);
+    skp_object_t* obj = skp_string_reserve(src_len + count * to_len - count * from_len);
+    char* out = obj->data.v_string.chars;
+    
+    size_t start = 0;
+    long found;
+    while ((found = string_search(src, src_len, from, from_len, start)) >= 0) {
+        memcpy(out, src + start, (size_t)found - start);
+        out += (size_t)found - start;
+        memcpy(out, to, to_len);
+        out += to_len;
+        start = (size_t)found + from_len;
+    }
+    memcpy(out, src + start, src_len - start);
+    
+    skp_string_seal(obj);
+    return obj;
+}
+
+/* نسخة من النص بعد تطبيق convert على كل بايت */
+static skp_object_t* string_map(skp_object_t* str, int (*convert)(int)) {
+    skp_string_flatten(str);
+    skp_object_t* obj = skp_string_reserve(str->data.v_string.length);
+    for (size_t i = 0; i < str->data.v_string.length; i++) {
+        obj->data.v_string.chars[i] = (char)convert((unsigned char)str->data.v_string.chars[i]);
+    }
+    skp_string_seal(obj);
     return obj;
 }
 
+skp_object_t* skp_str_upper(skp_object_t* str) {
+    if (!str || str->type != SKP_TYPE_STRING) return skp_new_string("");
+    return string_map(str, toupper);
+}
+
+skp_object_t* skp_str_lower(skp_object_t* str) {
+    if (!str || str->type != SKP_TYPE_STRING) return skp_new_string("");
+    return string_map(str, tolower);
+}
+
 skp_object_t* skp_str_trim(skp_object_t* str) {
     if (!str || str->type != SKP_TYPE_STRING) return skp_new_string("");
+    skp_string_flatten(str);
     
-    char* s = str->data.v_string;
-    while (isspace(*s)) s++;
+    const char* chars = str->data.v_string.chars;
+    size_t start = 0;
+    size_t end = str->data.v_string.length;
     
-    if (*s == '\0') return skp_new_string("");
+    while (start < end && isspace((unsigned char)chars[start])) start++;
+    while (end > start && isspace((unsigned char)chars[end - 1])) end--;
     
-    char* e = s + strlen(s) - 1;
-    while (e > s && isspace(*e)) e--;
+    return skp_new_string_len(chars + start, end - start);
+}
+
+/* ============================================
+ * المكتبة القياسية - باني النصوص
+ * ============================================ */
+
+/* إلحاق تمثيل القيمة النصي بنهاية الباني، بنمو مضاعف للسعة */
+void skp_builder_append(skp_object_t* builder, skp_value_t value) {
+    if (!builder || builder->type != SKP_TYPE_BUILDER) return;
     
-    size_t len = e - s + 1;
-    char* result = (char*)malloc(len + 1);
-    strncpy(result, s, len);
-    result[len] = '\0';
+    skp_object_t* str = skp_to_string(value);
+    size_t length = str->data.v_string.length;
+    size_t needed = builder->data.v_builder.length + length + 1;
     
-    skp_object_t* obj = skp_new_string(result);
-    free(result);
-    return obj;
+    if (needed > builder->data.v_builder.capacity) {
+        size_t capacity = builder->data.v_builder.capacity < 64 ? 64 : builder->data.v_builder.capacity;
+        while (capacity < needed) capacity *= 2;
+        builder->data.v_builder.chars = (char*)realloc(builder->data.v_builder.chars, capacity);
+        builder->data.v_builder.capacity = capacity;
+    }
+    
+    memcpy(builder->data.v_builder.chars + builder->data.v_builder.length,
+           str->data.v_string.chars, length);
+    builder->data.v_builder.length += length;
+    builder->data.v_builder.chars[builder->data.v_builder.length] = '\0';
+    builder->data.v_builder.char_count += skp_string_char_count(str);
+    skp_decref(str);
+}
+
+void skp_builder_clear(skp_object_t* builder) {
+    if (!builder || builder->type != SKP_TYPE_BUILDER) return;
+    
+    builder->data.v_builder.length = 0;
+    builder->data.v_builder.char_count = 0;
+    if (builder->data.v_builder.chars) builder->data.v_builder.chars[0] = '\0';
 }
 
 /* ============================================
  * المكتبة القياسية - الرياضيات
  * ============================================ */
 
-skp_object_t* skp_math_abs(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    if (x->type == SKP_TYPE_INT) {
-        return skp_new_int(x->data.v_int < 0 ? -x->data.v_int : x->data.v_int);
+skp_value_t skp_math_abs(skp_value_t x) {
+    if (SKP_IS_INT(x)) {
+        return SKP_INT_VAL(SKP_AS_INT(x) < 0 ? skp_int_neg(SKP_AS_INT(x)) : SKP_AS_INT(x));
     }
-    if (x->type == SKP_TYPE_FLOAT) {
-        return skp_new_float(fabs(x->data.v_float));
+    if (SKP_IS_FLOAT(x)) {
+        return SKP_FLOAT_VAL(fabs(SKP_AS_FLOAT(x)));
     }
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* skp_math_sqrt(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) val = x->data.v_int;
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(sqrt(val));
+skp_value_t skp_math_sqrt(skp_value_t x) {
+    if (!SKP_IS_NUMBER(x)) return SKP_NULL_VAL;
+    return SKP_FLOAT_VAL(sqrt(SKP_AS_NUMBER(x)));
 }
 
-skp_object_t* skp_math_sin(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) val = x->data.v_int;
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(sin(val));
+skp_value_t skp_math_sin(skp_value_t x) {
+    if (!SKP_IS_NUMBER(x)) return SKP_NULL_VAL;
+    return SKP_FLOAT_VAL(sin(SKP_AS_NUMBER(x)));
 }
 
-skp_object_t* skp_math_cos(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) val = x->data.v_int;
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(cos(val));
+skp_value_t skp_math_cos(skp_value_t x) {
+    if (!SKP_IS_NUMBER(x)) return SKP_NULL_VAL;
+    return SKP_FLOAT_VAL(cos(SKP_AS_NUMBER(x)));
 }
 
-skp_object_t* skp_math_tan(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) val = x->data.v_int;
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(tan(val));
+skp_value_t skp_math_tan(skp_value_t x) {
+    if (!SKP_IS_NUMBER(x)) return SKP_NULL_VAL;
+    return SKP_FLOAT_VAL(tan(SKP_AS_NUMBER(x)));
 }
 
-skp_object_t* skp_math_log(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) val = x->data.v_int;
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(log(val));
+skp_value_t skp_math_log(skp_value_t x) {
+    if (!SKP_IS_NUMBER(x)) return SKP_NULL_VAL;
+    return SKP_FLOAT_VAL(log(SKP_AS_NUMBER(x)));
 }
 
-skp_object_t* skp_math_exp(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) val = x->data.v_int;
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_float(exp(val));
+skp_value_t skp_math_exp(skp_value_t x) {
+    if (!SKP_IS_NUMBER(x)) return SKP_NULL_VAL;
+    return SKP_FLOAT_VAL(exp(SKP_AS_NUMBER(x)));
 }
 
-skp_object_t* skp_math_floor(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) return skp_new_int(x->data.v_int);
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_int((skp_int)floor(val));
+skp_value_t skp_math_floor(skp_value_t x) {
+    if (SKP_IS_INT(x)) return x;
+    if (!SKP_IS_FLOAT(x)) return SKP_NULL_VAL;
+    return SKP_INT_VAL((skp_int)floor(SKP_AS_FLOAT(x)));
 }
 
-skp_object_t* skp_math_ceil(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) return skp_new_int(x->data.v_int);
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_int((skp_int)ceil(val));
+skp_value_t skp_math_ceil(skp_value_t x) {
+    if (SKP_IS_INT(x)) return x;
+    if (!SKP_IS_FLOAT(x)) return SKP_NULL_VAL;
+    return SKP_INT_VAL((skp_int)ceil(SKP_AS_FLOAT(x)));
 }
 
-skp_object_t* skp_math_round(skp_object_t* x) {
-    if (!x) return skp_new_null();
-    
-    skp_float val = 0;
-    if (x->type == SKP_TYPE_INT) return skp_new_int(x->data.v_int);
-    else if (x->type == SKP_TYPE_FLOAT) val = x->data.v_float;
-    else return skp_new_null();
-    
-    return skp_new_int((skp_int)round(val));
+skp_value_t skp_math_round(skp_value_t x) {
+    if (SKP_IS_INT(x)) return x;
+    if (!SKP_IS_FLOAT(x)) return SKP_NULL_VAL;
+    return SKP_INT_VAL((skp_int)round(SKP_AS_FLOAT(x)));
 }
 
-skp_object_t* skp_math_random(void) {
-    return skp_new_float((skp_float)rand() / RAND_MAX);
+skp_value_t skp_math_random(void) {
+    return SKP_FLOAT_VAL((skp_float)rand() / RAND_MAX);
 }
 
 /* ============================================
  * المكتبة القياسية - النظام
  * ============================================ */
 
-void skp_print(skp_object_t* obj) {
-    if (!obj) {
-        printf("فارغ");
-        return;
-    }
-    
-    switch (obj->type) {
+void skp_print(skp_value_t value) {
+    switch (value.type) {
         case SKP_TYPE_INT:
-            printf("%ld", obj->data.v_int);
+            printf("%ld", (long)SKP_AS_INT(value));
             break;
         case SKP_TYPE_FLOAT:
-            printf("%g", obj->data.v_float);
+            printf("%g", SKP_AS_FLOAT(value));
             break;
         case SKP_TYPE_BOOL:
-            printf("%s", obj->data.v_bool ? "صحيح" : "خطأ");
+            printf("%s", SKP_AS_BOOL(value) ? "صحيح" : "خطأ");
             break;
         case SKP_TYPE_STRING:
-            printf("%s", obj->data.v_string);
+            skp_string_flatten(SKP_AS_OBJ(value));
+            fwrite(SKP_AS_CSTRING(value), 1, SKP_AS_OBJ(value)->data.v_string.length, stdout);
             break;
-        case SKP_TYPE_LIST:
+        case SKP_TYPE_LIST: {
+            skp_object_t* list = SKP_AS_OBJ(value);
             printf("[");
-            for (size_t i = 0; i < obj->data.v_list.count; i++) {
-                skp_print(obj->data.v_list.items[i]);
-                if (i < obj->data.v_list.count - 1) printf(", ");
+            for (size_t i = 0; i < list->data.v_list.count; i++) {
+                skp_print(list->data.v_list.items[i]);
+                if (i < list->data.v_list.count - 1) printf(", ");
             }
             printf("]");
             break;
-        case SKP_TYPE_DICT:
+        }
+        case SKP_TYPE_RANGE: {
+            skp_object_t* range = SKP_AS_OBJ(value);
+            printf("[");
+            for (skp_int i = 0; i < range->data.v_range.count; i++) {
+                if (i > 0) printf(", ");
+                printf("%ld", (long)skp_range_at(range, i));
+            }
+            printf("]");
+            break;
+        }
+        case SKP_TYPE_DICT: {
+            skp_object_t* dict = SKP_AS_OBJ(value);
+            size_t position = 0;
+            size_t printed = 0;
+            skp_dict_entry_t* entry;
             printf("{");
-            for (size_t i = 0; i < obj->data.v_dict.count; i++) {
-                printf("%s: ", obj->data.v_dict.entries[i]->key);
-                skp_print(obj->data.v_dict.entries[i]->value);
-                if (i < obj->data.v_dict.count - 1) printf(", ");
+            while (skp_dict_next(dict, &position, &entry)) {
+                if (printed++ > 0) printf(", ");
+                printf("%s: ", entry->key->data.v_string.chars);
+                skp_print(entry->value);
             }
             printf("}");
             break;
+        }
         case SKP_TYPE_NULL:
             printf("فارغ");
             break;
-        default:
-            printf("<object>");
+        default: {
+            skp_object_t* str = skp_to_string(value);
+            printf("%s", str->data.v_string.chars);
+            skp_decref(str);
             break;
+        }
     }
 }
 
-void skp_println(skp_object_t* obj) {
-    skp_print(obj);
+void skp_println(skp_value_t value) {
+    skp_print(value);
     printf("\n");
 }
 
@@ -876,24 +2695,21 @@ void skp_exit(skp_int code) {
  * المكتبة القياسية - الوقت
  * ============================================ */
 
-skp_object_t* skp_time_now(void) {
-    return skp_new_float((skp_float)time(NULL));
+skp_value_t skp_time_now(void) {
+    return SKP_FLOAT_VAL((skp_float)time(NULL));
 }
 
-skp_object_t* skp_time_sleep(skp_object_t* seconds) {
-    if (!seconds) return skp_new_null();
+skp_value_t skp_time_sleep(skp_value_t seconds) {
+    if (!SKP_IS_NUMBER(seconds)) return SKP_NULL_VAL;
     
-    skp_float secs = 0;
-    if (seconds->type == SKP_TYPE_INT) secs = seconds->data.v_int;
-    else if (seconds->type == SKP_TYPE_FLOAT) secs = seconds->data.v_float;
-    else return skp_new_null();
+    skp_float secs = SKP_AS_NUMBER(seconds);
     
     struct timespec ts;
     ts.tv_sec = (time_t)secs;
     ts.tv_nsec = (long)((secs - ts.tv_sec) * 1e9);
     nanosleep(&ts, NULL);
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
 /* ============================================
@@ -909,14 +2725,20 @@ const char* skp_type_name(skp_type_t type) {
         case SKP_TYPE_LIST: return "قائمة";
         case SKP_TYPE_DICT: return "قاموس";
         case SKP_TYPE_FUNC: return "دالة";
+        case SKP_TYPE_CLOSURE: return "دالة";
+        case SKP_TYPE_NATIVE: return "دالة";
+        case SKP_TYPE_BOUND_METHOD: return "دالة";
+        case SKP_TYPE_BUILDER: return "باني_نص";
+        case SKP_TYPE_RANGE: return "مدى";
+        case SKP_TYPE_CLASS: return "صنف";
         case SKP_TYPE_OBJECT: return "كائن";
         case SKP_TYPE_NULL: return "فارغ";
         default: return "غير_معروف";
     }
 }
 
-skp_type_t skp_get_type(skp_object_t* obj) {
-    return obj ? obj->type : SKP_TYPE_NULL;
+skp_type_t skp_get_type(skp_value_t value) {
+    return value.type;
 }
 
 const char* skp_version(void) {
@@ -57,122 +57,541 @@ typedef enum {
     SKP_TYPE_FUNC,
     SKP_TYPE_OBJECT,
     SKP_TYPE_NULL,
-    SKP_TYPE_ANY
+    SKP_TYPE_ANY,
+    SKP_TYPE_CLOSURE,        /* إغلاق (دالة + upvalues) */
+    SKP_TYPE_NATIVE,         /* دالة مدمجة */
+    SKP_TYPE_CLASS,          /* صنف */
+    SKP_TYPE_BOUND_METHOD,   /* طريقة مربوطة بكائن */
+    SKP_TYPE_BUILDER,        /* باني نصوص قابل للتعديل */
+    SKP_TYPE_RANGE,          /* مدى أعداد صحيحة يُحسب عنصره عند الطلب */
+    SKP_TYPE_UNDEFINED       /* فتحة متغير عام لم يُعرَّف بعد (داخلي) */
 } skp_type_t;
 
 /* ============================================
- * هيكل الكائن الأساسي
- * ============================================ */
+ * القيمة
+ * ============================================
+ *
+ * الأعداد والقيم المنطقية والفارغ تُحمل مباشرة داخل القيمة
+ * دون أي تخصيص، أما النصوص والقوائم والقواميس والدوال
+ * والكائنات فتُحمل كمؤشر إلى كائن في الكومة.
+ * حقل النوع يطابق نوع الكائن المشار إليه دائماً.
+ */
 
-typedef struct skp_object {
+struct skp_object;
+struct skp_vm;
+struct chunk;
+struct reg_proto;
+
+typedef struct skp_value {
     skp_type_t type;
-    int refcount;
-    
     union {
         skp_int    v_int;
         skp_float  v_float;
         skp_bool   v_bool;
-        skp_string v_string;
+        struct skp_object* v_obj;
+    } as;
+} skp_value_t;
+
+/* إنشاء القيم */
+#define SKP_INT_VAL(i)    ((skp_value_t){SKP_TYPE_INT,   {.v_int = (skp_int)(i)}})
+#define SKP_FLOAT_VAL(f)  ((skp_value_t){SKP_TYPE_FLOAT, {.v_float = (skp_float)(f)}})
+#define SKP_BOOL_VAL(b)   ((skp_value_t){SKP_TYPE_BOOL,  {.v_bool = (b) ? SKP_TRUE : SKP_FALSE}})
+#define SKP_NULL_VAL      ((skp_value_t){SKP_TYPE_NULL,  {.v_int = 0}})
+#define SKP_UNDEFINED_VAL ((skp_value_t){SKP_TYPE_UNDEFINED, {.v_int = 0}})
+#define SKP_OBJ_VAL(o)    skp_obj_val(o)
+
+/* فحص الأنواع */
+#define SKP_IS_INT(v)     ((v).type == SKP_TYPE_INT)
+#define SKP_IS_FLOAT(v)   ((v).type == SKP_TYPE_FLOAT)
+#define SKP_IS_NUMBER(v)  ((v).type == SKP_TYPE_INT || (v).type == SKP_TYPE_FLOAT)
+#define SKP_IS_BOOL(v)    ((v).type == SKP_TYPE_BOOL)
+#define SKP_IS_NULL(v)    ((v).type == SKP_TYPE_NULL)
+#define SKP_IS_STRING(v)  ((v).type == SKP_TYPE_STRING)
+#define SKP_IS_LIST(v)    ((v).type == SKP_TYPE_LIST)
+#define SKP_IS_DICT(v)    ((v).type == SKP_TYPE_DICT)
+#define SKP_IS_RANGE(v)   ((v).type == SKP_TYPE_RANGE)
+#define SKP_IS_OBJ(v)     skp_is_obj_type((v).type)
+
+/* استخراج المحتوى */
+#define SKP_AS_INT(v)     ((v).as.v_int)
+#define SKP_AS_FLOAT(v)   ((v).as.v_float)
+#define SKP_AS_BOOL(v)    ((v).as.v_bool)
+#define SKP_AS_OBJ(v)     ((v).as.v_obj)
+#define SKP_AS_CSTRING(v) ((v).as.v_obj->data.v_string.chars)
+#define SKP_AS_NUMBER(v)  (SKP_IS_INT(v) ? (skp_float)(v).as.v_int : (v).as.v_float)
+
+/* ============================================
+ * هيكل الكائن الأساسي
+ * ============================================ */
+
+/* دالة مدمجة */
+typedef skp_value_t (*skp_native_func_t)(struct skp_vm* vm, int argc, skp_value_t* argv);
+
+/* upvalue: متغير ملتقط من نطاق خارجي. يُحرر حين يتركه آخر مالكيه: الإغلاقات
+ * التي تحمله، والقائمة المفتوحة ما دام مفتوحاً */
+typedef struct skp_upvalue {
+    skp_value_t* location;       /* مكان القيمة (المكدس أو closed) */
+    skp_value_t closed;          /* القيمة بعد إغلاق النطاق */
+    struct skp_upvalue* next;    /* قائمة upvalues المفتوحة */
+    int32_t owners;              /* عدد المالكين */
+    skp_bool pooled;             /* من مجمّع الكومة لا من malloc */
+} skp_upvalue_t;
+
+/* أعلام جمع القمامة في رأس الكائن */
+#define SKP_GC_MANAGED    0x01   /* تملكه كومة الجهاز؛ عدّ المراجع لا يحرره */
+#define SKP_GC_YOUNG      0x02   /* في الحضانة */
+#define SKP_GC_MARKED     0x04   /* حي في جمع الجيل القديم */
+#define SKP_GC_FORWARDED  0x08   /* نُقل من الحضانة، وnext يشير إلى نسخته */
+#define SKP_GC_REMEMBERED 0x10   /* في المجموعة المتذكرة */
+#define SKP_GC_PARTIAL    0x20   /* فُحص بعضها، ولها مؤشر في partial */
+
+typedef struct skp_object {
+    uint8_t type;                /* skp_type_t */
+    uint8_t gc;                  /* أعلام SKP_GC_* */
+    uint8_t pool_class;          /* فئة الحجم في مجمّع الكومة + 1، أو 0 إن خُصص بـ malloc */
+    int32_t refcount;            /* للكائنات غير المُدارة فقط */
+    struct skp_object* next;     /* سلسلة الجيل القديم، أو عنوان النسخة بعد النقل */
+    
+    union {
+        /* البيانات ملحقة بالكائن في الكتلة نفسها، ولا تنتهي بالضرورة
+         * عند أول بايت صفري؛ الطول هو المرجع. ناتج جمع النصوص الطويلة حبل
+         * (chars فارغ) يُدمج عند أول قراءة بـ skp_string_flatten */
+        struct {
+            char* chars;             /* يشير إلى ما بعد الكائن، وينتهي بصفر للتوافق */
+            size_t length;           /* الطول بالبايتات */
+            size_t char_count;       /* عدد محارف UTF-8، يُحسب عند أول طلب */
+            uint32_t hash;           /* تجزئة FNV-1a محسوبة عند الإنشاء أو الدمج */
+            skp_bool interned;       /* هل هو النسخة الوحيدة في جدول الاحتجاز؟ */
+            skp_bool borrowed;       /* chars في ذاكرة لا يملكها النص (صورة بايتكود) */
+        } v_string;
         
         struct {
-            struct skp_object** items;
+            skp_value_t* items;
             size_t count;
             size_t capacity;
         } v_list;
         
         struct {
-            struct skp_dict_entry** entries;
-            size_t count;
+            struct skp_dict_entry* entries;  /* المدخلات بترتيب الإدخال */
+            size_t count;                    /* عدد المدخلات الحية */
+            size_t used;                     /* المدخلات المستعملة مع المحذوفة */
             size_t capacity;
+            uint32_t* slots;                 /* جدول التجزئة: فهرس المدخل + 1، و0 للفارغ */
+            size_t slot_capacity;            /* قوة للعدد 2 */
         } v_dict;
         
         struct {
-            struct skp_object* (*func)(struct skp_object** args, size_t argc);
-            struct skp_object* closure;
+            struct chunk* chunk;     /* بايتكود الدالة */
+            struct reg_proto* regs;  /* كود الجهاز السجلي إن تُرجمت له بدل البايتكود */
+            int arity;               /* عدد المعاملات */
+            int upvalue_count;
+            char* name;
         } v_func;
         
+        struct {
+            struct skp_object* function;
+            skp_upvalue_t** upvalues;
+            int upvalue_count;
+        } v_closure;
+        
+        struct {
+            skp_native_func_t func;
+            const char* name;
+        } v_native;
+        
         struct {
             struct skp_class* klass;
-            struct skp_dict_entry** fields;
-            size_t field_count;
+        } v_class;
+        
+        struct {
+            struct skp_class* klass;
+            struct skp_shape* shape;     /* شكل الحقول: الأسماء وفتحاتها */
+            skp_value_t* fields;         /* قيم الحقول بترتيب فتحات الشكل */
+            size_t count;                /* نسخة من عدد حقول الشكل، فقد يُحرر الصنف قبل كائناته */
+            size_t capacity;
         } v_object;
+        
+        struct {
+            skp_value_t receiver;
+            struct skp_object* method;   /* إغلاق الطريقة */
+        } v_bound_method;
+        
+        struct {
+            char* chars;
+            size_t length;           /* بالبايتات */
+            size_t char_count;       /* بمحارف UTF-8 */
+            size_t capacity;
+        } v_builder;
+        
+        /* لا يحمل عناصره: العنصر i هو start + i * step */
+        struct {
+            skp_int start;
+            skp_int step;
+            skp_int count;           /* عدد العناصر، يُحسب عند الإنشاء */
+        } v_range;
     } data;
 } skp_object_t;
 
-/* مدخل القاموس */
+/* مدخل القاموس (المفتاح NULL لمدخل محذوف) */
 typedef struct skp_dict_entry {
-    char* key;
-    skp_object_t* value;
+    skp_object_t* key;           /* كائن نص؛ المحتجز منه يُقارن بالمؤشر */
+    uint32_t hash;               /* تجزئة المفتاح المخزنة */
+    skp_value_t value;
 } skp_dict_entry_t;
 
+/* شكل الكائن (صنف خفي): يتشاركه كل كائن أُضيفت حقوله بالترتيب نفسه.
+ * الأشكال شجرة جذرها في الصنف، وكل إضافة حقل انتقال إلى شكل ابن. */
+typedef struct skp_shape {
+    struct skp_shape* parent;        /* الشكل قبل إضافة آخر حقل */
+    skp_object_t* name;              /* اسم آخر حقل مضاف، نص محتجز (NULL في الجذر) */
+    uint32_t field_count;            /* عدد الحقول؛ فتحة آخرها field_count - 1 */
+    uint32_t id;                     /* معرف فريد لا يتكرر حتى بعد تحرير الشكل */
+    struct skp_shape** transitions;  /* الأشكال الأبناء */
+    size_t transition_count;
+    size_t transition_capacity;
+} skp_shape_t;
+
 /* الصنف */
 typedef struct skp_class {
     char* name;
     struct skp_class* parent;
-    skp_dict_entry_t** methods;
-    size_t method_count;
+    skp_object_t* object;        /* كائن الصنف، ليبقى حياً ما بقيت كائناته */
+    skp_object_t* methods;       /* قاموس الطرق */
+    skp_shape_t* shape;          /* الشكل الجذر لكائنات الصنف */
+    uint32_t field_hint;         /* أكبر عدد حقول بلغه كائن، لحجز الكائنات الجديدة */
 } skp_class_t;
 
+/* ============================================
+ * الكومة (جمع القمامة بالأجيال)
+ * ============================================ */
+
+/* حجم كتلة الحضانة، وأكبر كائن يُخصص فيها؛ ما فوقه يذهب للجيل القديم مباشرة */
+#ifndef SKP_NURSERY_SIZE
+#define SKP_NURSERY_SIZE (512 * 1024)
+#endif
+#define SKP_NURSERY_LARGE (SKP_NURSERY_SIZE / 8)
+
+/* مجمّع بفئات أحجام لرؤوس الجيل القديم والذاكرة الخارجية الصغيرة للكائنات
+ * المُدارة (عناصر القوائم، مدخلات القواميس وفتحاتها، الحقول). الكتل تُقتطع
+ * بالإزاحة من ألواح كبيرة، والمحرر يعود لقائمة فئته، والألواح كلها تُحرر
+ * مع الكومة. ما فوق SKP_POOL_MAX يُخصص بـ malloc */
+#define SKP_POOL_CLASSES 16
+#define SKP_POOL_MAX 512
+#define SKP_POOL_SLAB (64 * 1024)
+
+typedef struct skp_pool {
+    void* free_lists[SKP_POOL_CLASSES];
+    char* slab_top;
+    char* slab_end;
+    char** slabs;
+    size_t slab_count;
+    size_t slab_capacity;
+} skp_pool_t;
+
+/* دين التخصيص في الجيل القديم الذي يطلب خطوة من الجمع التدريجي الجاري */
+#define SKP_GC_STEP_DEBT (64 * 1024)
+
+/* مرحلة جمع الجيل القديم */
+typedef enum {
+    SKP_GC_IDLE,
+    SKP_GC_MARKING,     /* تعليم ثلاثي الألوان على خطوات */
+    SKP_GC_SWEEPING     /* كنس القائمة المفصولة ثم تحرير الموتى على خطوات */
+} skp_gc_phase_t;
+
+/* حاوية طويلة تُفحص شريحة بعد شريحة */
+typedef struct {
+    skp_object_t* object;
+    size_t position;
+} skp_gc_cursor_t;
+
+/* الكائنات المُنشأة أثناء التشغيل تُخصص بالإزاحة في الحضانة، ومن ينجو منها
+ * جمعاً صغيراً يُنقل إلى الجيل القديم الذي يُجمع بالتعليم والكنس. الكائنات
+ * المُنشأة خارج التشغيل (ثوابت الترجمة، النصوص المحتجزة، الدوال المدمجة)
+ * غير مُدارة وتبقى بعدّ المراجع، ولا تشير إلى كائنات مُدارة. */
+typedef struct skp_heap {
+    char* nursery;                   /* الكتلة الأساسية للحضانة */
+    char* nursery_top;               /* موضع التخصيص التالي */
+    char* nursery_end;
+    skp_bool nursery_full;           /* امتلأت الكتلة الأساسية؛ الجمع عند أول نقطة آمنة */
+    skp_bool gc_requested;           /* عمل ينتظر النقطة الآمنة التالية */
+    char** overflow;                 /* كتل مؤقتة حتى تلك النقطة */
+    size_t overflow_count;
+    size_t overflow_capacity;
+    
+    skp_object_t** owners;           /* كائنات الحضانة التي تملك ذاكرة خارجية أو مراجع */
+    size_t owner_count;
+    size_t owner_capacity;
+    
+    skp_object_t** remembered;       /* كائنات قديمة كُتب فيها مرجع لكائن صغير */
+    size_t remembered_count;
+    size_t remembered_capacity;
+    struct skp_upvalue** remembered_upvalues;
+    size_t remembered_upvalue_count;
+    size_t remembered_upvalue_capacity;
+    
+    skp_object_t* objects;           /* الجيل القديم */
+    size_t bytes_allocated;          /* حجم الجيل القديم */
+    size_t next_gc;                  /* الحجم الذي يبدأ عنده جمع الجيل القديم */
+    
+    /* الجمع التدريجي: الأبيض غير مُعلَّم، والرمادي مُعلَّم في gray، والأسود
+     * مُعلَّم فُحصت مراجعه. ما يُنقل أو يُخصص في الجيل القديم أثناء التعليم
+     * يولد رمادياً */
+    skp_gc_phase_t phase;
+    skp_object_t** gray;
+    size_t gray_count;
+    size_t gray_capacity;
+    skp_gc_cursor_t* partial;        /* حاويات كبيرة فُحص بعضها، مع أول عنصر لم يُفحص */
+    size_t partial_count;
+    size_t partial_capacity;
+    size_t debt;                     /* بايتات خُصصت لم تسددها خطوات الجمع */
+    skp_object_t* sweeping;          /* الجيل القديم كما كان عند بدء الكنس */
+    skp_object_t* dead;              /* موتى أُطلقت ذاكرتهم الخارجية ولم يُحرروا */
+    
+    skp_pool_t pool;
+} skp_heap_t;
+
+/* زائر مؤشرات الكائنات داخل كائن (للتعليم وللنقل) */
+typedef void (*skp_visit_fn)(skp_object_t** slot, void* context);
+
+void skp_heap_init(skp_heap_t* heap, size_t threshold);
+void skp_heap_destroy(skp_heap_t* heap);
+skp_heap_t* skp_heap_use(skp_heap_t* heap);
+void skp_heap_remember(skp_object_t* object);
+void skp_heap_remember_upvalue(struct skp_upvalue* upvalue);
+skp_object_t* skp_heap_promote(skp_heap_t* heap, skp_object_t* object);
+void skp_heap_finish_minor(skp_heap_t* heap);
+void skp_heap_mark(skp_heap_t* heap, skp_object_t* object);
+void skp_heap_shade(skp_object_t* object);
+void skp_heap_reorder(skp_object_t* container);
+skp_bool skp_heap_mark_step(skp_heap_t* heap, uint64_t deadline);
+void skp_heap_begin_sweep(skp_heap_t* heap);
+skp_bool skp_heap_sweep_step(skp_heap_t* heap, uint64_t deadline);
+uint64_t skp_clock_ns(void);
+void skp_object_visit(skp_object_t* object, skp_visit_fn visit, void* context);
+void skp_object_visit_slice(skp_object_t* object, size_t from, size_t to,
+                            skp_visit_fn visit, void* context);
+size_t skp_object_length(skp_object_t* object);
+
+/* هل النوع كائن في الكومة؟ */
+static inline skp_bool skp_is_obj_type(skp_type_t type) {
+    return type != SKP_TYPE_INT && type != SKP_TYPE_FLOAT &&
+           type != SKP_TYPE_BOOL && type != SKP_TYPE_NULL &&
+           type != SKP_TYPE_ANY && type != SKP_TYPE_UNDEFINED;
+}
+
+/* تغليف كائن في قيمة */
+static inline skp_value_t skp_obj_val(skp_object_t* obj) {
+    skp_value_t value;
+    if (!obj) return SKP_NULL_VAL;
+    value.type = obj->type;
+    value.as.v_obj = obj;
+    return value;
+}
+
+/* حاجز الكتابة قبل تخزين value في container:
+ * - كائن قديم يُخزن فيه مرجع لكائن صغير يُضاف للمجموعة المتذكرة، فيصير
+ *   جذراً في الجمع الصغير التالي
+ * - كائن مُعلَّم يُخزن فيه كائن قديم أبيض يُلوَّن الأخير رمادياً (حاجز
+ *   ديكسترا)، فلا يشير أسود إلى أبيض أثناء التعليم التدريجي */
+static inline void skp_write_barrier(skp_object_t* container, skp_value_t value) {
+    if (!skp_is_obj_type(value.type)) return;
+    
+    uint8_t flags = value.as.v_obj->gc;
+    if (flags & SKP_GC_YOUNG) {
+        if (!(container->gc & (SKP_GC_YOUNG | SKP_GC_REMEMBERED))) skp_heap_remember(container);
+    } else if ((container->gc & SKP_GC_MARKED) &&
+               (flags & (SKP_GC_MANAGED | SKP_GC_MARKED)) == SKP_GC_MANAGED) {
+        skp_heap_shade(value.as.v_obj);
+    }
+}
+
 /* ============================================
  * إدارة الذاكرة
  * ============================================ */
 
-skp_object_t* skp_new_int(skp_int value);
-skp_object_t* skp_new_float(skp_float value);
-skp_object_t* skp_new_bool(skp_bool value);
 skp_object_t* skp_new_string(const char* value);
+skp_object_t* skp_new_string_len(const char* chars, size_t length);
+skp_object_t* skp_string_reserve(size_t length);
+void skp_string_seal(skp_object_t* string);
+size_t skp_string_char_count(skp_object_t* string);
+size_t skp_string_char_offset(skp_object_t* string, size_t index);
+size_t skp_string_char_index(skp_object_t* string, size_t offset);
+size_t skp_string_next_char(skp_object_t* string, size_t offset);
+void skp_rope_flatten(skp_object_t* rope);
+skp_object_t* skp_intern(const char* chars, size_t length);
+skp_object_t* skp_intern_lookup(const char* chars, size_t length);
+skp_object_t* skp_intern_borrowed(const char* chars, size_t length);
 skp_object_t* skp_new_list(void);
 skp_object_t* skp_new_dict(void);
-skp_object_t* skp_new_null(void);
-skp_object_t* skp_new_func(skp_object_t* (*func)(skp_object_t** args, size_t argc));
+skp_object_t* skp_new_function(const char* name, int arity, struct chunk* chunk);
+skp_object_t* skp_new_closure(skp_object_t* function);
+skp_object_t* skp_new_native(skp_native_func_t func, const char* name);
+skp_object_t* skp_new_class(const char* name);
 skp_object_t* skp_new_object(skp_class_t* klass);
+skp_object_t* skp_new_bound_method(skp_value_t receiver, skp_object_t* method);
+skp_object_t* skp_new_builder(void);
+uint64_t skp_range_count(skp_int start, skp_int end, skp_int step);
+skp_object_t* skp_new_range(skp_int start, skp_int end, skp_int step);
+skp_upvalue_t* skp_new_upvalue(skp_value_t* slot);
+void skp_upvalue_decref(skp_upvalue_t* upvalue);
 
 void skp_incref(skp_object_t* obj);
 void skp_decref(skp_object_t* obj);
 void skp_free(skp_object_t* obj);
 
+/* عدّ المراجع على مستوى القيمة (لا أثر للقيم المباشرة) */
+static inline void skp_value_incref(skp_value_t value) {
+    if (SKP_IS_OBJ(value)) skp_incref(value.as.v_obj);
+}
+
+static inline void skp_value_decref(skp_value_t value) {
+    if (SKP_IS_OBJ(value)) skp_decref(value.as.v_obj);
+}
+
+/* دمج الحبل قبل قراءة بيانات النص؛ الطول وحده لا يحتاجه */
+static inline void skp_string_flatten(skp_object_t* string) {
+    if (string->data.v_string.chars == NULL) skp_rope_flatten(string);
+}
+
 /* ============================================
  * عمليات على القوائم
  * ============================================ */
 
-void skp_list_append(skp_object_t* list, skp_object_t* item);
-skp_object_t* skp_list_get(skp_object_t* list, size_t index);
-void skp_list_set(skp_object_t* list, size_t index, skp_object_t* item);
+void skp_list_append(skp_object_t* list, skp_value_t item);
+skp_value_t skp_list_get(skp_object_t* list, size_t index);
+void skp_list_set(skp_object_t* list, size_t index, skp_value_t item);
 size_t skp_list_len(skp_object_t* list);
 skp_object_t* skp_list_slice(skp_object_t* list, skp_int start, skp_int end);
 void skp_list_sort(skp_object_t* list);
+void skp_list_insert(skp_object_t* list, skp_int index, skp_value_t item);
+void skp_list_remove(skp_object_t* list, skp_int index);
+void skp_list_clear(skp_object_t* list);
+skp_object_t* skp_list_copy(skp_object_t* list);
+
+/* ============================================
+ * عمليات على المديات
+ * ============================================ */
+
+/* العنصر index دون فحص الحدود */
+static inline skp_int skp_range_at(skp_object_t* range, skp_int index) {
+    /* النتيجة داخل المدى دائماً، لكن الجداء وحده قد يفيض skp_int */
+    return (skp_int)((uint64_t)range->data.v_range.start +
+                     (uint64_t)index * (uint64_t)range->data.v_range.step);
+}
+
+skp_object_t* skp_range_to_list(skp_object_t* range);
 
 /* ============================================
  * عمليات على القواميس
  * ============================================ */
 
-void skp_dict_set(skp_object_t* dict, const char* key, skp_object_t* value);
-skp_object_t* skp_dict_get(skp_object_t* dict, const char* key);
+void skp_dict_set(skp_object_t* dict, const char* key, skp_value_t value);
+skp_bool skp_dict_get(skp_object_t* dict, const char* key, skp_value_t* out);
+void skp_dict_set_key(skp_object_t* dict, skp_object_t* key, skp_value_t value);
+skp_dict_entry_t* skp_dict_find(skp_object_t* dict, skp_object_t* key);
 skp_bool skp_dict_has(skp_object_t* dict, const char* key);
 void skp_dict_remove(skp_object_t* dict, const char* key);
 size_t skp_dict_len(skp_object_t* dict);
+void skp_dict_clear(skp_object_t* dict);
+skp_object_t* skp_dict_copy(skp_object_t* dict);
+void skp_dict_merge(skp_object_t* dest, skp_object_t* src);
+skp_object_t* skp_dict_keys(skp_object_t* dict);
+skp_object_t* skp_dict_values(skp_object_t* dict);
+skp_object_t* skp_dict_items(skp_object_t* dict);
+skp_bool skp_dict_next(skp_object_t* dict, size_t* position, skp_dict_entry_t** entry);
+uint32_t skp_hash_string(const char* key);
+uint32_t skp_hash_bytes(const char* chars, size_t length);
+
+/* ============================================
+ * الأشكال وحقول الكائنات
+ * ============================================ */
+
+skp_shape_t* skp_new_shape(void);
+void skp_free_shape(skp_shape_t* shape);
+skp_shape_t* skp_shape_transition(skp_shape_t* shape, skp_object_t* name);
+int skp_shape_find(skp_shape_t* shape, skp_object_t* name);
+skp_bool skp_object_get_field(skp_object_t* obj, const char* name, skp_value_t* out);
+void skp_object_set_field(skp_object_t* obj, const char* name, skp_value_t value);
+void skp_object_add_field(skp_object_t* obj, skp_shape_t* shape, skp_value_t value);
+
+/* ============================================
+ * الفهرسة
+ * ============================================ */
+
+skp_bool skp_get_index(skp_value_t object, skp_value_t index, skp_value_t* out);
+skp_bool skp_set_index(skp_value_t object, skp_value_t index, skp_value_t value);
 
 /* ============================================
  * العمليات الحسابية
  * ============================================ */
 
-skp_object_t* skp_add(skp_object_t* a, skp_object_t* b);
-skp_object_t* skp_sub(skp_object_t* a, skp_object_t* b);
-skp_object_t* skp_mul(skp_object_t* a, skp_object_t* b);
-skp_object_t* skp_div(skp_object_t* a, skp_object_t* b);
-skp_object_t* skp_mod(skp_object_t* a, skp_object_t* b);
-skp_object_t* skp_pow(skp_object_t* a, skp_object_t* b);
+/* الأعداد الصحيحة تلتف عند الفيض بمتمم الاثنين في كل الأجهزة ومستويات
+ * التحسين؛ الفيض بالإشارة سلوك غير معرف في C فيُحسب بلا إشارة */
+#if defined(__GNUC__)
+static inline skp_int skp_int_add(skp_int a, skp_int b) {
+    skp_int result;
+    __builtin_add_overflow(a, b, &result);
+    return result;
+}
+
+static inline skp_int skp_int_sub(skp_int a, skp_int b) {
+    skp_int result;
+    __builtin_sub_overflow(a, b, &result);
+    return result;
+}
+
+static inline skp_int skp_int_mul(skp_int a, skp_int b) {
+    skp_int result;
+    __builtin_mul_overflow(a, b, &result);
+    return result;
+}
+#else
+static inline skp_int skp_int_add(skp_int a, skp_int b) {
+    return (skp_int)((uint64_t)a + (uint64_t)b);
+}
+
+static inline skp_int skp_int_sub(skp_int a, skp_int b) {
+    return (skp_int)((uint64_t)a - (uint64_t)b);
+}
+
+static inline skp_int skp_int_mul(skp_int a, skp_int b) {
+    return (skp_int)((uint64_t)a * (uint64_t)b);
+}
+#endif
+
+static inline skp_int skp_int_neg(skp_int a) {
+    return skp_int_sub(0, a);
+}
+
+/* عدد الإزاحة بِبتاته الست الدنيا، فلا إزاحة بعدد سالب أو يبلغ 64. اليسرى
+ * تلتف كالضرب، واليمنى تحفظ الإشارة */
+static inline skp_int skp_int_shl(skp_int a, skp_int b) {
+    return (skp_int)((uint64_t)a << (b & 63));
+}
+
+static inline skp_int skp_int_shr(skp_int a, skp_int b) {
+    int shift = (int)(b & 63);
+    return a < 0 ? (skp_int)~(~(uint64_t)a >> shift) : (skp_int)((uint64_t)a >> shift);
+}
+
+skp_value_t skp_add(skp_value_t a, skp_value_t b);
+skp_value_t skp_sub(skp_value_t a, skp_value_t b);
+skp_value_t skp_mul(skp_value_t a, skp_value_t b);
+skp_value_t skp_div(skp_value_t a, skp_value_t b);
+skp_value_t skp_mod(skp_value_t a, skp_value_t b);
+skp_value_t skp_pow(skp_value_t a, skp_value_t b);
+skp_value_t skp_neg(skp_value_t a);
 
 /* ============================================
  * العمليات المنطقية
  * ============================================ */
 
-skp_bool skp_eq(skp_object_t* a, skp_object_t* b);
-skp_bool skp_ne(skp_object_t* a, skp_object_t* b);
-skp_bool skp_lt(skp_object_t* a, skp_object_t* b);
-skp_bool skp_gt(skp_object_t* a, skp_object_t* b);
-skp_bool skp_le(skp_object_t* a, skp_object_t* b);
-skp_bool skp_ge(skp_object_t* a, skp_object_t* b);
+skp_bool skp_eq(skp_value_t a, skp_value_t b);
+skp_bool skp_ne(skp_value_t a, skp_value_t b);
+skp_bool skp_lt(skp_value_t a, skp_value_t b);
+skp_bool skp_gt(skp_value_t a, skp_value_t b);
+skp_bool skp_le(skp_value_t a, skp_value_t b);
+skp_bool skp_ge(skp_value_t a, skp_value_t b);
 
 skp_bool skp_and(skp_bool a, skp_bool b);
 skp_bool skp_or(skp_bool a, skp_bool b);
@@ -182,55 +601,60 @@ skp_bool skp_not(skp_bool a);
  * التحويل بين الأنواع
  * ============================================ */
 
-skp_object_t* skp_to_string(skp_object_t* obj);
-skp_object_t* skp_to_int(skp_object_t* obj);
-skp_object_t* skp_to_float(skp_object_t* obj);
-skp_bool skp_to_bool(skp_object_t* obj);
+skp_object_t* skp_to_string(skp_value_t value);
+skp_int skp_to_int(skp_value_t value);
+skp_float skp_to_float(skp_value_t value);
+skp_bool skp_to_bool(skp_value_t value);
 
 /* ============================================
  * المكتبة القياسية
  * ============================================ */
 
 /* النصوص */
-skp_object_t* skp_str_length(skp_object_t* str);
+skp_value_t skp_str_length(skp_object_t* str);
 skp_object_t* skp_str_concat(skp_object_t* a, skp_object_t* b);
 skp_object_t* skp_str_substring(skp_object_t* str, skp_int start, skp_int end);
-skp_object_t* skp_str_contains(skp_object_t* str, skp_object_t* substr);
+skp_value_t skp_str_contains(skp_object_t* str, skp_object_t* substr);
+skp_int skp_str_find(skp_object_t* str, skp_object_t* substr);
 skp_object_t* skp_str_split(skp_object_t* str, skp_object_t* delim);
 skp_object_t* skp_str_replace(skp_object_t* str, skp_object_t* old, skp_object_t* new);
 skp_object_t* skp_str_upper(skp_object_t* str);
 skp_object_t* skp_str_lower(skp_object_t* str);
 skp_object_t* skp_str_trim(skp_object_t* str);
 
+/* باني النصوص */
+void skp_builder_append(skp_object_t* builder, skp_value_t value);
+void skp_builder_clear(skp_object_t* builder);
+
 /* الرياضيات */
-skp_object_t* skp_math_abs(skp_object_t* x);
-skp_object_t* skp_math_sqrt(skp_object_t* x);
-skp_object_t* skp_math_sin(skp_object_t* x);
-skp_object_t* skp_math_cos(skp_object_t* x);
-skp_object_t* skp_math_tan(skp_object_t* x);
-skp_object_t* skp_math_log(skp_object_t* x);
-skp_object_t* skp_math_exp(skp_object_t* x);
-skp_object_t* skp_math_floor(skp_object_t* x);
-skp_object_t* skp_math_ceil(skp_object_t* x);
-skp_object_t* skp_math_round(skp_object_t* x);
-skp_object_t* skp_math_random(void);
+skp_value_t skp_math_abs(skp_value_t x);
+skp_value_t skp_math_sqrt(skp_value_t x);
+skp_value_t skp_math_sin(skp_value_t x);
+skp_value_t skp_math_cos(skp_value_t x);
+skp_value_t skp_math_tan(skp_value_t x);
+skp_value_t skp_math_log(skp_value_t x);
+skp_value_t skp_math_exp(skp_value_t x);
+skp_value_t skp_math_floor(skp_value_t x);
+skp_value_t skp_math_ceil(skp_value_t x);
+skp_value_t skp_math_round(skp_value_t x);
+skp_value_t skp_math_random(void);
 
 /* النظام */
-void skp_print(skp_object_t* obj);
-void skp_println(skp_object_t* obj);
+void skp_print(skp_value_t value);
+void skp_println(skp_value_t value);
 skp_object_t* skp_input(void);
 void skp_exit(skp_int code);
 
 /* الوقت */
-skp_object_t* skp_time_now(void);
-skp_object_t* skp_time_sleep(skp_object_t* seconds);
+skp_value_t skp_time_now(void);
+skp_value_t skp_time_sleep(skp_value_t seconds);
 
 /* ============================================
  * معلومات
  * ============================================ */
 
 const char* skp_type_name(skp_type_t type);
-skp_type_t skp_get_type(skp_object_t* obj);
+skp_type_t skp_get_type(skp_value_t value);
 const char* skp_version(void);
 void skp_info(void);
 
@@ -1,7 +1,7 @@
 /*
  * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
  * الجهاز الافتراضي (VM) - Virtual Machine Implementation
- * 
+ *
  * ينفذ بايتكود SEEKEP
  */
 
@@ -9,8 +9,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <ctype.h>
 #include <time.h>
 #include <math.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
 #include "vm.h"
 
 /* ========== إنشاء وإتلاف الجهاز الافتراضي ========== */
@@ -21,14 +25,17 @@ skp_vm_t* vm_create(void) {
     
     vm->stack_top = vm->stack;
     vm->frame_count = 0;
-    vm->globals = skp_dict_create();
-    vm->objects = NULL;
-    vm->bytes_allocated = 0;
-    vm->next_gc = SKP_GC_THRESHOLD;
+    vm->globals = skp_new_dict();
+    vm->global_values = NULL;
+    vm->global_capacity = 0;
+    skp_heap_init(&vm->heap, SKP_GC_THRESHOLD);
     vm->open_upvalues = NULL;
-    vm->gray_stack = NULL;
-    vm->gray_count = 0;
-    vm->gray_capacity = 0;
+    vm->promoted = NULL;
+    vm->promoted_count = 0;
+    vm->promoted_capacity = 0;
+    vm->gc_pause_budget = (uint64_t)SKP_GC_PAUSE_BUDGET_US * 1000;
+    vm->gc_remarks = 0;
+    memset(&vm->gc_stats, 0, sizeof(skp_gc_stats_t));
     vm->running = 0;
     vm->had_error = 0;
     vm->error_message = NULL;
@@ -42,19 +49,17 @@ skp_vm_t* vm_create(void) {
 void vm_destroy(skp_vm_t* vm) {
     if (!vm) return;
     
-    /* تحرير جميع الكائنات */
-    skp_object_t* object = vm->objects;
-    while (object) {
-        skp_object_t* next = object->next;
-        skp_free(object);
-        object = next;
+    /* تحرير المتغيرات العامة: المُدار منها يبقى للكومة */
+    for (size_t i = 0; i < vm->global_capacity; i++) {
+        skp_value_decref(vm->global_values[i]);
     }
+    free(vm->global_values);
+    skp_decref(vm->globals);
     
-    /* تحرير القاموس العام */
-    skp_dict_destroy(vm->globals);
+    /* تحرير جميع الكائنات المُدارة */
+    skp_heap_destroy(&vm->heap);
     
-    /* تحرير المكدس الرمادي */
-    free(vm->gray_stack);
+    free(vm->promoted);
     
     /* تحرير رسالة الخطأ */
     free(vm->error_message);
@@ -65,6 +70,7 @@ void vm_destroy(skp_vm_t* vm) {
 void vm_reset(skp_vm_t* vm) {
     vm->stack_top = vm->stack;
     vm->frame_count = 0;
+    vm->open_upvalues = NULL;
     vm->had_error = 0;
     free(vm->error_message);
     vm->error_message = NULL;
@@ -72,17 +78,17 @@ void vm_reset(skp_vm_t* vm) {
 
 /* ========== المكدس ========== */
 
-void vm_push(skp_vm_t* vm, skp_object_t* value) {
+void vm_push(skp_vm_t* vm, skp_value_t value) {
     *vm->stack_top = value;
     vm->stack_top++;
 }
 
-skp_object_t* vm_pop(skp_vm_t* vm) {
+skp_value_t vm_pop(skp_vm_t* vm) {
     vm->stack_top--;
     return *vm->stack_top;
 }
 
-skp_object_t* vm_peek(skp_vm_t* vm, int distance) {
+skp_value_t vm_peek(skp_vm_t* vm, int distance) {
     return vm->stack_top[-1 - distance];
 }
 
@@ -112,52 +118,102 @@ void vm_runtime_error(skp_vm_t* vm, const char* format, ...) {
         call_frame_t* frame = &vm->frames[i];
         int instruction = (int)(frame->ip - frame->chunk->code - 1);
         int line = frame->chunk->lines[instruction];
-        fprintf(stderr, "[سطر %d] في الدالة\n", line);
+        if (frame->closure) {
+            const char* name = frame->closure->data.v_closure.function->data.v_func.name;
+            fprintf(stderr, "[سطر %d] في الدالة %s\n", line, name ? name : "");
+        } else {
+            fprintf(stderr, "[سطر %d] في البرنامج\n", line);
+        }
+    }
+}
+
+/* ========== المتغيرات العامة ========== */
+
+/* توسيع مصفوفة القيم لتغطي كل الفتحات التي حجزها المترجم */
+void vm_sync_globals(skp_vm_t* vm) {
+    size_t count = skp_dict_len(vm->globals);
+    if (count <= vm->global_capacity) return;
+    
+    size_t capacity = vm->global_capacity == 0 ? 64 : vm->global_capacity;
+    while (capacity < count) capacity *= 2;
+    
+    vm->global_values = (skp_value_t*)realloc(vm->global_values, sizeof(skp_value_t) * capacity);
+    for (size_t i = vm->global_capacity; i < capacity; i++) {
+        vm->global_values[i] = SKP_UNDEFINED_VAL;
+    }
+    vm->global_capacity = capacity;
+}
+
+/* اسم الفتحة لرسائل الخطأ فقط */
+const char* vm_global_name(skp_vm_t* vm, uint16_t slot) {
+    size_t position = 0;
+    skp_dict_entry_t* entry;
+    while (skp_dict_next(vm->globals, &position, &entry)) {
+        if (SKP_AS_INT(entry->value) == slot) return entry->key->data.v_string.chars;
     }
+    return "?";
 }
 
 /* ========== الاستدعاء ========== */
 
-int vm_call(skp_vm_t* vm, skp_object_t* callee, int arg_count) {
+int vm_call(skp_vm_t* vm, skp_object_t* closure, int arg_count) {
+    skp_object_t* function = closure->data.v_closure.function;
+    int arity = function->data.v_func.arity;
+    
+    if (arg_count > arity) {
+        vm_runtime_error(vm, "توقع %d معاملات لكن تم تمرير %d", arity, arg_count);
+        return 0;
+    }
+    
     if (vm->frame_count >= SKP_FRAMES_MAX) {
         vm_runtime_error(vm, "تجاوز الحد الأقصى لعمق الاستدعاء");
         return 0;
     }
     
+    /* المعاملات الناقصة تصل فارغة وتأخذ قيمها الافتراضية داخل الدالة */
+    while (arg_count < arity) {
+        vm_push(vm, SKP_NULL_VAL);
+        arg_count++;
+    }
+    
     call_frame_t* frame = &vm->frames[vm->frame_count++];
-    frame->chunk = &callee->data.v_func.closure->data.v_closure.function->chunk;
+    frame->closure = closure;
+    frame->chunk = function->data.v_func.chunk;
     frame->ip = frame->chunk->code;
     frame->slots = vm->stack_top - arg_count - 1;
     
     return 1;
 }
 
-int vm_call_value(skp_vm_t* vm, skp_object_t* callee, int arg_count) {
-    if (callee == NULL) {
-        vm_runtime_error(vm, "لا يمكن استدعاء قيمة فارغة");
-        return 0;
-    }
-    
-    switch (callee->type) {
-        case SKP_TYPE_FUNCTION:
-            return vm_call(vm, callee, arg_count);
-            
+int vm_call_value(skp_vm_t* vm, skp_value_t callee, int arg_count) {
+    switch (callee.type) {
+        case SKP_TYPE_CLOSURE:
+            return vm_call(vm, SKP_AS_OBJ(callee), arg_count);
+        
         case SKP_TYPE_NATIVE: {
-            skp_native_func_t native = callee->data.v_native.func;
-            skp_object_t* result = native(vm, arg_count, vm->stack_top - arg_count);
+            skp_native_func_t native = SKP_AS_OBJ(callee)->data.v_native.func;
+            
+            /* الدوال المدمجة تقرأ بيانات النصوص مباشرة، فتُدمج الحبال قبلها */
+            skp_value_t* args = vm->stack_top - arg_count;
+            for (int i = 0; i < arg_count; i++) {
+                if (SKP_IS_STRING(args[i])) skp_string_flatten(SKP_AS_OBJ(args[i]));
+            }
+            
+            skp_value_t result = native(vm, arg_count, vm->stack_top - arg_count);
+            if (vm->had_error) return 0;
             vm->stack_top -= arg_count + 1;
             vm_push(vm, result);
             return 1;
         }
-            
+        
         case SKP_TYPE_CLASS: {
-            skp_object_t* instance = skp_new_instance(callee->data.v_class.klass);
-            vm->stack_top[-arg_count - 1] = instance;
+            skp_class_t* klass = SKP_AS_OBJ(callee)->data.v_class.klass;
+            vm->stack_top[-arg_count - 1] = SKP_OBJ_VAL(skp_new_object(klass));
             
             /* استدعاء المُنشئ إذا وجد */
-            skp_object_t* initializer;
-            if (skp_dict_get(callee->data.v_class.klass->methods, "init", &initializer)) {
-                return vm_call(vm, initializer, arg_count);
+            skp_value_t initializer;
+            if (skp_dict_get(klass->methods, "init", &initializer)) {
+                return vm_call(vm, SKP_AS_OBJ(initializer), arg_count);
             } else if (arg_count != 0) {
                 vm_runtime_error(vm, "توقع 0 معاملات لكن تم تمرير %d", arg_count);
                 return 0;
@@ -165,30 +221,30 @@ int vm_call_value(skp_vm_t* vm, skp_object_t* callee, int arg_count) {
             
             return 1;
         }
-            
+        
         case SKP_TYPE_BOUND_METHOD: {
-            skp_bound_method_t* bound = callee->data.v_bound_method.bound;
-            vm->stack_top[-arg_count - 1] = bound->receiver;
-            return vm_call(vm, bound->method, arg_count);
+            skp_object_t* bound = SKP_AS_OBJ(callee);
+            vm->stack_top[-arg_count - 1] = bound->data.v_bound_method.receiver;
+            return vm_call(vm, bound->data.v_bound_method.method, arg_count);
         }
-            
+        
         default:
-            vm_runtime_error(vm, "لا يمكن استدعاء هذا النوع");
+            vm_runtime_error(vm, "لا يمكن استدعاء قيمة من نوع %s",
+                             skp_type_name(callee.type));
             return 0;
     }
 }
 
-int vm_invoke(skp_vm_t* vm, skp_object_t* receiver, skp_string name, int arg_count) {
-    skp_type_t type = skp_get_type(receiver);
-    
-    if (type == SKP_TYPE_INSTANCE) {
-        skp_object_t* value;
-        if (skp_dict_get(receiver->data.v_object.fields, name, &value)) {
+int vm_invoke(skp_vm_t* vm, skp_value_t receiver, const char* name, int arg_count) {
+    if (receiver.type == SKP_TYPE_OBJECT) {
+        skp_object_t* instance = SKP_AS_OBJ(receiver);
+        skp_value_t value;
+        if (skp_object_get_field(instance, name, &value)) {
             vm->stack_top[-arg_count - 1] = value;
             return vm_call_value(vm, value, arg_count);
         }
         
-        return vm_invoke_from_class(vm, receiver->data.v_object.klass, name, arg_count);
+        return vm_invoke_from_class(vm, instance->data.v_object.klass, name, arg_count);
     }
     
     /* دوال مدمجة للأنواع الأساسية */
@@ -196,19 +252,57 @@ int vm_invoke(skp_vm_t* vm, skp_object_t* receiver, skp_string name, int arg_cou
     return 0;
 }
 
-int vm_invoke_from_class(skp_vm_t* vm, skp_class_t* klass, skp_string name, int arg_count) {
-    skp_object_t* method;
+int vm_invoke_from_class(skp_vm_t* vm, skp_class_t* klass, const char* name, int arg_count) {
+    skp_value_t method;
     if (!skp_dict_get(klass->methods, name, &method)) {
         vm_runtime_error(vm, "الطريقة غير معرفة: %s", name);
         return 0;
     }
     
-    return vm_call(vm, method, arg_count);
+    return vm_call(vm, SKP_AS_OBJ(method), arg_count);
+}
+
+/* يستبدل الكائن في قمة المكدس بطريقته المربوطة */
+int vm_bind_method(skp_vm_t* vm, skp_class_t* klass, const char* name) {
+    skp_value_t method;
+    if (!skp_dict_get(klass->methods, name, &method)) {
+        vm_runtime_error(vm, "خاصية غير معرفة: %s", name);
+        return 0;
+    }
+    
+    skp_object_t* bound = skp_new_bound_method(vm_peek(vm, 0), SKP_AS_OBJ(method));
+    vm_pop(vm);
+    vm_push(vm, SKP_OBJ_VAL(bound));
+    return 1;
+}
+
+/* ========== الذواكر المخبئية المضمنة ========== */
+
+/* مدخل شكل الكائن في ذاكرة التعليمة؛ عند الإخفاق تُحل فتحة الحقل وطريقة الصنف
+ * مرة واحدة ويُستبدل أقدم مدخل */
+static inline_cache_entry_t* vm_cache_entry(inline_cache_t* cache, skp_object_t* instance,
+                                            skp_object_t* name) {
+    skp_shape_t* shape = instance->data.v_object.shape;
+    for (int i = 0; i < SKP_IC_WAYS; i++) {
+        if (cache->entries[i].shape_id == shape->id) {
+            return &cache->entries[i];
+        }
+    }
+    
+    inline_cache_entry_t* entry = &cache->entries[cache->next];
+    cache->next = (cache->next + 1) % SKP_IC_WAYS;
+    
+    skp_dict_entry_t* method = skp_dict_find(instance->data.v_object.klass->methods, name);
+    entry->shape_id = shape->id;
+    entry->slot = skp_shape_find(shape, name);
+    entry->transition = NULL;
+    entry->method = method ? SKP_AS_OBJ(method->value) : NULL;
+    return entry;
 }
 
 /* ========== Upvalues ========== */
 
-skp_upvalue_t* vm_capture_upvalue(skp_vm_t* vm, skp_object_t** local) {
+skp_upvalue_t* vm_capture_upvalue(skp_vm_t* vm, skp_value_t* local) {
     /* البحث عن upvalue موجود */
     skp_upvalue_t* prev_upvalue = NULL;
     skp_upvalue_t* upvalue = vm->open_upvalues;
@@ -235,12 +329,246 @@ skp_upvalue_t* vm_capture_upvalue(skp_vm_t* vm, skp_object_t** local) {
     return created;
 }
 
-void vm_close_upvalues(skp_vm_t* vm, skp_object_t** last) {
+/* حاجز الكتابة في upvalue مغلق. الإغلاقات في الجيل القديم، فالقيمة
+ * الصغيرة تُتذكر، والقديمة تُلوَّن إن كان التعليم جارياً */
+static void vm_upvalue_barrier(skp_upvalue_t* upvalue, skp_value_t value) {
+    if (!SKP_IS_OBJ(value)) return;
+    if (SKP_AS_OBJ(value)->gc & SKP_GC_YOUNG) {
+        skp_heap_remember_upvalue(upvalue);
+    } else {
+        skp_heap_shade(SKP_AS_OBJ(value));
+    }
+}
+
+/* الإغلاق يُسقط مرجع القائمة المفتوحة؛ وما لم يبق له إغلاق حي يُحرر فوراً */
+void vm_close_upvalues(skp_vm_t* vm, skp_value_t* last) {
     while (vm->open_upvalues && vm->open_upvalues->location >= last) {
         skp_upvalue_t* upvalue = vm->open_upvalues;
+        vm->open_upvalues = upvalue->next;
+        if (upvalue->owners == 1) {
+            skp_upvalue_decref(upvalue);
+            continue;
+        }
+        upvalue->owners--;
         upvalue->closed = *upvalue->location;
         upvalue->location = &upvalue->closed;
-        vm->open_upvalues = upvalue->next;
+        vm_upvalue_barrier(upvalue, upvalue->closed);
+    }
+}
+
+/* ========== جمع القمامة ========== */
+
+static void vm_promoted_push(skp_vm_t* vm, skp_object_t* object) {
+    if (vm->promoted_count >= vm->promoted_capacity) {
+        vm->promoted_capacity = vm->promoted_capacity < 64 ? 64 : vm->promoted_capacity * 2;
+        vm->promoted = (skp_object_t**)realloc(vm->promoted,
+                                               sizeof(skp_object_t*) * vm->promoted_capacity);
+    }
+    vm->promoted[vm->promoted_count++] = object;
+}
+
+/* الجذور: المكدس، إغلاقات الإطارات، والمتغيرات العامة */
+static void vm_visit_roots(skp_vm_t* vm, skp_visit_fn visit) {
+    for (skp_value_t* slot = vm->stack; slot < vm->stack_top; slot++) {
+        if (SKP_IS_OBJ(*slot) && slot->as.v_obj) visit(&slot->as.v_obj, vm);
+    }
+    for (int i = 0; i < vm->frame_count; i++) {
+        if (vm->frames[i].closure) visit(&vm->frames[i].closure, vm);
+    }
+    for (size_t i = 0; i < vm->global_capacity; i++) {
+        skp_value_t* value = &vm->global_values[i];
+        if (SKP_IS_OBJ(*value) && value->as.v_obj) visit(&value->as.v_obj, vm);
+    }
+}
+
+/* نقل كائن حي من الحضانة وتحديث المرجع إليه */
+static void vm_evacuate(skp_object_t** slot, void* context) {
+    skp_vm_t* vm = (skp_vm_t*)context;
+    skp_object_t* object = *slot;
+    if (!(object->gc & SKP_GC_YOUNG)) return;
+    
+    if (object->gc & SKP_GC_FORWARDED) {
+        *slot = object->next;
+        return;
+    }
+    
+    *slot = skp_heap_promote(&vm->heap, object);
+    vm_promoted_push(vm, *slot);
+}
+
+/* الجمع الصغير: نسخ الناجين من الحضانة إلى الجيل القديم. الجذور هي جذور
+ * الجهاز مع الكائنات القديمة المتذكرة، فلا حاجة لمسح الجيل القديم كله */
+void vm_collect_nursery(skp_vm_t* vm) {
+    skp_heap_t* heap = &vm->heap;
+    
+    vm_visit_roots(vm, vm_evacuate);
+    for (size_t i = 0; i < heap->remembered_count; i++) {
+        skp_object_visit(heap->remembered[i], vm_evacuate, vm);
+    }
+    for (size_t i = 0; i < heap->remembered_upvalue_count; i++) {
+        skp_value_t* closed = &heap->remembered_upvalues[i]->closed;
+        if (SKP_IS_OBJ(*closed) && closed->as.v_obj) vm_evacuate(&closed->as.v_obj, vm);
+    }
+    
+    while (vm->promoted_count > 0) {
+        skp_object_visit(vm->promoted[--vm->promoted_count], vm_evacuate, vm);
+    }
+    
+    skp_heap_finish_minor(heap);
+    vm->gc_stats.minor_count++;
+}
+
+void vm_mark_object(skp_vm_t* vm, skp_object_t* object) {
+    skp_heap_mark(&vm->heap, object);
+}
+
+void vm_mark_value(skp_vm_t* vm, skp_value_t value) {
+    if (SKP_IS_OBJ(value)) vm_mark_object(vm, SKP_AS_OBJ(value));
+}
+
+static void vm_mark_slot(skp_object_t** slot, void* context) {
+    vm_mark_object((skp_vm_t*)context, *slot);
+}
+
+/* نهاية التعليم دفعة واحدة للجمع الكامل. المكدس والمتغيرات العامة بلا
+ * حاجز كتابة، فتُمسح الجذور ثانية؛ والحضانة تُفرغ قبلها كي لا يبقى كائن
+ * صغير ميت يشير إلى كائن سيُحرر. الخطوات التدريجية تنهيه بـ vm_remark_step */
+void vm_trace_references(skp_vm_t* vm) {
+    skp_heap_t* heap = &vm->heap;
+    if (heap->phase == SKP_GC_IDLE) heap->phase = SKP_GC_MARKING;
+    
+    vm_collect_nursery(vm);
+    vm_visit_roots(vm, vm_mark_slot);
+    skp_heap_mark_step(heap, 0);
+}
+
+static void vm_end_cycle(skp_vm_t* vm) {
+    size_t next = vm->heap.bytes_allocated * SKP_GC_GROW_FACTOR;
+    vm->heap.next_gc = next > SKP_GC_THRESHOLD ? next : SKP_GC_THRESHOLD;
+    vm->gc_stats.major_count++;
+    vm->gc_remarks = 0;
+}
+
+void vm_sweep(skp_vm_t* vm) {
+    if (vm->heap.phase == SKP_GC_MARKING) skp_heap_begin_sweep(&vm->heap);
+    skp_heap_sweep_step(&vm->heap, 0);
+    vm_end_cycle(vm);
+}
+
+/* جمع كامل يُنهي أي دورة جارية */
+void vm_collect_garbage(skp_vm_t* vm) {
+    if (vm->heap.phase == SKP_GC_SWEEPING) vm_sweep(vm);
+    vm_trace_references(vm);
+    vm_sweep(vm);
+}
+
+static void vm_record_pause(skp_vm_t* vm, uint64_t nanoseconds) {
+    skp_gc_stats_t* stats = &vm->gc_stats;
+    uint64_t micros = nanoseconds / 1000;
+    
+    int bucket = 0;
+    while (bucket < SKP_GC_PAUSE_BUCKETS - 1 && micros >= ((uint64_t)1 << bucket)) bucket++;
+    
+    stats->pauses[bucket]++;
+    stats->pause_count++;
+    stats->pause_total_ns += nanoseconds;
+    if (nanoseconds > stats->pause_max_ns) stats->pause_max_ns = nanoseconds;
+}
+
+static void vm_record_minor_pause(skp_vm_t* vm, uint64_t nanoseconds) {
+    skp_gc_stats_t* stats = &vm->gc_stats;
+    stats->minor_total_ns += nanoseconds;
+    if (nanoseconds > stats->minor_max_ns) stats->minor_max_ns = nanoseconds;
+}
+
+/* جمع الحضانة داخل خطوة: يُسجل توقفاً لها، ويُزاح بمدته بدء الخطوة
+ * وموعدها فلا يأكل ميزانية الجيل القديم */
+static void vm_step_nursery(skp_vm_t* vm, uint64_t* start, uint64_t* deadline) {
+    uint64_t before = skp_clock_ns();
+    vm_collect_nursery(vm);
+    uint64_t elapsed = skp_clock_ns() - before;
+    
+    vm_record_minor_pause(vm, elapsed);
+    *start += elapsed;
+    *deadline += elapsed;
+}
+
+/* نهاية التعليم في خطوة: المكدس والمتغيرات العامة بلا حاجز كتابة فتُمسح
+ * ثانية بعد إفراغ الحضانة، وما تلونه يُفحص في ما بقي من الميزانية. إن لم
+ * يفرغ الرمادي أكملته الخطوات التالية ثم أُعيد المسح، فلا يُكنس إلا بعد
+ * مسح فرغ الرمادي في خطوته. بعد SKP_GC_REMARK_LIMIT محاولات يُتم الفحص
+ * دون حد كي تنتهي الدورة. ترجع SKP_TRUE إن انتهى التعليم */
+static skp_bool vm_remark_step(skp_vm_t* vm, uint64_t* start, uint64_t* deadline) {
+    vm_step_nursery(vm, start, deadline);
+    vm_visit_roots(vm, vm_mark_slot);
+    
+    if (++vm->gc_remarks >= SKP_GC_REMARK_LIMIT) {
+        vm->gc_stats.forced_remarks++;
+        return skp_heap_mark_step(&vm->heap, 0);
+    }
+    return skp_heap_mark_step(&vm->heap, *deadline);
+}
+
+/* عمل الجمع عند نقطة آمنة: الحضانة إن امتلأت، ثم خطوة من دورة الجيل
+ * القديم لا تتجاوز ميزانية التوقف. جمع الحضانة خارج الميزانية: النقل لا
+ * يتجزأ لأن الحضانة تُفرغ بعده ولا حاجز قراءة، وحده حجم الحضانة. كل خطوة
+ * تسدد SKP_GC_STEP_DEBT من دين التخصيص، وما بقي منه يطلب خطوة في النقطة
+ * الآمنة التالية، فالنقل الكبير من الحضانة يُسدد على خطوات. إن سبق
+ * التخصيص التعليم حتى تضاعف الجيل القديم توالت الخطوات عند كل نقطة آمنة
+ * حتى تنتهي الدورة: يتباطأ البرنامج ولا يطول توقف */
+void vm_collect_step(skp_vm_t* vm) {
+    skp_heap_t* heap = &vm->heap;
+    uint64_t start = skp_clock_ns();
+    
+    uint64_t deadline = start + vm->gc_pause_budget;
+    skp_bool behind = heap->bytes_allocated > heap->next_gc * SKP_GC_GROW_FACTOR;
+    
+    heap->gc_requested = SKP_FALSE;
+    if (heap->nursery_full) vm_step_nursery(vm, &start, &deadline);
+    
+    if (heap->phase == SKP_GC_IDLE && heap->bytes_allocated > heap->next_gc) {
+        heap->phase = SKP_GC_MARKING;
+        heap->debt = 0;
+        vm_visit_roots(vm, vm_mark_slot);
+    }
+    if (heap->phase == SKP_GC_IDLE) return;
+    
+    if (heap->phase == SKP_GC_MARKING && skp_heap_mark_step(heap, deadline) &&
+        vm_remark_step(vm, &start, &deadline)) {
+        skp_heap_begin_sweep(heap);
+    }
+    
+    if (heap->phase == SKP_GC_SWEEPING && skp_heap_sweep_step(heap, deadline)) {
+        vm_end_cycle(vm);
+    }
+    
+    if (heap->phase != SKP_GC_IDLE) {
+        heap->debt = heap->debt > SKP_GC_STEP_DEBT ? heap->debt - SKP_GC_STEP_DEBT : 0;
+        if (behind || heap->debt >= SKP_GC_STEP_DEBT) heap->gc_requested = SKP_TRUE;
+    }
+    vm_record_pause(vm, skp_clock_ns() - start);
+}
+
+void vm_print_gc_stats(skp_vm_t* vm, FILE* out) {
+    skp_gc_stats_t* stats = &vm->gc_stats;
+    
+    fprintf(out, "=== جمع القمامة ===\n");
+    fprintf(out, "جمعات الحضانة: %llu، المجموع: %.3f ms، الأقصى: %.3f ms (خارج الميزانية)\n",
+            (unsigned long long)stats->minor_count, stats->minor_total_ns / 1e6,
+            stats->minor_max_ns / 1e6);
+    fprintf(out, "دورات الجيل القديم: %llu، أُتم تعليم %llu منها دون ميزانية\n",
+            (unsigned long long)stats->major_count, (unsigned long long)stats->forced_remarks);
+    fprintf(out, "التوقفات: %llu، المجموع: %.3f ms، الأقصى: %.3f ms، الميزانية: %.3f ms\n",
+            (unsigned long long)stats->pause_count, stats->pause_total_ns / 1e6,
+            stats->pause_max_ns / 1e6, vm->gc_pause_budget / 1e6);
+    
+    for (int i = 0; i < SKP_GC_PAUSE_BUCKETS; i++) {
+        if (stats->pauses[i] == 0) continue;
+        if (i == SKP_GC_PAUSE_BUCKETS - 1) {
+            fprintf(out, "  >= %6llu us: %llu\n", 1ULL << (i - 1), (unsigned long long)stats->pauses[i]);
+        } else {
+            fprintf(out, "  <  %6llu us: %llu\n", 1ULL << i, (unsigned long long)stats->pauses[i]);
+        }
     }
 }
 
@@ -264,20 +592,19 @@ skp_result_t vm_interpret(skp_vm_t* vm, const char* source) {
     ast_node_t* ast = parser_parse(parser);
     
     if (parser->had_error) {
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         return SKP_COMPILE_ERROR;
     }
     
     /* إنشاء المترجم */
-    skp_compiler_t* compiler = compiler_create(parser);
+    skp_compiler_t* compiler = compiler_create(parser, vm->globals);
     if (!compiler) {
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         return SKP_COMPILE_ERROR;
     }
+    compiler_bind_globals(compiler, vm->global_values, vm->global_capacity);
     
     /* الترجمة */
     chunk_t* chunk = compiler_compile(compiler, ast);
@@ -288,7 +615,6 @@ skp_result_t vm_interpret(skp_vm_t* vm, const char* source) {
             free(chunk);
         }
         compiler_destroy(compiler);
-        ast_destroy_node(ast);
         parser_destroy(parser);
         lexer_destroy(lexer);
         return SKP_COMPILE_ERROR;
@@ -296,13 +622,19 @@ skp_result_t vm_interpret(skp_vm_t* vm, const char* source) {
     
     /* تنظيف */
     compiler_destroy(compiler);
-    ast_destroy_node(ast);
     parser_destroy(parser);
     lexer_destroy(lexer);
     
     /* التشغيل */
     skp_result_t result = vm_run(vm, chunk);
     
+    /* المكدس قد يبقى في منتصف دالة بعد خطأ زمني */
+    if (result != SKP_OK) {
+        vm->stack_top = vm->stack;
+        vm->frame_count = 0;
+        vm->open_upvalues = NULL;
+    }
+    
     /* تحرير الكتلة */
     chunk_free(chunk);
     free(chunk);
@@ -310,515 +642,1056 @@ skp_result_t vm_interpret(skp_vm_t* vm, const char* source) {
     return result;
 }
 
+/* العنصر التالي في حلقة لكل، والموضع يتقدم بعده. يُرجع 1 ومعه العنصر،
+ * أو 0 عند النهاية، أو -1 إن لم تكن القيمة مما يُكرر عليه */
+int vm_iter_next(skp_value_t collection, skp_value_t* position, skp_value_t* item) {
+    skp_int index = SKP_AS_INT(*position);
+    
+    if (SKP_IS_LIST(collection)) {
+        skp_object_t* list = SKP_AS_OBJ(collection);
+        if ((size_t)index >= list->data.v_list.count) return 0;
+        *item = list->data.v_list.items[index];
+        *position = SKP_INT_VAL(index + 1);
+        return 1;
+    }
+    
+    if (SKP_IS_RANGE(collection)) {
+        skp_object_t* range = SKP_AS_OBJ(collection);
+        if (index >= range->data.v_range.count) return 0;
+        *item = SKP_INT_VAL(skp_range_at(range, index));
+        *position = SKP_INT_VAL(index + 1);
+        return 1;
+    }
+    
+    if (SKP_IS_STRING(collection)) {
+        /* التكرار على محارف UTF-8 لا على البايتات، والموضع بالبايت */
+        skp_object_t* string = SKP_AS_OBJ(collection);
+        skp_string_flatten(string);
+        if ((size_t)index >= string->data.v_string.length ||
+            skp_string_char_count(string) == 0) {
+            return 0;
+        }
+        size_t next = skp_string_next_char(string, (size_t)index);
+        *item = SKP_OBJ_VAL(skp_new_string_len(string->data.v_string.chars + index,
+                                               next - (size_t)index));
+        *position = SKP_INT_VAL((skp_int)next);
+        return 1;
+    }
+    
+    if (SKP_IS_DICT(collection)) {
+        /* الموضع فهرس في مصفوفة المدخلات يتخطى المحذوفة */
+        size_t next = (size_t)index;
+        skp_dict_entry_t* entry;
+        if (!skp_dict_next(SKP_AS_OBJ(collection), &next, &entry)) return 0;
+        skp_incref(entry->key);
+        *item = SKP_OBJ_VAL(entry->key);
+        *position = SKP_INT_VAL(next);
+        return 1;
+    }
+    
+    return -1;
+}
+
+static skp_result_t vm_execute(skp_vm_t* vm);
+
 skp_result_t vm_run(skp_vm_t* vm, chunk_t* chunk) {
+    vm_sync_globals(vm);
+    
     call_frame_t* frame = &vm->frames[vm->frame_count++];
+    frame->closure = NULL;
     frame->chunk = chunk;
     frame->ip = chunk->code;
     frame->slots = vm->stack;
     
     vm->running = 1;
+    vm->had_error = 0;
     
+    /* الكائنات المُنشأة أثناء التنفيذ وحدها تُخصص في كومة الجهاز */
+    skp_heap_t* previous = skp_heap_use(&vm->heap);
+    skp_result_t result = vm_execute(vm);
+    skp_heap_use(previous);
+    
+    return result;
+}
+
+static skp_result_t vm_execute(skp_vm_t* vm) {
+    call_frame_t* frame = &vm->frames[vm->frame_count - 1];
+
 #define READ_BYTE() (*frame->ip++)
 #define READ_SHORT() (frame->ip += 2, (uint16_t)((frame->ip[-2] << 8) | frame->ip[-1]))
 #define READ_CONSTANT() (frame->chunk->constants[READ_BYTE()])
-#define BINARY_OP(value_type, op) \
+#define READ_CACHE() (&frame->chunk->caches[READ_SHORT()])
+/* عملية حسابية بمسار سريع للأعداد الصحيحة دون تخصيص */
+#define ARITH_OP(int_op, func, symbol) \
+    do { \
+        skp_value_t b = vm_pop(vm); \
+        skp_value_t a = vm_pop(vm); \
+        if (SKP_IS_INT(a) && SKP_IS_INT(b)) { \
+            vm_push(vm, SKP_INT_VAL(int_op(SKP_AS_INT(a), SKP_AS_INT(b)))); \
+        } else { \
+            skp_value_t result = func(a, b); \
+            if (SKP_IS_NULL(result)) { \
+                vm_runtime_error(vm, "العملية '%s' غير مدعومة بين %s و %s", symbol, \
+                                 skp_type_name(a.type), skp_type_name(b.type)); \
+                return SKP_RUNTIME_ERROR; \
+            } \
+            vm_push(vm, result); \
+        } \
+    } while (false)
+#define COMPARE_OP(op, func) \
     do { \
-        skp_object_t* b = vm_pop(vm); \
-        skp_object_t* a = vm_pop(vm); \
-        skp_double result = skp_to_float(a) op skp_to_float(b); \
-        vm_push(vm, skp_new_float(result)); \
+        skp_value_t b = vm_pop(vm); \
+        skp_value_t a = vm_pop(vm); \
+        if (SKP_IS_INT(a) && SKP_IS_INT(b)) { \
+            vm_push(vm, SKP_BOOL_VAL(SKP_AS_INT(a) op SKP_AS_INT(b))); \
+        } else { \
+            vm_push(vm, SKP_BOOL_VAL(func(a, b))); \
+        } \
+    } while (false)
+/* التعليمة العامة تتخصص في مكانها حسب نوع المعاملين */
+#define QUICKEN(int_op, float_op) \
+    do { \
+        skp_value_t b = vm_peek(vm, 0); \
+        skp_value_t a = vm_peek(vm, 1); \
+        if (SKP_IS_INT(a) && SKP_IS_INT(b)) { \
+            frame->ip[-1] = int_op; \
+        } else if (SKP_IS_FLOAT(a) && SKP_IS_FLOAT(b)) { \
+            frame->ip[-1] = float_op; \
+        } \
+    } while (false)
+/* المتغير المخصص يعود إلى التعليمة العامة ويعيد تنفيذها إذا خالف النوع */
+#define SPECIALIZED_OP(is_type, generic, result) \
+    do { \
+        skp_value_t b = vm_peek(vm, 0); \
+        skp_value_t a = vm_peek(vm, 1); \
+        if (!is_type(a) || !is_type(b)) { \
+            frame->ip[-1] = generic; \
+            frame->ip--; \
+            DISPATCH(); \
+        } \
+        vm->stack_top--; \
+        vm->stack_top[-1] = result; \
+    } while (false)
+#define BITWISE_OP(op) \
+    do { \
+        skp_value_t b = vm_pop(vm); \
+        skp_value_t a = vm_pop(vm); \
+        vm_push(vm, SKP_INT_VAL(skp_to_int(a) op skp_to_int(b))); \
+    } while (false)
+#define SHIFT_OP(func) \
+    do { \
+        skp_value_t b = vm_pop(vm); \
+        skp_value_t a = vm_pop(vm); \
+        vm_push(vm, SKP_INT_VAL(func(skp_to_int(a), skp_to_int(b)))); \
+    } while (false)
+/* نقطة آمنة للجمع: كل القيم الحية على المكدس أو في الجذور، فيجوز نقل
+ * الكائنات. تُفحص عند القفز للخلف والاستدعاء، فلا تطول حلقة دونها */
+#define SAFEPOINT() \
+    do { \
+        if (vm->heap.gc_requested) vm_collect_step(vm); \
     } while (false)
     
-    while (vm->running) {
+    uint8_t instruction;
+
 #ifdef DEBUG_TRACE_EXECUTION
-        printf("          ");
-        for (skp_object_t** slot = vm->stack; slot < vm->stack_top; slot++) {
-            printf("[ ");
-            skp_print(*slot);
-            printf(" ]");
-        }
-        printf("\n");
-        disassemble_instruction(frame->chunk, (int)(frame->ip - frame->chunk->code));
+#define TRACE_INSTRUCTION() \
+    do { \
+        printf("          "); \
+        for (skp_value_t* slot = vm->stack; slot < vm->stack_top; slot++) { \
+            printf("[ "); \
+            skp_print(*slot); \
+            printf(" ]"); \
+        } \
+        printf("\n"); \
+        disassemble_instruction(frame->chunk, (int)(frame->ip - frame->chunk->code)); \
+    } while (false)
+#else
+#define TRACE_INSTRUCTION() do { } while (false)
+#endif
+
+#ifdef SKP_COMPUTED_GOTO
+    /* جدول القفز بترتيب opcode_t: كل معالج يقفز مباشرة إلى معالج التعليمة التالية */
+    static void* dispatch_table[] = {
+        &&code_OP_CONST_INT,
+        &&code_OP_CONST_FLOAT,
+        &&code_OP_CONST_STRING,
+        &&code_OP_CONST_TRUE,
+        &&code_OP_CONST_FALSE,
+        &&code_OP_CONST_NULL,
+        &&code_OP_CONST_LIST,
+        &&code_OP_CONST_DICT,
+        &&code_OP_GET_LOCAL,
+        &&code_OP_SET_LOCAL,
+        &&code_OP_GET_GLOBAL,
+        &&code_OP_SET_GLOBAL,
+        &&code_OP_GET_UPVALUE,
+        &&code_OP_SET_UPVALUE,
+        &&code_OP_GET_FIELD,
+        &&code_OP_SET_FIELD,
+        &&code_OP_GET_INDEX,
+        &&code_OP_SET_INDEX,
+        &&code_OP_DEFINE_GLOBAL,
+        &&code_OP_ADD,
+        &&code_OP_SUB,
+        &&code_OP_MUL,
+        &&code_OP_DIV,
+        &&code_OP_MOD,
+        &&code_OP_POW,
+        &&code_OP_NEG,
+        &&code_OP_NOT,
+        &&code_OP_AND,
+        &&code_OP_OR,
+        &&code_OP_EQ,
+        &&code_OP_NE,
+        &&code_OP_LT,
+        &&code_OP_GT,
+        &&code_OP_LE,
+        &&code_OP_GE,
+        &&code_OP_BIT_AND,
+        &&code_OP_BIT_OR,
+        &&code_OP_BIT_XOR,
+        &&code_OP_BIT_NOT,
+        &&code_OP_SHL,
+        &&code_OP_SHR,
+        &&code_OP_JUMP,
+        &&code_OP_JUMP_IF_FALSE,
+        &&code_OP_JUMP_IF_TRUE,
+        &&code_OP_LOOP,
+        &&code_OP_ITER_NEXT,
+        &&code_OP_CALL,
+        &&code_OP_INVOKE,
+        &&code_OP_RETURN,
+        &&code_OP_RETURN_VOID,
+        &&code_OP_CLOSURE,
+        &&code_OP_CLOSE_UPVALUE,
+        &&code_OP_CLASS,
+        &&code_OP_METHOD,
+        &&code_OP_INHERIT,
+        &&code_unknown,       /* OP_GET_SUPER */
+        &&code_unknown,       /* OP_SUPER_INVOKE */
+        &&code_unknown,       /* OP_THROW */
+        &&code_unknown,       /* OP_TRY_START */
+        &&code_unknown,       /* OP_TRY_END */
+        &&code_unknown,       /* OP_CATCH */
+        &&code_unknown,       /* OP_FINALLY */
+        &&code_OP_ADD_INT,
+        &&code_OP_ADD_FLOAT,
+        &&code_OP_SUB_INT,
+        &&code_OP_SUB_FLOAT,
+        &&code_OP_MUL_INT,
+        &&code_OP_MUL_FLOAT,
+        &&code_OP_LT_INT,
+        &&code_OP_LT_FLOAT,
+        &&code_OP_GT_INT,
+        &&code_OP_GT_FLOAT,
+        &&code_OP_LE_INT,
+        &&code_OP_LE_FLOAT,
+        &&code_OP_GE_INT,
+        &&code_OP_GE_FLOAT,
+        &&code_OP_SET_LOCAL_POP,
+        &&code_OP_SET_GLOBAL_POP,
+        &&code_OP_IS_NULL,
+        &&code_OP_GET_LOCAL_GET_LOCAL,
+        &&code_OP_GET_LOCAL_CONST_ADD,
+        &&code_OP_LT_JUMP_IF_FALSE,
+        &&code_OP_INC_LOCAL,
+        &&code_OP_CALL_GLOBAL,
+        &&code_OP_POP,
+        &&code_OP_DUP,
+        &&code_OP_SWAP,
+        &&code_OP_PRINT,
+        &&code_OP_IMPORT,
+        &&code_OP_EXPORT,
+        &&code_OP_HALT
+    };
+
+#define CASE(op) code_##op
+#define CASE_UNKNOWN code_unknown
+#define DISPATCH() \
+    do { \
+        TRACE_INSTRUCTION(); \
+        goto *dispatch_table[instruction = READ_BYTE()]; \
+    } while (false)
+    
+    DISPATCH();
+#else
+#define CASE(op) case op
+#define CASE_UNKNOWN default
+#define DISPATCH() goto dispatch
+
+dispatch:
+    TRACE_INSTRUCTION();
+    switch (instruction = READ_BYTE())
 #endif
+    {
+        CASE(OP_CONST_INT): {
+            constant_t constant = READ_CONSTANT();
+            vm_push(vm, SKP_INT_VAL(constant.value.int_val));
+            DISPATCH();
+        }
         
-        uint8_t instruction;
-        switch (instruction = READ_BYTE()) {
-            case OP_CONST_INT: {
-                constant_t constant = READ_CONSTANT();
-                vm_push(vm, skp_new_int(constant.value.int_val));
-                break;
-            }
-                
-            case OP_CONST_FLOAT: {
-                constant_t constant = READ_CONSTANT();
-                vm_push(vm, skp_new_float(constant.value.float_val));
-                break;
-            }
-                
-            case OP_CONST_STRING: {
-                constant_t constant = READ_CONSTANT();
-                vm_push(vm, skp_new_string(constant.value.string_val));
-                break;
-            }
-                
-            case OP_CONST_TRUE:
-                vm_push(vm, skp_new_bool(1));
-                break;
-                
-            case OP_CONST_FALSE:
-                vm_push(vm, skp_new_bool(0));
-                break;
-                
-            case OP_CONST_NULL:
-                vm_push(vm, skp_new_null());
-                break;
-                
-            case OP_CONST_LIST: {
-                uint8_t count = READ_BYTE();
-                skp_object_t* list = skp_list_create();
-                for (int i = count - 1; i >= 0; i--) {
-                    skp_list_append(list, vm_peek(vm, i));
-                }
-                vm_popn(vm, count);
-                vm_push(vm, list);
-                break;
-            }
-                
-            case OP_CONST_DICT: {
-                uint8_t count = READ_BYTE();
-                skp_object_t* dict = skp_dict_create();
-                for (int i = count - 1; i >= 0; i--) {
-                    skp_object_t* value = vm_pop(vm);
-                    skp_object_t* key = vm_pop(vm);
-                    if (skp_get_type(key) != SKP_TYPE_STRING) {
-                        vm_runtime_error(vm, "المفتاح يجب أن يكون نصاً");
-                        return SKP_RUNTIME_ERROR;
-                    }
-                    skp_dict_set(dict, skp_to_string(key), value);
-                }
-                vm_push(vm, dict);
-                break;
-            }
-                
-            case OP_GET_LOCAL: {
-                uint8_t slot = READ_BYTE();
-                vm_push(vm, frame->slots[slot]);
-                break;
-            }
-                
-            case OP_SET_LOCAL: {
-                uint8_t slot = READ_BYTE();
-                frame->slots[slot] = vm_peek(vm, 0);
-                break;
+        CASE(OP_CONST_FLOAT): {
+            constant_t constant = READ_CONSTANT();
+            vm_push(vm, SKP_FLOAT_VAL(constant.value.float_val));
+            DISPATCH();
+        }
+        
+        CASE(OP_CONST_STRING): {
+            /* الثابت محتجز فلا يُنسخ؛ المرجع الإضافي يقوم مقام مرجع الإنشاء */
+            skp_object_t* string = READ_CONSTANT().value.string_val;
+            skp_incref(string);
+            vm_push(vm, SKP_OBJ_VAL(string));
+            DISPATCH();
+        }
+        
+        CASE(OP_CONST_TRUE):
+            vm_push(vm, SKP_BOOL_VAL(SKP_TRUE));
+            DISPATCH();
+        
+        CASE(OP_CONST_FALSE):
+            vm_push(vm, SKP_BOOL_VAL(SKP_FALSE));
+            DISPATCH();
+        
+        CASE(OP_CONST_NULL):
+            vm_push(vm, SKP_NULL_VAL);
+            DISPATCH();
+        
+        CASE(OP_CONST_LIST): {
+            uint8_t count = READ_BYTE();
+            skp_object_t* list = skp_new_list();
+            for (int i = count - 1; i >= 0; i--) {
+                skp_list_append(list, vm_peek(vm, i));
             }
-                
-            case OP_GET_GLOBAL: {
-                constant_t name = READ_CONSTANT();
-                skp_object_t* value;
-                if (!skp_dict_get(vm->globals, name.value.string_val, &value)) {
-                    vm_runtime_error(vm, "متغير غير معرف: %s", name.value.string_val);
+            vm_popn(vm, count);
+            vm_push(vm, SKP_OBJ_VAL(list));
+            DISPATCH();
+        }
+        
+        CASE(OP_CONST_DICT): {
+            uint8_t count = READ_BYTE();
+            skp_object_t* dict = skp_new_dict();
+            /* الأزواج على المكدس بالترتيب: مفتاح، قيمة، مفتاح، قيمة... */
+            skp_value_t* pairs = vm->stack_top - count * 2;
+            for (int i = 0; i < count; i++) {
+                skp_value_t key = pairs[i * 2];
+                if (!SKP_IS_STRING(key)) {
+                    vm_runtime_error(vm, "المفتاح يجب أن يكون نصاً");
                     return SKP_RUNTIME_ERROR;
                 }
-                vm_push(vm, value);
-                break;
+                skp_dict_set_key(dict, SKP_AS_OBJ(key), pairs[i * 2 + 1]);
             }
-                
-            case OP_SET_GLOBAL: {
-                constant_t name = READ_CONSTANT();
-                skp_dict_set(vm->globals, name.value.string_val, vm_peek(vm, 0));
-                break;
+            vm_popn(vm, count * 2);
+            vm_push(vm, SKP_OBJ_VAL(dict));
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_LOCAL): {
+            uint8_t slot = READ_BYTE();
+            vm_push(vm, frame->slots[slot]);
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_LOCAL): {
+            uint8_t slot = READ_BYTE();
+            frame->slots[slot] = vm_peek(vm, 0);
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_LOCAL_GET_LOCAL): {
+            uint8_t first = READ_BYTE();
+            uint8_t second = READ_BYTE();
+            vm_push(vm, frame->slots[first]);
+            vm_push(vm, frame->slots[second]);
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_LOCAL_CONST_ADD): {
+            skp_value_t a = frame->slots[READ_BYTE()];
+            constant_t constant = READ_CONSTANT();
+            if (SKP_IS_INT(a) && constant.type == SKP_TYPE_INT) {
+                vm_push(vm, SKP_INT_VAL(skp_int_add(SKP_AS_INT(a), constant.value.int_val)));
+                DISPATCH();
             }
-                
-            case OP_DEFINE_GLOBAL: {
-                constant_t name = READ_CONSTANT();
-                skp_dict_set(vm->globals, name.value.string_val, vm_peek(vm, 0));
-                vm_pop(vm);
-                break;
+            
+            skp_value_t b = constant.type == SKP_TYPE_INT ? SKP_INT_VAL(constant.value.int_val)
+                                                          : SKP_FLOAT_VAL(constant.value.float_val);
+            skp_value_t result = skp_add(a, b);
+            if (SKP_IS_NULL(result)) {
+                vm_runtime_error(vm, "العملية '+' غير مدعومة بين %s و %s",
+                                 skp_type_name(a.type), skp_type_name(b.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_GET_UPVALUE: {
-                uint8_t slot = READ_BYTE();
-                vm_push(vm, *frame->closure->upvalues[slot]->location);
-                break;
+            vm_push(vm, result);
+            DISPATCH();
+        }
+        
+        CASE(OP_INC_LOCAL): {
+            skp_value_t* local = &frame->slots[READ_BYTE()];
+            if (SKP_IS_INT(*local)) {
+                *local = SKP_INT_VAL(skp_int_add(SKP_AS_INT(*local), 1));
+                DISPATCH();
             }
-                
-            case OP_SET_UPVALUE: {
-                uint8_t slot = READ_BYTE();
-                *frame->closure->upvalues[slot]->location = vm_peek(vm, 0);
-                break;
+            
+            skp_value_t result = skp_add(*local, SKP_INT_VAL(1));
+            if (SKP_IS_NULL(result)) {
+                vm_runtime_error(vm, "العملية '+' غير مدعومة بين %s و %s",
+                                 skp_type_name(local->type), skp_type_name(SKP_TYPE_INT));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_GET_FIELD: {
-                constant_t name = READ_CONSTANT();
-                skp_object_t* receiver = vm_peek(vm, 0);
-                
-                if (skp_get_type(receiver) == SKP_TYPE_INSTANCE) {
-                    skp_object_t* value;
-                    if (skp_dict_get(receiver->data.v_object.fields, 
-                                     name.value.string_val, &value)) {
-                        vm_pop(vm);
-                        vm_push(vm, value);
-                        break;
-                    }
-                }
-                
-                if (!vm_bind_method(vm, receiver, name.value.string_val)) {
-                    return SKP_RUNTIME_ERROR;
-                }
-                break;
+            *local = result;
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_LOCAL_POP): {
+            uint8_t slot = READ_BYTE();
+            frame->slots[slot] = vm_pop(vm);
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_GLOBAL): {
+            uint16_t slot = READ_SHORT();
+            skp_value_t value = vm->global_values[slot];
+            if (value.type == SKP_TYPE_UNDEFINED) {
+                vm_runtime_error(vm, "متغير غير معرف: %s", vm_global_name(vm, slot));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_SET_FIELD: {
-                constant_t name = READ_CONSTANT();
-                skp_object_t* receiver = vm_peek(vm, 1);
-                
-                if (skp_get_type(receiver) != SKP_TYPE_INSTANCE) {
-                    vm_runtime_error(vm, "يمكن تعيين الحقول فقط للكائنات");
-                    return SKP_RUNTIME_ERROR;
-                }
-                
-                skp_dict_set(receiver->data.v_object.fields, 
-                            name.value.string_val, vm_peek(vm, 0));
-                skp_object_t* value = vm_pop(vm);
-                vm_pop(vm);
-                vm_push(vm, value);
-                break;
+            vm_push(vm, value);
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_GLOBAL): {
+            uint16_t slot = READ_SHORT();
+            if (vm->global_values[slot].type == SKP_TYPE_UNDEFINED) {
+                vm_runtime_error(vm, "متغير غير معرف: %s", vm_global_name(vm, slot));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_GET_INDEX: {
-                skp_object_t* index = vm_pop(vm);
-                skp_object_t* object = vm_pop(vm);
-                skp_object_t* result = skp_get_index(object, index);
-                if (!result) {
-                    vm_runtime_error(vm, "فهرس غير صالح");
-                    return SKP_RUNTIME_ERROR;
-                }
-                vm_push(vm, result);
-                break;
+            vm->global_values[slot] = vm_peek(vm, 0);
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_GLOBAL_POP): {
+            uint16_t slot = READ_SHORT();
+            if (vm->global_values[slot].type == SKP_TYPE_UNDEFINED) {
+                vm_runtime_error(vm, "متغير غير معرف: %s", vm_global_name(vm, slot));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_SET_INDEX: {
-                skp_object_t* value = vm_pop(vm);
-                skp_object_t* index = vm_pop(vm);
-                skp_object_t* object = vm_pop(vm);
-                if (!skp_set_index(object, index, value)) {
-                    vm_runtime_error(vm, "فهرس غير صالح");
-                    return SKP_RUNTIME_ERROR;
-                }
-                vm_push(vm, value);
-                break;
+            vm->global_values[slot] = vm_pop(vm);
+            DISPATCH();
+        }
+        
+        CASE(OP_DEFINE_GLOBAL): {
+            uint16_t slot = READ_SHORT();
+            vm->global_values[slot] = vm_pop(vm);
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_UPVALUE): {
+            uint8_t slot = READ_BYTE();
+            vm_push(vm, *frame->closure->data.v_closure.upvalues[slot]->location);
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_UPVALUE): {
+            uint8_t slot = READ_BYTE();
+            skp_upvalue_t* upvalue = frame->closure->data.v_closure.upvalues[slot];
+            skp_value_t value = vm_peek(vm, 0);
+            *upvalue->location = value;
+            if (upvalue->location == &upvalue->closed) vm_upvalue_barrier(upvalue, value);
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_FIELD): {
+            skp_object_t* name = READ_CONSTANT().value.string_val;
+            inline_cache_t* cache = READ_CACHE();
+            skp_value_t receiver = vm_peek(vm, 0);
+            
+            if (receiver.type != SKP_TYPE_OBJECT) {
+                vm_runtime_error(vm, "لا يمكن قراءة الخاصية '%s' من قيمة من نوع %s",
+                                 name->data.v_string.chars, skp_type_name(receiver.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_ADD: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                
-                if (skp_get_type(a) == SKP_TYPE_STRING && skp_get_type(b) == SKP_TYPE_STRING) {
-                    vm_push(vm, skp_string_concat(a, b));
-                } else {
-                    vm_push(vm, skp_add(a, b));
-                }
-                break;
+            
+            skp_object_t* instance = SKP_AS_OBJ(receiver);
+            inline_cache_entry_t* entry = vm_cache_entry(cache, instance, name);
+            if (entry->slot >= 0) {
+                vm->stack_top[-1] = instance->data.v_object.fields[entry->slot];
+                DISPATCH();
             }
-                
-            case OP_SUB:
-                BINARY_OP(SKP_TYPE_FLOAT, -);
-                break;
-                
-            case OP_MUL:
-                BINARY_OP(SKP_TYPE_FLOAT, *);
-                break;
-                
-            case OP_DIV:
-                BINARY_OP(SKP_TYPE_FLOAT, /);
-                break;
-                
-            case OP_MOD: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_mod(a, b));
-                break;
+            
+            if (!entry->method) {
+                vm_runtime_error(vm, "خاصية غير معرفة: %s", name->data.v_string.chars);
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_POW: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_pow(a, b));
-                break;
+            vm->stack_top[-1] = SKP_OBJ_VAL(skp_new_bound_method(receiver, entry->method));
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_FIELD): {
+            skp_object_t* name = READ_CONSTANT().value.string_val;
+            inline_cache_t* cache = READ_CACHE();
+            skp_value_t receiver = vm_peek(vm, 1);
+            
+            if (receiver.type != SKP_TYPE_OBJECT) {
+                vm_runtime_error(vm, "يمكن تعيين الحقول فقط للكائنات");
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_NEG: {
-                skp_object_t* value = vm_pop(vm);
-                vm_push(vm, skp_neg(value));
-                break;
+            
+            skp_object_t* instance = SKP_AS_OBJ(receiver);
+            inline_cache_entry_t* entry = vm_cache_entry(cache, instance, name);
+            skp_value_t value = vm_pop(vm);
+            
+            /* حقل جديد لهذا الشكل: يُحفظ الانتقال فتصير الإضافات التالية مباشرة */
+            if (entry->slot < 0) {
+                entry->transition = skp_shape_transition(instance->data.v_object.shape, name);
+                entry->slot = (int32_t)entry->transition->field_count - 1;
             }
-                
-            case OP_NOT: {
-                skp_object_t* value = vm_pop(vm);
-                vm_push(vm, skp_new_bool(!skp_is_truthy(value)));
-                break;
+            
+            if (entry->transition) {
+                skp_object_add_field(instance, entry->transition, value);
+            } else {
+                skp_value_t* field = &instance->data.v_object.fields[entry->slot];
+                skp_write_barrier(instance, value);
+                skp_value_incref(value);
+                skp_value_decref(*field);
+                *field = value;
             }
-                
-            case OP_AND: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_bool(skp_is_truthy(a) && skp_is_truthy(b)));
-                break;
+            
+            vm->stack_top[-1] = value;
+            DISPATCH();
+        }
+        
+        CASE(OP_GET_INDEX): {
+            skp_value_t index = vm_pop(vm);
+            skp_value_t object = vm_pop(vm);
+            skp_value_t result;
+            if (!skp_get_index(object, index, &result)) {
+                vm_runtime_error(vm, "فهرس غير صالح");
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_OR: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_bool(skp_is_truthy(a) || skp_is_truthy(b)));
-                break;
+            vm_push(vm, result);
+            DISPATCH();
+        }
+        
+        CASE(OP_SET_INDEX): {
+            skp_value_t value = vm_pop(vm);
+            skp_value_t index = vm_pop(vm);
+            skp_value_t object = vm_pop(vm);
+            if (!skp_set_index(object, index, value)) {
+                vm_runtime_error(vm, "فهرس غير صالح");
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_EQ: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_bool(skp_eq(a, b)));
-                break;
+            vm_push(vm, value);
+            DISPATCH();
+        }
+        
+        CASE(OP_ADD):
+            QUICKEN(OP_ADD_INT, OP_ADD_FLOAT);
+            ARITH_OP(skp_int_add, skp_add, "+");
+            DISPATCH();
+        
+        CASE(OP_ADD_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_ADD, SKP_INT_VAL(skp_int_add(SKP_AS_INT(a), SKP_AS_INT(b))));
+            DISPATCH();
+        
+        CASE(OP_ADD_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_ADD, SKP_FLOAT_VAL(SKP_AS_FLOAT(a) + SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_SUB):
+            QUICKEN(OP_SUB_INT, OP_SUB_FLOAT);
+            ARITH_OP(skp_int_sub, skp_sub, "-");
+            DISPATCH();
+        
+        CASE(OP_SUB_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_SUB, SKP_INT_VAL(skp_int_sub(SKP_AS_INT(a), SKP_AS_INT(b))));
+            DISPATCH();
+        
+        CASE(OP_SUB_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_SUB, SKP_FLOAT_VAL(SKP_AS_FLOAT(a) - SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_MUL):
+            QUICKEN(OP_MUL_INT, OP_MUL_FLOAT);
+            ARITH_OP(skp_int_mul, skp_mul, "*");
+            DISPATCH();
+        
+        CASE(OP_MUL_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_MUL, SKP_INT_VAL(skp_int_mul(SKP_AS_INT(a), SKP_AS_INT(b))));
+            DISPATCH();
+        
+        CASE(OP_MUL_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_MUL, SKP_FLOAT_VAL(SKP_AS_FLOAT(a) * SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_DIV): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            if (SKP_IS_NUMBER(b) && SKP_AS_NUMBER(b) == 0) {
+                vm_runtime_error(vm, "قسمة على صفر");
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_NE: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_bool(!skp_eq(a, b)));
-                break;
+            skp_value_t result = skp_div(a, b);
+            if (SKP_IS_NULL(result)) {
+                vm_runtime_error(vm, "العملية '/' غير مدعومة بين %s و %s",
+                                 skp_type_name(a.type), skp_type_name(b.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_LT:
-                BINARY_OP(SKP_TYPE_BOOL, <);
-                break;
-                
-            case OP_GT:
-                BINARY_OP(SKP_TYPE_BOOL, >);
-                break;
-                
-            case OP_LE:
-                BINARY_OP(SKP_TYPE_BOOL, <=);
-                break;
-                
-            case OP_GE:
-                BINARY_OP(SKP_TYPE_BOOL, >=);
-                break;
-                
-            case OP_BIT_AND: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_int(skp_to_int(a) & skp_to_int(b)));
-                break;
+            vm_push(vm, result);
+            DISPATCH();
+        }
+        
+        CASE(OP_MOD): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            if (SKP_IS_NUMBER(b) && SKP_AS_NUMBER(b) == 0) {
+                vm_runtime_error(vm, "قسمة على صفر");
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_BIT_OR: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_int(skp_to_int(a) | skp_to_int(b)));
-                break;
+            skp_value_t result = skp_mod(a, b);
+            if (SKP_IS_NULL(result)) {
+                vm_runtime_error(vm, "العملية '%%' غير مدعومة بين %s و %s",
+                                 skp_type_name(a.type), skp_type_name(b.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_BIT_XOR: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_int(skp_to_int(a) ^ skp_to_int(b)));
-                break;
+            vm_push(vm, result);
+            DISPATCH();
+        }
+        
+        CASE(OP_POW): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            skp_value_t result = skp_pow(a, b);
+            if (SKP_IS_NULL(result)) {
+                vm_runtime_error(vm, "العملية '^' غير مدعومة بين %s و %s",
+                                 skp_type_name(a.type), skp_type_name(b.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_BIT_NOT: {
-                skp_object_t* value = vm_pop(vm);
-                vm_push(vm, skp_new_int(~skp_to_int(value)));
-                break;
+            vm_push(vm, result);
+            DISPATCH();
+        }
+        
+        CASE(OP_NEG): {
+            skp_value_t value = vm_pop(vm);
+            if (!SKP_IS_NUMBER(value)) {
+                vm_runtime_error(vm, "لا يمكن نفي قيمة من نوع %s", skp_type_name(value.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_SHL: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_int(skp_to_int(a) << skp_to_int(b)));
-                break;
+            vm_push(vm, skp_neg(value));
+            DISPATCH();
+        }
+        
+        CASE(OP_NOT): {
+            skp_value_t value = vm_pop(vm);
+            vm_push(vm, SKP_BOOL_VAL(!skp_to_bool(value)));
+            DISPATCH();
+        }
+        
+        CASE(OP_AND): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            vm_push(vm, SKP_BOOL_VAL(skp_to_bool(a) && skp_to_bool(b)));
+            DISPATCH();
+        }
+        
+        CASE(OP_OR): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            vm_push(vm, SKP_BOOL_VAL(skp_to_bool(a) || skp_to_bool(b)));
+            DISPATCH();
+        }
+        
+        CASE(OP_EQ): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            vm_push(vm, SKP_BOOL_VAL(skp_eq(a, b)));
+            DISPATCH();
+        }
+        
+        CASE(OP_IS_NULL): {
+            skp_value_t value = vm_pop(vm);
+            vm_push(vm, SKP_BOOL_VAL(SKP_IS_NULL(value)));
+            DISPATCH();
+        }
+        
+        CASE(OP_NE): {
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            vm_push(vm, SKP_BOOL_VAL(!skp_eq(a, b)));
+            DISPATCH();
+        }
+        
+        CASE(OP_LT):
+            QUICKEN(OP_LT_INT, OP_LT_FLOAT);
+            COMPARE_OP(<, skp_lt);
+            DISPATCH();
+        
+        CASE(OP_LT_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_LT, SKP_BOOL_VAL(SKP_AS_INT(a) < SKP_AS_INT(b)));
+            DISPATCH();
+        
+        CASE(OP_LT_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_LT, SKP_BOOL_VAL(SKP_AS_FLOAT(a) < SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_GT):
+            QUICKEN(OP_GT_INT, OP_GT_FLOAT);
+            COMPARE_OP(>, skp_gt);
+            DISPATCH();
+        
+        CASE(OP_GT_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_GT, SKP_BOOL_VAL(SKP_AS_INT(a) > SKP_AS_INT(b)));
+            DISPATCH();
+        
+        CASE(OP_GT_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_GT, SKP_BOOL_VAL(SKP_AS_FLOAT(a) > SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_LE):
+            QUICKEN(OP_LE_INT, OP_LE_FLOAT);
+            COMPARE_OP(<=, skp_le);
+            DISPATCH();
+        
+        CASE(OP_LE_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_LE, SKP_BOOL_VAL(SKP_AS_INT(a) <= SKP_AS_INT(b)));
+            DISPATCH();
+        
+        CASE(OP_LE_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_LE, SKP_BOOL_VAL(SKP_AS_FLOAT(a) <= SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_GE):
+            QUICKEN(OP_GE_INT, OP_GE_FLOAT);
+            COMPARE_OP(>=, skp_ge);
+            DISPATCH();
+        
+        CASE(OP_GE_INT):
+            SPECIALIZED_OP(SKP_IS_INT, OP_GE, SKP_BOOL_VAL(SKP_AS_INT(a) >= SKP_AS_INT(b)));
+            DISPATCH();
+        
+        CASE(OP_GE_FLOAT):
+            SPECIALIZED_OP(SKP_IS_FLOAT, OP_GE, SKP_BOOL_VAL(SKP_AS_FLOAT(a) >= SKP_AS_FLOAT(b)));
+            DISPATCH();
+        
+        CASE(OP_BIT_AND):
+            BITWISE_OP(&);
+            DISPATCH();
+        
+        CASE(OP_BIT_OR):
+            BITWISE_OP(|);
+            DISPATCH();
+        
+        CASE(OP_BIT_XOR):
+            BITWISE_OP(^);
+            DISPATCH();
+        
+        CASE(OP_BIT_NOT): {
+            skp_value_t value = vm_pop(vm);
+            vm_push(vm, SKP_INT_VAL(~skp_to_int(value)));
+            DISPATCH();
+        }
+        
+        CASE(OP_SHL):
+            SHIFT_OP(skp_int_shl);
+            DISPATCH();
+        
+        CASE(OP_SHR):
+            SHIFT_OP(skp_int_shr);
+            DISPATCH();
+        
+        CASE(OP_JUMP): {
+            uint16_t offset = READ_SHORT();
+            frame->ip += offset;
+            DISPATCH();
+        }
+        
+        CASE(OP_JUMP_IF_FALSE): {
+            uint16_t offset = READ_SHORT();
+            if (!skp_to_bool(vm_peek(vm, 0))) {
+                frame->ip += offset;
             }
-                
-            case OP_SHR: {
-                skp_object_t* b = vm_pop(vm);
-                skp_object_t* a = vm_pop(vm);
-                vm_push(vm, skp_new_int(skp_to_int(a) >> skp_to_int(b)));
-                break;
+            DISPATCH();
+        }
+        
+        CASE(OP_LT_JUMP_IF_FALSE): {
+            uint16_t offset = READ_SHORT();
+            skp_value_t b = vm_pop(vm);
+            skp_value_t a = vm_pop(vm);
+            int less = SKP_IS_INT(a) && SKP_IS_INT(b) ? SKP_AS_INT(a) < SKP_AS_INT(b) : skp_lt(a, b);
+            if (!less) {
+                frame->ip += offset;
             }
-                
-            case OP_JUMP: {
-                uint16_t offset = READ_SHORT();
+            DISPATCH();
+        }
+        
+        CASE(OP_JUMP_IF_TRUE): {
+            uint16_t offset = READ_SHORT();
+            if (skp_to_bool(vm_peek(vm, 0))) {
                 frame->ip += offset;
-                break;
             }
-                
-            case OP_JUMP_IF_FALSE: {
-                uint16_t offset = READ_SHORT();
-                if (!skp_is_truthy(vm_peek(vm, 0))) {
+            DISPATCH();
+        }
+        
+        CASE(OP_LOOP): {
+            uint16_t offset = READ_SHORT();
+            frame->ip -= offset;
+            SAFEPOINT();
+            DISPATCH();
+        }
+        
+        CASE(OP_ITER_NEXT): {
+            /* slots[slot] المجموعة و slots[slot + 1] موضع التكرار */
+            uint8_t slot = READ_BYTE();
+            uint16_t offset = READ_SHORT();
+            skp_value_t collection = frame->slots[slot];
+            
+            if (SKP_IS_LIST(collection)) {
+                skp_object_t* list = SKP_AS_OBJ(collection);
+                skp_int index = SKP_AS_INT(frame->slots[slot + 1]);
+                if ((size_t)index >= list->data.v_list.count) {
                     frame->ip += offset;
+                    DISPATCH();
                 }
-                break;
+                vm_push(vm, list->data.v_list.items[index]);
+                frame->slots[slot + 1] = SKP_INT_VAL(index + 1);
+                DISPATCH();
             }
-                
-            case OP_JUMP_IF_TRUE: {
-                uint16_t offset = READ_SHORT();
-                if (skp_is_truthy(vm_peek(vm, 0))) {
+            
+            if (SKP_IS_RANGE(collection)) {
+                /* العنصر يُحسب من الموضع فلا تخصيص في الحلقة */
+                skp_object_t* range = SKP_AS_OBJ(collection);
+                skp_int index = SKP_AS_INT(frame->slots[slot + 1]);
+                if (index >= range->data.v_range.count) {
                     frame->ip += offset;
+                    DISPATCH();
                 }
-                break;
+                vm_push(vm, SKP_INT_VAL(skp_range_at(range, index)));
+                frame->slots[slot + 1] = SKP_INT_VAL(index + 1);
+                DISPATCH();
             }
-                
-            case OP_LOOP: {
-                uint16_t offset = READ_SHORT();
-                frame->ip -= offset;
-                break;
+            
+            skp_value_t item;
+            int status = vm_iter_next(collection, &frame->slots[slot + 1], &item);
+            if (status < 0) {
+                vm_runtime_error(vm, "لا يمكن التكرار على قيمة من نوع %s",
+                                 skp_type_name(collection.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_CALL: {
-                int arg_count = READ_BYTE();
-                if (!vm_call_value(vm, vm_peek(vm, arg_count), arg_count)) {
-                    return SKP_RUNTIME_ERROR;
-                }
-                frame = &vm->frames[vm->frame_count - 1];
-                break;
+            if (status == 0) {
+                frame->ip += offset;
+                DISPATCH();
             }
-                
-            case OP_RETURN: {
-                skp_object_t* result = vm_pop(vm);
-                vm_close_upvalues(vm, frame->slots);
-                vm->frame_count--;
-                if (vm->frame_count == 0) {
-                    vm_pop(vm);
-                    return SKP_OK;
-                }
-                
-                vm->stack_top = frame->slots;
-                vm_push(vm, result);
-                frame = &vm->frames[vm->frame_count - 1];
-                break;
+            vm_push(vm, item);
+            DISPATCH();
+        }
+        
+        CASE(OP_CALL): {
+            int arg_count = READ_BYTE();
+            SAFEPOINT();
+            if (!vm_call_value(vm, vm_peek(vm, arg_count), arg_count)) {
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_RETURN_VOID: {
-                vm_close_upvalues(vm, frame->slots);
-                vm->frame_count--;
-                if (vm->frame_count == 0) {
-                    return SKP_OK;
-                }
-                
-                vm->stack_top = frame->slots;
-                vm_push(vm, skp_new_null());
-                frame = &vm->frames[vm->frame_count - 1];
-                break;
+            frame = &vm->frames[vm->frame_count - 1];
+            DISPATCH();
+        }
+        
+        CASE(OP_CALL_GLOBAL): {
+            uint16_t slot = READ_SHORT();
+            int arg_count = READ_BYTE();
+            skp_value_t callee = vm->global_values[slot];
+            if (callee.type == SKP_TYPE_UNDEFINED) {
+                vm_runtime_error(vm, "متغير غير معرف: %s", vm_global_name(vm, slot));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_CLOSURE: {
-                constant_t constant = READ_CONSTANT();
-                skp_object_t* function = skp_new_function(constant.value.string_val);
-                vm_push(vm, function);
-                
-                skp_object_t* closure = skp_new_closure(function);
-                vm_pop(vm);
-                vm_push(vm, closure);
-                
-                uint8_t upvalue_count = READ_BYTE();
-                for (int i = 0; i < upvalue_count; i++) {
-                    uint8_t is_local = READ_BYTE();
-                    uint8_t index = READ_BYTE();
-                    if (is_local) {
-                        closure->data.v_closure.upvalues[i] = 
-                            vm_capture_upvalue(vm, frame->slots + index);
-                    } else {
-                        closure->data.v_closure.upvalues[i] = frame->closure->upvalues[index];
-                    }
-                }
-                break;
+            
+            /* الدالة تحت معاملاتها كما يتركها GET_GLOBAL قبل OP_CALL */
+            skp_value_t* args = vm->stack_top - arg_count;
+            memmove(args + 1, args, sizeof(skp_value_t) * (size_t)arg_count);
+            *args = callee;
+            vm->stack_top++;
+            
+            SAFEPOINT();
+            if (!vm_call_value(vm, callee, arg_count)) {
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_CLOSE_UPVALUE:
-                vm_close_upvalues(vm, vm->stack_top - 1);
-                vm_pop(vm);
-                break;
-                
-            case OP_CLASS: {
-                constant_t name = READ_CONSTANT();
-                vm_push(vm, skp_new_class(name.value.string_val));
-                break;
+            frame = &vm->frames[vm->frame_count - 1];
+            DISPATCH();
+        }
+        
+        CASE(OP_INVOKE): {
+            skp_object_t* name = READ_CONSTANT().value.string_val;
+            int arg_count = READ_BYTE();
+            inline_cache_t* cache = READ_CACHE();
+            SAFEPOINT();
+            skp_value_t receiver = vm_peek(vm, arg_count);
+            
+            if (receiver.type != SKP_TYPE_OBJECT) {
+                vm_runtime_error(vm, "لا يمكن قراءة الخاصية '%s' من قيمة من نوع %s",
+                                 name->data.v_string.chars, skp_type_name(receiver.type));
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_METHOD: {
-                constant_t name = READ_CONSTANT();
-                skp_object_t* method = vm_peek(vm, 0);
-                skp_object_t* klass = vm_peek(vm, 1);
-                skp_dict_set(klass->data.v_class.klass->methods, 
-                            name.value.string_val, method);
-                vm_pop(vm);
-                break;
+            
+            /* الحقل يحجب الطريقة التي تحمل الاسم نفسه */
+            skp_object_t* instance = SKP_AS_OBJ(receiver);
+            inline_cache_entry_t* entry = vm_cache_entry(cache, instance, name);
+            int ok;
+            if (entry->slot >= 0) {
+                skp_value_t field = instance->data.v_object.fields[entry->slot];
+                vm->stack_top[-arg_count - 1] = field;
+                ok = vm_call_value(vm, field, arg_count);
+            } else if (entry->method) {
+                ok = vm_call(vm, entry->method, arg_count);
+            } else {
+                vm_runtime_error(vm, "خاصية غير معرفة: %s", name->data.v_string.chars);
+                ok = 0;
             }
-                
-            case OP_INHERIT: {
-                skp_object_t* superclass = vm_peek(vm, 1);
-                skp_object_t* subclass = vm_peek(vm, 0);
-                
-                if (skp_get_type(superclass) != SKP_TYPE_CLASS) {
-                    vm_runtime_error(vm, "الصنف الأب يجب أن يكون صنفاً");
-                    return SKP_RUNTIME_ERROR;
-                }
-                
-                /* نسخ الطرق من الأب */
-                skp_dict_merge(subclass->data.v_class.klass->methods,
-                              superclass->data.v_class.klass->methods);
-                
-                vm_pop(vm);
-                break;
+            
+            if (!ok) {
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_POP:
-                vm_pop(vm);
-                break;
-                
-            case OP_DUP:
-                vm_push(vm, vm_peek(vm, 0));
-                break;
-                
-            case OP_SWAP: {
-                skp_object_t* a = vm_pop(vm);
-                skp_object_t* b = vm_pop(vm);
-                vm_push(vm, a);
-                vm_push(vm, b);
-                break;
+            frame = &vm->frames[vm->frame_count - 1];
+            DISPATCH();
+        }
+        
+        CASE(OP_RETURN): {
+            skp_value_t result = vm_pop(vm);
+            vm_close_upvalues(vm, frame->slots);
+            vm->frame_count--;
+            if (vm->frame_count == 0) {
+                vm->stack_top = vm->stack;
+                return SKP_OK;
             }
-                
-            case OP_PRINT: {
-                skp_object_t* value = vm_pop(vm);
-                skp_print(value);
-                printf("\n");
-                break;
+            
+            vm->stack_top = frame->slots;
+            vm_push(vm, result);
+            frame = &vm->frames[vm->frame_count - 1];
+            DISPATCH();
+        }
+        
+        CASE(OP_RETURN_VOID): {
+            vm_close_upvalues(vm, frame->slots);
+            vm->frame_count--;
+            if (vm->frame_count == 0) {
+                vm->stack_top = vm->stack;
+                return SKP_OK;
             }
-                
-            case OP_IMPORT: {
-                constant_t name = READ_CONSTANT();
-                /* TODO: تنفيذ الاستيراد */
-                break;
+            
+            vm->stack_top = frame->slots;
+            vm_push(vm, SKP_NULL_VAL);
+            frame = &vm->frames[vm->frame_count - 1];
+            DISPATCH();
+        }
+        
+        CASE(OP_CLOSURE): {
+            constant_t constant = READ_CONSTANT();
+            skp_object_t* function = constant.value.func_val;
+            skp_object_t* closure = skp_new_closure(function);
+            vm_push(vm, SKP_OBJ_VAL(closure));
+            
+            for (int i = 0; i < closure->data.v_closure.upvalue_count; i++) {
+                uint8_t is_local = READ_BYTE();
+                uint8_t index = READ_BYTE();
+                skp_upvalue_t* upvalue = is_local
+                    ? vm_capture_upvalue(vm, frame->slots + index)
+                    : frame->closure->data.v_closure.upvalues[index];
+                upvalue->owners++;
+                closure->data.v_closure.upvalues[i] = upvalue;
             }
-                
-            case OP_EXPORT: {
-                constant_t name = READ_CONSTANT();
-                /* TODO: تنفيذ التصدير */
-                break;
+            DISPATCH();
+        }
+        
+        CASE(OP_CLOSE_UPVALUE):
+            vm_close_upvalues(vm, vm->stack_top - 1);
+            vm_pop(vm);
+            DISPATCH();
+        
+        CASE(OP_CLASS): {
+            constant_t name = READ_CONSTANT();
+            vm_push(vm, SKP_OBJ_VAL(skp_new_class(name.value.string_val->data.v_string.chars)));
+            DISPATCH();
+        }
+        
+        CASE(OP_METHOD): {
+            constant_t name = READ_CONSTANT();
+            skp_value_t method = vm_peek(vm, 0);
+            if (vm_peek(vm, 1).type != SKP_TYPE_CLASS) {
+                vm_runtime_error(vm, "الطريقة تُعرف على صنف فقط");
+                return SKP_RUNTIME_ERROR;
             }
-                
-            case OP_HALT:
-                vm->running = 0;
-                return SKP_OK;
-                
-            default:
-                vm_runtime_error(vm, "كود عملية غير معروف: %d", instruction);
+            skp_class_t* klass = SKP_AS_OBJ(vm_peek(vm, 1))->data.v_class.klass;
+            skp_dict_set_key(klass->methods, name.value.string_val, method);
+            vm_pop(vm);
+            DISPATCH();
+        }
+        
+        CASE(OP_INHERIT): {
+            skp_value_t superclass = vm_peek(vm, 0);
+            skp_value_t subclass = vm_peek(vm, 1);
+            
+            if (superclass.type != SKP_TYPE_CLASS || subclass.type != SKP_TYPE_CLASS) {
+                vm_runtime_error(vm, "الصنف الأب يجب أن يكون صنفاً");
                 return SKP_RUNTIME_ERROR;
+            }
+            
+            /* نسخ الطرق من الأب قبل تعريف طرق الصنف حتى تتجاوزها */
+            skp_class_t* parent = SKP_AS_OBJ(superclass)->data.v_class.klass;
+            skp_class_t* child = SKP_AS_OBJ(subclass)->data.v_class.klass;
+            skp_dict_merge(child->methods, parent->methods);
+            child->parent = parent;
+            
+            vm_pop(vm);
+            DISPATCH();
         }
+        
+        CASE(OP_POP):
+            vm_pop(vm);
+            DISPATCH();
+        
+        CASE(OP_DUP):
+            vm_push(vm, vm_peek(vm, 0));
+            DISPATCH();
+        
+        CASE(OP_SWAP): {
+            skp_value_t a = vm_pop(vm);
+            skp_value_t b = vm_pop(vm);
+            vm_push(vm, a);
+            vm_push(vm, b);
+            DISPATCH();
+        }
+        
+        CASE(OP_PRINT): {
+            skp_value_t value = vm_pop(vm);
+            skp_println(value);
+            DISPATCH();
+        }
+        
+        CASE(OP_IMPORT):
+        CASE(OP_EXPORT):
+            /* TODO: تنفيذ الاستيراد والتصدير */
+            frame->ip++;
+            DISPATCH();
+        
+        CASE(OP_HALT):
+            vm->frame_count--;
+            vm->running = 0;
+            return SKP_OK;
+        
+        CASE_UNKNOWN:
+            vm_runtime_error(vm, "كود عملية غير معروف: %d", instruction);
+            return SKP_RUNTIME_ERROR;
     }
-    
+
+
 #undef READ_BYTE
 #undef READ_SHORT
 #undef READ_CONSTANT
-#undef BINARY_OP
+#undef READ_CACHE
+#undef ARITH_OP
+#undef COMPARE_OP
+#undef BITWISE_OP
+#undef SHIFT_OP
+#undef QUICKEN
+#undef SPECIALIZED_OP
+#undef SAFEPOINT
     
     return SKP_OK;
 }
@@ -826,20 +1699,32 @@ skp_result_t vm_run(skp_vm_t* vm, chunk_t* chunk) {
 /* ========== دوال native مدمجة ========== */
 
 void vm_define_native(skp_vm_t* vm, const char* name, skp_native_func_t func) {
-    skp_dict_set(vm->globals, name, skp_new_native(func));
+    int slot = resolve_global(vm->globals, name);
+    vm_sync_globals(vm);
+    
+    /* الفتحة تملك مرجع الإنشاء */
+    skp_value_decref(vm->global_values[slot]);
+    vm->global_values[slot] = SKP_OBJ_VAL(skp_new_native(func, name));
+}
+
+/* إضافة نص جديد إلى قائمة دون الاحتفاظ بمرجع إضافي */
+static void list_append_string(skp_object_t* list, const char* chars) {
+    skp_object_t* item = skp_new_string(chars);
+    skp_list_append(list, SKP_OBJ_VAL(item));
+    skp_decref(item);
 }
 
 /* دوال الإدخال/الإخراج */
-skp_object_t* native_print(skp_vm_t* vm, int argc, skp_object_t** argv) {
+skp_value_t native_print(skp_vm_t* vm, int argc, skp_value_t* argv) {
     for (int i = 0; i < argc; i++) {
         skp_print(argv[i]);
         if (i < argc - 1) printf(" ");
     }
     printf("\n");
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* native_input(skp_vm_t* vm, int argc, skp_object_t** argv) {
+skp_value_t native_input(skp_vm_t* vm, int argc, skp_value_t* argv) {
     if (argc > 0) {
         skp_print(argv[0]);
     }
@@ -850,37 +1735,41 @@ skp_object_t* native_input(skp_vm_t* vm, int argc, skp_object_t** argv) {
         if (len > 0 && buffer[len - 1] == '\n') {
             buffer[len - 1] = '\0';
         }
-        return skp_new_string(buffer);
+        return SKP_OBJ_VAL(skp_new_string(buffer));
     }
     
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* native_clock(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    return skp_new_float((skp_double)clock() / CLOCKS_PER_SEC);
+skp_value_t native_clock(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    return SKP_FLOAT_VAL((skp_float)clock() / CLOCKS_PER_SEC);
 }
 
-skp_object_t* native_type(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_null();
-    return skp_new_string(skp_type_name(skp_get_type(argv[0])));
+skp_value_t native_type(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_NULL_VAL;
+    return SKP_OBJ_VAL(skp_new_string(skp_type_name(skp_get_type(argv[0]))));
 }
 
-skp_object_t* native_len(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_int(0);
+skp_value_t native_len(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_INT_VAL(0);
     
     skp_type_t type = skp_get_type(argv[0]);
     if (type == SKP_TYPE_STRING) {
-        return skp_new_int(strlen(argv[0]->data.v_string.chars));
+        return skp_str_length(SKP_AS_OBJ(argv[0]));
     } else if (type == SKP_TYPE_LIST) {
-        return skp_new_int(argv[0]->data.v_list.count);
+        return SKP_INT_VAL(SKP_AS_OBJ(argv[0])->data.v_list.count);
     } else if (type == SKP_TYPE_DICT) {
-        return skp_new_int(argv[0]->data.v_dict.count);
+        return SKP_INT_VAL(SKP_AS_OBJ(argv[0])->data.v_dict.count);
+    } else if (type == SKP_TYPE_BUILDER) {
+        return SKP_INT_VAL(SKP_AS_OBJ(argv[0])->data.v_builder.char_count);
+    } else if (type == SKP_TYPE_RANGE) {
+        return SKP_INT_VAL(SKP_AS_OBJ(argv[0])->data.v_range.count);
     }
     
-    return skp_new_int(0);
+    return SKP_INT_VAL(0);
 }
 
-skp_object_t* native_range(skp_vm_t* vm, int argc, skp_object_t** argv) {
+skp_value_t native_range(skp_vm_t* vm, int argc, skp_value_t* argv) {
     skp_int start = 0, end = 0, step = 1;
     
     if (argc == 1) {
@@ -893,149 +1782,157 @@ skp_object_t* native_range(skp_vm_t* vm, int argc, skp_object_t** argv) {
         }
     }
     
-    skp_object_t* list = skp_list_create();
-    if (step > 0) {
-        for (skp_int i = start; i < end; i += step) {
-            skp_list_append(list, skp_new_int(i));
-        }
-    } else if (step < 0) {
-        for (skp_int i = start; i > end; i += step) {
-            skp_list_append(list, skp_new_int(i));
-        }
+    /* العدد يجب أن يتسع في skp_int ليُقرأ بالطول والفهرسة */
+    uint64_t count = skp_range_count(start, end, step);
+    if (count > (uint64_t)INT64_MAX) {
+        vm_runtime_error(vm, "المدى أطول من أن يُمثل: %llu عنصراً",
+                         (unsigned long long)count);
+        return SKP_NULL_VAL;
     }
     
-    return list;
+    /* كائن بحجم ثابت مهما طال المدى؛ انسخ يحوله قائمة عند الحاجة */
+    return SKP_OBJ_VAL(skp_new_range(start, end, step));
 }
 
-skp_object_t* native_int(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_int(0);
-    return skp_new_int(skp_to_int(argv[0]));
+skp_value_t native_int(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_INT_VAL(0);
+    return SKP_INT_VAL(skp_to_int(argv[0]));
 }
 
-skp_object_t* native_float(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0.0);
-    return skp_new_float(skp_to_float(argv[0]));
+skp_value_t native_float(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0.0);
+    return SKP_FLOAT_VAL(skp_to_float(argv[0]));
 }
 
-skp_object_t* native_str(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_string("");
-    
-    char buffer[256];
-    skp_type_t type = skp_get_type(argv[0]);
+skp_value_t native_str(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_OBJ_VAL(skp_new_string(""));
+    if (SKP_IS_STRING(argv[0])) return argv[0];
+    return SKP_OBJ_VAL(skp_to_string(argv[0]));
+}
+
+/* إحصاءات الجمع: عدد الجمعات وأزمنة التوقف بالميكروثانية ومدرجها.
+ * التوقفات ومدرجها لخطوات الجيل القديم، ولجمعات الحضانة مفاتيحها */
+skp_value_t native_gc_stats(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    skp_gc_stats_t* stats = &vm->gc_stats;
+    skp_object_t* result = skp_new_dict();
+    skp_object_t* histogram = skp_new_list();
     
-    switch (type) {
-        case SKP_TYPE_INT:
-            snprintf(buffer, sizeof(buffer), "%lld", argv[0]->data.v_int.value);
-            return skp_new_string(buffer);
-        case SKP_TYPE_FLOAT:
-            snprintf(buffer, sizeof(buffer), "%g", argv[0]->data.v_float.value);
-            return skp_new_string(buffer);
-        case SKP_TYPE_BOOL:
-            return skp_new_string(argv[0]->data.v_bool.value ? "صحيح" : "خطأ");
-        case SKP_TYPE_NULL:
-            return skp_new_string("فارغ");
-        case SKP_TYPE_STRING:
-            return argv[0];
-        default:
-            snprintf(buffer, sizeof(buffer), "<%s>", skp_type_name(type));
-            return skp_new_string(buffer);
+    for (int i = 0; i < SKP_GC_PAUSE_BUCKETS; i++) {
+        skp_list_append(histogram, SKP_INT_VAL((skp_int)stats->pauses[i]));
     }
+    
+    skp_dict_set(result, "جمعات_الحضانة", SKP_INT_VAL((skp_int)stats->minor_count));
+    skp_dict_set(result, "أقصى_توقف_للحضانة", SKP_INT_VAL((skp_int)(stats->minor_max_ns / 1000)));
+    skp_dict_set(result, "مجموع_توقفات_الحضانة", SKP_INT_VAL((skp_int)(stats->minor_total_ns / 1000)));
+    skp_dict_set(result, "دورات_كاملة", SKP_INT_VAL((skp_int)stats->major_count));
+    skp_dict_set(result, "تعليم_دون_ميزانية", SKP_INT_VAL((skp_int)stats->forced_remarks));
+    skp_dict_set(result, "توقفات", SKP_INT_VAL((skp_int)stats->pause_count));
+    skp_dict_set(result, "أقصى_توقف", SKP_INT_VAL((skp_int)(stats->pause_max_ns / 1000)));
+    skp_dict_set(result, "مجموع_التوقفات", SKP_INT_VAL((skp_int)(stats->pause_total_ns / 1000)));
+    skp_dict_set(result, "الميزانية", SKP_INT_VAL((skp_int)(vm->gc_pause_budget / 1000)));
+    skp_dict_set(result, "المدرج", SKP_OBJ_VAL(histogram));
+    
+    return SKP_OBJ_VAL(result);
 }
 
-skp_object_t* native_exit(skp_vm_t* vm, int argc, skp_object_t** argv) {
+skp_value_t native_exit(skp_vm_t* vm, int argc, skp_value_t* argv) {
     int code = 0;
     if (argc > 0) {
         code = (int)skp_to_int(argv[0]);
     }
     exit(code);
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
 /* دوال الرياضيات */
-skp_object_t* native_abs(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_int(0);
-    skp_double val = skp_to_float(argv[0]);
-    return skp_new_float(val < 0 ? -val : val);
+skp_value_t native_abs(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_INT_VAL(0);
+    if (SKP_IS_INT(argv[0])) {
+        skp_int val = SKP_AS_INT(argv[0]);
+        return SKP_INT_VAL(val < 0 ? skp_int_neg(val) : val);
+    }
+    skp_float val = skp_to_float(argv[0]);
+    return SKP_FLOAT_VAL(val < 0 ? -val : val);
 }
 
-skp_object_t* native_sqrt(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(sqrt(skp_to_float(argv[0])));
+skp_value_t native_sqrt(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(sqrt(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_pow(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2) return skp_new_float(0);
-    return skp_new_float(pow(skp_to_float(argv[0]), skp_to_float(argv[1])));
+skp_value_t native_pow(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(pow(skp_to_float(argv[0]), skp_to_float(argv[1])));
 }
 
-skp_object_t* native_sin(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(sin(skp_to_float(argv[0])));
+skp_value_t native_sin(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(sin(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_cos(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(cos(skp_to_float(argv[0])));
+skp_value_t native_cos(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(cos(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_tan(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(tan(skp_to_float(argv[0])));
+skp_value_t native_tan(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(tan(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_log(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(log(skp_to_float(argv[0])));
+skp_value_t native_log(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(log(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_log10(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(log10(skp_to_float(argv[0])));
+skp_value_t native_log10(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(log10(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_exp(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(exp(skp_to_float(argv[0])));
+skp_value_t native_exp(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(exp(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_floor(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(floor(skp_to_float(argv[0])));
+skp_value_t native_floor(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(floor(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_ceil(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(ceil(skp_to_float(argv[0])));
+skp_value_t native_ceil(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(ceil(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_round(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_float(0);
-    return skp_new_float(round(skp_to_float(argv[0])));
+skp_value_t native_round(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_FLOAT_VAL(0);
+    return SKP_FLOAT_VAL(round(skp_to_float(argv[0])));
 }
 
-skp_object_t* native_min(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_int(0);
-    skp_object_t* min = argv[0];
+skp_value_t native_min(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_INT_VAL(0);
+    skp_value_t min = argv[0];
     for (int i = 1; i < argc; i++) {
-        if (skp_to_float(argv[i]) < skp_to_float(min)) {
+        if (skp_lt(argv[i], min)) {
             min = argv[i];
         }
     }
     return min;
 }
 
-skp_object_t* native_max(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_int(0);
-    skp_object_t* max = argv[0];
+skp_value_t native_max(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_INT_VAL(0);
+    skp_value_t max = argv[0];
     for (int i = 1; i < argc; i++) {
-        if (skp_to_float(argv[i]) > skp_to_float(max)) {
+        if (skp_gt(argv[i], max)) {
             max = argv[i];
         }
     }
     return max;
 }
 
-skp_object_t* native_random(skp_vm_t* vm, int argc, skp_object_t** argv) {
+skp_value_t native_random(skp_vm_t* vm, int argc, skp_value_t* argv) {
     static int seeded = 0;
     if (!seeded) {
         srand((unsigned)time(NULL));
@@ -1045,446 +1942,465 @@ skp_object_t* native_random(skp_vm_t* vm, int argc, skp_object_t** argv) {
     if (argc >= 2) {
         skp_int min = skp_to_int(argv[0]);
         skp_int max = skp_to_int(argv[1]);
-        return skp_new_int(min + rand() % (max - min + 1));
+        return SKP_INT_VAL(min + rand() % (max - min + 1));
     }
     
-    return skp_new_float((skp_double)rand() / RAND_MAX);
+    return SKP_FLOAT_VAL((skp_float)rand() / RAND_MAX);
 }
 
 /* دوال النصوص */
-skp_object_t* native_chr(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_string("");
-    char buffer[2] = {(char)skp_to_int(argv[0]), '\0'};
-    return skp_new_string(buffer);
-}
-
-skp_object_t* native_ord(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_int(0);
+/* حرف(رمز): المحرف برمز يونيكود، مرمزاً بـ UTF-8 */
+skp_value_t native_chr(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_OBJ_VAL(skp_new_string(""));
+    
+    skp_int code = skp_to_int(argv[0]);
+    if (code < 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+        vm_runtime_error(vm, "لا محرف برمز %lld", (long long)code);
+        return SKP_NULL_VAL;
+    }
+    
+    unsigned char buffer[4];
+    size_t length;
+    if (code < 0x80) {
+        buffer[0] = (unsigned char)code;
+        length = 1;
+    } else if (code < 0x800) {
+        buffer[0] = (unsigned char)(0xC0 | (code >> 6));
+        length = 2;
+    } else if (code < 0x10000) {
+        buffer[0] = (unsigned char)(0xE0 | (code >> 12));
+        length = 3;
+    } else {
+        buffer[0] = (unsigned char)(0xF0 | (code >> 18));
+        length = 4;
+    }
+    for (size_t i = 1; i < length; i++) {
+        buffer[i] = (unsigned char)(0x80 | ((code >> (6 * (length - 1 - i))) & 0x3F));
     }
-    return skp_new_int((skp_int)argv[0]->data.v_string.chars[0]);
+    return SKP_OBJ_VAL(skp_new_string_len((const char*)buffer, length));
 }
 
-skp_object_t* native_split(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_list_create();
+/* ترميز(نص): رمز يونيكود للمحرف الأول؛ التسلسل غير السليم يُقرأ بايته
+ * الأول */
+skp_value_t native_ord(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_INT_VAL(0);
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    skp_string sep = argv[1]->data.v_string.chars;
+    skp_object_t* string = SKP_AS_OBJ(argv[0]);
+    skp_string_flatten(string);
+    const unsigned char* chars = (const unsigned char*)string->data.v_string.chars;
+    size_t length = string->data.v_string.length;
+    if (length == 0) return SKP_INT_VAL(0);
     
-    skp_object_t* list = skp_list_create();
-    char* copy = strdup(str);
-    char* token = strtok(copy, sep);
-    
-    while (token) {
-        skp_list_append(list, skp_new_string(token));
-        token = strtok(NULL, sep);
+    size_t extra = chars[0] >= 0xF0 ? 3 : chars[0] >= 0xE0 ? 2 : chars[0] >= 0xC0 ? 1 : 0;
+    skp_int code = extra ? chars[0] & (0x3F >> extra) : chars[0];
+    for (size_t i = 1; i <= extra; i++) {
+        if (i >= length || (chars[i] & 0xC0) != 0x80) return SKP_INT_VAL(chars[0]);
+        code = (code << 6) | (chars[i] & 0x3F);
+    }
+    return SKP_INT_VAL(code);
+}
+
+skp_value_t native_split(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_OBJ_VAL(skp_new_list());
     }
     
-    free(copy);
-    return list;
+    return SKP_OBJ_VAL(skp_str_split(SKP_AS_OBJ(argv[0]), SKP_AS_OBJ(argv[1])));
 }
 
-skp_object_t* native_join(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_LIST || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_string("");
+skp_value_t native_join(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_LIST(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_OBJ_VAL(skp_new_string(""));
     }
     
-    skp_object_t* list = argv[0];
-    skp_string sep = argv[1]->data.v_string.chars;
+    skp_object_t* list = SKP_AS_OBJ(argv[0]);
+    const char* sep = SKP_AS_CSTRING(argv[1]);
+    size_t sep_len = SKP_AS_OBJ(argv[1])->data.v_string.length;
     
-    char buffer[4096] = {0};
-    size_t pos = 0;
+    /* تحويل العناصر أولاً لمعرفة الطول النهائي، ثم نسخة واحدة */
+    size_t count = list->data.v_list.count;
+    skp_object_t** parts = (skp_object_t**)malloc((count ? count : 1) * sizeof(skp_object_t*));
+    size_t length = count > 0 ? (count - 1) * sep_len : 0;
+    for (size_t i = 0; i < count; i++) {
+        parts[i] = skp_to_string(list->data.v_list.items[i]);
+        length += parts[i]->data.v_string.length;
+    }
     
-    for (size_t i = 0; i < list->data.v_list.count; i++) {
-        skp_object_t* item = list->data.v_list.items[i];
-        skp_string str = skp_to_string(item);
-        
+    skp_object_t* result = skp_string_reserve(length);
+    char* out = result->data.v_string.chars;
+    for (size_t i = 0; i < count; i++) {
         if (i > 0) {
-            pos += snprintf(buffer + pos, sizeof(buffer) - pos, "%s", sep);
+            memcpy(out, sep, sep_len);
+            out += sep_len;
         }
-        pos += snprintf(buffer + pos, sizeof(buffer) - pos, "%s", str);
+        memcpy(out, parts[i]->data.v_string.chars, parts[i]->data.v_string.length);
+        out += parts[i]->data.v_string.length;
+        skp_decref(parts[i]);
     }
+    free(parts);
     
-    return skp_new_string(buffer);
+    skp_string_seal(result);
+    return SKP_OBJ_VAL(result);
 }
 
-skp_object_t* native_upper(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_string("");
-    }
-    
-    skp_string str = argv[0]->data.v_string.chars;
-    char* result = strdup(str);
-    for (char* p = result; *p; p++) {
-        *p = toupper(*p);
+skp_value_t native_upper(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_OBJ_VAL(skp_new_string(""));
     }
     
-    skp_object_t* obj = skp_new_string(result);
-    free(result);
-    return obj;
+    return SKP_OBJ_VAL(skp_str_upper(SKP_AS_OBJ(argv[0])));
 }
 
-skp_object_t* native_lower(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_string("");
+skp_value_t native_lower(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_OBJ_VAL(skp_new_string(""));
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    char* result = strdup(str);
-    for (char* p = result; *p; p++) {
-        *p = tolower(*p);
-    }
-    
-    skp_object_t* obj = skp_new_string(result);
-    free(result);
-    return obj;
+    return SKP_OBJ_VAL(skp_str_lower(SKP_AS_OBJ(argv[0])));
 }
 
-skp_object_t* native_strip(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_string("");
+skp_value_t native_strip(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_OBJ_VAL(skp_new_string(""));
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    while (isspace(*str)) str++;
-    
-    char* end = (char*)str + strlen(str) - 1;
-    while (end > str && isspace(*end)) end--;
-    end[1] = '\0';
-    
-    return skp_new_string(str);
+    return SKP_OBJ_VAL(skp_str_trim(SKP_AS_OBJ(argv[0])));
 }
 
-skp_object_t* native_replace(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 3 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[2]) != SKP_TYPE_STRING) {
-        return skp_new_string("");
+skp_value_t native_replace(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 3 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1]) ||
+        !SKP_IS_STRING(argv[2])) {
+        return SKP_OBJ_VAL(skp_new_string(""));
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    skp_string old = argv[1]->data.v_string.chars;
-    skp_string new_str = argv[2]->data.v_string.chars;
-    
-    char buffer[4096] = {0};
-    char* pos = (char*)str;
-    char* found;
-    size_t buf_pos = 0;
-    size_t old_len = strlen(old);
-    
-    while ((found = strstr(pos, old)) != NULL) {
-        size_t len = found - pos;
-        memcpy(buffer + buf_pos, pos, len);
-        buf_pos += len;
-        memcpy(buffer + buf_pos, new_str, strlen(new_str));
-        buf_pos += strlen(new_str);
-        pos = found + old_len;
-    }
-    
-    strcpy(buffer + buf_pos, pos);
-    return skp_new_string(buffer);
+    return SKP_OBJ_VAL(skp_str_replace(SKP_AS_OBJ(argv[0]), SKP_AS_OBJ(argv[1]),
+                                       SKP_AS_OBJ(argv[2])));
 }
 
-skp_object_t* native_find(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_int(-1);
+skp_value_t native_find(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_INT_VAL(-1);
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    skp_string substr = argv[1]->data.v_string.chars;
-    
-    char* found = strstr(str, substr);
-    if (found) {
-        return skp_new_int(found - str);
-    }
-    return skp_new_int(-1);
+    return SKP_INT_VAL(skp_str_find(SKP_AS_OBJ(argv[0]), SKP_AS_OBJ(argv[1])));
 }
 
-skp_object_t* native_startswith(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_startswith(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    skp_string prefix = argv[1]->data.v_string.chars;
+    skp_object_t* str = SKP_AS_OBJ(argv[0]);
+    skp_object_t* prefix = SKP_AS_OBJ(argv[1]);
     
-    return skp_new_bool(strncmp(str, prefix, strlen(prefix)) == 0);
+    if (prefix->data.v_string.length > str->data.v_string.length) return SKP_BOOL_VAL(0);
+    
+    return SKP_BOOL_VAL(memcmp(str->data.v_string.chars, prefix->data.v_string.chars,
+                               prefix->data.v_string.length) == 0);
 }
 
-skp_object_t* native_endswith(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_endswith(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    skp_string str = argv[0]->data.v_string.chars;
-    skp_string suffix = argv[1]->data.v_string.chars;
+    skp_object_t* str = SKP_AS_OBJ(argv[0]);
+    skp_object_t* suffix = SKP_AS_OBJ(argv[1]);
     
-    size_t str_len = strlen(str);
-    size_t suffix_len = strlen(suffix);
+    size_t str_len = str->data.v_string.length;
+    size_t suffix_len = suffix->data.v_string.length;
     
-    if (suffix_len > str_len) return skp_new_bool(0);
+    if (suffix_len > str_len) return SKP_BOOL_VAL(0);
     
-    return skp_new_bool(strcmp(str + str_len - suffix_len, suffix) == 0);
+    return SKP_BOOL_VAL(memcmp(str->data.v_string.chars + str_len - suffix_len,
+                               suffix->data.v_string.chars, suffix_len) == 0);
+}
+
+/* باني_نص(أجزاء...): نص قابل للإلحاق بـ أضف، يُقرأ بـ نص() */
+skp_value_t native_builder(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    skp_object_t* builder = skp_new_builder();
+    for (int i = 0; i < argc; i++) {
+        skp_builder_append(builder, argv[i]);
+    }
+    return SKP_OBJ_VAL(builder);
 }
 
 /* دوال القوائم والقواميس */
-skp_object_t* native_append(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_LIST) {
-        return skp_new_null();
+skp_value_t native_append(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc >= 1 && argv[0].type == SKP_TYPE_BUILDER) {
+        for (int i = 1; i < argc; i++) {
+            skp_builder_append(SKP_AS_OBJ(argv[0]), argv[i]);
+        }
+        return argv[0];
     }
     
-    skp_list_append(argv[0], argv[1]);
+    if (argc < 2 || !SKP_IS_LIST(argv[0])) {
+        return SKP_NULL_VAL;
+    }
+    
+    skp_list_append(SKP_AS_OBJ(argv[0]), argv[1]);
     return argv[0];
 }
 
-skp_object_t* native_insert(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 3 || skp_get_type(argv[0]) != SKP_TYPE_LIST) {
-        return skp_new_null();
+skp_value_t native_insert(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 3 || !SKP_IS_LIST(argv[0])) {
+        return SKP_NULL_VAL;
     }
     
     skp_int index = skp_to_int(argv[1]);
-    skp_list_insert(argv[0], index, argv[2]);
+    skp_list_insert(SKP_AS_OBJ(argv[0]), index, argv[2]);
     return argv[0];
 }
 
-skp_object_t* native_remove(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2) return skp_new_null();
+skp_value_t native_remove(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2) return SKP_NULL_VAL;
     
     skp_type_t type = skp_get_type(argv[0]);
     if (type == SKP_TYPE_LIST) {
         skp_int index = skp_to_int(argv[1]);
-        skp_list_remove(argv[0], index);
+        skp_list_remove(SKP_AS_OBJ(argv[0]), index);
     } else if (type == SKP_TYPE_DICT) {
-        skp_dict_remove(argv[0], skp_to_string(argv[1]));
+        skp_object_t* key = skp_to_string(argv[1]);
+        skp_dict_remove(SKP_AS_OBJ(argv[0]), key->data.v_string.chars);
+        skp_decref(key);
     }
     
     return argv[0];
 }
 
-skp_object_t* native_pop(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_LIST) {
-        return skp_new_null();
+skp_value_t native_pop(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_LIST(argv[0])) {
+        return SKP_NULL_VAL;
     }
     
-    skp_object_t* list = argv[0];
-    if (list->data.v_list.count == 0) return skp_new_null();
+    skp_object_t* list = SKP_AS_OBJ(argv[0]);
+    if (list->data.v_list.count == 0) return SKP_NULL_VAL;
     
     skp_int index = list->data.v_list.count - 1;
     if (argc >= 2) {
         index = skp_to_int(argv[1]);
     }
+    if (index < 0 || index >= (skp_int)list->data.v_list.count) {
+        return SKP_NULL_VAL;
+    }
     
-    skp_object_t* result = skp_list_get(list, index);
+    /* الاحتفاظ بالعنصر قبل أن تحرره القائمة */
+    skp_value_t result = skp_list_get(list, index);
+    skp_value_incref(result);
     skp_list_remove(list, index);
     return result;
 }
 
-skp_object_t* native_clear(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_null();
+skp_value_t native_clear(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_NULL_VAL;
     
     skp_type_t type = skp_get_type(argv[0]);
     if (type == SKP_TYPE_LIST) {
-        skp_list_clear(argv[0]);
+        skp_list_clear(SKP_AS_OBJ(argv[0]));
     } else if (type == SKP_TYPE_DICT) {
-        skp_dict_clear(argv[0]);
+        skp_dict_clear(SKP_AS_OBJ(argv[0]));
+    } else if (type == SKP_TYPE_BUILDER) {
+        skp_builder_clear(SKP_AS_OBJ(argv[0]));
     }
     
     return argv[0];
 }
 
-skp_object_t* native_sort(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_LIST) {
-        return skp_new_null();
+skp_value_t native_sort(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_LIST(argv[0])) {
+        return SKP_NULL_VAL;
     }
     
-    /* TODO: تنفيذ الفرز */
+    skp_list_sort(SKP_AS_OBJ(argv[0]));
     return argv[0];
 }
 
-skp_object_t* native_reverse(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_LIST) {
-        return skp_new_null();
+skp_value_t native_reverse(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_LIST(argv[0])) {
+        return SKP_NULL_VAL;
     }
     
-    skp_object_t* list = argv[0];
+    skp_object_t* list = SKP_AS_OBJ(argv[0]);
     size_t count = list->data.v_list.count;
     
+    skp_heap_reorder(list);
     for (size_t i = 0; i < count / 2; i++) {
-        skp_object_t* temp = list->data.v_list.items[i];
+        skp_value_t temp = list->data.v_list.items[i];
         list->data.v_list.items[i] = list->data.v_list.items[count - 1 - i];
         list->data.v_list.items[count - 1 - i] = temp;
     }
     
-    return list;
+    return argv[0];
 }
 
-skp_object_t* native_copy(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1) return skp_new_null();
+skp_value_t native_copy(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1) return SKP_NULL_VAL;
     
     skp_type_t type = skp_get_type(argv[0]);
     if (type == SKP_TYPE_LIST) {
-        return skp_list_copy(argv[0]);
+        return SKP_OBJ_VAL(skp_list_copy(SKP_AS_OBJ(argv[0])));
+    } else if (type == SKP_TYPE_RANGE) {
+        skp_object_t* list = skp_range_to_list(SKP_AS_OBJ(argv[0]));
+        if (!list) {
+            vm_runtime_error(vm, "المدى أطول من أن يُنسخ إلى قائمة: %lld عنصراً",
+                             (long long)SKP_AS_OBJ(argv[0])->data.v_range.count);
+            return SKP_NULL_VAL;
+        }
+        return SKP_OBJ_VAL(list);
     } else if (type == SKP_TYPE_DICT) {
-        return skp_dict_copy(argv[0]);
+        return SKP_OBJ_VAL(skp_dict_copy(SKP_AS_OBJ(argv[0])));
     }
     
     return argv[0];
 }
 
-skp_object_t* native_keys(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_DICT) {
-        return skp_list_create();
+skp_value_t native_keys(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_DICT(argv[0])) {
+        return SKP_OBJ_VAL(skp_new_list());
     }
     
-    return skp_dict_keys(argv[0]);
+    return SKP_OBJ_VAL(skp_dict_keys(SKP_AS_OBJ(argv[0])));
 }
 
-skp_object_t* native_values(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_DICT) {
-        return skp_list_create();
+skp_value_t native_values(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_DICT(argv[0])) {
+        return SKP_OBJ_VAL(skp_new_list());
     }
     
-    return skp_dict_values(argv[0]);
+    return SKP_OBJ_VAL(skp_dict_values(SKP_AS_OBJ(argv[0])));
 }
 
-skp_object_t* native_items(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_DICT) {
-        return skp_list_create();
+skp_value_t native_items(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_DICT(argv[0])) {
+        return SKP_OBJ_VAL(skp_new_list());
     }
     
-    return skp_dict_items(argv[0]);
+    return SKP_OBJ_VAL(skp_dict_items(SKP_AS_OBJ(argv[0])));
 }
 
 /* دوال الملفات */
-skp_object_t* native_open(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_null();
+skp_value_t native_open(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_NULL_VAL;
     }
     
-    skp_string path = argv[0]->data.v_string.chars;
-    skp_string mode = argv[1]->data.v_string.chars;
-    
-    FILE* file = fopen(path, mode);
-    if (!file) return skp_new_null();
+    FILE* file = fopen(SKP_AS_CSTRING(argv[0]), SKP_AS_CSTRING(argv[1]));
+    if (!file) return SKP_NULL_VAL;
     
     /* TODO: إرجاع كائن ملف */
     fclose(file);
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* native_read(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_null();
+skp_value_t native_read(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_NULL_VAL;
     }
     
-    skp_string path = argv[0]->data.v_string.chars;
-    FILE* file = fopen(path, "r");
-    if (!file) return skp_new_null();
+    FILE* file = fopen(SKP_AS_CSTRING(argv[0]), "rb");
+    if (!file) return SKP_NULL_VAL;
     
     fseek(file, 0, SEEK_END);
     long size = ftell(file);
     fseek(file, 0, SEEK_SET);
     
-    char* buffer = malloc(size + 1);
-    fread(buffer, 1, size, file);
-    buffer[size] = '\0';
+    if (size < 0) {
+        fclose(file);
+        return SKP_NULL_VAL;
+    }
+    
+    /* القراءة مباشرة في بيانات النص، فالملف قد يحوي بايتات صفرية */
+    skp_object_t* result = skp_string_reserve((size_t)size);
+    size_t bytes_read = fread(result->data.v_string.chars, 1, (size_t)size, file);
     fclose(file);
     
-    skp_object_t* result = skp_new_string(buffer);
-    free(buffer);
-    return result;
+    result->data.v_string.length = bytes_read;
+    result->data.v_string.chars[bytes_read] = '\0';
+    skp_string_seal(result);
+    return SKP_OBJ_VAL(result);
 }
 
-skp_object_t* native_write(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_write(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    skp_string path = argv[0]->data.v_string.chars;
-    skp_string content = argv[1]->data.v_string.chars;
+    skp_object_t* content = SKP_AS_OBJ(argv[1]);
     
-    FILE* file = fopen(path, "w");
-    if (!file) return skp_new_bool(0);
+    FILE* file = fopen(SKP_AS_CSTRING(argv[0]), "w");
+    if (!file) return SKP_BOOL_VAL(0);
     
-    fwrite(content, 1, strlen(content), file);
+    size_t length = content->data.v_string.length;
+    size_t written = fwrite(content->data.v_string.chars, 1, length, file);
     fclose(file);
     
-    return skp_new_bool(1);
+    return SKP_BOOL_VAL(written == length);
 }
 
-skp_object_t* native_close(skp_vm_t* vm, int argc, skp_object_t** argv) {
+skp_value_t native_close(skp_vm_t* vm, int argc, skp_value_t* argv) {
     /* TODO: إغلاق كائن ملف */
-    return skp_new_null();
+    return SKP_NULL_VAL;
 }
 
-skp_object_t* native_exists(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_exists(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    FILE* file = fopen(argv[0]->data.v_string.chars, "r");
+    FILE* file = fopen(SKP_AS_CSTRING(argv[0]), "r");
     if (file) {
         fclose(file);
-        return skp_new_bool(1);
+        return SKP_BOOL_VAL(1);
     }
-    return skp_new_bool(0);
+    return SKP_BOOL_VAL(0);
 }
 
-skp_object_t* native_remove_file(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_remove_file(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    return skp_new_bool(remove(argv[0]->data.v_string.chars) == 0);
+    return SKP_BOOL_VAL(remove(SKP_AS_CSTRING(argv[0])) == 0);
 }
 
-skp_object_t* native_rename(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 2 || skp_get_type(argv[0]) != SKP_TYPE_STRING || 
-        skp_get_type(argv[1]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_rename(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 2 || !SKP_IS_STRING(argv[0]) || !SKP_IS_STRING(argv[1])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    return skp_new_bool(rename(argv[0]->data.v_string.chars, 
-                                argv[1]->data.v_string.chars) == 0);
+    return SKP_BOOL_VAL(rename(SKP_AS_CSTRING(argv[0]), SKP_AS_CSTRING(argv[1])) == 0);
 }
 
-skp_object_t* native_mkdir(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_mkdir(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_BOOL_VAL(0);
     }
-    
+
 #ifdef _WIN32
-    return skp_new_bool(_mkdir(argv[0]->data.v_string.chars) == 0);
+    return SKP_BOOL_VAL(_mkdir(SKP_AS_CSTRING(argv[0])) == 0);
 #else
-    return skp_new_bool(mkdir(argv[0]->data.v_string.chars, 0755) == 0);
+    return SKP_BOOL_VAL(mkdir(SKP_AS_CSTRING(argv[0]), 0755) == 0);
 #endif
 }
 
-skp_object_t* native_rmdir(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    if (argc < 1 || skp_get_type(argv[0]) != SKP_TYPE_STRING) {
-        return skp_new_bool(0);
+skp_value_t native_rmdir(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    if (argc < 1 || !SKP_IS_STRING(argv[0])) {
+        return SKP_BOOL_VAL(0);
     }
     
-    return skp_new_bool(rmdir(argv[0]->data.v_string.chars) == 0);
+    return SKP_BOOL_VAL(rmdir(SKP_AS_CSTRING(argv[0])) == 0);
 }
 
-skp_object_t* native_listdir(skp_vm_t* vm, int argc, skp_object_t** argv) {
-    skp_string path = ".";
-    if (argc >= 1 && skp_get_type(argv[0]) == SKP_TYPE_STRING) {
-        path = argv[0]->data.v_string.chars;
+skp_value_t native_listdir(skp_vm_t* vm, int argc, skp_value_t* argv) {
+    const char* path = ".";
+    if (argc >= 1 && SKP_IS_STRING(argv[0])) {
+        path = SKP_AS_CSTRING(argv[0]);
     }
     
-    skp_object_t* list = skp_list_create();
-    
+    skp_object_t* list = skp_new_list();
+
 #ifdef _WIN32
     WIN32_FIND_DATA findData;
     HANDLE hFind;
@@ -1494,7 +2410,7 @@ skp_object_t* native_listdir(skp_vm_t* vm, int argc, skp_object_t** argv) {
     hFind = FindFirstFile(searchPath, &findData);
     if (hFind != INVALID_HANDLE_VALUE) {
         do {
-            skp_list_append(list, skp_new_string(findData.cFileName));
+            list_append_string(list, findData.cFileName);
         } while (FindNextFile(hFind, &findData));
         FindClose(hFind);
     }
@@ -1503,13 +2419,13 @@ skp_object_t* native_listdir(skp_vm_t* vm, int argc, skp_object_t** argv) {
     if (dir) {
         struct dirent* entry;
         while ((entry = readdir(dir)) != NULL) {
-            skp_list_append(list, skp_new_string(entry->d_name));
+            list_append_string(list, entry->d_name);
         }
         closedir(dir);
     }
 #endif
     
-    return list;
+    return SKP_OBJ_VAL(list);
 }
 
 /* ========== تسجيل الدوال المدمجة ========== */
@@ -1526,6 +2442,7 @@ void vm_register_natives(skp_vm_t* vm) {
     vm_define_native(vm, "عشري", native_float);
     vm_define_native(vm, "نص", native_str);
     vm_define_native(vm, "اخرج", native_exit);
+    vm_define_native(vm, "إحصاءات_الجمع", native_gc_stats);
     
     /* الرياضيات */
     vm_define_native(vm, "قيمة_مطلقة", native_abs);
@@ -1556,6 +2473,7 @@ void vm_register_natives(skp_vm_t* vm) {
     vm_define_native(vm, "ابحث", native_find);
     vm_define_native(vm, "يبدأ_بـ", native_startswith);
     vm_define_native(vm, "ينتهي_بـ", native_endswith);
+    vm_define_native(vm, "باني_نص", native_builder);
     
     /* القوائم والقواميس */
     vm_define_native(vm, "أضف", native_append);
@@ -14,40 +14,72 @@
 /* حجم المكدس */
 #define SKP_STACK_MAX 65536
 #define SKP_FRAMES_MAX 64
-#define SKP_GC_THRESHOLD 1024 * 1024  /* 1MB */
+#define SKP_GC_THRESHOLD (1024 * 1024)  /* 1MB، حجم الجيل القديم قبل أول جمع له */
+#define SKP_GC_GROW_FACTOR 2           /* بعد الجمع: الحد التالي = الحجم الحي × هذا */
+#define SKP_GC_PAUSE_BUDGET_US 500     /* أقصى توقف لخطوة تدريجية افتراضياً */
+#define SKP_GC_PAUSE_BUCKETS 16
+#define SKP_GC_REMARK_LIMIT 4          /* إعادات مسح الجذور في الميزانية قبل إتمام التعليم دون حد */
+
+/* التوزيع المترابط: كل معالج يقفز مباشرة إلى التالي عبر جدول عناوين
+ * (امتداد labels-as-values في GCC و Clang). يمكن الرجوع إلى switch
+ * المحمول بتعريف SKP_NO_COMPUTED_GOTO */
+#if defined(__GNUC__) && !defined(SKP_NO_COMPUTED_GOTO)
+#define SKP_COMPUTED_GOTO
+#endif
 
 /* إطار الاستدعاء */
 typedef struct {
+    skp_object_t* closure;   /* الإغلاق المُنفَّذ (NULL للبرنامج الرئيسي) */
     chunk_t* chunk;          /* كتلة البايتكود */
     uint8_t* ip;             /* مؤشر التعليمة */
-    skp_object_t** slots;    /* فتحات المكدس للدالة */
+    skp_value_t* slots;      /* فتحات المكدس للدالة */
 } call_frame_t;
 
-/* الجهاز الافتراضي */
+/* إحصاءات الجمع. التوقفات ومدرجها لخطوات الجيل القديم التي تحدها
+ * الميزانية؛ الخانة i في المدرج تعد التوقفات الأقصر من 2^i ميكروثانية،
+ * والأخيرة ما زاد على ذلك. جمعات الحضانة تُحصى وحدها */
 typedef struct {
+    uint64_t pauses[SKP_GC_PAUSE_BUCKETS];
+    uint64_t pause_count;
+    uint64_t pause_total_ns;
+    uint64_t pause_max_ns;
+    uint64_t minor_count;            /* جمعات الحضانة */
+    uint64_t minor_total_ns;
+    uint64_t minor_max_ns;
+    uint64_t major_count;            /* دورات الجيل القديم المكتملة */
+    uint64_t forced_remarks;         /* دورات أُتم تعليمها دون ميزانية */
+} skp_gc_stats_t;
+
+/* الجهاز الافتراضي */
+typedef struct skp_vm {
     /* المكدس */
-    skp_object_t* stack[SKP_STACK_MAX];
-    skp_object_t** stack_top;
+    skp_value_t stack[SKP_STACK_MAX];
+    skp_value_t* stack_top;
     
     /* إطارات الاستدعاء */
     call_frame_t frames[SKP_FRAMES_MAX];
     int frame_count;
     
-    /* المتغيرات العامة */
-    skp_dict_t* globals;
+    /* المتغيرات العامة: الأسماء تُحل إلى فتحات عند الترجمة */
+    skp_object_t* globals;           /* اسم ← رقم الفتحة */
+    skp_value_t* global_values;      /* قيم الفتحات */
+    size_t global_capacity;
     
-    /* الكائنات المُخصَّصة (لجمع القمامة) */
-    skp_object_t* objects;
-    size_t bytes_allocated;
-    size_t next_gc;
+    /* الكومة: الحضانة والجيل القديم */
+    skp_heap_t heap;
     
     /* Upvalues المفتوحة */
     skp_upvalue_t* open_upvalues;
     
-    /* الكائنات الرمادية (للـ GC) */
-    skp_object_t** gray_stack;
-    int gray_count;
-    int gray_capacity;
+    /* الكائنات المنقولة من الحضانة ولم تُفحص مراجعها بعد */
+    skp_object_t** promoted;
+    int promoted_count;
+    int promoted_capacity;
+    
+    /* سياسة الجمع وإحصاءاته */
+    uint64_t gc_pause_budget;        /* بالنانوثانية */
+    int gc_remarks;                  /* إعادات مسح الجذور في الدورة الجارية */
+    skp_gc_stats_t gc_stats;
     
     /* حالة التشغيل */
     int running;
@@ -72,98 +104,111 @@ skp_result_t vm_interpret(skp_vm_t* vm, const char* source);
 skp_result_t vm_run(skp_vm_t* vm, chunk_t* chunk);
 
 /* المكدس */
-void vm_push(skp_vm_t* vm, skp_object_t* value);
-skp_object_t* vm_pop(skp_vm_t* vm);
-skp_object_t* vm_peek(skp_vm_t* vm, int distance);
+void vm_push(skp_vm_t* vm, skp_value_t value);
+skp_value_t vm_pop(skp_vm_t* vm);
+skp_value_t vm_peek(skp_vm_t* vm, int distance);
 void vm_popn(skp_vm_t* vm, int n);
 
 /* العمليات */
-int vm_call(skp_vm_t* vm, skp_object_t* callee, int arg_count);
-int vm_call_value(skp_vm_t* vm, skp_object_t* callee, int arg_count);
-int vm_invoke(skp_vm_t* vm, skp_object_t* receiver, skp_string name, int arg_count);
-int vm_invoke_from_class(skp_vm_t* vm, skp_class_t* klass, skp_string name, int arg_count);
+int vm_call(skp_vm_t* vm, skp_object_t* closure, int arg_count);
+int vm_call_value(skp_vm_t* vm, skp_value_t callee, int arg_count);
+int vm_invoke(skp_vm_t* vm, skp_value_t receiver, const char* name, int arg_count);
+int vm_invoke_from_class(skp_vm_t* vm, skp_class_t* klass, const char* name, int arg_count);
+int vm_bind_method(skp_vm_t* vm, skp_class_t* klass, const char* name);
 
 /* Upvalues */
-skp_upvalue_t* vm_capture_upvalue(skp_vm_t* vm, skp_object_t** local);
-void vm_close_upvalues(skp_vm_t* vm, skp_object_t** last);
+skp_upvalue_t* vm_capture_upvalue(skp_vm_t* vm, skp_value_t* local);
+void vm_close_upvalues(skp_vm_t* vm, skp_value_t* last);
 
 /* الأخطاء */
 void vm_runtime_error(skp_vm_t* vm, const char* format, ...);
 void vm_define_native(skp_vm_t* vm, const char* name, skp_native_func_t func);
 
+/* المتغيرات العامة */
+void vm_sync_globals(skp_vm_t* vm);
+const char* vm_global_name(skp_vm_t* vm, uint16_t slot);
+
+/* التكرار في حلقة لكل */
+int vm_iter_next(skp_value_t collection, skp_value_t* position, skp_value_t* item);
+
 /* جمع القمامة */
 void vm_collect_garbage(skp_vm_t* vm);
+void vm_collect_nursery(skp_vm_t* vm);
+void vm_collect_step(skp_vm_t* vm);
 void vm_mark_object(skp_vm_t* vm, skp_object_t* object);
-void vm_mark_value(skp_vm_t* vm, skp_object_t* value);
+void vm_mark_value(skp_vm_t* vm, skp_value_t value);
 void vm_trace_references(skp_vm_t* vm);
 void vm_sweep(skp_vm_t* vm);
+void vm_print_gc_stats(skp_vm_t* vm, FILE* out);
 
 /* دوال native مدمجة */
-skp_object_t* native_print(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_input(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_clock(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_type(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_len(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_range(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_int(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_float(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_str(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_exit(skp_vm_t* vm, int argc, skp_object_t** argv);
+skp_value_t native_print(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_input(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_clock(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_type(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_len(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_range(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_int(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_float(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_str(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_exit(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_gc_stats(skp_vm_t* vm, int argc, skp_value_t* argv);
 
 /* دوال الرياضيات */
-skp_object_t* native_abs(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_sqrt(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_pow(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_sin(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_cos(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_tan(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_log(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_log10(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_exp(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_floor(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_ceil(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_round(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_min(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_max(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_random(skp_vm_t* vm, int argc, skp_object_t** argv);
+skp_value_t native_abs(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_sqrt(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_pow(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_sin(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_cos(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_tan(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_log(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_log10(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_exp(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_floor(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_ceil(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_round(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_min(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_max(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_random(skp_vm_t* vm, int argc, skp_value_t* argv);
 
 /* دوال النصوص */
-skp_object_t* native_chr(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_ord(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_split(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_join(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_upper(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_lower(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_strip(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_replace(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_find(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_startswith(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_endswith(skp_vm_t* vm, int argc, skp_object_t** argv);
+skp_value_t native_chr(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_ord(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_split(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_join(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_upper(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_lower(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_strip(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_replace(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_find(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_startswith(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_endswith(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_builder(skp_vm_t* vm, int argc, skp_value_t* argv);
 
 /* دوال القوائم والقواميس */
-skp_object_t* native_append(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_insert(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_remove(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_pop(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_clear(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_sort(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_reverse(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_copy(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_keys(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_values(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_items(skp_vm_t* vm, int argc, skp_object_t** argv);
+skp_value_t native_append(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_insert(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_remove(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_pop(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_clear(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_sort(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_reverse(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_copy(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_keys(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_values(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_items(skp_vm_t* vm, int argc, skp_value_t* argv);
 
 /* دوال الملفات */
-skp_object_t* native_open(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_read(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_write(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_close(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_exists(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_remove_file(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_rename(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_mkdir(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_rmdir(skp_vm_t* vm, int argc, skp_object_t** argv);
-skp_object_t* native_listdir(skp_vm_t* vm, int argc, skp_object_t** argv);
+skp_value_t native_open(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_read(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_write(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_close(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_exists(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_remove_file(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_rename(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_mkdir(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_rmdir(skp_vm_t* vm, int argc, skp_value_t* argv);
+skp_value_t native_listdir(skp_vm_t* vm, int argc, skp_value_t* argv);
 
 /* تسجيل جميع الدوال المدمجة */
 void vm_register_natives(skp_vm_t* vm);
@@ -0,0 +1,87 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * مقياس أداء القواميس
+ *
+ * يقيس زمن الإدراج والبحث والحذف لكل عملية مع تزايد عدد المفاتيح،
+ * فإذا بقي الزمن لكل عملية ثابتاً تقريباً فالعمليات O(1).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../المصدر/seekep.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void make_key(char* buffer, size_t size, size_t i) {
+    snprintf(buffer, size, "مفتاح_%zu", i);
+}
+
+static int run(size_t n) {
+    char key[64];
+    skp_object_t* dict = skp_new_dict();
+    
+    double start = now_seconds();
+    for (size_t i = 0; i < n; i++) {
+        make_key(key, sizeof(key), i);
+        skp_dict_set(dict, key, SKP_INT_VAL(i));
+    }
+    double insert = now_seconds() - start;
+    
+    start = now_seconds();
+    skp_int sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        skp_value_t value;
+        make_key(key, sizeof(key), i);
+        if (!skp_dict_get(dict, key, &value)) {
+            fprintf(stderr, "خطأ: المفتاح %s مفقود\n", key);
+            return 1;
+        }
+        sum += SKP_AS_INT(value);
+    }
+    double lookup = now_seconds() - start;
+    
+    /* حذف النصف الزوجي ثم إعادة إدراجه لاختبار الجدول بعد الحذف */
+    start = now_seconds();
+    for (size_t i = 0; i < n; i += 2) {
+        make_key(key, sizeof(key), i);
+        skp_dict_remove(dict, key);
+    }
+    for (size_t i = 0; i < n; i += 2) {
+        make_key(key, sizeof(key), i);
+        skp_dict_set(dict, key, SKP_INT_VAL(i));
+    }
+    for (size_t i = 0; i < n; i++) {
+        make_key(key, sizeof(key), i);
+        skp_dict_remove(dict, key);
+    }
+    double removal = now_seconds() - start;
+    
+    if (skp_dict_len(dict) != 0 || sum != (skp_int)(n * (n - 1) / 2)) {
+        fprintf(stderr, "خطأ: نتيجة غير صحيحة عند %zu مفتاح\n", n);
+        return 1;
+    }
+    
+    printf("%10zu  %12.1f  %12.1f  %12.1f\n", n,
+           insert * 1e9 / n, lookup * 1e9 / n, removal * 1e9 / (n * 2));
+    
+    skp_decref(dict);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    size_t max = argc > 1 ? (size_t)atol(argv[1]) : 4096000;
+    
+    printf("القواميس: نانوثانية لكل عملية\n");
+    printf("%10s  %12s  %12s  %12s\n", "المفاتيح", "إدراج", "بحث", "حذف");
+    
+    for (size_t n = 1000; n <= max; n *= 4) {
+        if (run(n) != 0) return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * مقياس تصنيف الكلمات المفتاحية
+ *
+ * يعزل lexer_keyword_type عن بقية المعجم: يصنف مزيجاً من الكلمات
+ * المفتاحية ومعرفات قريبة منها (بالطول نفسه أو البادئة نفسها) ويقيس
+ * زمن التصنيف الواحد.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../المصدر/lexer.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static const char* WORDS[] = {
+    /* كلمات مفتاحية */
+    "متغير", "ثابت", "دالة", "أرجع", "إذا", "وإلا", "أثناء", "لكل", "في",
+    "توقف", "استمر", "صنف", "جديد", "هذا", "استورد", "صدر", "صحيح", "خطأ",
+    "فارغ", "و", "أو", "ليس",
+    /* معرفات شائعة وأخرى تشبه الكلمات المفتاحية */
+    "المجموع", "العنصر", "القائمة", "عدد_العناصر", "الاسم", "الرصيد",
+    "متغيرات", "دالتي", "إذاً", "لكن", "فيه", "صدري", "جديدة", "أول",
+    "ليست", "وإلى", "استوردت", "i", "x", "count", "total", "self",
+};
+
+#define WORD_COUNT (sizeof(WORDS) / sizeof(WORDS[0]))
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 20000000;
+    size_t lengths[WORD_COUNT];
+    int rounds = 5;
+    
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        lengths[i] = strlen(WORDS[i]);
+    }
+    
+    double best = 0;
+    long keywords = 0;
+    for (int r = 0; r < rounds; r++) {
+        keywords = 0;
+        double start = now_seconds();
+        /* خطوة 7 أولية مع عدد الكلمات فتمر عليها كلها بترتيب متقطع */
+        for (long n = 0, i = 0; n < iterations; n++) {
+            i = (i + 7) % (long)WORD_COUNT;
+            keywords += lexer_keyword_type(WORDS[i], lengths[i]) != TOKEN_IDENTIFIER;
+        }
+        double elapsed = now_seconds() - start;
+        
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    
+    printf("الكلمات المفتاحية: %ld تصنيف، %ld كلمة مفتاحية\n", iterations, keywords);
+    printf("%.2f نانوثانية لكل تصنيف\n", best * 1e9 / iterations);
+    
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * مقياس أداء المعجم
+ *
+ * يبني نصاً عربياً كبيراً من قالب برنامج نموذجي بمعرفات متغيرة، ثم
+ * يقيس سرعة تحويله إلى رموز بالميغابايت في الثانية.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../المصدر/lexer.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* قالب بالأسلوب الشائع في البرامج: مسافات بادئة ومعرفات عربية طويلة
+ * وفواصل عربية ونصوص وتعليقات. %zu يُستبدل برقم المقطع */
+static const char* TEMPLATE =
+    "# حساب إحصاءات المجموعة رقم %zu\n"
+    "دالة احسب_المتوسط_%zu(القائمة، الحد_الأدنى = 0) {\n"
+    "    متغير المجموع_الكلي = 0؛\n"
+    "    متغير عدد_العناصر = 0\n"
+    "    لكل (العنصر في القائمة) {\n"
+    "        إذا (العنصر >= الحد_الأدنى و العنصر != فارغ) {\n"
+    "            المجموع_الكلي += العنصر\n"
+    "            عدد_العناصر = عدد_العناصر + 1\n"
+    "        } وإلا {\n"
+    "            اطبع(\"تجاهل العنصر: \" + نص(العنصر))\n"
+    "        }\n"
+    "    }\n"
+    "    أرجع عدد_العناصر > 0 ? المجموع_الكلي / عدد_العناصر : 0.0\n"
+    "}\n"
+    "\n"
+    "صنف حساب_مصرفي_%zu {\n"
+    "    دالة init(الاسم، الرصيد) {\n"
+    "        هذا.الاسم = الاسم\n"
+    "        هذا.الرصيد = الرصيد\n"
+    "    }\n"
+    "}\n"
+    "متغير النتائج = {\"الأول\": [1، 2، 3]، \"الثاني\": احسب_المتوسط_%zu([4، 5، 6])}\n"
+    "\n";
+
+static char* build_corpus(size_t target, size_t* length) {
+    char chunk[4096];
+    size_t capacity = target + sizeof(chunk);
+    char* corpus = (char*)malloc(capacity + 1);
+    size_t used = 0;
+    
+    for (size_t i = 0; used < target; i++) {
+        int n = snprintf(chunk, sizeof(chunk), TEMPLATE, i, i, i, i);
+        memcpy(corpus + used, chunk, (size_t)n);
+        used += (size_t)n;
+    }
+    corpus[used] = '\0';
+    *length = used;
+    return corpus;
+}
+
+int main(int argc, char** argv) {
+    size_t target = (argc > 1 ? (size_t)atol(argv[1]) : 32) * 1024 * 1024;
+    int rounds = 5;
+    
+    size_t length;
+    char* corpus = build_corpus(target, &length);
+    
+    double best = 0;
+    size_t tokens = 0;
+    for (int r = 0; r < rounds; r++) {
+        double start = now_seconds();
+        lexer_t* lexer = lexer_create(corpus);
+        lexer_tokenize(lexer, &tokens);
+        double elapsed = now_seconds() - start;
+        lexer_destroy(lexer);
+        
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    
+    printf("المعجم: %.1f ميغابايت، %zu رمز\n", length / (1024.0 * 1024.0), tokens);
+    printf("%.1f ميغابايت/ثانية، %.1f نانوثانية لكل رمز\n",
+           length / (1024.0 * 1024.0) / best, best * 1e9 / tokens);
+    
+    free(corpus);
+    return 0;
+}
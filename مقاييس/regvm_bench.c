@@ -0,0 +1,165 @@
+/*
+ * SEEKEP - Smart Expressive Efficient Knowledge Execution Platform
+ * مقياس الجهاز السجلي مقابل الجهاز المكدسي
+ *
+ * يترجم كل برنامج من الشجرة نفسها إلى البايتكود المكدسي وإلى التعليمات
+ * السجلية، وينفذ كلاً منهما في جهاز جديد، ويقيس زمن التنفيذ وحده. يتحقق
+ * أيضاً من أن المتغير العام النتيجة واحد في الجهازين.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../المصدر/lexer.h"
+#include "../المصدر/parser.h"
+#include "../المصدر/compiler.h"
+#include "../المصدر/vm.h"
+#include "../المصدر/regvm.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+    const char* name;
+    const char* source;
+} workload_t;
+
+static const workload_t WORKLOADS[] = {
+    {
+        "حلقات متداخلة في دالة",
+        "دالة عمل() {\n"
+        "    متغير م = 0\n"
+        "    لكل (متغير ي = 0; ي < 1000; ي = ي + 1) {\n"
+        "        لكل (متغير ج = 0; ج < 1000; ج = ج + 1) {\n"
+        "            م = م + ي * ج % 7\n"
+        "        }\n"
+        "    }\n"
+        "    أرجع م\n"
+        "}\n"
+        "متغير النتيجة = عمل()\n"
+    },
+    {
+        "استدعاءات متكررة (فيبوناتشي 25)",
+        "دالة فيب(ن) {\n"
+        "    إذا (ن < 2) { أرجع ن }\n"
+        "    أرجع فيب(ن - 1) + فيب(ن - 2)\n"
+        "}\n"
+        "متغير النتيجة = فيب(25)\n"
+    },
+    {
+        "بناء قائمة وجمعها بلكل",
+        "دالة عمل() {\n"
+        "    متغير م = 0\n"
+        "    لكل (متغير د = 0; د < 20; د = د + 1) {\n"
+        "        متغير ل = []\n"
+        "        لكل (متغير ي = 0; ي < 20000; ي = ي + 1) { أضف(ل، ي) }\n"
+        "        لكل (ع في ل) { م = م + ع }\n"
+        "    }\n"
+        "    أرجع م\n"
+        "}\n"
+        "متغير النتيجة = عمل()\n"
+    },
+    {
+        "حلقة على متغيرات عامة",
+        "متغير النتيجة = 0\n"
+        "متغير ي = 0\n"
+        "أثناء (ي < 1000000) {\n"
+        "    النتيجة = النتيجة + ي\n"
+        "    ي = ي + 1\n"
+        "}\n"
+    },
+};
+
+#define WORKLOAD_COUNT (sizeof(WORKLOADS) / sizeof(WORKLOADS[0]))
+
+/* قيمة النتيجة بعد التنفيذ */
+static skp_value_t read_result(skp_vm_t* vm) {
+    skp_value_t slot;
+    if (!skp_dict_get(vm->globals, "النتيجة", &slot)) return SKP_NULL_VAL;
+    return vm->global_values[SKP_AS_INT(slot)];
+}
+
+/* زمن تنفيذ البرنامج مرة واحدة بأحد الجهازين، أو سالب عند الفشل */
+static double run_once(const char* source, int registers, skp_value_t* result) {
+    lexer_t* lexer = lexer_create(source);
+    parser_t* parser = parser_create(lexer);
+    ast_node_t* ast = parser_parse(parser);
+    skp_vm_t* vm = vm_create();
+    double elapsed = -1;
+    
+    if (!parser->had_error) {
+        if (registers) {
+            reg_proto_t* proto = reg_compile(ast, vm->globals);
+            if (proto) {
+                double start = now_seconds();
+                skp_result_t status = reg_run(vm, proto);
+                elapsed = now_seconds() - start;
+                if (status != SKP_OK) elapsed = -1;
+                reg_proto_free(proto);
+            }
+        } else {
+            skp_compiler_t* compiler = compiler_create(parser, vm->globals);
+            chunk_t* chunk = compiler_compile(compiler, ast);
+            if (chunk && !compiler->had_error) {
+                double start = now_seconds();
+                skp_result_t status = vm_run(vm, chunk);
+                elapsed = now_seconds() - start;
+                if (status != SKP_OK) elapsed = -1;
+            }
+            if (chunk) {
+                chunk_free(chunk);
+                free(chunk);
+            }
+            compiler_destroy(compiler);
+        }
+    }
+    
+    *result = read_result(vm);
+    vm_destroy(vm);
+    parser_destroy(parser);
+    lexer_destroy(lexer);
+    return elapsed;
+}
+
+/* أفضل زمن من عدة جولات */
+static double best_of(const char* source, int registers, int rounds, skp_value_t* result) {
+    double best = -1;
+    for (int r = 0; r < rounds; r++) {
+        double elapsed = run_once(source, registers, result);
+        if (elapsed < 0) return -1;
+        if (best < 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 5;
+    int failed = 0;
+    
+    printf("الجهاز السجلي مقابل المكدسي: أفضل زمن تنفيذ من %d جولات\n", rounds);
+    for (size_t i = 0; i < WORKLOAD_COUNT; i++) {
+        skp_value_t stack_result, register_result;
+        double stack_time = best_of(WORKLOADS[i].source, 0, rounds, &stack_result);
+        double register_time = best_of(WORKLOADS[i].source, 1, rounds, &register_result);
+        
+        if (stack_time < 0 || register_time < 0) {
+            fprintf(stderr, "خطأ: فشل تنفيذ %s\n", WORKLOADS[i].name);
+            failed = 1;
+            continue;
+        }
+        if (!skp_eq(stack_result, register_result)) {
+            fprintf(stderr, "خطأ: نتيجتا الجهازين مختلفتان في %s\n", WORKLOADS[i].name);
+            failed = 1;
+            continue;
+        }
+        
+        printf("%s: المكدسي %.2f ms، السجلي %.2f ms (%.2fx)\n", WORKLOADS[i].name,
+               stack_time * 1e3, register_time * 1e3, stack_time / register_time);
+    }
+    
+    return failed;
+}